@@ -0,0 +1,114 @@
+/*
+    Multi-threaded allocation benchmark.
+
+    Compares the builtin allocator behind mem__alloc against the malloc passthrough
+    (the previous mem__alloc, kept here). Every thread keeps a working set of live
+    objects and randomly frees, allocates and reallocates them. Sizes are mostly small
+    with an occasional large allocation, like the converter metadata.
+
+    bench/alloc [operations per thread]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef OS_LINUX
+
+#include <pthread.h>
+
+#define MAX_THREADS 16
+#define WORKING_SET 4096
+
+typedef void* (*AllocFN)(uint64_t size, void* old_ptr);
+
+static void* passthrough_alloc(uint64_t size, void* old_ptr) {
+    if (size == 0) {
+        free(old_ptr);
+        return NULL;
+    } else if (!old_ptr) {
+        return malloc(size);
+    }
+    return realloc(old_ptr, size);
+}
+
+static int     operations = 2000000;
+static AllocFN current_alloc;
+
+static void* worker(void* arg) {
+    uint64_t state = 0x9E3779B97F4A7C15ull * ((uint64_t)(uintptr_t)arg + 1);
+    void** live = calloc(WORKING_SET, sizeof(void*));
+    AllocFN alloc = current_alloc;
+
+    for (int i = 0; i < operations; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        uint32_t slot = state % WORKING_SET;
+        uint32_t kind = (state >> 16) % 100;
+        uint64_t size;
+        if (kind < 90)
+            size = 8 + (state >> 24) % 248;      // 8 - 256 bytes
+        else if (kind < 99)
+            size = 256 + (state >> 24) % 3840;   // 256 - 4096 bytes
+        else
+            size = 16384 + (state >> 24) % 65536;
+
+        if (!live[slot]) {
+            live[slot] = alloc(size, NULL);
+            *(char*)live[slot] = 1;
+        } else if ((state >> 40) % 4 == 0) {
+            live[slot] = alloc(size, live[slot]);
+        } else {
+            alloc(0, live[slot]);
+            live[slot] = NULL;
+        }
+    }
+    for (int i = 0; i < WORKING_SET; i++) {
+        if (live[i])
+            alloc(0, live[i]);
+    }
+    free(live);
+    return NULL;
+}
+
+static void run(const char* name, AllocFN alloc, int thread_count) {
+    pthread_t threads[MAX_THREADS];
+    current_alloc = alloc;
+    uint64_t start = time__monotonic();
+    for (int i = 0; i < thread_count; i++)
+        pthread_create(&threads[i], NULL, worker, (void*)(uintptr_t)i);
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(threads[i], NULL);
+    uint64_t elapsed = time__monotonic() - start;
+    uint64_t total = (uint64_t)operations * thread_count;
+    printf("  %-12s threads=%-2d %7.2f ns/op %8.2f Mops/s\n", name, thread_count, (double)elapsed / total, total / (elapsed / 1e9) / 1e6);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1)
+        operations = atoi(argv[1]);
+
+    if (!mem__set_allocator(MEM_ALLOCATOR_BUILTIN)) {
+        printf("  could not select builtin allocator\n");
+        return 1;
+    }
+
+    int thread_counts[] = { 1, 2, 4, 8 };
+    for (int i = 0; i < sizeof(thread_counts)/sizeof(*thread_counts); i++) {
+        run("malloc", passthrough_alloc, thread_counts[i]);
+        run("builtin", mem__alloc, thread_counts[i]);
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+    printf("  alloc benchmark is only implemented for Linux\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,190 @@
+/*
+    Build time of 'barf -c' over ELF objects, serial against the thread pool.
+
+    Generates synthetic relocatable ELF objects (.text with PLT32 calls to
+    functions of other objects and PC32 references to .data, one .rela.text,
+    global and local symbols) and combines 10, 100, 1000... of them with one
+    thread and with one thread per core (at least 4). Both outputs must be
+    byte-identical.
+    Inputs are converted in memory, each object is read once and no ~.ba
+    files are written. The docs budget about 1 ms per object.
+
+    Symbols are resolved through a hash map, ms/object stays flat as the
+    symbol count grows. 1000 objects with 333 globals (and 666 externals)
+    each give 1M input symbols:
+
+    bench/build [max object count] [globals per object]
+    bench/build 1000 333
+*/
+
+#include "barf/format.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define EXTERNALS_PER_GLOBAL 2
+#define TEXT_SIZE            1024
+#define DATA_SIZE            256
+
+static void write_elf(const char* path, int index, int object_count, int globals) {
+    int externals = globals * EXTERNALS_PER_GLOBAL;
+
+    // null, .data section symbol, globals, externals
+    int       symbol_count = 2 + globals + externals;
+    Elf64_Sym* symbols     = calloc(symbol_count, sizeof(Elf64_Sym));
+    char*     strings      = calloc(symbol_count, 64);
+    u32       string_size  = 1;
+
+    int        relocation_count = externals + globals;
+    Elf64_Rela* relocations     = calloc(relocation_count, sizeof(Elf64_Rela));
+
+    symbols[1].st_info  = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+    symbols[1].st_shndx = 3;
+    for (int g = 0; g < globals; g++) {
+        Elf64_Sym* symbol = &symbols[2 + g];
+        symbol->st_name  = string_size;
+        symbol->st_info  = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        symbol->st_shndx = 1;
+        symbol->st_value = g * 16;
+        string_size += 1 + sprintf(strings + string_size, "object%d_function%d", index, g);
+
+        relocations[g].r_offset = (g * 16 + 8) % (TEXT_SIZE - 4);
+        relocations[g].r_info   = ELF64_R_INFO(1, R_X86_64_PC32);
+        relocations[g].r_addend = g * 4 - 4;
+    }
+    for (int e = 0; e < externals; e++) {
+        int target = (index + 1 + e / globals) % object_count;
+        Elf64_Sym* symbol = &symbols[2 + globals + e];
+        symbol->st_name  = string_size;
+        symbol->st_info  = ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE);
+        symbol->st_shndx = SHN_UNDEF;
+        string_size += 1 + sprintf(strings + string_size, "object%d_function%d", target, e % globals);
+
+        relocations[globals + e].r_offset = (e * 8 + 1) % (TEXT_SIZE - 4);
+        relocations[globals + e].r_info   = ELF64_R_INFO(2 + globals + e, R_X86_64_PLT32);
+        relocations[globals + e].r_addend = -4;
+    }
+
+    static char section_names[] = "\0.text\0.rela.text\0.data\0.symtab\0.strtab\0.shstrtab";
+    static char text[TEXT_SIZE];
+    static char data[DATA_SIZE];
+
+    Elf64_Shdr sections[7];
+    memset(sections, 0, sizeof(sections));
+    u64 offset = sizeof(Elf64_Ehdr);
+
+    #define SECTION(I, NAME, TYPE, FLAGS, SIZE, LINK, INFO, ALIGN, ENTSIZE) \
+        sections[I].sh_name = NAME; sections[I].sh_type = TYPE; sections[I].sh_flags = FLAGS; \
+        sections[I].sh_offset = offset; sections[I].sh_size = SIZE; sections[I].sh_link = LINK; \
+        sections[I].sh_info = INFO; sections[I].sh_addralign = ALIGN; sections[I].sh_entsize = ENTSIZE; \
+        offset = (offset + (SIZE) + 7) & ~7ull;
+
+    SECTION(1, 1,  SHT_PROGBITS, SHF_ALLOC|SHF_EXECINSTR, TEXT_SIZE, 0, 0, 16, 0)
+    SECTION(2, 7,  SHT_RELA,     SHF_INFO_LINK, relocation_count * sizeof(Elf64_Rela), 4, 1, 8, sizeof(Elf64_Rela))
+    SECTION(3, 18, SHT_PROGBITS, SHF_ALLOC|SHF_WRITE, DATA_SIZE, 0, 0, 16, 0)
+    SECTION(4, 24, SHT_SYMTAB,   0, symbol_count * sizeof(Elf64_Sym), 5, 2, 8, sizeof(Elf64_Sym))
+    SECTION(5, 32, SHT_STRTAB,   0, string_size, 0, 0, 1, 0)
+    SECTION(6, 40, SHT_STRTAB,   0, sizeof(section_names), 0, 0, 1, 0)
+    #undef SECTION
+
+    Elf64_Ehdr header = { 0 };
+    memcpy(header.e_ident, ELFMAG, 4);
+    header.e_ident[EI_CLASS]   = ELFCLASS64;
+    header.e_ident[EI_DATA]    = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_type      = ET_REL;
+    header.e_machine   = EM_X86_64;
+    header.e_version   = EV_CURRENT;
+    header.e_ehsize    = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum     = 7;
+    header.e_shstrndx  = 6;
+    header.e_shoff     = offset;
+
+    FSHandle file = fs__open(path, FS_WRITE);
+    fs__write(file, 0, &header, sizeof(header));
+    fs__write(file, sections[1].sh_offset, text, TEXT_SIZE);
+    fs__write(file, sections[2].sh_offset, relocations, sections[2].sh_size);
+    fs__write(file, sections[3].sh_offset, data, DATA_SIZE);
+    fs__write(file, sections[4].sh_offset, symbols, sections[4].sh_size);
+    fs__write(file, sections[5].sh_offset, strings, string_size);
+    fs__write(file, sections[6].sh_offset, section_names, sizeof(section_names));
+    fs__write(file, header.e_shoff, sections, sizeof(sections));
+    fs__close(file);
+
+    free(symbols);
+    free(strings);
+    free(relocations);
+}
+
+static bool same_file(const char* a, const char* b) {
+    FSHandle fa = fs__open(a, FS_READ);
+    FSHandle fb = fs__open(b, FS_READ);
+    FSInfo ia, ib;
+    fs__info(fa, &ia);
+    fs__info(fb, &ib);
+    bool same = ia.file_size == ib.file_size;
+    if (same && ia.file_size) {
+        char* da = fs__map(fa, 0, ia.file_size, FS_MAP_READ);
+        char* db = fs__map(fb, 0, ib.file_size, FS_MAP_READ);
+        same = !memcmp(da, db, ia.file_size);
+        fs__unmap(da, ia.file_size);
+        fs__unmap(db, ib.file_size);
+    }
+    fs__close(fa);
+    fs__close(fb);
+    return same;
+}
+
+static double combine(int count, const char** paths, const char* output, int threads) {
+    BarfCombineOptions options = { 0 };
+    options.thread_count = threads;
+    u64 start = time__monotonic();
+    bool ok = barf_combine_to_artifact(count, paths, output, &options);
+    u64 elapsed = time__monotonic() - start;
+    if (!ok) {
+        printf("  combine failed\n");
+        exit(1);
+    }
+    return elapsed / 1e6;
+}
+
+int main(int argc, char** argv) {
+    int max_count = argc > 1 ? atoi(argv[1]) : 10000;
+    int globals   = argc > 2 ? atoi(argv[2]) : 4;
+
+    CPUInfo cpu;
+    cpu__info(&cpu);
+    printf("  %u logical cores, %d globals per object, %d symbols per object\n", cpu.logical_cores, globals, 2 + globals * (1 + EXTERNALS_PER_GLOBAL));
+    // At least 4 so the comparison goes through the thread pool on small machines too
+    int threads = cpu.logical_cores > 4 ? cpu.logical_cores : 4;
+    printf("  objects   1 thread (ms/object)   %2d threads (ms/object)  identical\n", threads);
+
+    for (int count = 10; count <= max_count; count *= 10) {
+        const char** paths = calloc(count, sizeof(char*));
+        for (int i = 0; i < count; i++) {
+            char* path = malloc(64);
+            snprintf(path, 64, "int/object%d.o", i);
+            paths[i] = path;
+            write_elf(path, i, count, globals);
+        }
+
+        double serial   = combine(count, paths, "int/serial.ba", 1);
+        double parallel = combine(count, paths, "int/parallel.ba", threads);
+        bool identical  = same_file("int/serial.ba", "int/parallel.ba");
+
+        printf("  %7d %10.2f (%6.3f) %14.2f (%6.3f)  %s\n", count,
+            serial, serial / count, parallel, parallel / count, identical ? "yes" : "NO");
+
+        for (int i = 0; i < count; i++) {
+            remove(paths[i]);
+            free((char*)paths[i]);
+        }
+        free(paths);
+        remove("int/serial.ba");
+        remove("int/parallel.ba");
+        if (!identical)
+            return 1;
+    }
+    return 0;
+}
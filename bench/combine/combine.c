@@ -0,0 +1,162 @@
+/*
+    Combining many artifacts into one.
+
+    Generates synthetic .ba inputs (a .text section with relocations and a .data
+    section per object, global symbols plus externals that resolve to globals in
+    other objects) and combines them with barf_combine_to_artifact. Reports the
+    time and how much the peak resident memory grew during the combine (Linux only).
+
+    bench/combine [object count] [globals per object]
+*/
+
+#include "barf/format.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define EXTERNALS_PER_GLOBAL 2
+#define TEXT_SIZE            4096
+
+static void write_object(const char* path, int index, int object_count, int globals) {
+    int externals    = globals * EXTERNALS_PER_GLOBAL;
+    int symbol_count = 1 + globals + externals;
+
+    BarfHeader     header   = { 0 };
+    BarfSection    sections[2];
+    BarfSymbol*    symbols  = calloc(symbol_count, sizeof(BarfSymbol));
+    BarfRelocation* relocations = calloc(externals, sizeof(BarfRelocation));
+    char*          strings  = calloc(symbol_count, 64);
+    u32            string_size = 0;
+    static char    text[TEXT_SIZE];
+    static char    data_bytes[256];
+
+    memset(sections, 0, sizeof(sections));
+    strcpy(sections[0].name, ".text");
+    sections[0].flags            = BARF_FLAG_EXEC;
+    sections[0].alignment        = 16;
+    sections[0].data_size        = TEXT_SIZE;
+    sections[0].relocation_count = externals;
+    strcpy(sections[1].name, ".data");
+    sections[1].flags            = BARF_FLAG_WRITE;
+    sections[1].alignment        = 16;
+    sections[1].data_size        = sizeof(data_bytes);
+
+    int si = 0;
+    symbols[si].type          = BARF_SYMBOL_LOCAL;
+    symbols[si].section_index = 1;
+    symbols[si].string_offset = string_size;
+    string_size += 1 + sprintf(strings + string_size, "local_data");
+    si++;
+    for (int g = 0; g < globals; g++, si++) {
+        symbols[si].type          = BARF_SYMBOL_GLOBAL;
+        symbols[si].section_index = 0;
+        symbols[si].offset        = g * 16;
+        symbols[si].string_offset = string_size;
+        string_size += 1 + sprintf(strings + string_size, "object%d_function%d", index, g);
+    }
+    for (int e = 0; e < externals; e++, si++) {
+        int target = (index + 1 + e / globals) % object_count;
+        symbols[si].type          = BARF_SYMBOL_EXTERNAL;
+        symbols[si].section_index = -1;
+        symbols[si].string_offset = string_size;
+        string_size += 1 + sprintf(strings + string_size, "object%d_function%d", target, e % globals);
+
+        relocations[e].type         = BARF_RELOC_REL32;
+        relocations[e].symbol_index = si;
+        relocations[e].offset       = (e * 8) % (TEXT_SIZE - 4);
+    }
+
+    header.magic          = BARF_MAGIC;
+    header.version        = BARF_FORMAT_VERSION;
+    strcpy(header.target, "x86_64");
+    header.section_count  = 2;
+    header.symbol_count   = symbol_count;
+    header.string_size    = string_size;
+    header.section_offset = sizeof(header);
+    header.symbol_offset  = header.section_offset + sizeof(sections);
+    header.string_offset  = header.symbol_offset + symbol_count * sizeof(BarfSymbol);
+
+    u64 offset = (header.string_offset + string_size + 15) & ~15ull;
+    sections[0].data_offset       = offset;
+    offset += TEXT_SIZE;
+    sections[0].relocation_offset = offset;
+    offset += externals * sizeof(BarfRelocation);
+    offset = (offset + 15) & ~15ull;
+    sections[1].data_offset       = offset;
+    offset += sizeof(data_bytes);
+    header.total_size = offset;
+
+    FSHandle file = fs__open(path, FS_WRITE);
+    fs__write(file, 0, &header, sizeof(header));
+    fs__write(file, header.section_offset, sections, sizeof(sections));
+    fs__write(file, header.symbol_offset, symbols, symbol_count * sizeof(BarfSymbol));
+    fs__write(file, header.string_offset, strings, string_size);
+    fs__write(file, sections[0].data_offset, text, TEXT_SIZE);
+    fs__write(file, sections[0].relocation_offset, relocations, externals * sizeof(BarfRelocation));
+    fs__write(file, sections[1].data_offset, data_bytes, sizeof(data_bytes));
+    fs__close(file);
+
+    free(symbols);
+    free(relocations);
+    free(strings);
+}
+
+// Peak resident memory (VmHWM) in KB, 0 if unknown
+static u64 peak_rss_kb() {
+    u64 kb = 0;
+    FILE* file = fopen("/proc/self/status", "r");
+    if (!file)
+        return 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (!strncmp(line, "VmHWM:", 6))
+            kb = strtoull(line + 6, NULL, 10);
+    }
+    fclose(file);
+    return kb;
+}
+
+// Resets the peak to the current resident memory so we only measure the combine
+static void reset_peak_rss() {
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+int main(int argc, char** argv) {
+    int object_count = argc > 1 ? atoi(argv[1]) : 1000;
+    int globals      = argc > 2 ? atoi(argv[2]) : 8;
+
+    const char** paths = calloc(object_count, sizeof(char*));
+    for (int i = 0; i < object_count; i++) {
+        char* path = malloc(64);
+        snprintf(path, 64, "int/object%d.ba", i);
+        paths[i] = path;
+        write_object(path, i, object_count, globals);
+    }
+
+    reset_peak_rss();
+    u64 rss_before = peak_rss_kb();
+    u64 start = time__monotonic();
+    bool ok = barf_combine_to_artifact(object_count, paths, "int/combined.ba", NULL);
+    u64 elapsed = time__monotonic() - start;
+    u64 rss_after = peak_rss_kb();
+
+    if (!ok) {
+        printf("  combine failed\n");
+        return 1;
+    }
+    printf("  %d objects, %d symbols each: %8.2f ms, peak RSS +%llu KB (%llu KB -> %llu KB)\n",
+        object_count, 1 + globals * (1 + EXTERNALS_PER_GLOBAL), elapsed / 1e6, (unsigned long long)(rss_after - rss_before),
+        (unsigned long long)rss_before, (unsigned long long)rss_after);
+
+    for (int i = 0; i < object_count; i++) {
+        remove(paths[i]);
+        free((char*)paths[i]);
+    }
+    remove("int/combined.ba");
+    free(paths);
+    return 0;
+}
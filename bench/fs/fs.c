@@ -0,0 +1,191 @@
+/*
+    Read/write throughput of the fs__ layer.
+
+    Compares the descriptor backend (pread/pwrite/fstat) against the previous
+    stdio backend (fseek + fread/fwrite, three seeks for the size) which is kept
+    here as a baseline. Also measures O_DIRECT and batched async reads.
+
+    bench/fs [file size in MB]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_FILE "int/bench_fs.bin"
+
+// Previous implementation of fs__, stdio based
+static FILE* stdio_handles[100];
+static int   stdio_handles_len;
+
+static FSHandle stdio_open(const char* path, uint32_t flags) {
+    FILE* file = NULL;
+    if (flags & FS_WRITE) {
+        file = fopen(path, "wb");
+    } else if (flags & FS_READ) {
+        file = fopen(path, "rb");
+    }
+    if (!file)
+        return FS_INVALID_HANDLE;
+    FSHandle handle = stdio_handles_len;
+    stdio_handles[stdio_handles_len++] = file;
+    return handle;
+}
+static void stdio_close(FSHandle handle) {
+    fclose(stdio_handles[handle]);
+    stdio_handles[handle] = NULL;
+    while (stdio_handles_len > 0 && stdio_handles[stdio_handles_len-1] == NULL)
+        stdio_handles_len--;
+}
+static void stdio_info(FSHandle handle, FSInfo* info) {
+    FILE* file = stdio_handles[handle];
+    size_t cur_pos = ftell(file);
+    fseek(file, 0, SEEK_END);
+    size_t file_size = ftell(file);
+    fseek(file, cur_pos, SEEK_SET);
+    info->file_size = file_size;
+    info->is_directory = false;
+}
+static uint64_t stdio_read(FSHandle handle, uint64_t offset, void* buffer, uint64_t size) {
+    FILE* file = stdio_handles[handle];
+    fseek(file, offset, SEEK_SET);
+    return fread(buffer, 1, size, file);
+}
+static uint64_t stdio_write(FSHandle handle, uint64_t offset, void* buffer, uint64_t size) {
+    FILE* file = stdio_handles[handle];
+    fseek(file, offset, SEEK_SET);
+    return fwrite(buffer, 1, size, file);
+}
+
+typedef struct {
+    const char* name;
+    FSHandle (*open)(const char* path, uint32_t flags);
+    void     (*close)(FSHandle handle);
+    void     (*info)(FSHandle handle, FSInfo* info);
+    uint64_t (*read)(FSHandle handle, uint64_t offset, void* buffer, uint64_t size);
+    uint64_t (*write)(FSHandle handle, uint64_t offset, void* buffer, uint64_t size);
+    uint32_t extra_flags;
+} Backend;
+
+static Backend backends[] = {
+    { "stdio",      stdio_open, stdio_close, stdio_info, stdio_read, stdio_write, 0 },
+    { "fd",         fs__open,   fs__close,   fs__info,   fs__read,   fs__write,   0 },
+    { "fd O_DIRECT",fs__open,   fs__close,   fs__info,   fs__read,   fs__write,   FS_DIRECT },
+};
+
+static uint64_t file_size;
+static char*    buffer;
+
+static void report(const char* test, const char* backend, uint64_t bytes, uint64_t ops, uint64_t elapsed) {
+    double seconds = elapsed / 1e9;
+    printf("  %-18s %-12s %9.1f MB/s %10.0f ops/s\n", test, backend, bytes / seconds / (1024*1024), ops / seconds);
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static uint64_t rng() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+int main(int argc, char** argv) {
+    uint64_t size_mb = argc > 1 ? atoi(argv[1]) : 64;
+    file_size = size_mb * 1024 * 1024;
+    const uint64_t block = 64 * 1024;
+    const uint64_t small_block = 4096;
+    const int      random_reads = 20000;
+
+    buffer = aligned_alloc(4096, block * 32);
+    memset(buffer, 0xAB, block * 32);
+
+    for (int bi = 0; bi < sizeof(backends)/sizeof(*backends); bi++) {
+        Backend* b = &backends[bi];
+
+        // Sequential write
+        FSHandle file = b->open(BENCH_FILE, FS_WRITE | b->extra_flags);
+        if (file == FS_INVALID_HANDLE) {
+            printf("  %-12s could not open %s\n", b->name, BENCH_FILE);
+            continue;
+        }
+        uint64_t start = time__monotonic();
+        for (uint64_t offset = 0; offset < file_size; offset += block)
+            b->write(file, offset, buffer, block);
+        b->close(file);
+        report("write 64K seq", b->name, file_size, file_size / block, time__monotonic() - start);
+
+        file = b->open(BENCH_FILE, FS_READ | b->extra_flags);
+
+        // Sequential read
+        start = time__monotonic();
+        for (uint64_t offset = 0; offset < file_size; offset += block)
+            b->read(file, offset, buffer, block);
+        report("read 64K seq", b->name, file_size, file_size / block, time__monotonic() - start);
+
+        // Random read
+        start = time__monotonic();
+        for (int i = 0; i < random_reads; i++) {
+            uint64_t offset = (rng() % (file_size / small_block)) * small_block;
+            b->read(file, offset, buffer, small_block);
+        }
+        report("read 4K random", b->name, random_reads * small_block, random_reads, time__monotonic() - start);
+
+        // Size queries
+        FSInfo info;
+        start = time__monotonic();
+        for (int i = 0; i < 100000; i++)
+            b->info(file, &info);
+        report("info", b->name, 0, 100000, time__monotonic() - start);
+
+        b->close(file);
+    }
+
+    // Batched async reads through the queue, 32 requests in flight
+    FSHandle file = fs__open(BENCH_FILE, FS_READ);
+    FSQueue* queue = fs__queue_create(32);
+    if (queue) {
+        FSRequest    requests[32];
+        FSCompletion completions[32];
+        uint64_t start = time__monotonic();
+        uint64_t offset = 0;
+        uint32_t inflight = 0;
+        while (offset < file_size || inflight > 0) {
+            uint32_t count = 0;
+            while (inflight + count < 32 && offset < file_size) {
+                requests[count] = (FSRequest){ FS_OP_READ, file, offset, buffer + (count * block), block, offset };
+                offset += block;
+                count++;
+            }
+            // Buffers are reused while requests are in flight, contents don't matter here.
+            inflight += fs__submit(queue, requests, count);
+            inflight -= fs__complete(queue, completions, 32, 1);
+        }
+        report("read 64K seq", "fd async", file_size, file_size / block, time__monotonic() - start);
+
+        start = time__monotonic();
+        int done = 0, submitted = 0;
+        inflight = 0;
+        while (done < random_reads) {
+            uint32_t count = 0;
+            while (inflight + count < 32 && submitted + count < random_reads) {
+                uint64_t offset = (rng() % (file_size / small_block)) * small_block;
+                requests[count] = (FSRequest){ FS_OP_READ, file, offset, buffer + (count * small_block), small_block, offset };
+                count++;
+            }
+            uint32_t n = fs__submit(queue, requests, count);
+            submitted += n;
+            inflight  += n;
+            n = fs__complete(queue, completions, 32, 1);
+            inflight -= n;
+            done     += n;
+        }
+        report("read 4K random", "fd async", random_reads * small_block, random_reads, time__monotonic() - start);
+        fs__queue_destroy(queue);
+    }
+    fs__close(file);
+
+    remove(BENCH_FILE);
+    return 0;
+}
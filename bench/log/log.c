@@ -0,0 +1,88 @@
+/*
+    Logging throughput.
+
+    Compares log__printf (per-thread ring buffers, background flusher) against the
+    previous implementation, vfprintf on the unbuffered stderr (kept here). stderr is
+    redirected to a file while measuring. The time includes log__flush at the end.
+
+    bench/log [messages per thread]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#ifdef OS_LINUX
+
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#define MAX_THREADS 16
+#define LOG_FILE    "int/bench_log.txt"
+
+static void stdio_log(const char* format, ...) {
+    va_list va;
+    va_start(va, format);
+    vfprintf(stderr, format, va);
+    va_end(va);
+}
+
+static int messages = 200000;
+static void (*current_log)(const char* format, ...);
+
+static void* worker(void* arg) {
+    int id = (int)(uintptr_t)arg;
+    for (int i = 0; i < messages; i++)
+        current_log("barf: thread %d message %d, section '%s' at 0x%x\n", id, i, ".text", i * 16);
+    return NULL;
+}
+
+static void run(const char* name, void (*log)(const char*, ...), int thread_count) {
+    pthread_t threads[MAX_THREADS];
+    current_log = log;
+
+    // Point stderr at a fresh file, keep the terminal for the results
+    int saved = dup(STDERR_FILENO);
+    int file = open(LOG_FILE, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    dup2(file, STDERR_FILENO);
+    close(file);
+
+    uint64_t start = time__monotonic();
+    for (int i = 0; i < thread_count; i++)
+        pthread_create(&threads[i], NULL, worker, (void*)(uintptr_t)i);
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(threads[i], NULL);
+    log__flush();
+    uint64_t elapsed = time__monotonic() - start;
+
+    dup2(saved, STDERR_FILENO);
+    close(saved);
+
+    uint64_t total = (uint64_t)messages * thread_count;
+    printf("  %-14s threads=%-2d %8.1f ns/message %8.2f M messages/s\n", name, thread_count, (double)elapsed / total, total / (elapsed / 1e9) / 1e6);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1)
+        messages = atoi(argv[1]);
+
+    int thread_counts[] = { 1, 4 };
+    for (int i = 0; i < sizeof(thread_counts)/sizeof(*thread_counts); i++) {
+        run("stderr", stdio_log, thread_counts[i]);
+        run("log__printf", log__printf, thread_counts[i]);
+    }
+    remove(LOG_FILE);
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+    printf("  log benchmark is only implemented for Linux\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+    libm from src/libc against glibc's libm.
+
+    Scalar calls go through function pointers over a buffer of random arguments
+    in a typical range for each function. The array versions run over the same
+    buffer, glibc has no array interface so its column is a plain loop of calls.
+    Float functions take the same arguments rounded to float.
+
+    bench/math [rounds]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "libc/libm_rename.h"
+#include "libc/libm.c"
+#include "libc/libm_unrename.h"
+
+typedef double (*UnaryFN)(double);
+typedef float  (*UnaryFloatFN)(float);
+typedef void   (*ArrayFN)(double*, const double*, size_t);
+typedef void   (*ArrayFloatFN)(float*, const float*, size_t);
+typedef double (*BinaryFN)(double, double);
+typedef float  (*BinaryFloatFN)(float, float);
+
+#define COUNT 4096
+
+static double x[COUNT], y[COUNT], z[COUNT];
+static float xf[COUNT], yf[COUNT], zf[COUNT];
+static int rounds;
+static volatile double sink;
+
+static uint64_t state = 0x2545F4914F6CDD1Dull;
+
+static double uniform(double lo, double hi) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return lo + (hi - lo) * (double)(state >> 11) * 0x1p-53;
+}
+
+static void fill(double lo, double hi, double y_lo, double y_hi) {
+    for (int i = 0; i < COUNT; i++) {
+        x[i] = uniform(lo, hi);
+        y[i] = uniform(y_lo, y_hi);
+        xf[i] = (float)x[i];
+        yf[i] = (float)y[i];
+    }
+}
+
+// ns per element
+static double elapsed_per_element(uint64_t start) {
+    return (double)(time__monotonic() - start) / ((double)rounds * COUNT);
+}
+
+static double run_scalar(UnaryFN fn) {
+    volatile UnaryFN f = fn;
+    double sum = 0;
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < COUNT; i++)
+            sum += f(x[i]);
+    sink = sum;
+    return elapsed_per_element(start);
+}
+
+static double run_scalar_float(UnaryFloatFN fn) {
+    volatile UnaryFloatFN f = fn;
+    float sum = 0;
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < COUNT; i++)
+            sum += f(xf[i]);
+    sink = sum;
+    return elapsed_per_element(start);
+}
+
+static double run_array(ArrayFN fn) {
+    volatile ArrayFN f = fn;
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        f(z, x, COUNT);
+    sink = z[rounds % COUNT];
+    return elapsed_per_element(start);
+}
+
+static double run_array_float(ArrayFloatFN fn) {
+    volatile ArrayFloatFN f = fn;
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        f(zf, xf, COUNT);
+    sink = zf[rounds % COUNT];
+    return elapsed_per_element(start);
+}
+
+static double run_binary(BinaryFN fn) {
+    volatile BinaryFN f = fn;
+    double sum = 0;
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < COUNT; i++)
+            sum += f(x[i], y[i]);
+    sink = sum;
+    return elapsed_per_element(start);
+}
+
+static double run_binary_float(BinaryFloatFN fn) {
+    volatile BinaryFloatFN f = fn;
+    float sum = 0;
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        for (int i = 0; i < COUNT; i++)
+            sum += f(xf[i], yf[i]);
+    sink = sum;
+    return elapsed_per_element(start);
+}
+
+static double run_pow_array(void) {
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        libm_pow_array(z, x, y, COUNT);
+    sink = z[rounds % COUNT];
+    return elapsed_per_element(start);
+}
+
+static double run_powf_array(void) {
+    uint64_t start = time__monotonic();
+    for (int r = 0; r < rounds; r++)
+        libm_powf_array(zf, xf, yf, COUNT);
+    sink = zf[rounds % COUNT];
+    return elapsed_per_element(start);
+}
+
+static void print(const char* name, double scalar, double array, double glibc) {
+    printf("  %-6s %10.2f %10.2f %10.2f\n", name, scalar, array, glibc);
+}
+
+typedef struct {
+    const char* name;
+    double lo, hi;
+    UnaryFN fn, glibc;
+    ArrayFN array;
+    UnaryFloatFN fn_f, glibc_f;
+    ArrayFloatFN array_f;
+} Unary;
+
+#define UNARY(name, lo, hi) { #name, lo, hi, libm_##name, name, libm_##name##_array, libm_##name##f, name##f, libm_##name##f_array }
+
+static const Unary unary[] = {
+    UNARY(exp, -10, 10),
+    UNARY(log, 1e-3, 1e3),
+    UNARY(sin, -10, 10),
+    UNARY(cos, -10, 10),
+    UNARY(tanh, -3, 3),
+    UNARY(sqrt, 0, 1e6),
+};
+
+int main(int argc, char** argv) {
+    rounds = argc > 1 ? atoi(argv[1]) : 500;
+
+    printf("  ns/call       libm libm array      glibc\n");
+    for (int i = 0; i < sizeof(unary)/sizeof(*unary); i++) {
+        const Unary* u = &unary[i];
+        fill(u->lo, u->hi, 0, 0);
+        print(u->name, run_scalar(u->fn), run_array(u->array), run_scalar(u->glibc));
+    }
+    fill(1e-3, 10, -5, 5);
+    print("pow", run_binary(libm_pow), run_pow_array(), run_binary(pow));
+
+    for (int i = 0; i < sizeof(unary)/sizeof(*unary); i++) {
+        const Unary* u = &unary[i];
+        char name[16];
+        snprintf(name, sizeof(name), "%sf", u->name);
+        fill(u->lo, u->hi, 0, 0);
+        print(name, run_scalar_float(u->fn_f), run_array_float(u->array_f), run_scalar_float(u->glibc_f));
+    }
+    fill(1e-3, 10, -5, 5);
+    print("powf", run_binary_float(libm_powf), run_powf_array(), run_binary_float(powf));
+    return 0;
+}
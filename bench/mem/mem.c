@@ -0,0 +1,128 @@
+/*
+    memcpy, memmove, memset and memcmp from src/libc against glibc.
+
+    The artifact libc is included with its functions renamed so both can live in one
+    program. The byte loops libc used before are kept here as a baseline. Every size
+    is run on a buffer that fits in L1 and copies above 4MB go through main memory.
+    Calls go through function pointers so the compiler can't inline or specialize them.
+
+    bench/mem [max size]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libc/libc_rename.h"
+#include "libc/libc.c"
+#include "libc/libc_unrename.h"
+
+typedef void* (*CopyFN)(void* dst, const void* src, size_t n);
+typedef void* (*SetFN)(void* dst, int c, size_t n);
+typedef int   (*CompareFN)(const void* a, const void* b, size_t n);
+
+static void* byte_memcpy(void* dst, const void* src, size_t n) {
+    volatile unsigned char* d = dst;
+    const unsigned char* s = src;
+    while (n--)
+        *d++ = *s++;
+    return dst;
+}
+
+static void* byte_memset(void* dst, int c, size_t n) {
+    volatile unsigned char* p = dst;
+    while (n--)
+        *p++ = (unsigned char)c;
+    return dst;
+}
+
+static int byte_memcmp(const void* a, const void* b, size_t n) {
+    const volatile unsigned char* pa = a;
+    const volatile unsigned char* pb = b;
+    for (; n > 0; n--, pa++, pb++) {
+        if (*pa != *pb)
+            return (int)*pa - (int)*pb;
+    }
+    return 0;
+}
+
+#define BUFFER_SIZE (64 * 1024 * 1024)
+#define TARGET_BYTES (256ull * 1024 * 1024) // work per measurement
+
+static char* source;
+static char* dest;
+
+static uint64_t iterations_for(size_t size) {
+    uint64_t n = TARGET_BYTES / (size + 16);
+    if (n > 2000000)
+        n = 2000000;
+    return n < 4 ? 4 : n;
+}
+
+// Returns GB/s
+static double run_copy(CopyFN copy, size_t size, int misalign, bool overlap) {
+    uint64_t iterations = iterations_for(size);
+    char* d = overlap ? source + 8 + misalign : dest + misalign;
+    volatile CopyFN fn = copy;
+    uint64_t start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        fn(d, source + 1, size);
+    uint64_t elapsed = time__monotonic() - start;
+    return (double)size * iterations / elapsed;
+}
+
+static double run_set(SetFN set, size_t size, int misalign) {
+    uint64_t iterations = iterations_for(size);
+    volatile SetFN fn = set;
+    uint64_t start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        fn(dest + misalign, (int)i, size);
+    uint64_t elapsed = time__monotonic() - start;
+    return (double)size * iterations / elapsed;
+}
+
+static double run_compare(CompareFN compare, size_t size) {
+    uint64_t iterations = iterations_for(size);
+    volatile CompareFN fn = compare;
+    volatile int sink = 0;
+    uint64_t start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        sink += fn(dest, source, size);
+    uint64_t elapsed = time__monotonic() - start;
+    return (double)size * iterations / elapsed;
+}
+
+int main(int argc, char** argv) {
+    size_t max_size = argc > 1 ? strtoull(argv[1], NULL, 10) : 32 * 1024 * 1024;
+    if (max_size > BUFFER_SIZE - 64)
+        max_size = BUFFER_SIZE - 64;
+
+    source = malloc(BUFFER_SIZE);
+    dest   = malloc(BUFFER_SIZE);
+    memset(source, 'a', BUFFER_SIZE);
+    memset(dest, 'b', BUFFER_SIZE);
+
+    size_t sizes[] = { 1, 7, 16, 31, 64, 100, 128, 256, 1024, 4096, 16384, 65536, 1 << 20, 8 << 20, 32 << 20 };
+
+    printf("  GB/s                 %10s %10s %10s\n", "libc", "glibc", "byte loop");
+    for (int i = 0; i < sizeof(sizes)/sizeof(*sizes) && sizes[i] <= max_size; i++) {
+        size_t size = sizes[i];
+        bool small = size <= 4096;
+        printf("  memcpy  %9zu    %10.2f %10.2f %10.2f\n", size,
+            run_copy(libc_memcpy, size, 3, false), run_copy(memcpy, size, 3, false), small ? run_copy(byte_memcpy, size, 3, false) : 0);
+        printf("  memmove %9zu    %10.2f %10.2f %10.2f\n", size,
+            run_copy(libc_memmove, size, 0, true), run_copy(memmove, size, 0, true), small ? run_copy(byte_memcpy, size, 0, false) : 0);
+        printf("  memset  %9zu    %10.2f %10.2f %10.2f\n", size,
+            run_set(libc_memset, size, 5), run_set(memset, size, 5), small ? run_set(byte_memset, size, 5) : 0);
+        memcpy(dest, source, size);
+        printf("  memcmp  %9zu    %10.2f %10.2f %10.2f\n", size,
+            run_compare(libc_memcmp, size), run_compare(memcmp, size), small ? run_compare(byte_memcmp, size) : 0);
+    }
+    printf("  (byte loop only measured up to 4096 bytes)\n");
+
+    free(source);
+    free(dest);
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+    strtoll and strtod from src/libc against glibc and the previous strtoul (kept
+    below, a byte loop that only handled integers).
+
+    Each input is a large generated text of one number per line, the whole text is
+    parsed by following endptr. Integers are CSV-like ids and counters, prices have
+    two decimals and doubles are printed with all 17 significant digits so they
+    round trip.
+
+    bench/parse [megabytes]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define strlen    libc_strlen
+#define strnlen   libc_strnlen
+#define strcpy    libc_strcpy
+#define strcmp    libc_strcmp
+#define strncmp   libc_strncmp
+#define strchr    libc_strchr
+#define strrchr   libc_strrchr
+#define memchr    libc_memchr
+#define strstr    libc_strstr
+#define memcpy    libc_memcpy
+#define memmove   libc_memmove
+#define memset    libc_memset
+#define memcmp    libc_memcmp
+#define strtol    libc_strtol
+#define strtoll   libc_strtoll
+#define strtoul   libc_strtoul
+#define strtoull  libc_strtoull
+#define strtod    libc_strtod
+#define strtof    libc_strtof
+#define vsnprintf libc_vsnprintf
+#define snprintf  libc_snprintf
+#include "libc/libc.c"
+#undef strlen
+#undef strnlen
+#undef strcpy
+#undef strcmp
+#undef strncmp
+#undef strchr
+#undef strrchr
+#undef memchr
+#undef strstr
+#undef memcpy
+#undef memmove
+#undef memset
+#undef memcmp
+#undef strtol
+#undef strtoll
+#undef strtoul
+#undef strtoull
+#undef strtod
+#undef strtof
+#undef vsnprintf
+#undef snprintf
+
+static unsigned long old_strtoul(const char *nptr, char **endptr, int base)
+{
+    const char *s = nptr;
+    unsigned long result = 0;
+    int negative = 0;
+    int any = 0;
+
+    while (s[0] == ' ' || s[0] == '\t' || s[0] == '\n' || s[0] == '\r')
+        s++;
+    if (*s == '+') {
+        s++;
+    } else if (*s == '-') {
+        negative = 1;
+        s++;
+    }
+    if (base == 0) {
+        if (*s == '0') {
+            if (s[1] == 'x' || s[1] == 'X') {
+                base = 16;
+                s += 2;
+            } else {
+                base = 8;
+                s++;
+            }
+        } else {
+            base = 10;
+        }
+    } else if (base == 16) {
+        if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+            s += 2;
+    }
+
+    unsigned long cutoff = ULONG_MAX / base;
+    unsigned long cutlim = ULONG_MAX % base;
+    for (; *s; s++) {
+        int digit;
+        if (*s >= '0' && *s <= '9')
+            digit = *s - '0';
+        else if (*s >= 'A' && *s <= 'Z')
+            digit = *s - 'A' + 10;
+        else if (*s >= 'a' && *s <= 'z')
+            digit = *s - 'a' + 10;
+        else
+            break;
+        if (digit >= base)
+            break;
+        if (result > cutoff || (result == cutoff && digit > cutlim)) {
+            result = ULONG_MAX;
+            any = -1;
+        } else {
+            any = 1;
+            result = result * base + digit;
+        }
+    }
+    if (endptr)
+        *endptr = (char *)(any ? s : nptr);
+    if (negative)
+        return (unsigned long)(-result);
+    return result;
+}
+
+static long long old_strtoll(const char *s, char **end, int base) { return (long long)old_strtoul(s, end, base); }
+
+typedef long long (*IntegerFN)(const char*, char**, int);
+typedef double    (*FloatFN)(const char*, char**);
+
+static uint64_t state = 0x2545F4914F6CDD1Dull;
+
+static uint64_t next() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+enum { INTEGERS, PRICES, DOUBLES };
+
+static char* generate(int kind, size_t size, int* count) {
+    char* text = malloc(size + 64);
+    size_t at = 0;
+    *count = 0;
+    while (at < size) {
+        uint64_t r = next();
+        if (kind == INTEGERS)
+            at += sprintf(text + at, "%lld\n", (long long)(r % 2 ? r % 100000 : r >> (r % 40)) * (r % 7 ? 1 : -1));
+        else if (kind == PRICES)
+            at += sprintf(text + at, "%.2f\n", (double)(r % 10000000) / 100);
+        else
+            at += sprintf(text + at, "%.17g\n", (double)(r >> 11) / (1ull << 53) * (double)(1ull << (r % 64)));
+        (*count)++;
+    }
+    return text;
+}
+
+static volatile double sink;
+
+static double run_integers(IntegerFN fn, const char* text, int count) {
+    volatile IntegerFN f = fn;
+    char* end = (char*)text;
+    long long sum = 0;
+    uint64_t start = time__monotonic();
+    for (int i = 0; i < count; i++)
+        sum += f(end, &end, 10);
+    uint64_t elapsed = time__monotonic() - start;
+    sink = (double)sum;
+    return (double)elapsed / count;
+}
+
+static double run_floats(FloatFN fn, const char* text, int count) {
+    volatile FloatFN f = fn;
+    char* end = (char*)text;
+    double sum = 0;
+    uint64_t start = time__monotonic();
+    for (int i = 0; i < count; i++)
+        sum += f(end, &end);
+    uint64_t elapsed = time__monotonic() - start;
+    sink = sum;
+    return (double)elapsed / count;
+}
+
+static void print(const char* name, size_t size, int count, double libc, double glibc, double previous) {
+    double mb = (double)size / count * 1000; // MB/s from ns per number
+    printf("  %-10s %7.1f %7.1f", name, libc, glibc);
+    if (previous > 0) printf(" %7.1f", previous); else printf(" %7s", "-");
+    printf("   %7.0f %7.0f\n", mb / libc, mb / glibc);
+}
+
+int main(int argc, char** argv) {
+    size_t size = (argc > 1 ? atoi(argv[1]) : 16) << 20;
+
+    printf("  ns/number     libc   glibc previous     libc   glibc MB/s\n");
+    int count;
+    char* text = generate(INTEGERS, size, &count);
+    print("integers", size, count, run_integers(libc_strtoll, text, count), run_integers(strtoll, text, count), run_integers(old_strtoll, text, count));
+    free(text);
+
+    const char* names[] = { "", "prices", "doubles" };
+    for (int kind = PRICES; kind <= DOUBLES; kind++) {
+        text = generate(kind, size, &count);
+        print(names[kind], size, count, run_floats(libc_strtod, text, count), run_floats(strtod, text, count), 0);
+        free(text);
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+    vsnprintf from src/libc against glibc and the previous libc implementation
+    (kept below, it only handles %s %c %d %i %u %x %X %p).
+
+    bench/printf [calls]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "libc/libc_rename.h"
+#include "libc/libc.c"
+#include "libc/libc_unrename.h"
+
+/* Internal helpers for snprintf/vsnprintf implementation */
+
+/* Append a single character to buffer if space remains. Always
+   increments *written (the would-be total). */
+static void old_putc(char *buf, size_t size, size_t *pos, char ch)
+{
+    if (*pos + 1 < size) {
+        buf[*pos] = ch;
+    }
+    (*pos)++;
+}
+
+/* Append a NUL-terminated string to buffer, return length added */
+static void old_puts(char *buf, size_t size, size_t *pos, const char *s)
+{
+    while (*s) {
+        old_putc(buf, size, pos, *s++);
+    }
+}
+
+/* Convert unsigned integer value to string in given base.
+   digits buffer must be large enough. Produces digits in reverse order. Returns length. */
+static int old_utoa_rev(unsigned long long value, unsigned int base, char *digits, int uppercase)
+{
+    const char *low = "0123456789abcdef";
+    const char *up  = "0123456789ABCDEF";
+    const char *map = uppercase ? up : low;
+    int len = 0;
+    if (value == 0) {
+        digits[len++] = '0';
+        return len;
+    }
+    while (value != 0) {
+        digits[len++] = map[value % base];
+        value /= base;
+    }
+    return len;
+}
+
+/* vsnprintf: minimal implementation using a va_list */
+static int old_vsnprintf(char *str, size_t size, const char *fmt, va_list ap)
+{
+    size_t pos = 0; /* number of characters that would have been written (excluding final NUL) */
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            old_putc(str, size, &pos, *fmt++);
+            continue;
+        }
+
+        /* handle format */
+        fmt++; /* skip '%' */
+        if (*fmt == '%') {
+            old_putc(str, size, &pos, '%');
+            fmt++;
+            continue;
+        }
+
+        /* No support for flags, width, precision, or length modifiers except pointer */
+        int uppercase = 0;
+        switch (*fmt) {
+            case 's': {
+                const char *s = va_arg(ap, const char *);
+                if (!s) s = "(null)";
+                old_puts(str, size, &pos, s);
+                fmt++;
+                break;
+            }
+            case 'c': {
+                int c = va_arg(ap, int);
+                old_putc(str, size, &pos, (char)c);
+                fmt++;
+                break;
+            }
+            case 'd':
+            case 'i': {
+                int v = va_arg(ap, int);
+                unsigned int uv;
+                if (v < 0) {
+                    old_putc(str, size, &pos, '-');
+                    uv = (unsigned int)(-(long long)v);
+                } else {
+                    uv = (unsigned int)v;
+                }
+                char rev[32];
+                int rl = old_utoa_rev((unsigned long long)uv, 10, rev, 0);
+                for (int i = rl - 1; i >= 0; --i) old_putc(str, size, &pos, rev[i]);
+                fmt++;
+                break;
+            }
+            case 'u': {
+                unsigned int uv = va_arg(ap, unsigned int);
+                char rev[32];
+                int rl = old_utoa_rev((unsigned long long)uv, 10, rev, 0);
+                for (int i = rl - 1; i >= 0; --i) old_putc(str, size, &pos, rev[i]);
+                fmt++;
+                break;
+            }
+            case 'x':
+            case 'X': {
+                if (*fmt == 'X') uppercase = 1;
+                unsigned int uv = va_arg(ap, unsigned int);
+                char rev[32];
+                int rl = old_utoa_rev((unsigned long long)uv, 16, rev, uppercase);
+                for (int i = rl - 1; i >= 0; --i) old_putc(str, size, &pos, rev[i]);
+                fmt++;
+                break;
+            }
+            case 'p': {
+                void *p = va_arg(ap, void *);
+                unsigned long long addr = (unsigned long long)(uintptr_t)p;
+                old_puts(str, size, &pos, "0x");
+                char rev[32];
+                int rl = old_utoa_rev(addr, 16, rev, 0);
+                for (int i = rl - 1; i >= 0; --i) old_putc(str, size, &pos, rev[i]);
+                fmt++;
+                break;
+            }
+            default:
+                /* Unknown specifier: treat literally (write '%' and the char) */
+                old_putc(str, size, &pos, '%');
+                if (*fmt) {
+                    old_putc(str, size, &pos, *fmt);
+                    fmt++;
+                }
+                break;
+        }
+    }
+
+    /* Null-terminate if possible */
+    if (size > 0) {
+        size_t nulpos = (pos < size) ? pos : (size - 1);
+        str[nulpos] = '\0';
+    }
+
+    /* Return number of characters that would have been written (not counting final NUL) */
+    if (pos > (size_t)INTPTR_MAX) /* avoid returning absurd huge values on overflow */
+        return (int)INTPTR_MAX;
+    return (int)pos;
+}
+
+typedef int (*FormatFN)(char* str, size_t size, const char* fmt, va_list ap);
+
+static volatile FormatFN current;
+static volatile uint64_t sink;
+
+static int call(char* buffer, size_t size, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = current(buffer, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+static int calls = 1000000;
+
+#define ROUNDS 10
+
+typedef enum { CASE_LOG, CASE_INTEGERS, CASE_STRINGS, CASE_FLOATS, CASE_PADDED } Case;
+
+static double run_once(Case c, int count) {
+    char buffer[256];
+    uint64_t start = time__monotonic();
+    for (int i = 0; i < count; i++) {
+        switch (c) {
+            case CASE_LOG:      sink += call(buffer, sizeof(buffer), "barf: section '%s' at 0x%x, %u relocations\n", ".text", i * 16, i & 1023); break;
+            case CASE_INTEGERS: sink += call(buffer, sizeof(buffer), "%d %d %d %d", i, -i, i * 7919, 1234567890 - i); break;
+            case CASE_STRINGS:  sink += call(buffer, sizeof(buffer), "%s/%s/%s.ba", "releases", "barf-0.0.1-dev-linux-x86_64", "artifact"); break;
+            case CASE_FLOATS:   sink += call(buffer, sizeof(buffer), "%f %g %.3e", i * 0.001, i * 1.5, i * 12345.678); break;
+            case CASE_PADDED:   sink += call(buffer, sizeof(buffer), "%-20s %08x %10lld|", "symbol", i, (long long)i * 1000003); break;
+        }
+    }
+    return (double)(time__monotonic() - start) / count;
+}
+
+// Best of several rounds, the machine may be noisy
+static double run(FormatFN fn, Case c) {
+    current = fn;
+    double best = 1e30;
+    for (int round = 0; round < ROUNDS; round++) {
+        double t = run_once(c, calls / ROUNDS);
+        if (t < best)
+            best = t;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1)
+        calls = atoi(argv[1]);
+
+    const char* names[] = { "log line", "integers", "strings", "floats", "padded" };
+    printf("  ns/call            %10s %10s %10s\n", "libc", "glibc", "previous");
+    for (int c = 0; c < sizeof(names)/sizeof(*names); c++) {
+        double ours = run(libc_vsnprintf, c);
+        double glibc = run(vsnprintf, c);
+        if (c == CASE_FLOATS || c == CASE_PADDED) // not supported by the previous version
+            printf("  %-16s   %10.1f %10.1f %10s\n", names[c], ours, glibc, "-");
+        else
+            printf("  %-16s   %10.1f %10.1f %10.1f\n", names[c], ours, glibc, run(old_vsnprintf, c));
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+    String routines from src/libc against glibc and the byte loops libc used before.
+
+    Strings are random lowercase text with the searched character and needle only at
+    the end, so every routine scans the whole string. Symbol names are mostly short,
+    the long strings show the throughput of the main loops.
+
+    bench/string
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libc/libc_rename.h"
+#include "libc/libc.c"
+#include "libc/libc_unrename.h"
+
+// The previous scalar versions
+static size_t byte_strlen(const char* a) {
+    size_t length = 0;
+    while (((volatile const char*)a)[length] != 0) length++;
+    return length;
+}
+
+static int byte_strcmp(const char* a, const char* b) {
+    const volatile unsigned char* ua = (const unsigned char*)a;
+    const volatile unsigned char* ub = (const unsigned char*)b;
+    while (*ua && (*ua == *ub)) {
+        ua++;
+        ub++;
+    }
+    return (int)(*ua - *ub);
+}
+
+static char* byte_strchr(const char* s, int c) {
+    const volatile char* p = s;
+    while (*p) {
+        if (*p == (char)c)
+            return (char*)p;
+        p++;
+    }
+    return c == 0 ? (char*)p : NULL;
+}
+
+static char* byte_strstr(const char* h, const char* n) {
+    size_t m = byte_strlen(n);
+    for (; *h; h++) {
+        size_t i = 0;
+        while (i < m && ((volatile const char*)h)[i] == n[i]) i++;
+        if (i == m)
+            return (char*)h;
+    }
+    return NULL;
+}
+
+typedef size_t (*LengthFN)(const char*);
+typedef int    (*CompareFN)(const char*, const char*);
+typedef char*  (*FindFN)(const char*, int);
+typedef char*  (*SearchFN)(const char*, const char*);
+
+#define TARGET_BYTES (128ull * 1024 * 1024)
+
+static volatile uint64_t sink;
+
+static uint64_t iterations_for(size_t length) {
+    uint64_t n = TARGET_BYTES / (length + 16);
+    return n > 2000000 ? 2000000 : n;
+}
+
+static double gbps(size_t length, uint64_t iterations, uint64_t start) {
+    return (double)length * iterations / (time__monotonic() - start);
+}
+
+static double run_length(LengthFN fn, const char* s, size_t length) {
+    volatile LengthFN f = fn;
+    uint64_t iterations = iterations_for(length), start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        sink += f(s);
+    return gbps(length, iterations, start);
+}
+
+static double run_compare(CompareFN fn, const char* a, const char* b, size_t length) {
+    volatile CompareFN f = fn;
+    uint64_t iterations = iterations_for(length), start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        sink += f(a, b);
+    return gbps(length, iterations, start);
+}
+
+static double run_find(FindFN fn, const char* s, int c, size_t length) {
+    volatile FindFN f = fn;
+    uint64_t iterations = iterations_for(length), start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        sink += (uintptr_t)f(s, c);
+    return gbps(length, iterations, start);
+}
+
+static double run_search(SearchFN fn, const char* h, const char* n, size_t length) {
+    volatile SearchFN f = fn;
+    uint64_t iterations = iterations_for(length), start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        sink += (uintptr_t)f(h, n);
+    return gbps(length, iterations, start);
+}
+
+typedef void* (*MemchrFN)(const void*, int, size_t);
+
+static double run_memchr(MemchrFN fn, const char* s, int c, size_t length) {
+    volatile MemchrFN f = fn;
+    uint64_t iterations = iterations_for(length), start = time__monotonic();
+    for (uint64_t i = 0; i < iterations; i++)
+        sink += (uintptr_t)f(s, c, length);
+    return gbps(length, iterations, start);
+}
+
+static int strcmp_wrapper(const char* a, const char* b) { return strcmp(a, b); }
+static size_t strlen_wrapper(const char* a) { return strlen(a); }
+
+// Random lowercase text without 'z'
+static void fill(char* s, size_t length) {
+    uint64_t state = 12345;
+    for (size_t i = 0; i < length; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        s[i] = 'a' + (state >> 33) % 25;
+    }
+    s[length] = 0;
+    s[length - 1] = 'z';
+}
+
+int main(int argc, char** argv) {
+    size_t lengths[] = { 8, 24, 64, 256, 4096, 65536 };
+    char* a = malloc(65536 + 64);
+    char* b = malloc(65536 + 64);
+
+    printf("  GB/s                   %10s %10s %10s\n", "libc", "glibc", "byte loop");
+    for (int i = 0; i < sizeof(lengths)/sizeof(*lengths); i++) {
+        size_t n = lengths[i];
+        // Unaligned starts, the interesting characters at the end
+        char* sa = a + 3;
+        char* sb = b + 5;
+        fill(sa, n);
+        fill(sb, n);
+        const char* needle = sa + n - 4;
+
+        printf("  strlen  %9zu      %10.2f %10.2f %10.2f\n", n,
+            run_length(libc_strlen, sa, n), run_length(strlen_wrapper, sa, n), run_length(byte_strlen, sa, n));
+        printf("  strcmp  %9zu      %10.2f %10.2f %10.2f\n", n,
+            run_compare(libc_strcmp, sa, sb, n), run_compare(strcmp_wrapper, sa, sb, n), run_compare(byte_strcmp, sa, sb, n));
+        printf("  strchr  %9zu      %10.2f %10.2f %10.2f\n", n,
+            run_find(libc_strchr, sa, 'z', n), run_find(strchr, sa, 'z', n), run_find(byte_strchr, sa, 'z', n));
+        printf("  strrchr %9zu      %10.2f %10.2f\n", n,
+            run_find(libc_strrchr, sa, 'y', n), run_find(strrchr, sa, 'y', n));
+        printf("  memchr  %9zu      %10.2f %10.2f\n", n,
+            run_memchr(libc_memchr, sa, 'z', n), run_memchr(memchr, sa, 'z', n));
+        printf("  strstr  %9zu      %10.2f %10.2f %10.2f\n", n,
+            run_search(libc_strstr, sa, needle, n), run_search(strstr, sa, needle, n), run_search(byte_strstr, sa, needle, n));
+    }
+    free(a);
+    free(b);
+    return 0;
+}
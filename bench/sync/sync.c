@@ -0,0 +1,114 @@
+/*
+    Contention benchmark for the synchronization primitives in the platform layer.
+
+    Threads hammer a shared counter behind a lock and we compare
+    SyncMutex against pthread_mutex_t. A semaphore ping-pong measures
+    the wake up latency when threads actually have to sleep.
+
+    bench/sync [iterations]
+*/
+
+#include "platform/platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef OS_LINUX
+
+#include <pthread.h>
+#include <time.h>
+
+#define MAX_THREADS 16
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int iterations = 1000000;
+static volatile uint64_t counter;
+
+static SyncMutex       sync_mutex;
+static pthread_mutex_t pthread_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void* sync_mutex_worker(void* arg) {
+    for (int i = 0; i < iterations; i++) {
+        sync__mutex_lock(&sync_mutex);
+        counter++;
+        sync__mutex_unlock(&sync_mutex);
+    }
+    return NULL;
+}
+static void* pthread_mutex_worker(void* arg) {
+    for (int i = 0; i < iterations; i++) {
+        pthread_mutex_lock(&pthread_mutex);
+        counter++;
+        pthread_mutex_unlock(&pthread_mutex);
+    }
+    return NULL;
+}
+
+static SyncSemaphore ping;
+static SyncSemaphore pong;
+
+static void* pong_worker(void* arg) {
+    int rounds = *(int*)arg;
+    for (int i = 0; i < rounds; i++) {
+        sync__sem_wait(&ping);
+        sync__sem_post(&pong);
+    }
+    return NULL;
+}
+
+static void run_threads(const char* name, void* (*worker)(void*), int thread_count) {
+    pthread_t threads[MAX_THREADS];
+    counter = 0;
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < thread_count; i++)
+        pthread_create(&threads[i], NULL, worker, NULL);
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(threads[i], NULL);
+    uint64_t elapsed = now_ns() - start;
+
+    uint64_t total_ops = (uint64_t)iterations * thread_count;
+    if (counter != total_ops) {
+        printf("  %-16s threads=%-2d FAILED counter %llu != %llu\n", name, thread_count, (unsigned long long)counter, (unsigned long long)total_ops);
+        exit(1);
+    }
+    printf("  %-16s threads=%-2d %8.2f ns/op\n", name, thread_count, (double)elapsed / total_ops);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+
+    int thread_counts[] = { 1, 2, 4, 8 };
+    for (int i = 0; i < sizeof(thread_counts)/sizeof(*thread_counts); i++) {
+        run_threads("SyncMutex", sync_mutex_worker, thread_counts[i]);
+        run_threads("pthread_mutex", pthread_mutex_worker, thread_counts[i]);
+    }
+
+    int rounds = iterations / 10;
+    pthread_t thread;
+    uint64_t start = now_ns();
+    pthread_create(&thread, NULL, pong_worker, &rounds);
+    for (int i = 0; i < rounds; i++) {
+        sync__sem_post(&ping);
+        sync__sem_wait(&pong);
+    }
+    pthread_join(thread, NULL);
+    uint64_t elapsed = now_ns() - start;
+    printf("  %-16s           %8.2f ns/round trip\n", "SyncSemaphore", (double)elapsed / rounds);
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+    printf("  sync benchmark is only implemented for Linux\n");
+    return 0;
+}
+
+#endif
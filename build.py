@@ -58,15 +58,17 @@ def compile_native_barf(output_path):
 
     OBJECTS = [ INT + "/" + os.path.basename(f).replace('.c', '.o') for f in BARF_FILES ]
 
+    LIBS = ""
     if platform.system() == "Windows":
         COMMON_FLAGS += " -DOS_WINDOWS"
+        LIBS += " -lsynchronization"
     if platform.system() == "Linux":
         COMMON_FLAGS += " -DOS_LINUX"
 
     for obj, src in zip(OBJECTS, BARF_FILES):
         cmd(f"gcc -c {COMMON_FLAGS} {WARN_FLAGS} {src} -o {obj}")
 
-    cmd(f"gcc {COMMON_FLAGS} {WARN_FLAGS} -o {EXE} {ROOT}/src/platform/platform.c {' '.join(OBJECTS)}")
+    cmd(f"gcc {COMMON_FLAGS} {WARN_FLAGS} -o {EXE} {ROOT}/src/platform/platform.c {' '.join(OBJECTS)}{LIBS}")
     
     
 def compile_artifact(output_file, files, flags):
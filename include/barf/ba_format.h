@@ -8,6 +8,9 @@
 
 
 #define BARF_MAGIC 0x46524142u // "BARF"
+// Readers reject other versions.
+//   2: BarfRelocation has an addend (24 bytes instead of 12)
+#define BARF_FORMAT_VERSION 2
 
 
 
@@ -43,6 +46,10 @@ typedef enum BarfSectionFlag {
     BARF_FLAG_EXEC   = 0x4,
     BARF_FLAG_ZEROED = 0x8,
     BARF_FLAG_IGNORE = 0x10,
+    BARF_FLAG_GROUP  = 0x20, // member of the COMDAT group named by 'group', one copy per name is kept
+    BARF_FLAG_GROUP_UNIQUE = 0x40, // a second group with the name is an error (COFF NODUPLICATES)
+    BARF_FLAG_MERGE   = 0x80,  // constants of 'entry_size' bytes, equal ones may be shared
+    BARF_FLAG_STRINGS = 0x100, // with BARF_FLAG_MERGE, null terminated strings of 'entry_size' characters
 } BarfSectionFlag;
 typedef u16 BarfSectionFlags;
 
@@ -53,8 +60,9 @@ typedef struct BarfSection {
     // @TODO We probably want to specify alignment. defaulting to 16 bytes is fine but
     //   what if you use SIMD on variables in .data section and you assume it's 64-byte aligned when it's just 16 byte aligned.
     u16    alignment;            // needed when using SIMD instructions (some need 32-byte alignment)
-    u32    _reserved;
+    u32    group;                // offset of the group name in the string table with BARF_FLAG_GROUP
     u32    relocation_count;     // offset from start of format
+    u32    entry_size;           // with BARF_FLAG_MERGE
     u64    data_size;
     u64    relocation_offset;
     u64    data_offset;          // offset from start of format
@@ -76,8 +84,16 @@ typedef struct BarfSymbol {
 } BarfSymbol;
 
 
+// S is the address of the symbol, A the addend, P the address of the field
+// and G the address of a GOT slot holding S. The result is added to the field.
 typedef enum {
-    BARF_RELOC_REL32,
+    BARF_RELOC_REL32,          // S + A - P, 32-bit
+    BARF_RELOC_ABS64,          // S + A, 64-bit
+    BARF_RELOC_ABS32,          // S + A, 32-bit zero-extended
+    BARF_RELOC_ABS32S,         // S + A, 32-bit sign-extended
+    BARF_RELOC_GOTPCREL,       // G + A - P, 32-bit
+    BARF_RELOC_GOTPCRELX,      // G + A - P, call/jmp/mov may be relaxed to S + A - P
+    BARF_RELOC_REX_GOTPCRELX,  // G + A - P, mov with REX prefix may be relaxed to lea
 } _BarfRelocationType;
 typedef u8 BarfRelocationType;
 
@@ -86,4 +102,6 @@ typedef struct {
     u8                 _reserved[3];
     u32                symbol_index;
     u32                offset; // offset into section where to perform relocation to the symbol
+    u32                _reserved2;
+    i64                addend;
 } BarfRelocation;
@@ -20,6 +20,7 @@ typedef struct {
 #define JUMP_ENTRY_STRIDE 12
 
 typedef struct BarfObject BarfObject;
+typedef struct Arena Arena;
 typedef struct {
     BarfObject* objects;
     u32         object_count;
@@ -28,6 +29,16 @@ typedef struct {
     // @TODO Lookup table
     char** external_names;
     int external_names_len;
+
+    // GOT slots for loads that couldn't be relaxed
+    void** got;
+    u32    got_size; // slots
+
+    // Segments, GOT and jump entries come from one reservation so 32-bit
+    // relative references between them always reach.
+    u8* image;
+    u64 image_size; // reserved
+    u64 image_used; // committed
 } BarfLoader;
 
 
@@ -37,10 +48,14 @@ typedef struct BarfObject {
     BarfSymbol*      symbols;
     BarfRelocation** relocations;
     char*            strings;
-    char**           section_data;
+    char**           section_data; // in memory section data, NULL for zeroed sections
+    void*            mapping;      // of the input while converting and combining
+    u64              mapping_size;
 
     // used at runtime
     BarfSegment* segments;
+
+    Arena*       arena; // owns the memory above, NULL when the caller's arena does
 } BarfObject;
 
 
@@ -52,14 +67,38 @@ typedef struct BarfObject {
 BarfObject* barf_parse_header_from_file(const char* path);
 void barf_dump(BarfObject* object);
 
+// Frees an object from barf_parse_header_from_file
 void barf_free_object(BarfObject* object);
+// Releases the mapping of the input behind section_data
+void barf_unmap_object(BarfObject* object);
 
 // Returns false if it wasn't coff
 bool barf_convert_from_coff(const char* path, const char* output);
 // Returns false if it wasn't elf
 bool barf_convert_from_elf(const char* path, const char* output);
 
-bool barf_combine_to_artifact(int input_count, const char** input_files, const char* output);
+typedef struct {
+    // Threads converting and parsing the inputs, 0 means one per logical core.
+    // The output is the same for any count.
+    int thread_count;
+    // Also write each converted ELF/COFF input as '<input>~.ba' next to it.
+    // Combining never reads them, inputs are converted in memory.
+    bool write_converted;
+    // Coalesce sections with equal name and flags into one output section,
+    // the loader then maps one segment per kind instead of one per input.
+    bool merge_sections;
+    // Drop sections that ba_entry, 'keep_symbols' and .refptr sections can't
+    // reach through relocations, along with their symbols.
+    bool gc_sections;
+    int          keep_count;
+    const char** keep_symbols;
+    // Fold read-only code sections with equal bytes and equivalent relocation
+    // targets into one (identical code folding). Folded functions share an address.
+    bool fold_identical;
+} BarfCombineOptions;
+
+// 'options' may be NULL for defaults
+bool barf_combine_to_artifact(int input_count, const char** input_files, const char* output, const BarfCombineOptions* options);
 
 
 bool barf_load_file(const char* path, int argc, const char** argv);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+/* Error bounds of each function are listed at the top of src/libc/libm.c */
+
+/* exp, expf: e raised to x */
+double exp(double x);
+float expf(float x);
+
+/* log, logf: natural logarithm, -inf at 0 and nan below */
+double log(double x);
+float logf(float x);
+
+/* pow, powf: x raised to y, special cases as in C99 Annex F */
+double pow(double x, double y);
+float powf(float x, float y);
+
+/* sin, cos, sinf, cosf: accurate for any finite x, large arguments are reduced exactly */
+double sin(double x);
+float sinf(float x);
+double cos(double x);
+float cosf(float x);
+
+/* tanh, tanhf: hyperbolic tangent */
+double tanh(double x);
+float tanhf(float x);
+
+/* sqrt, sqrtf: correctly rounded square root */
+double sqrt(double x);
+float sqrtf(float x);
+
+/* Array versions: y[i] = f(x[i]) for i < n, four elements per iteration.
+   Results are bitwise equal to the scalar functions. y may equal x. */
+void exp_array(double *y, const double *x, size_t n);
+void expf_array(float *y, const float *x, size_t n);
+void log_array(double *y, const double *x, size_t n);
+void logf_array(float *y, const float *x, size_t n);
+void sin_array(double *y, const double *x, size_t n);
+void sinf_array(float *y, const float *x, size_t n);
+void cos_array(double *y, const double *x, size_t n);
+void cosf_array(float *y, const float *x, size_t n);
+void tanh_array(double *y, const double *x, size_t n);
+void tanhf_array(float *y, const float *x, size_t n);
+void sqrt_array(double *y, const double *x, size_t n);
+void sqrtf_array(float *y, const float *x, size_t n);
+
+/* pow_array, powf_array: z[i] = pow(x[i], y[i]) */
+void pow_array(double *z, const double *x, const double *y, size_t n);
+void powf_array(float *z, const float *x, const float *y, size_t n);
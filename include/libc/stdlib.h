@@ -3,3 +3,14 @@ static inline long labs(long a) {
     return a < 0 ? -a : a;
 }
 
+/* strtol, strtoll: parse a signed integer in base (0 detects 0x and 0), saturate on overflow */
+long strtol(const char *nptr, char **endptr, int base);
+long long strtoll(const char *nptr, char **endptr, int base);
+
+/* strtoul, strtoull: parse an unsigned integer, a leading - negates the result */
+unsigned long strtoul(const char *nptr, char **endptr, int base);
+unsigned long long strtoull(const char *nptr, char **endptr, int base);
+
+/* strtod, strtof: parse a decimal or hexadecimal float, inf or nan, correctly rounded */
+double strtod(const char *nptr, char **endptr);
+float strtof(const char *nptr, char **endptr);
@@ -4,8 +4,13 @@
 #include <stddef.h>
 
 
+/* strlen: return length of string */
 size_t strlen(const char *a);
 
+/* strnlen: length of s, at most n */
+size_t strnlen(const char *s, size_t n);
+
+/* strcpy: copy src including the terminator to dst */
 char* strcpy(char *dst, const char *src);
 
 /* strcmp: compare two NUL-terminated strings */
@@ -18,10 +23,23 @@ int strncmp(const char *a, const char *b, size_t n);
    is undefined (like the standard memcpy). */
 void *memcpy(void *dst, const void *src, size_t n);
 
+/* memmove: like memcpy but the regions may overlap */
+void *memmove(void *dst, const void *src, size_t n);
+
 /* memset: set n bytes of s to byte value c */
 void *memset(void *s, int c, size_t n);
 
+/* memcmp: compare n bytes as unsigned chars */
+int memcmp(const void *a, const void *b, size_t n);
+
 /* strchr: locate first occurrence of character c in string s */
 char *strchr(const char *s, int c);
 
-unsigned long strtoul(const char *nptr, char **endptr, int base);
+/* strrchr: locate last occurrence of character c in string s */
+char *strrchr(const char *s, int c);
+
+/* memchr: locate first byte c in the n bytes at s */
+void *memchr(const void *s, int c, size_t n);
+
+/* strstr: locate the first occurrence of needle in haystack */
+char *strstr(const char *haystack, const char *needle);
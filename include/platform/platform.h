@@ -41,8 +41,9 @@ void ed__destroy(EDHandle handle);
 
 typedef uint32_t FSHandle;
 
-#define FS_READ  0x1
-#define FS_WRITE 0x2
+#define FS_READ   0x1
+#define FS_WRITE  0x2  // creates or truncates the file, FS_READ|FS_WRITE opens for read and write without truncating
+#define FS_DIRECT 0x4  // bypass the page cache (O_DIRECT), buffer, offset and size must be aligned to the block size (4096 is safe)
 #define FS_INVALID_HANDLE 0xFFFFFFFF
 typedef struct {
     uint64_t file_size;
@@ -57,6 +58,72 @@ void fs__info(FSHandle handle, FSInfo* info);
 uint64_t fs__read(FSHandle handle, uint64_t offset, void* buffer, uint64_t size);
 uint64_t fs__write(FSHandle handle, uint64_t offset, void* buffer, uint64_t size);
 
+// Memory mapped files
+//   Maps part of a file into memory, the pages come straight from the page cache (no copies).
+//   'offset' does not need to be page aligned. 'size' must not be 0, get it from fs__info.
+//   The file handle can be closed while the mapping is alive.
+
+#define FS_MAP_READ       0x1  // read-only
+#define FS_MAP_PRIVATE    0x2  // read and write, writes are copy-on-write and never reach the file
+#define FS_MAP_SHARED     0x4  // read and write, writes go to the file (open with FS_READ|FS_WRITE)
+// Access pattern hints, can be combined with the modes above or passed to fs__advise
+#define FS_MAP_SEQUENTIAL 0x10 // aggressive read-ahead, pages behind you may be dropped early
+#define FS_MAP_RANDOM     0x20 // no read-ahead
+#define FS_MAP_WILLNEED   0x40 // start reading the range in now
+
+// Returns NULL on failure or if 'size' is 0.
+void* fs__map(FSHandle handle, uint64_t offset, uint64_t size, int flags);
+// Pass the address and size that fs__map returned/was given.
+void  fs__unmap(void* address, uint64_t size);
+void  fs__advise(void* address, uint64_t size, int hints);
+
+// Asynchronous batched IO
+//   Submit many reads and writes at once and collect completions later.
+//   Uses io_uring on Linux and a pool of worker threads where io_uring isn't available.
+//
+//   FSQueue* queue = fs__queue_create(64);
+//   fs__submit(queue, requests, request_count);
+//   ... do other work
+//   fs__complete(queue, completions, 64, request_count); // wait for all
+//
+//   A queue is not thread-safe, use one queue per thread.
+
+typedef struct FSQueue FSQueue;
+
+#define FS_OP_READ   1
+#define FS_OP_WRITE  2
+#define FS_OP_READV  3 // vectored, 'buffer' points to FSBuffer array and 'size' is the number of buffers
+#define FS_OP_WRITEV 4
+
+typedef struct {
+    void*    data;
+    uint64_t size;
+} FSBuffer; // same layout as struct iovec
+
+typedef struct {
+    uint32_t  op;        // FS_OP_*
+    FSHandle  handle;
+    uint64_t  offset;
+    void*     buffer;
+    uint64_t  size;      // at most 0x7ffff000 bytes are transferred, larger requests complete short
+    uint64_t  user_data; // returned in the completion
+} FSRequest;
+
+typedef struct {
+    uint64_t user_data;
+    int64_t  result;     // bytes transferred, negative on error
+} FSCompletion;
+
+// 'depth' is the max number of requests in flight. Returns NULL on failure.
+FSQueue* fs__queue_create(uint32_t depth);
+// Waits for requests in flight before destroying the queue.
+void     fs__queue_destroy(FSQueue* queue);
+// Returns the number of requests that were submitted, fewer than 'count' if the queue is full.
+uint32_t fs__submit(FSQueue* queue, const FSRequest* requests, uint32_t count);
+// Blocks until at least 'min_count' completions are available (0 polls).
+// Returns the number of completions written, at most 'max_count'.
+uint32_t fs__complete(FSQueue* queue, FSCompletion* completions, uint32_t max_count, uint32_t min_count);
+
 // @TODO Iterate directory, recursively
 
 // ##########################
@@ -67,6 +134,14 @@ uint64_t fs__write(FSHandle handle, uint64_t offset, void* buffer, uint64_t size
 // reallocate:  ptr = mem_alloc(4096, ptr)
 // free:        mem_alloc(0, ptr)
 void* mem__alloc(uint64_t size, void* old_ptr);
+
+#define MEM_ALLOCATOR_MALLOC  1 // malloc/realloc/free from the C runtime (default)
+#define MEM_ALLOCATOR_BUILTIN 2 // size classes with per-thread caches, see platform.c
+
+// Selects the allocator behind mem__alloc. Must be called before the first allocation,
+// returns false if another allocator is already in use. Without a call the environment
+// variable BARF_ALLOCATOR=builtin selects the builtin allocator.
+bool mem__set_allocator(uint32_t allocator);
 // #define mem__malloc(SIZE) mem__alloc(SIZE, NULL)
 // #define mem__realloc(SIZE, PTR) mem__alloc(SIZE, PTR)
 // #define mem__free(PTR) mem__alloc(0, PTR)
@@ -75,10 +150,140 @@ void* mem__alloc(uint64_t size, void* old_ptr);
 #define MEM_WRITE 0x2
 #define MEM_EXEC  0x4
 
+// 'address' is a hint and may be NULL, the memory is committed and zeroed.
 void* mem__map(void* address, uint64_t size, int flags);
 void  mem__mapflag(void* address, uint64_t size, int flags);
+// Releases a whole mapping or reservation (Windows can't release part of one).
 void  mem__unmap(void* address, uint64_t size);
 
+// Reserved memory
+//   Reserve a large range of address space up front and commit pages as you need them,
+//   a growable buffer can then grow in place without copying and stable pointers into it.
+//
+//   char* base = mem__reserve(NULL, 64ull << 30); // 64 GB of address space, no memory used
+//   mem__commit(base, 1 << 20, MEM_READ|MEM_WRITE);
+//   ... grow
+//   mem__commit(base + (1 << 20), 1 << 20, MEM_READ|MEM_WRITE);
+//   mem__decommit(base, 2 << 20);
+//   mem__unmap(base, 64ull << 30);
+//
+//   Ranges passed to commit/decommit are widened to whole pages.
+
+uint64_t mem__page_size();
+// Returns NULL on failure. Touching reserved memory before committing it crashes.
+void* mem__reserve(void* address, uint64_t size);
+// Committed pages read as zero. Returns false when out of memory.
+bool  mem__commit(void* address, uint64_t size, int flags);
+// Gives the physical pages back, the range stays reserved and can be committed again.
+void  mem__decommit(void* address, uint64_t size);
+
+
+// ##########################
+//      Synchronization
+// ##########################
+
+// The primitives are plain 32-bit words so they can live anywhere (globals, heap, shared memory).
+// Zero-initialize them before use. A zeroed mutex is unlocked, a zeroed semaphore has a count
+// of zero and a zeroed event is not set. Set 'count' directly for a semaphore with initial value.
+//
+// The uncontended paths are a single atomic instruction, the kernel is only entered
+// when a thread has to sleep or wake someone (futex on Linux, WaitOnAddress on Windows).
+
+typedef struct {
+    uint32_t state; // 0 = unlocked, 1 = locked, 2 = locked with waiters
+} SyncMutex;
+
+typedef struct {
+    uint32_t sequence;
+} SyncCondition;
+
+typedef struct {
+    uint32_t count;
+    uint32_t waiters;
+} SyncSemaphore;
+
+typedef struct {
+    uint32_t state; // 0 = not set, 1 = set
+} SyncEvent;
+
+void sync__mutex_lock(SyncMutex* mutex);
+bool sync__mutex_trylock(SyncMutex* mutex);
+void sync__mutex_unlock(SyncMutex* mutex);
+
+// Mutex must be locked. Wakeups may be spurious, always check your condition in a loop.
+void sync__cond_wait(SyncCondition* cond, SyncMutex* mutex);
+void sync__cond_signal(SyncCondition* cond);
+void sync__cond_broadcast(SyncCondition* cond);
+
+void sync__sem_wait(SyncSemaphore* sem);
+void sync__sem_post(SyncSemaphore* sem);
+
+// One-shot event, once set it stays set and all current and future waiters pass through.
+void sync__event_wait(SyncEvent* event);
+void sync__event_set(SyncEvent* event);
+bool sync__event_is_set(SyncEvent* event);
+
+
+// ##########################
+//      Threads
+// ##########################
+
+typedef struct Thread Thread;
+typedef void (*ThreadFN)(void* arg);
+
+// Runs func(arg) on a new thread, NULL if the thread couldn't be started.
+Thread* thread__create(ThreadFN func, void* arg);
+// Waits for the thread to return and frees it.
+void thread__join(Thread* thread);
+
+
+// ##########################
+//      Time
+// ##########################
+
+// Nanoseconds from an arbitrary point, never goes backwards. Use it to measure durations.
+// Read through the vDSO on Linux and QueryPerformanceCounter on Windows, no system call.
+uint64_t time__monotonic();
+// Nanoseconds since 1970-01-01 UTC. May jump if the system clock is adjusted.
+uint64_t time__wall();
+
+// Raw time stamp counter (rdtsc). Cheapest clock there is, use it for very short measurements.
+// Convert to seconds with time__cycle_frequency(). Only meaningful when CPU_FEATURE_INVARIANT_TSC is set.
+uint64_t time__cycles();
+// Cycles per second of time__cycles(), calibrated against the monotonic clock on first call.
+uint64_t time__cycle_frequency();
+
+
+// ##########################
+//      CPU
+// ##########################
+
+#define CPU_FEATURE_SSE2          0x1
+#define CPU_FEATURE_SSE42         0x2
+#define CPU_FEATURE_POPCNT        0x4
+#define CPU_FEATURE_AVX           0x8
+#define CPU_FEATURE_AVX2          0x10
+#define CPU_FEATURE_FMA           0x20
+#define CPU_FEATURE_BMI2          0x40
+#define CPU_FEATURE_AVX512F       0x80
+#define CPU_FEATURE_AVX512BW      0x100
+#define CPU_FEATURE_AVX512VL      0x200
+#define CPU_FEATURE_INVARIANT_TSC 0x400
+
+typedef struct {
+    char     vendor[16];       // null-terminated, "GenuineIntel", "AuthenticAMD"...
+    char     brand[64];        // null-terminated
+    uint32_t logical_cores;    // hardware threads available to us
+    uint32_t physical_cores;
+    uint32_t cache_line_size;  // bytes
+    uint32_t l1d_cache_size;   // bytes, per core
+    uint32_t l2_cache_size;    // bytes, per core
+    uint32_t l3_cache_size;    // bytes, shared
+    uint64_t features;         // CPU_FEATURE_*, only set if the OS also saves the registers (AVX, AVX-512)
+} CPUInfo;
+
+void cpu__info(CPUInfo* info);
+
 
 
 
@@ -86,5 +291,37 @@ void  mem__unmap(void* address, uint64_t size);
 //      Debug/logging
 // ##########################
 
+// Messages are formatted into a ring buffer of the calling thread and written to stderr
+// by a background thread, so logging doesn't cost a system call. Messages from one
+// thread stay in order. Everything is flushed at exit, and when the process crashes
+// if log__install_crash_handlers was called.
+
+#define LOG_ERROR   1
+#define LOG_WARNING 2
+#define LOG_INFO    3
+#define LOG_DEBUG   4
+
+// Messages above LOG_MAX_LEVEL are compiled out of the log__ macros below.
+#ifndef LOG_MAX_LEVEL
+    #define LOG_MAX_LEVEL LOG_DEBUG
+#endif
+
+// Logged at LOG_INFO
 void log__printf(const char* format, ...);
+void log__message(int level, const char* format, ...);
+
+#define log__error(...)   do { if (LOG_ERROR   <= LOG_MAX_LEVEL) log__message(LOG_ERROR,   __VA_ARGS__); } while (0)
+#define log__warning(...) do { if (LOG_WARNING <= LOG_MAX_LEVEL) log__message(LOG_WARNING, __VA_ARGS__); } while (0)
+#define log__info(...)    do { if (LOG_INFO    <= LOG_MAX_LEVEL) log__message(LOG_INFO,    __VA_ARGS__); } while (0)
+#define log__debug(...)   do { if (LOG_DEBUG   <= LOG_MAX_LEVEL) log__message(LOG_DEBUG,   __VA_ARGS__); } while (0)
+
+// Messages above 'level' are dropped at runtime. Defaults to LOG_INFO, or the
+// environment variable BARF_LOG_LEVEL (error, warning, info, debug).
+void log__set_level(int level);
+// Blocks until everything logged so far (by any thread) is written.
+void log__flush();
+// Flushes the log when the process crashes (SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT or
+// an unhandled exception on Windows). Only replaces default handlers. Not done by
+// log__printf, programs opt in.
+void log__install_crash_handlers();
 
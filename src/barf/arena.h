@@ -0,0 +1,112 @@
+#pragma once
+
+#include "barf/types.h"
+
+/*
+    Bump allocator for metadata that lives as long as one operation
+    (parsing an object, converting an object file, combining artifacts).
+
+    Address space is reserved in blocks and committed in steps as a block fills up.
+    When a block is full the arena reserves another one (at least as large as the
+    allocation), so pointers into the arena stay valid and the address space an
+    arena takes follows what it holds. Memory from the arena is zeroed. There is
+    no free, everything goes away at once with arena_destroy.
+
+    Arena* arena = arena_create();
+    BarfSymbol* symbols = arena_alloc(arena, sizeof(BarfSymbol) * count);
+    ...
+    arena_destroy(arena);
+*/
+
+#define ARENA_BLOCK_RESERVE (64ull << 20) // address space of a block, larger allocations get a block of their own
+#define ARENA_COMMIT_STEP   (1024 * 1024)
+#define ARENA_ALIGNMENT     16
+
+// Start of every block
+typedef struct ArenaBlock {
+    struct ArenaBlock* prev;
+    u64                reserved;
+} ArenaBlock;
+
+// Lives in the first block, after its ArenaBlock
+typedef struct Arena {
+    char* base; // current block
+    u64   used;
+    u64   committed;
+    u64   reserved;
+} Arena;
+
+#define ARENA_ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~(u64)(ARENA_ALIGNMENT - 1))
+
+static inline bool arena_commit(Arena* arena, u64 size) {
+    u64 new_committed = (size + ARENA_COMMIT_STEP - 1) & ~(u64)(ARENA_COMMIT_STEP - 1);
+    if (!mem__commit(arena->base + arena->committed, new_committed - arena->committed, MEM_READ|MEM_WRITE))
+        return false;
+    arena->committed = new_committed;
+    return true;
+}
+
+// Makes a block with room for 'size' bytes the current one
+static inline bool arena_new_block(Arena* arena, u64 size) {
+    u64 reserve = ARENA_ALIGN(sizeof(ArenaBlock)) + size;
+    reserve = (reserve + ARENA_COMMIT_STEP - 1) & ~(u64)(ARENA_COMMIT_STEP - 1);
+    if (reserve < ARENA_BLOCK_RESERVE)
+        reserve = ARENA_BLOCK_RESERVE;
+    char* base = mem__reserve(NULL, reserve);
+    if (!base) {
+        log__printf("barf: arena could not reserve %llu bytes\n", (unsigned long long)reserve);
+        return false;
+    }
+    Arena block = { base, ARENA_ALIGN(sizeof(ArenaBlock)), 0, reserve };
+    if (!arena_commit(&block, block.used)) {
+        mem__unmap(base, reserve);
+        return false;
+    }
+    ((ArenaBlock*)base)->prev     = (ArenaBlock*)arena->base;
+    ((ArenaBlock*)base)->reserved = reserve;
+    *arena = block;
+    return true;
+}
+
+// Returns NULL on failure.
+static inline Arena* arena_create() {
+    Arena local = { 0 };
+    if (!arena_new_block(&local, sizeof(Arena)))
+        return NULL;
+    Arena* arena = (Arena*)(local.base + local.used);
+    local.used += ARENA_ALIGN(sizeof(Arena));
+    *arena = local;
+    return arena;
+}
+
+static inline void arena_destroy(Arena* arena) {
+    if (!arena)
+        return;
+    // The first block holds the arena and goes last
+    ArenaBlock* block = (ArenaBlock*)arena->base;
+    while (block) {
+        ArenaBlock* prev = block->prev;
+        mem__unmap(block, block->reserved);
+        block = prev;
+    }
+}
+
+// Zeroed and 16-byte aligned. Returns NULL when out of memory.
+static inline void* arena_alloc(Arena* arena, u64 size) {
+    size = ARENA_ALIGN(size);
+    if (arena->used + size > arena->reserved && !arena_new_block(arena, size))
+        return NULL;
+    u64 offset = arena->used;
+    u64 end    = offset + size;
+    if (end > arena->committed && !arena_commit(arena, end))
+        return NULL;
+    arena->used = end;
+    return arena->base + offset;
+}
+
+static inline char* arena_strdup(Arena* arena, const char* str, int len) {
+    char* copy = arena_alloc(arena, len + 1);
+    if (copy)
+        memcpy(copy, str, len); // already null-terminated
+    return copy;
+}
@@ -38,14 +38,88 @@ void* barf_find_name(BarfLoader* loader, const char* name) {
     return NULL;
 }
 
+// Rewrites a GOT load at 'field' into a direct reference, returns the address of
+// the new rel32 field or NULL if the instruction can't be relaxed.
+static u8* barf_relax_got_load(BarfRelocationType type, u8* field) {
+    u8* modrm  = field - 1;
+    u8* opcode = field - 2;
+    if (type == BARF_RELOC_GOTPCRELX && *opcode == 0xff && *modrm == 0x15) {
+        // call *foo@GOTPCREL(%rip) -> addr32 call foo
+        *opcode = 0x67;
+        *modrm  = 0xe8;
+        return field;
+    }
+    if (type == BARF_RELOC_GOTPCRELX && *opcode == 0xff && *modrm == 0x25) {
+        // jmp *foo@GOTPCREL(%rip) -> jmp foo; nop
+        // The rel32 moves one byte back, the jmp ends one byte earlier too.
+        u32 displacement = *(u32*)field;
+        *opcode = 0xe9;
+        *(u32*)modrm = displacement;
+        field[3] = 0x90;
+        return modrm;
+    }
+    if (*opcode == 0x8b && (*modrm & 0xc7) == 0x05) {
+        // mov foo@GOTPCREL(%rip), %reg -> lea foo(%rip), %reg
+        *opcode = 0x8d;
+        return field;
+    }
+    return NULL;
+}
+
+static bool barf_fits_rel32(u8* target, u8* field) {
+    i64 distance = (i64)(target - field);
+    return distance >= INT32_MIN + 0x1000 && distance <= INT32_MAX - 0x1000;
+}
+
+// Page-aligned and zeroed memory from the image reservation, NULL when it's full
+static void* barf_image_alloc(BarfLoader* loader, u64 size) {
+    u64 page = mem__page_size();
+    size = size ? (size + page - 1) & ~(page - 1) : page;
+    if (loader->image_used + size > loader->image_size) {
+        log__printf("barf: image reservation is full\n");
+        return NULL;
+    }
+    u8* address = loader->image + loader->image_used;
+    if (!mem__commit(address, size, MEM_READ|MEM_WRITE))
+        return NULL;
+    loader->image_used += size;
+    return address;
+}
+
 // returns false if there were external symbols
 bool barf_apply_relocations(BarfLoader* loader) {
 
     BarfObject* object = &loader->objects[0];
+
+    // One GOT slot per symbol at most, allocated when there are GOT relocations
+    u32* got_slots = NULL;
+    u32 got_relocation_count = 0;
+    for (int si=0;si<object->header.section_count;si++) {
+        for (int ri=0;ri<object->sections[si].relocation_count;ri++) {
+            BarfRelocationType type = object->relocations[si][ri].type;
+            if (type == BARF_RELOC_GOTPCREL || type == BARF_RELOC_GOTPCRELX || type == BARF_RELOC_REX_GOTPCRELX)
+                got_relocation_count++;
+        }
+    }
+    u32 got_used = 0;
+    if (got_relocation_count) {
+        loader->got_size = got_relocation_count;
+        loader->got = barf_image_alloc(loader, got_relocation_count * sizeof(void*));
+        if (!loader->got)
+            return false;
+        got_slots = mem__alloc(object->header.symbol_count * sizeof(u32), NULL);
+        if (!got_slots) {
+            log__printf("barf: malloc failed\n");
+            return false;
+        }
+        memset(got_slots, 0xFF, object->header.symbol_count * sizeof(u32));
+    }
+
+    bool result = true;
     for (int si=0;si<object->header.section_count;si++) {
         BarfSection* section = &object->sections[si];
         BarfSegment* segment = &object->segments[si];
-        if (section->flags == BARF_FLAG_IGNORE) {
+        if (section->flags & BARF_FLAG_IGNORE) {
             continue;
         }
 
@@ -54,34 +128,74 @@ bool barf_apply_relocations(BarfLoader* loader) {
             BarfSymbol* symbol = &object->symbols[relocation->symbol_index];
             const char* name = object->strings + symbol->string_offset;
 
-            if (relocation->type == BARF_RELOC_REL32) {
-                void* target_address;
-                if (symbol->section_index == -1) {
-                    target_address = barf_find_name(loader, name);
-                    if (!target_address) {
-                        log__printf("barf: Cannot relocate external symbol '%s' at %s+0x%x\n", name, section->name, relocation->offset);
-                        return false;
-                    }
-                } else {
-                    BarfSegment* target_segment = &object->segments[symbol->section_index];
-                    target_address = (void*)(target_segment->address + symbol->offset);
+            u8* target_address;
+            bool local = symbol->section_index != -1;
+            if (!local) {
+                target_address = barf_find_name(loader, name);
+                if (!target_address) {
+                    log__printf("barf: Cannot relocate external symbol '%s' at %s+0x%x\n", name, section->name, relocation->offset);
+                    result = false;
+                    goto cleanup;
                 }
+            } else {
+                BarfSegment* target_segment = &object->segments[symbol->section_index];
+                target_address = target_segment->address + symbol->offset;
+            }
+
+            u8* field = segment->address + relocation->offset;
+            BarfRelocationType type = relocation->type;
 
-                u32* rel_value = (u32*)(segment->address + relocation->offset);
-                
-                // If assert is triggered then distance between rel value and target function is too far for
-                // a relative jump.
-                ASSERT(labs((uint64_t)target_address - (uint64_t)rel_value) < 0x7FFFFFFF);
+            if (type == BARF_RELOC_GOTPCREL || type == BARF_RELOC_GOTPCRELX || type == BARF_RELOC_REX_GOTPCRELX) {
+                u8* relaxed = NULL;
+                if (local && type != BARF_RELOC_GOTPCREL && barf_fits_rel32(target_address, field))
+                    relaxed = barf_relax_got_load(type, field);
+                if (relaxed) {
+                    *(u32*)relaxed += (u32)(target_address + relocation->addend - relaxed);
+                    continue;
+                }
+                if (got_slots[relocation->symbol_index] == -1) {
+                    got_slots[relocation->symbol_index] = got_used;
+                    loader->got[got_used++] = target_address;
+                }
+                // From here on it's a rel32 to the slot
+                target_address = (u8*)&loader->got[got_slots[relocation->symbol_index]];
+                type = BARF_RELOC_REL32;
+            }
+
+            u64 value = (u64)(target_address + relocation->addend);
+            if (type == BARF_RELOC_REL32) {
+                // If this fails then the target is too far away for a relative reference.
+                if (!barf_fits_rel32(target_address, field)) {
+                    log__printf("barf: '%s' is too far from %s+0x%x for a 32-bit relative relocation\n", name, section->name, relocation->offset);
+                    result = false;
+                    goto cleanup;
+                }
                 // Very important, relocation from COFF on windows we shall ADD
                 // the offset to .rdata section, COFF puts the relative offset into the immediate displacement already.
-
-                *rel_value += (u8*)target_address - ((u8*)rel_value + 4);
+                *(u32*)field += (u32)(value - (u64)field);
+            } else if (type == BARF_RELOC_ABS64) {
+                *(u64*)field += value;
+            } else if (type == BARF_RELOC_ABS32 || type == BARF_RELOC_ABS32S) {
+                bool fits = type == BARF_RELOC_ABS32 ? value <= UINT32_MAX : (i64)value == (i32)value;
+                if (!fits) {
+                    log__printf("barf: Address of '%s' doesn't fit in 32 bits at %s+0x%x, compile with -fPIC\n", name, section->name, relocation->offset);
+                    result = false;
+                    goto cleanup;
+                }
+                *(u32*)field += (u32)value;
             } else {
                 log__printf("barf: Unhandled relocation type %u, %s\n", (u32)relocation->type, name);
             }
         }
     }
-    return true;
+
+    if (loader->got)
+        mem__mapflag(loader->got, loader->got_size * sizeof(void*), MEM_READ);
+
+cleanup:
+    if (got_slots)
+        mem__alloc(0, got_slots);
+    return result;
 }
 
 void emit_jmp(void* code_address, void* function_address) {
@@ -99,7 +213,7 @@ void emit_jmp(void* code_address, void* function_address) {
 void create_platform(BarfLoader* loader) {
     int max_funcs = 128;
     int size = JUMP_ENTRY_STRIDE * max_funcs;
-    void* ptr = mem__map(NULL, size, MEM_READ|MEM_WRITE);
+    void* ptr = barf_image_alloc(loader, size);
     loader->external_segment = ptr;
 
     char** names = mem__alloc(8 * max_funcs, NULL);
@@ -122,15 +236,48 @@ void create_platform(BarfLoader* loader) {
     }
 
     ADD(mem__alloc)
+    ADD(mem__set_allocator)
     ADD(mem__map)
     ADD(mem__mapflag)
     ADD(mem__unmap)
+    ADD(mem__page_size)
+    ADD(mem__reserve)
+    ADD(mem__commit)
+    ADD(mem__decommit)
     ADD(fs__open)
     ADD(fs__close)
     ADD(fs__info)
     ADD(fs__read)
     ADD(fs__write)
+    ADD(fs__map)
+    ADD(fs__unmap)
+    ADD(fs__advise)
+    ADD(fs__queue_create)
+    ADD(fs__queue_destroy)
+    ADD(fs__submit)
+    ADD(fs__complete)
+    ADD(thread__create)
+    ADD(thread__join)
+    ADD(sync__mutex_lock)
+    ADD(sync__mutex_trylock)
+    ADD(sync__mutex_unlock)
+    ADD(sync__cond_wait)
+    ADD(sync__cond_signal)
+    ADD(sync__cond_broadcast)
+    ADD(sync__sem_wait)
+    ADD(sync__sem_post)
+    ADD(sync__event_wait)
+    ADD(sync__event_set)
+    ADD(sync__event_is_set)
+    ADD(time__monotonic)
+    ADD(time__wall)
+    ADD(time__cycles)
+    ADD(time__cycle_frequency)
+    ADD(cpu__info)
     ADD(log__printf)
+    ADD(log__message)
+    ADD(log__set_level)
+    ADD(log__flush)
 
     #undef ADD
     
@@ -219,8 +366,6 @@ bool barf_load_file(const char* path, int argc, const char** argv) {
     }
     memset(loader, 0, sizeof(*loader));
 
-    create_platform(loader);
-
     object = barf_parse_header_from_file(path);
     if (!object) {
         return false;
@@ -229,6 +374,21 @@ bool barf_load_file(const char* path, int argc, const char** argv) {
     loader->objects = object;
     loader->object_count = 1;
 
+    // Address space for the jump entries, every segment and a GOT slot per
+    // relocation at most, each rounded up to pages
+    u64 page = mem__page_size();
+    u64 image_size = (JUMP_ENTRY_STRIDE * 128 + page) + (object->header.section_count + 1) * page;
+    for (int i=0; i< object->header.section_count;i++)
+        image_size += object->sections[i].data_size + object->sections[i].relocation_count * sizeof(void*);
+    loader->image = mem__reserve(NULL, image_size);
+    if (!loader->image) {
+        log__printf("barf: Could not reserve %llu bytes for '%s'\n", (unsigned long long)image_size, path);
+        return false;
+    }
+    loader->image_size = image_size;
+
+    create_platform(loader);
+
     object->segments = mem__alloc(sizeof(*object->segments) * object->header.section_count, NULL);
     memset(object->segments, 0, sizeof(*object->segments) * object->header.section_count);
 
@@ -242,8 +402,10 @@ bool barf_load_file(const char* path, int argc, const char** argv) {
             continue; 
         }
 
-        // @TODO Ensure section alignment
-        segment->address = mem__map(NULL, section->data_size, MEM_READ|MEM_WRITE);
+        // Page-aligned, enough for any section alignment we produce
+        segment->address = barf_image_alloc(loader, section->data_size);
+        if (!segment->address)
+            goto cleanup;
 
         if ((section->flags & BARF_FLAG_ZEROED) == 0) {
             size_t read_bytes = fs__read(file, section->data_offset, segment->address, section->data_size);
@@ -314,15 +476,12 @@ bool barf_load_file(const char* path, int argc, const char** argv) {
 
     // alloc memory
 
-    for (int i=0; i< object->header.section_count;i++) {
-        BarfSection* section = &object->sections[i];
-        BarfSegment* segment = &object->segments[i];
-        if (section->flags & BARF_FLAG_IGNORE) {
-            continue;
-        }
-        mem__unmap(segment->address, section->data_size);
-        segment->address = NULL;
-    }
+    for (int i=0; i< object->header.section_count;i++)
+        object->segments[i].address = NULL;
+    mem__unmap(loader->image, loader->image_size);
+    loader->image = NULL;
+    loader->got = NULL;
+    loader->external_segment = NULL;
 
     return true;
 
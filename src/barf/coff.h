@@ -207,6 +207,15 @@ typedef struct Symbol_Record {
     u8 NumberOfAuxSymbols;
 } Symbol_Record;
 
+typedef enum {
+    IMAGE_COMDAT_SELECT_NODUPLICATES = 1,
+    IMAGE_COMDAT_SELECT_ANY          = 2,
+    IMAGE_COMDAT_SELECT_SAME_SIZE    = 3,
+    IMAGE_COMDAT_SELECT_EXACT_MATCH  = 4,
+    IMAGE_COMDAT_SELECT_ASSOCIATIVE  = 5, // kept or discarded with the section in 'Number'
+    IMAGE_COMDAT_SELECT_LARGEST      = 6,
+} COMDAT_Selection;
+
 #define Aux_Format_5_SIZE Symbol_Record_SIZE
 typedef struct Aux_Format_5 {
     u32 Length;
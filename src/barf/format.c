@@ -4,22 +4,20 @@
 
 #include "barf/elf.h"
 #include "barf/coff.h"
+#include "barf/arena.h"
 
-#define debug(...) log_error(__VA_ARGS__)
-// #define debug(...)
+#define debug(...) log__debug(__VA_ARGS__)
 
-#define log_error(...) log__printf(__VA_ARGS__)
-#define log_warning(...) log__printf(__VA_ARGS__)
+#define log_error(...) log__error(__VA_ARGS__)
+#define log_warning(...) log__warning(__VA_ARGS__)
 
 #define file_read(FILE, HEAD_PTR, PTR, SIZE) fs__read(FILE, ((*(HEAD_PTR) += (SIZE)), *(HEAD_PTR) - (SIZE)), PTR, SIZE)
 #define file_write(FILE, HEAD_PTR, PTR, SIZE) fs__write(FILE, ((*(HEAD_PTR) += (SIZE)), *(HEAD_PTR) - (SIZE)), PTR, SIZE)
 
-#define heap_alloc(SIZE) mem__alloc(SIZE, NULL)
-#define heap_free(PTR) mem__alloc(0, PTR)
-
 #define IS_INVALID_FS_HANDLE(F) ((F) == FS_INVALID_HANDLE)
 
-BarfObject* barf_parse_header_from_file(const char* path) {
+// All memory of the object comes from 'arena'
+static BarfObject* barf_parse_object(const char* path, Arena* arena) {
     BarfObject* object = NULL;
     FSHandle file = FS_INVALID_HANDLE;
     
@@ -34,12 +32,11 @@ BarfObject* barf_parse_header_from_file(const char* path) {
 
     size_t fs_head = 0;
 
-    object = mem__alloc(sizeof(*object), NULL);
+    object = arena_alloc(arena, sizeof(*object));
     if (!object) {
-        log_error("ERROR barf: heap_alloc failed, when parsing '%s'\n", path);
+        log_error("ERROR barf: arena_alloc failed, when parsing '%s'\n", path);
         goto cleanup;
     }
-    memset(object, 0, sizeof(*object));
 
     if (file_size < sizeof(object->header)) {
         log_error("ERROR barf: file to small for header, when parsing '%s'\n", path);
@@ -56,6 +53,10 @@ BarfObject* barf_parse_header_from_file(const char* path) {
         log_error("ERROR barf: magic incorrect %u == %.4s (should be %4.s)\n", object->header.magic, (char*)&object->header.magic, magic.name);
         goto cleanup;
     }
+    if (object->header.version != BARF_FORMAT_VERSION) {
+        log_error("ERROR barf: '%s' has format version %u, expected %u (convert it again)\n", path, object->header.version, BARF_FORMAT_VERSION);
+        goto cleanup;
+    }
     
     u64 size_of_sections = object->header.section_count * sizeof(*object->sections);
 
@@ -64,30 +65,22 @@ BarfObject* barf_parse_header_from_file(const char* path) {
         goto cleanup;
     }
 
-    object->sections = mem__alloc(size_of_sections, NULL);
-    if (!object->sections) {
-        log_error("ERROR barf: heap_alloc failed, when parsing '%s'\n", path);
+    u64 size_of_symbols = object->header.symbol_count * sizeof(*object->symbols);
+    u64 size_of_relocations_list = object->header.section_count * sizeof(*object->relocations);
+
+    object->sections    = arena_alloc(arena, size_of_sections);
+    object->symbols     = arena_alloc(arena, size_of_symbols);
+    object->strings     = arena_alloc(arena, object->header.string_size);
+    object->relocations = arena_alloc(arena, size_of_relocations_list);
+    if (!object->sections || !object->symbols || !object->strings || !object->relocations) {
+        log_error("ERROR barf: arena_alloc failed, when parsing '%s'\n", path);
         goto cleanup;
     }
-    memset(object->sections, 0, size_of_sections);
-    
-    file_read(file, &fs_head, object->sections, sizeof(*object->sections) * object->header.section_count);
-
     
-    u64 size_of_symbols = object->header.symbol_count * sizeof(*object->symbols);
-    object->symbols = mem__alloc(size_of_symbols, NULL);
-    memset(object->symbols, 0, size_of_symbols);
-    file_read(file, &fs_head, object->symbols, sizeof(*object->symbols) * object->header.symbol_count);
-
-    object->strings = mem__alloc(object->header.string_size, NULL);
-    memset(object->strings, 0, object->header.string_size);
+    file_read(file, &fs_head, object->sections, size_of_sections);
+    file_read(file, &fs_head, object->symbols, size_of_symbols);
     file_read(file, &fs_head, object->strings, object->header.string_size);
 
-    u64 size_of_relocations_list = object->header.section_count * sizeof(*object->relocations);
-    
-    object->relocations = mem__alloc(size_of_relocations_list, NULL);
-    memset(object->relocations, 0, size_of_relocations_list);
-
     for (int i=0;i<object->header.section_count;i++) {
         BarfSection* section = &object->sections[i];
 
@@ -96,10 +89,13 @@ BarfObject* barf_parse_header_from_file(const char* path) {
         }
 
         u64 size_of_relocations = section->relocation_count * sizeof(**object->relocations);
-        BarfRelocation* relocations = mem__alloc(size_of_relocations, NULL);
-        memset(relocations, 0, size_of_relocations);
+        BarfRelocation* relocations = arena_alloc(arena, size_of_relocations);
+        if (!relocations) {
+            log_error("ERROR barf: arena_alloc failed, when parsing '%s'\n", path);
+            goto cleanup;
+        }
 
-        fs__read(file, section->relocation_offset, relocations, sizeof(**object->relocations) * section->relocation_count);
+        fs__read(file, section->relocation_offset, relocations, size_of_relocations);
 
         object->relocations[i] = relocations;
     }
@@ -110,21 +106,85 @@ BarfObject* barf_parse_header_from_file(const char* path) {
     return object;
 
 cleanup:
-    if (file)
+    if (!IS_INVALID_FS_HANDLE(file))
         fs__close(file);
-    if (object) {
-        if (object->sections)
-            mem__alloc(0, object->sections);
-        mem__alloc(0, object);
-    }
     return NULL;
 }
 
+// Points section_data into the mapping of the input, data_offset is the offset
+// in the input until the object is written.
+static bool barf_map_section_data(BarfObject* object, const char* path, Arena* arena) {
+    object->section_data = arena_alloc(arena, sizeof(char*) * object->header.section_count);
+    if (!object->section_data) {
+        log_error("barf: arena_alloc failed, when parsing '%s'\n", path);
+        return false;
+    }
+    for (u32 i = 0; i < object->header.section_count; i++) {
+        BarfSection* section = &object->sections[i];
+        if (section->flags & BARF_FLAG_ZEROED) {
+            // No data in the input
+            continue;
+        }
+        if (section->data_offset > object->mapping_size || section->data_size > object->mapping_size - section->data_offset) {
+            log_error("barf: section '%s' is outside of '%s'\n", section->name, path);
+            return false;
+        }
+        object->section_data[i] = (char*)object->mapping + section->data_offset;
+    }
+    return true;
+}
+
+// Parses an artifact into 'arena' and maps its section data like the converters do
+static BarfObject* barf_object_from_ba(const char* path, Arena* arena) {
+    BarfObject* object = barf_parse_object(path, arena);
+    if (!object)
+        return NULL;
+
+    FSHandle file = fs__open(path, FS_READ);
+    if (IS_INVALID_FS_HANDLE(file)) {
+        log_error("ERROR barf: '%s' not found\n", path);
+        return NULL;
+    }
+    FSInfo info;
+    fs__info(file, &info);
+    object->mapping_size = info.file_size;
+    object->mapping      = fs__map(file, 0, info.file_size, FS_MAP_READ);
+    fs__close(file);
+    if (!object->mapping) {
+        log_error("barf: could not map '%s'\n", path);
+        return NULL;
+    }
+    if (!barf_map_section_data(object, path, arena)) {
+        barf_unmap_object(object);
+        return NULL;
+    }
+    return object;
+}
+
+void barf_unmap_object(BarfObject* object) {
+    if (object && object->mapping) {
+        fs__unmap(object->mapping, object->mapping_size);
+        object->mapping = NULL;
+    }
+}
 
+BarfObject* barf_parse_header_from_file(const char* path) {
+    Arena* arena = arena_create();
+    if (!arena) {
+        log_error("ERROR barf: arena_create failed, when parsing '%s'\n", path);
+        return NULL;
+    }
+    BarfObject* object = barf_parse_object(path, arena);
+    if (!object) {
+        arena_destroy(arena);
+        return NULL;
+    }
+    object->arena = arena;
+    return object;
+}
 
 void barf_free_object(BarfObject* object) {
-    mem__alloc(0, object->sections);
-    mem__alloc(0, object);
+    arena_destroy(object->arena);
 }
 
 
@@ -162,28 +222,48 @@ void barf_dump(BarfObject* object) {
         if (section->flags & BARF_FLAG_IGNORE) {
             log("IGNORE ");
         }
+        if (section->flags & BARF_FLAG_GROUP_UNIQUE) {
+            log("UNIQUE ");
+        }
+        if (section->flags & BARF_FLAG_MERGE) {
+            log("MERGE ");
+        }
+        if (section->flags & BARF_FLAG_STRINGS) {
+            log("STRINGS ");
+        }
         log("\n");
+        if (section->flags & BARF_FLAG_GROUP) {
+            log("   group:  %s\n", object->strings + section->group);
+        }
+        if (section->flags & BARF_FLAG_MERGE) {
+            log("   entry:  %u\n", section->entry_size);
+        }
         log("   align:  %hu\n", section->alignment);
         log("   offset: "FL"u\n", section->data_offset);
         log("   size:   "FL"u\n", section->data_size);
         log("   reloc_offset: "FL"u\n", section->relocation_offset);
         log("   reloc_count:  %u\n", section->relocation_count);
 
+        static const char* relocation_names[] = { "REL32", "ABS64", "ABS32", "ABS32S", "GOTPCREL", "GOTPCRELX", "REX_GOTPCRELX" };
         for (u32 ri=0; ri < section->relocation_count; ri++) {
             BarfRelocation* relocation = &object->relocations[i][ri];
             BarfSymbol* symbol = &object->symbols[relocation->symbol_index];
             const char* name = object->strings + symbol->string_offset;
+            const char* type = relocation->type < sizeof(relocation_names)/sizeof(*relocation_names) ? relocation_names[relocation->type] : "unknown";
+            log("     0x%x %s %s", relocation->offset, type, name);
+            if (relocation->addend)
+                log("%+lld", (long long)relocation->addend);
             if (symbol->type == BARF_SYMBOL_LOCAL) {
-                log("     0x%x %s (local symbol)\n", relocation->offset, name);
+                log(" (local symbol)\n");
             } else if (symbol->type == BARF_SYMBOL_GLOBAL) {
                 if (symbol->section_index >= 0 && symbol->section_index < object->header.section_count) {
                     BarfSection* sym_section = &object->sections[symbol->section_index];
-                    log("     0x%x %s (in %s)\n", relocation->offset, name, sym_section->name);
+                    log(" (in %s)\n", sym_section->name);
                 } else {
-                    log("     0x%x %s (in section index %d, bad index)\n", relocation->offset, name, symbol->section_index);
+                    log(" (in section index %d, bad index)\n", symbol->section_index);
                 }
             } else {
-                log("     0x%x %s (external symbol)\n", relocation->offset, name);
+                log(" (external symbol)\n");
             }
         }
     }
@@ -207,7 +287,9 @@ void barf_dump(BarfObject* object) {
     }
 }
 
-bool barf_convert_from_coff(const char* path, const char* output) {
+// Converts into 'arena', section data points into a mapping of the input that
+// the object keeps (barf_unmap_object). Returns NULL if it wasn't COFF.
+static BarfObject* barf_object_from_coff(const char* path, Arena* arena) {
     BarfObject* object   = NULL;
     FSHandle    file     = FS_INVALID_HANDLE;
     u8*         data     = NULL;
@@ -223,18 +305,18 @@ bool barf_convert_from_coff(const char* path, const char* output) {
     fs__info(file, &fileInfo);
     dataSize = fileInfo.file_size;
 
-    data = mem__alloc(COFF_File_Header_SIZE, NULL);
+    u8 header_data[COFF_File_Header_SIZE];
 
     uint64_t fs_head = 0;
 
-    size_t read_bytes = file_read(file, &fs_head, data, COFF_File_Header_SIZE);
+    size_t read_bytes = file_read(file, &fs_head, header_data, COFF_File_Header_SIZE);
     if(read_bytes != COFF_File_Header_SIZE) {
         // not COFF
-        return false;
+        goto cleanup;
     }
 
     // Heuristic checks for COFF format
-    COFF_File_Header* header = (COFF_File_Header*) data;
+    COFF_File_Header* header = (COFF_File_Header*) header_data;
     if (
         (header->Machine != IMAGE_FILE_MACHINE_AMD64 &&
         header->Machine != IMAGE_FILE_MACHINE_ARM &&
@@ -246,24 +328,30 @@ bool barf_convert_from_coff(const char* path, const char* output) {
         goto cleanup;
     }
 
-    // Probably COFF, read rest of file at once (easiest)
-    data = mem__alloc(dataSize, data);
-    read_bytes = file_read(file, &fs_head, data + COFF_File_Header_SIZE, dataSize - COFF_File_Header_SIZE);
-    if(read_bytes != dataSize - COFF_File_Header_SIZE) {
-        log_error("barf: could not read all bytes '%s'\n", path);
+    // Probably COFF, map the whole file. Metadata of the conversion comes from
+    // the arena, section data is used from the mapping and never copied.
+    data = fs__map(file, 0, dataSize, FS_MAP_READ);
+    if (!data) {
+        log_error("barf: could not map '%s'\n", path);
         goto cleanup;
     }
 
+    // The mapping stays valid after the handle is closed
     fs__close(file);
     file = FS_INVALID_HANDLE;
     
-    header = (COFF_File_Header*) data; // set again after realloc
+    header = (COFF_File_Header*) data;
     
-    object = mem__alloc(sizeof(*object), NULL);
-    memset(object, 0, sizeof(*object));
+    object = arena_alloc(arena, sizeof(*object));
+    if (!object) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
+    object->mapping      = data;
+    object->mapping_size = dataSize;
 
     object->header.magic = BARF_MAGIC;
-    object->header.version = 1;
+    object->header.version = BARF_FORMAT_VERSION;
     object->header.flags = 0; // little endian
 
     switch (header->Machine) {
@@ -274,13 +362,14 @@ bool barf_convert_from_coff(const char* path, const char* output) {
         default: strcpy(object->header.target, "unknown");
     }
 
-    object->sections = mem__alloc(header->NumberOfSections * sizeof(*object->sections), NULL);
-    memset(object->sections, 0, header->NumberOfSections * sizeof(*object->sections));
+    object->sections = arena_alloc(arena, header->NumberOfSections * sizeof(*object->sections));
 
-    
     u64 size_of_relocations_list = header->NumberOfSections * sizeof(*object->relocations);
-    object->relocations = mem__alloc(size_of_relocations_list, NULL);
-    memset(object->relocations, 0, size_of_relocations_list);
+    object->relocations = arena_alloc(arena, size_of_relocations_list);
+    if (!object->sections || !object->relocations) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
 
 
     u64 offset_of_sections = COFF_File_Header_SIZE + header->SizeOfOptionalHeader;
@@ -289,14 +378,21 @@ bool barf_convert_from_coff(const char* path, const char* output) {
 
     typedef struct {
         int section_index;
+        int selection;  // COMDAT selection from the section symbol, 0 if not a COMDAT
+        int associated; // section number the section goes with (IMAGE_COMDAT_SELECT_ASSOCIATIVE)
+        int group;      // string offset of the COMDAT symbol, -1 until seen
     } SectionInfo;
 
-    SectionInfo* section_infos = mem__alloc(sizeof(SectionInfo) * header->NumberOfSections, NULL);
-    memset(section_infos, 0, sizeof(SectionInfo) * header->NumberOfSections);
+    SectionInfo* section_infos = arena_alloc(arena, sizeof(SectionInfo) * header->NumberOfSections);
+    if (!section_infos) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
 
     for (int i = 0; i < header->NumberOfSections; i++) {
         Section_Header* section = (Section_Header*)(data + offset_of_sections + i * Section_Header_SIZE);
         section_infos[i].section_index = -1;
+        section_infos[i].group = -1;
 
         char _name[12];
         char* name = _name;
@@ -346,19 +442,20 @@ bool barf_convert_from_coff(const char* path, const char* output) {
         sec->alignment = 1 << (((section->Characteristics >> 20) & 0xF) - 1);
     }
 
-    object->strings = mem__alloc(size_of_strings, NULL);
-    memset(object->strings, 0, size_of_strings);
+    object->strings = arena_alloc(arena, size_of_strings);
 
-    object->symbols = mem__alloc(header->NumberOfSymbols * sizeof(*object->symbols), NULL);
-    memset(object->symbols, 0, header->NumberOfSymbols * sizeof(*object->symbols));
+    object->symbols = arena_alloc(arena, header->NumberOfSymbols * sizeof(*object->symbols));
 
     // Need a way to map Coff symbol numbers to barf symbol indexes, since aux symbols aren't carried over and number indexes don't map 1:1
 
     typedef struct {
         u32 symbol_index;
     } SymbolInfo;
-    SymbolInfo* symbol_infos = mem__alloc(sizeof(SymbolInfo) * header->NumberOfSymbols, NULL);
-    memset(symbol_infos, 0, sizeof(SymbolInfo) * header->NumberOfSymbols);
+    SymbolInfo* symbol_infos = arena_alloc(arena, sizeof(SymbolInfo) * header->NumberOfSymbols);
+    if (!object->strings || !object->symbols || !symbol_infos) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
 
     u64 next_string_offset = 0;
 
@@ -400,6 +497,20 @@ bool barf_convert_from_coff(const char* path, const char* output) {
             }
 
             ASSERT(sym->section_index != -1);
+
+            // A COMDAT section has its section symbol first, the aux record holds
+            // the selection. The next symbol in the section names the group.
+            SectionInfo* info = &section_infos[symbol->SectionNumber-1];
+            Section_Header* section = (Section_Header*)(data + offset_of_sections + (symbol->SectionNumber-1) * Section_Header_SIZE);
+            if (section->Characteristics & IMAGE_SCN_LNK_COMDAT) {
+                if (info->selection == 0 && symbol->StorageClass == IMAGE_SYM_CLASS_STATIC && symbol->NumberOfAuxSymbols) {
+                    Aux_Format_5* aux = (Aux_Format_5*)(data + header->PointerToSymbolTable + (i+1) * Symbol_Record_SIZE);
+                    info->selection  = aux->Selection;
+                    info->associated = aux->Number;
+                } else if (info->selection != 0 && info->selection != IMAGE_COMDAT_SELECT_ASSOCIATIVE && info->group == -1) {
+                    info->group = next_string_offset;
+                }
+            }
         }
         sym->string_offset = next_string_offset;
 
@@ -417,7 +528,29 @@ bool barf_convert_from_coff(const char* path, const char* output) {
     }
 
     object->header.string_size = next_string_offset;
-    
+
+    // Sections of a COMDAT go to its group, associative ones (.pdata, .xdata of
+    // a COMDAT function) to the group of the section they go with. The copy
+    // that is kept is always the first, LARGEST is treated as ANY.
+    for (int pass = 0; pass < 2; pass++) {
+        for (int si = 0; si < header->NumberOfSections; si++) {
+            SectionInfo* info = &section_infos[si];
+            if (info->section_index == -1 || info->selection == 0)
+                continue;
+            bool associative = info->selection == IMAGE_COMDAT_SELECT_ASSOCIATIVE;
+            if (associative != (pass == 1))
+                continue;
+            if (associative && info->associated >= 1 && info->associated <= header->NumberOfSections)
+                info->group = section_infos[info->associated-1].group;
+            if (info->group == -1)
+                continue;
+            BarfSection* sec = &object->sections[info->section_index];
+            sec->flags |= BARF_FLAG_GROUP;
+            if (info->selection == IMAGE_COMDAT_SELECT_NODUPLICATES)
+                sec->flags |= BARF_FLAG_GROUP_UNIQUE;
+            sec->group = info->group;
+        }
+    }
 
     for (int si = 0; si < header->NumberOfSections; si++) {
         Section_Header* section = (Section_Header*)(data + offset_of_sections + si * Section_Header_SIZE);
@@ -431,9 +564,12 @@ bool barf_convert_from_coff(const char* path, const char* output) {
         if (!section->NumberOfRelocations) {
             continue;
         }
-        BarfRelocation* relocations = mem__alloc(section->NumberOfRelocations * sizeof(BarfRelocation), NULL);
-        object->relocations[si] = relocations;
-        memset(relocations, 0, section->NumberOfRelocations * sizeof(BarfRelocation));
+        BarfRelocation* relocations = arena_alloc(arena, section->NumberOfRelocations * sizeof(BarfRelocation));
+        if (!relocations) {
+            log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+            goto cleanup;
+        }
+        object->relocations[section_info->section_index] = relocations;
 
         for (int ri=0;ri<section->NumberOfRelocations;ri++) {
             COFF_Relocation* relocation = (COFF_Relocation*)(data + section->PointerToRelocations + ri * COFF_Relocation_SIZE);
@@ -444,9 +580,16 @@ bool barf_convert_from_coff(const char* path, const char* output) {
             const char* name = object->strings + symbol->string_offset;
 
             if (relocation->Type == IMAGE_REL_AMD64_REL32) {
+                // COFF keeps the addend in the field, relative to the end of it
                 rel->type = BARF_RELOC_REL32;
                 rel->symbol_index = symbol_index;
                 rel->offset = relocation->VirtualAddress;
+                rel->addend = -4;
+                sec->relocation_count++;
+            } else if (relocation->Type == IMAGE_REL_AMD64_ADDR64) {
+                rel->type = BARF_RELOC_ABS64;
+                rel->symbol_index = symbol_index;
+                rel->offset = relocation->VirtualAddress;
                 sec->relocation_count++;
             } else {
                 // @TODO What to do with this?
@@ -457,69 +600,29 @@ bool barf_convert_from_coff(const char* path, const char* output) {
 
     // barf_dump(object);
 
-    file = fs__open(output, FS_WRITE);
-    if (IS_INVALID_FS_HANDLE(file)) {
-        log_error("barf: Could not open '%s'\n", output);
+    if (!barf_map_section_data(object, path, arena))
         goto cleanup;
-    }
-
-    u64 size_of_symbols = sizeof(*object->symbols) * object->header.symbol_count;
-    u64 size_of_sections = sizeof(*object->sections) * object->header.section_count;
-    
-    object->header.section_offset = sizeof(object->header);
-    object->header.symbol_offset  = sizeof(object->header) + size_of_sections;
-    object->header.string_offset  = sizeof(object->header) + size_of_sections + size_of_symbols;
-    
-    u64 next_section_data_offset = sizeof(object->header) + size_of_sections + size_of_symbols + object->header.string_size;
-
-    for (int i = 0; i < object->header.section_count; i++) {
-        BarfSection* section = &object->sections[i];
-
-        next_section_data_offset += (section->alignment - (next_section_data_offset % section->alignment)) % section->alignment;
-
-        u64 new_offset = next_section_data_offset;
-
-        fs__write(file, next_section_data_offset, data + section->data_offset, section->data_size);
-
-        next_section_data_offset += section->data_size;
-
-        section->data_offset = new_offset;
-        
-        next_section_data_offset += (8 - (next_section_data_offset % 8)) % 8;
-
-        new_offset = next_section_data_offset;
-
-        fs__write(file, next_section_data_offset, object->relocations[i], sizeof(BarfRelocation) * section->relocation_count);
-        
-        section->relocation_offset = new_offset;
-
-        next_section_data_offset += section->relocation_count * sizeof(BarfRelocation);
-    }
-    
-    object->header.total_size = next_section_data_offset;
-
-    fs_head = 0;
-    file_write(file, &fs_head, &object->header, sizeof(object->header));
-
-    file_write(file, &fs_head, object->sections, sizeof(*object->sections) * object->header.section_count);
-    
-    file_write(file, &fs_head, object->symbols, sizeof(*object->symbols) * object->header.symbol_count);
-    
-    file_write(file, &fs_head, object->strings, object->header.string_size);
-    fs__close(file);
-    mem__alloc(0, object);
-    return true;
+    return object;
 
 cleanup:
-    if (file)
+    if (!IS_INVALID_FS_HANDLE(file))
         fs__close(file);
-    if (object)
-        mem__alloc(0, object);
-    if (data)
-        mem__alloc(0, data);
-    return false;
+    fs__unmap(data, dataSize);
+    return NULL;
 }
-bool barf_convert_from_elf(const char* path, const char* output) {
+
+// Same as barf_object_from_coff. Returns NULL if it wasn't ELF.
+// Name of the group a SHT_GROUP section declares, the name of its signature
+// symbol or of the section that symbol is for.
+static const char* elf_group_name(u8* data, Elf64_Shdr* elf_sections, const char* elf_section_names, Elf64_Shdr* group) {
+    Elf64_Shdr* symbol_table = &elf_sections[group->sh_link];
+    Elf64_Sym*  symbol = (Elf64_Sym*)(data + symbol_table->sh_offset) + group->sh_info;
+    if (ELF64_ST_TYPE(symbol->st_info) == STT_SECTION)
+        return elf_section_names + elf_sections[symbol->st_shndx].sh_name;
+    return (const char*)data + elf_sections[symbol_table->sh_link].sh_offset + symbol->st_name;
+}
+
+static BarfObject* barf_object_from_elf(const char* path, Arena* arena) {
     BarfObject* object   = NULL;
     FSHandle    file     = FS_INVALID_HANDLE;
     u8*         data     = NULL;
@@ -531,23 +634,21 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         goto cleanup;
     }
 
-    debug("Convert %s\n", path);
-
     FSInfo fileInfo;
     fs__info(file, &fileInfo);
     dataSize = fileInfo.file_size;
 
-    data = mem__alloc(sizeof(Elf64_Ehdr), NULL);
+    Elf64_Ehdr header_data;
 
     uint64_t fs_head = 0;
 
-    size_t read_bytes = file_read(file, &fs_head, data, sizeof(Elf64_Ehdr));
+    size_t read_bytes = file_read(file, &fs_head, &header_data, sizeof(Elf64_Ehdr));
     if(read_bytes != sizeof(Elf64_Ehdr)) {
-        // not COFF
-        return false;
+        // not ELF
+        goto cleanup;
     }
 
-    Elf64_Ehdr* header = (Elf64_Ehdr*)data;
+    Elf64_Ehdr* header = &header_data;
 
     if (strncmp((char*)header->e_ident, ELFMAG, 4)) {
         goto cleanup;
@@ -566,23 +667,32 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         goto cleanup;
     }
 
-    data = mem__alloc(dataSize, data);
-    read_bytes = file_read(file, &fs_head, data + sizeof(Elf64_Ehdr), dataSize - sizeof(Elf64_Ehdr));
-    if(read_bytes != dataSize - sizeof(Elf64_Ehdr)) {
-        log_error("barf: could not read all bytes '%s'\n", path);
+    debug("Convert %s\n", path);
+
+    // Metadata of the conversion comes from the arena, section data is used
+    // from a mapping of the input and never copied.
+    data = fs__map(file, 0, dataSize, FS_MAP_READ);
+    if (!data) {
+        log_error("barf: could not map '%s'\n", path);
         goto cleanup;
     }
-    
+
+    // The mapping stays valid after the handle is closed
     fs__close(file);
     file = FS_INVALID_HANDLE;
     
-    header = (Elf64_Ehdr*) data; // set again after realloc
+    header = (Elf64_Ehdr*) data;
     
-    object = mem__alloc(sizeof(*object), NULL);
-    memset(object, 0, sizeof(*object));
+    object = arena_alloc(arena, sizeof(*object));
+    if (!object) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
+    object->mapping      = data;
+    object->mapping_size = dataSize;
 
     object->header.magic = BARF_MAGIC;
-    object->header.version = 1;
+    object->header.version = BARF_FORMAT_VERSION;
     object->header.flags = 0; // little endian
 
     switch (header->e_machine) {
@@ -593,12 +703,14 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         default: strcpy(object->header.target, "unknown");
     }
 
-    object->sections = mem__alloc(header->e_shnum * sizeof(*object->sections), NULL);
-    memset(object->sections, 0, header->e_shnum * sizeof(*object->sections));
+    object->sections = arena_alloc(arena, header->e_shnum * sizeof(*object->sections));
 
     u64 size_of_relocations_list = header->e_shnum * sizeof(*object->relocations);
-    object->relocations = mem__alloc(size_of_relocations_list, NULL);
-    memset(object->relocations, 0, size_of_relocations_list);
+    object->relocations = arena_alloc(arena, size_of_relocations_list);
+    if (!object->sections || !object->relocations) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
 
     
     typedef struct {
@@ -607,26 +719,30 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         int rel_index;
     } SectionInfo;
 
-    SectionInfo* section_infos = mem__alloc(sizeof(SectionInfo) * header->e_shnum, NULL);
-    memset(section_infos, 0, sizeof(SectionInfo) * header->e_shnum);
+    SectionInfo* section_infos = arena_alloc(arena, sizeof(SectionInfo) * header->e_shnum);
+    if (!section_infos) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
 
 
     Elf64_Shdr* elf_sections = (Elf64_Shdr*)(data + header->e_shoff);
     char* elf_section_names = (char*)data + elf_sections[header->e_shstrndx].sh_offset;
     // char* names = (char*)data + header->e_shstrndx;
 
-    int elf_symbol_table_index = -1;
     Elf64_Shdr* elf_symbol_table = NULL;
     Elf64_Shdr* elf_symbol_string_table = NULL;
 
     u64 estimated_string_table_size = 0;
 
     for (int i = 0; i < header->e_shnum; i++) {
-        Elf64_Shdr* section = &elf_sections[i];
-
         section_infos[i].section_index = -1;
         section_infos[i].rela_index = -1;
         section_infos[i].rel_index = -1;
+    }
+
+    for (int i = 0; i < header->e_shnum; i++) {
+        Elf64_Shdr* section = &elf_sections[i];
 
         char* name =  elf_section_names + section->sh_name;
 
@@ -635,29 +751,24 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         if (section->sh_type == SHT_STRTAB) {
             estimated_string_table_size += section->sh_size;
         }
+        if (section->sh_type == SHT_GROUP) {
+            estimated_string_table_size += strlen(elf_group_name(data, elf_sections, elf_section_names, section)) + 1;
+            continue;
+        }
 
         if (section->sh_type == SHT_RELA || section->sh_type == SHT_REL) {
-            char* target_name = name + (section->sh_type == SHT_RELA ? 5 : 4);
-            int found_index = -1;
-            for (int j = 0; j < header->e_shnum; j++) {
-                Elf64_Shdr* current = &elf_sections[j];
-                char* current_name = current->sh_name;
-                if (!strcmp(target_name, current_name)) {
-                    found_index = -1;
-                    break;
-                }
-            }
-            if (found_index != -1) {
+            // sh_info is the section the relocations apply to
+            if (section->sh_info < header->e_shnum) {
                 if (section->sh_type == SHT_RELA) {
-                    section_infos[i].rela_index = found_index;
+                    section_infos[section->sh_info].rela_index = i;
                 } else {
-                    section_infos[i].rel_index = found_index;
+                    section_infos[section->sh_info].rel_index = i;
                 }
             }
+            continue;
         }
 
         if (section->sh_type == SHT_SYMTAB) {
-            elf_symbol_table_index = i;
             elf_symbol_table = section;
             elf_symbol_string_table = &elf_sections[elf_symbol_table->sh_link];
             continue;
@@ -686,31 +797,35 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         sec->data_offset = section->sh_offset; // Temporarily set, update later
 
         sec->flags = 0;
+        if (section->sh_type == SHT_NOBITS) {
+            sec->flags |= BARF_FLAG_ZEROED;
+        }
         if (section->sh_type == SHT_NOTE || 0 == (section->sh_flags & SHF_ALLOC)) {
-            sec->flags = BARF_FLAG_IGNORE;
+            sec->flags |= BARF_FLAG_IGNORE;
         } else {
-            if (section->sh_type == SHT_NOBITS) {
-                sec->flags |= BARF_FLAG_ZEROED;
-            }
             if (section->sh_flags & SHF_WRITE) {
                 sec->flags |= BARF_FLAG_WRITE;
             }
             if (section->sh_flags & SHF_EXECINSTR) {
                 sec->flags |= BARF_FLAG_EXEC;
             }
+            if ((section->sh_flags & SHF_MERGE) && section->sh_entsize > 0 && section->sh_type == SHT_PROGBITS) {
+                sec->flags |= BARF_FLAG_MERGE;
+                if (section->sh_flags & SHF_STRINGS)
+                    sec->flags |= BARF_FLAG_STRINGS;
+                sec->entry_size = section->sh_entsize;
+            }
         }
 
         sec->alignment = section->sh_addralign;
-        log__printf("%s\n", name);
+        debug("  %s\n", name);
     }
 
-    int symbol_count = elf_sections[elf_symbol_table_index].sh_size / sizeof(Elf64_Sym);
+    int symbol_count = elf_symbol_table ? elf_symbol_table->sh_size / sizeof(Elf64_Sym) : 0;
     
-    object->strings = mem__alloc(estimated_string_table_size, NULL);
-    memset(object->strings, 0, estimated_string_table_size);
+    object->strings = arena_alloc(arena, estimated_string_table_size);
 
-    object->symbols = mem__alloc(symbol_count * sizeof(*object->symbols), NULL);
-    memset(object->symbols, 0, symbol_count * sizeof(*object->symbols));
+    object->symbols = arena_alloc(arena, symbol_count * sizeof(*object->symbols));
 
     
     u64 next_string_offset = 0;
@@ -718,10 +833,13 @@ bool barf_convert_from_elf(const char* path, const char* output) {
     typedef struct {
         u32 symbol_index;
     } SymbolInfo;
-    SymbolInfo* symbol_infos = mem__alloc(sizeof(SymbolInfo) * symbol_count, NULL);
-    memset(symbol_infos, 0, sizeof(SymbolInfo) * symbol_count);
+    SymbolInfo* symbol_infos = arena_alloc(arena, sizeof(SymbolInfo) * symbol_count);
+    if (!object->strings || !object->symbols || !symbol_infos) {
+        log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+        goto cleanup;
+    }
 
-    Elf64_Sym* elf_symbols = (Elf64_Sym*)(data + elf_symbol_table->sh_offset);
+    Elf64_Sym* elf_symbols = elf_symbol_table ? (Elf64_Sym*)(data + elf_symbol_table->sh_offset) : NULL;
 
     for (int i=0;i<symbol_count;i++) {
         Elf64_Sym* symbol = &elf_symbols[i];
@@ -729,18 +847,37 @@ bool barf_convert_from_elf(const char* path, const char* output) {
 
         symbol_infos[i].symbol_index = -1;
 
-        char* name = (data + elf_symbol_string_table->sh_offset + symbol->st_name);
+        char* name = (char*)(data + elf_symbol_string_table->sh_offset + symbol->st_name);
         int   name_len = strlen(name);
 
         int bind = ELF64_ST_BIND(symbol->st_info);
         int type = ELF64_ST_TYPE(symbol->st_info);
 
-        if (bind == STB_LOCAL) {
-            sym->type = BARF_SYMBOL_LOCAL;
-        } else if (bind == STB_GLOBAL) {
-            sym->type = BARF_SYMBOL_GLOBAL;
+        if (i == 0 || type == STT_FILE) {
+            // null symbol and source file name
+            continue;
+        }
+
+        if (symbol->st_shndx == SHN_UNDEF) {
+            if (bind == STB_LOCAL) {
+                continue;
+            }
+            sym->type = BARF_SYMBOL_EXTERNAL;
+            sym->section_index = -1;
+        } else {
+            if (symbol->st_shndx >= SHN_LORESERVE) {
+                // @TODO Absolute and common symbols (-fcommon)
+                log_warning("barf: Unhandled symbol '%s' in special section 0x%x, '%s'\n", name, symbol->st_shndx, path);
+                continue;
+            }
+            sym->section_index = section_infos[symbol->st_shndx].section_index;
+            if (sym->section_index == -1) {
+                // Symbol in a section that isn't converted (.eh_frame, .group)
+                continue;
+            }
+            // Weak definitions are treated as global
+            sym->type = bind == STB_LOCAL ? BARF_SYMBOL_LOCAL : BARF_SYMBOL_GLOBAL;
         }
-        sym->section_index = section_infos[symbol->st_shndx].section_index;
         sym->offset = symbol->st_value;
         
         sym->string_offset = next_string_offset;
@@ -752,11 +889,40 @@ bool barf_convert_from_elf(const char* path, const char* output) {
         object->header.symbol_count++;
     }
 
+    // Members of COMDAT groups are tagged with the group name, other groups
+    // only tie sections together for 'ld -r' and are ignored.
+    for (int i = 0; i < header->e_shnum; i++) {
+        Elf64_Shdr* section = &elf_sections[i];
+        if (section->sh_type != SHT_GROUP || section->sh_size < sizeof(u32))
+            continue;
+        u32* words = (u32*)(data + section->sh_offset);
+        if (!(words[0] & GRP_COMDAT))
+            continue;
+
+        const char* name = elf_group_name(data, elf_sections, elf_section_names, section);
+        u32 group = next_string_offset;
+        int name_len = strlen(name);
+        memcpy(object->strings + next_string_offset, name, name_len + 1);
+        next_string_offset += name_len + 1;
+
+        for (u64 wi = 1; wi < section->sh_size / sizeof(u32); wi++) {
+            if (words[wi] >= header->e_shnum || section_infos[words[wi]].section_index == -1)
+                continue;
+            BarfSection* sec = &object->sections[section_infos[words[wi]].section_index];
+            sec->flags |= BARF_FLAG_GROUP;
+            sec->group = group;
+        }
+    }
+
     object->header.string_size = next_string_offset;
     
     
-    for (int si = 0; si < header->e_shnum; si++) {
-        Elf64_Shdr*  section = &elf_sections[si];
+    if (header->e_machine != EM_X86_64) {
+        // @TODO Relocation types of other machines
+        log_warning("barf: Relocations are only converted for x86_64, '%s'\n", path);
+    }
+
+    for (int si = 0; header->e_machine == EM_X86_64 && si < header->e_shnum; si++) {
         SectionInfo* section_info = &section_infos[si];
 
         if (section_info->section_index == -1) {
@@ -768,53 +934,90 @@ bool barf_convert_from_elf(const char* path, const char* output) {
             // no relocations
             continue;
         }
+        if (sec->flags & BARF_FLAG_IGNORE) {
+            // Not loaded so never relocated (debug info)
+            continue;
+        }
 
         Elf64_Shdr* rel_section = section_info->rel_index == -1 ? NULL : &elf_sections[section_info->rel_index];
         Elf64_Shdr* rela_section = section_info->rela_index == -1 ? NULL : &elf_sections[section_info->rela_index];
 
-        int relocation_count = (rel_section ? rel_section->sh_size / rel_section->sh_entsize : 0) + (rela_section ? rela_section->sh_size / rela_section->sh_entsize : 0);
-
-
-        BarfRelocation* relocations = mem__alloc(relocation_count * sizeof(BarfRelocation), NULL);
-        object->relocations[si] = relocations;
-        memset(relocations, 0, relocation_count * sizeof(BarfRelocation));
-        // sec->relocation_offset = section->PointerToRelocations;
-
-        for (int ri=0;ri<rel_section->sh_size / rel_section->sh_entsize;ri++) {
-            Elf64_Rel* relocation = (Elf64_Rel*)(data + rel_section->sh_offset + ri * rel_section->sh_entsize);
-            BarfRelocation* rel = &relocations[sec->relocation_count];
-
-            uint32_t rel_sym_index = ELF64_R_SYM(relocation->r_info);
-            uint32_t rel_type = ELF64_R_TYPE(relocation->r_info);
+        u64 rel_count  = rel_section ? rel_section->sh_size / sizeof(Elf64_Rel) : 0;
+        u64 rela_count = rela_section ? rela_section->sh_size / sizeof(Elf64_Rela) : 0;
 
-            u32 symbol_index = symbol_infos[rel_sym_index].symbol_index;
+        BarfRelocation* relocations = arena_alloc(arena, (rel_count + rela_count) * sizeof(BarfRelocation));
+        if (!relocations) {
+            log_error("barf: arena_alloc failed, when converting '%s'\n", path);
+            goto cleanup;
+        }
+        object->relocations[section_info->section_index] = relocations;
+
+        for (u64 ri = 0; ri < rela_count + rel_count; ri++) {
+            u64 r_offset;
+            u64 r_info;
+            i64 r_addend = 0; // REL keeps the addend in the field, the loader adds to it
+            if (ri < rela_count) {
+                Elf64_Rela* relocation = (Elf64_Rela*)(data + rela_section->sh_offset) + ri;
+                r_offset = relocation->r_offset;
+                r_info   = relocation->r_info;
+                r_addend = relocation->r_addend;
+            } else {
+                Elf64_Rel* relocation = (Elf64_Rel*)(data + rel_section->sh_offset) + (ri - rela_count);
+                r_offset = relocation->r_offset;
+                r_info   = relocation->r_info;
+            }
 
-            BarfSymbol* symbol = &object->symbols[symbol_index];
-            const char* name = object->strings + symbol->string_offset;
+            uint32_t rel_sym_index = ELF64_R_SYM(r_info);
+            uint32_t rel_type = ELF64_R_TYPE(r_info);
+
+            BarfRelocationType type;
+            switch (rel_type) {
+                case R_X86_64_NONE:          continue;
+                case R_X86_64_PC32:
+                case R_X86_64_PLT32:         type = BARF_RELOC_REL32;         break;
+                case R_X86_64_64:            type = BARF_RELOC_ABS64;         break;
+                case R_X86_64_32:            type = BARF_RELOC_ABS32;         break;
+                case R_X86_64_32S:           type = BARF_RELOC_ABS32S;        break;
+                case R_X86_64_GOTPCREL:      type = BARF_RELOC_GOTPCREL;      break;
+                case R_X86_64_GOTPCRELX:     type = BARF_RELOC_GOTPCRELX;     break;
+                case R_X86_64_REX_GOTPCRELX: type = BARF_RELOC_REX_GOTPCRELX; break;
+                default:
+                    log_warning("barf: Unhandled ELF relocation type %u at %s+0x%x, '%s'\n", rel_type, sec->name, (u32)r_offset, path);
+                    continue;
+            }
 
-            if (rel_type == R_X86_64_PC32) {
-                rel->type = BARF_RELOC_REL32;
-                rel->symbol_index = symbol_index;
-                rel->offset = relocation->r_offset;
-                sec->relocation_count++;
-            }else if (rel_type == R_X86_64_PLT32) {
-                rel->type = BARF_RELOC_REL32;
-                rel->symbol_index = symbol_index;
-                rel->offset = relocation->r_offset;
-                sec->relocation_count++;
-            } else {
-                // @TODO What to do with this?
-                // log_warning("barf: Unhandled coff reloc type %d, sym index %u\n", relocation->Type, symbol_index);
+            if (rel_sym_index >= symbol_count || symbol_infos[rel_sym_index].symbol_index == -1) {
+                log_warning("barf: Relocation at %s+0x%x refers to a symbol that wasn't converted, '%s'\n", sec->name, (u32)r_offset, path);
+                continue;
             }
+
+            BarfRelocation* rel = &relocations[sec->relocation_count];
+            rel->type = type;
+            rel->symbol_index = symbol_infos[rel_sym_index].symbol_index;
+            rel->offset = r_offset;
+            rel->addend = r_addend;
+            sec->relocation_count++;
         }
     }
 
     // barf_dump(object);
-    
-    file = fs__open(output, FS_WRITE);
+
+    if (!barf_map_section_data(object, path, arena))
+        goto cleanup;
+    return object;
+
+cleanup:
+    if (!IS_INVALID_FS_HANDLE(file))
+        fs__close(file);
+    fs__unmap(data, dataSize);
+    return NULL;
+}
+
+static bool barf_write_object(BarfObject* object, const char* output) {
+    FSHandle file = fs__open(output, FS_WRITE);
     if (IS_INVALID_FS_HANDLE(file)) {
         log_error("barf: Could not open '%s'\n", output);
-        goto cleanup;
+        return false;
     }
 
     u64 size_of_symbols = sizeof(*object->symbols) * object->header.symbol_count;
@@ -826,6 +1029,10 @@ bool barf_convert_from_elf(const char* path, const char* output) {
     
     u64 next_section_data_offset = sizeof(object->header) + size_of_sections + size_of_symbols + object->header.string_size;
 
+    // Section data is read front to back from here on
+    if (object->mapping)
+        fs__advise(object->mapping, object->mapping_size, FS_MAP_SEQUENTIAL);
+
     for (int i = 0; i < object->header.section_count; i++) {
         BarfSection* section = &object->sections[i];
 
@@ -833,7 +1040,9 @@ bool barf_convert_from_elf(const char* path, const char* output) {
 
         u64 new_offset = next_section_data_offset;
 
-        fs__write(file, next_section_data_offset, data + section->data_offset, section->data_size);
+        // Zeroed sections have no data, the output leaves a hole
+        if (object->section_data[i])
+            fs__write(file, next_section_data_offset, object->section_data[i], section->data_size);
 
         next_section_data_offset += section->data_size;
 
@@ -852,7 +1061,7 @@ bool barf_convert_from_elf(const char* path, const char* output) {
     
     object->header.total_size = next_section_data_offset;
 
-    fs_head = 0;
+    u64 fs_head = 0;
     file_write(file, &fs_head, &object->header, sizeof(object->header));
 
     file_write(file, &fs_head, object->sections, sizeof(*object->sections) * object->header.section_count);
@@ -861,33 +1070,599 @@ bool barf_convert_from_elf(const char* path, const char* output) {
     
     file_write(file, &fs_head, object->strings, object->header.string_size);
     fs__close(file);
-    mem__alloc(0, object);
     return true;
+}
 
-cleanup:
-    if (file)
-        fs__close(file);
-    if (object)
-        mem__alloc(0, object);
-    if (data)
-        mem__alloc(0, data);
-    return false;
+static bool barf_convert(const char* path, const char* output, BarfObject* (*convert)(const char* path, Arena* arena)) {
+    // All memory of the conversion comes from the arena and is freed at once.
+    Arena* arena = arena_create();
+    if (!arena) {
+        log_error("barf: arena_create failed, when converting '%s'\n", path);
+        return false;
+    }
+    BarfObject* object = convert(path, arena);
+    bool res = object && barf_write_object(object, output);
+    barf_unmap_object(object);
+    arena_destroy(arena);
+    return res;
+}
+
+bool barf_convert_from_coff(const char* path, const char* output) {
+    return barf_convert(path, output, barf_object_from_coff);
+}
+
+bool barf_convert_from_elf(const char* path, const char* output) {
+    return barf_convert(path, output, barf_object_from_elf);
+}
+
+// '<input without extension>~.ba', next to the input
+static const char* barf_converted_path(const char* input, Arena* arena) {
+    int input_len = strlen(input);
+    int dot = input_len-1;
+    while (dot > 0 && input[dot] != '.') dot--;
+    if (dot > 0)
+        input_len = dot;
+    int ba_path_size = input_len + sizeof("~.ba");
+    char* ba_path = arena_alloc(arena, ba_path_size);
+    if (!ba_path)
+        return NULL;
+    snprintf(ba_path, ba_path_size, "%.*s~.ba", input_len, input);
+    // @TODO ba_path should be in temporary 'int' directory. Same directory
+    //   as the object files will work for now.
+    return ba_path;
+}
+
+// Inputs are converted and parsed by a pool of threads, each thread takes the next
+// unclaimed input. Results go to the slot of the input so the merge sees them in
+// command line order no matter which thread finished first.
+typedef struct {
+    int          input_count;
+    const char** input_files;
+    BarfObject** objects;
+    bool         write_converted;
+    u32          next_input;
+} CombineWork;
+
+typedef struct {
+    CombineWork* work;
+    Arena*       arena;  // objects parsed by this thread
+    Thread*      thread; // NULL for the calling thread
+} CombineWorker;
+
+static void combine_worker(void* arg) {
+    CombineWorker* worker = arg;
+    CombineWork*   work   = worker->work;
+    while (true) {
+        u32 i = __atomic_fetch_add(&work->next_input, 1, __ATOMIC_RELAXED);
+        if (i >= work->input_count)
+            break;
+
+        // Converted objects go straight to the merge, section data stays in
+        // the mapping of the input until the output is written.
+        const char* input = work->input_files[i];
+        BarfObject* object;
+        object = barf_object_from_coff(input, worker->arena);
+        if (!object)
+            object = barf_object_from_elf(input, worker->arena);
+        if (object && work->write_converted) {
+            // Rewrites the offsets of the object, the merge only uses section_data
+            const char* ba_path = barf_converted_path(input, worker->arena);
+            if (ba_path)
+                barf_write_object(object, ba_path);
+            else
+                log_error("barf: arena_alloc failed, when converting '%s'\n", input);
+        }
+        if (!object)
+            object = barf_object_from_ba(input, worker->arena);
+
+        // NULL on failure, already printed error
+        work->objects[i] = object;
+    }
+}
+
+static void combine_destroy_workers(CombineWorker* workers, int count, BarfObject** objects, int input_count) {
+    for (int i = 0; objects && i < input_count; i++)
+        barf_unmap_object(objects[i]);
+    for (int i = 0; workers && i < count; i++)
+        arena_destroy(workers[i].arena);
+}
+
+// Global and external symbols of the merged object by name (and merged sections
+// by name and flags). Open addressing with linear probing, the table is sized up
+// front for every symbol of the inputs so it never grows. A slot holds the hash
+// and index + 1, 0 is free.
+typedef struct {
+    u32  hash;
+    u32  index_plus_one;
+} SymbolSlot;
+
+typedef struct {
+    SymbolSlot* slots;
+    u32         mask;
+} SymbolMap;
+
+static u32 symbol_hash(const char* name) {
+    // FNV-1a
+    u32 hash = 2166136261u;
+    for (; *name; name++)
+        hash = (hash ^ (u8)*name) * 16777619u;
+    return hash;
+}
+
+static bool symbol_map_init(SymbolMap* map, u32 max_count, Arena* arena) {
+    u32 capacity = 16;
+    while (capacity < max_count * 2)
+        capacity *= 2;
+    map->mask  = capacity - 1;
+    map->slots = arena_alloc(arena, sizeof(SymbolSlot) * capacity);
+    return map->slots != NULL;
+}
+
+// Slot number 'probe' of the ones 'hash' may be in, a lookup stops at a free slot
+static SymbolSlot* symbol_map_slot(SymbolMap* map, u32 hash, u32 probe) {
+    return &map->slots[(hash + probe) & map->mask];
+}
+
+// Returns the slot holding 'name' or the free slot where it belongs
+static SymbolSlot* symbol_map_find(SymbolMap* map, BarfObject* merged, const char* name, u32 hash) {
+    for (u32 probe = 0; ; probe++) {
+        SymbolSlot* slot = symbol_map_slot(map, hash, probe);
+        if (!slot->index_plus_one)
+            return slot;
+        if (slot->hash == hash && !strcmp(name, merged->strings + merged->symbols[slot->index_plus_one - 1].string_offset))
+            return slot;
+    }
+}
+
+// Returns the slot holding the merged section with the name, flags and entry size
+// of 'section' or the free slot where it belongs
+static SymbolSlot* section_map_find(SymbolMap* map, BarfObject* merged, BarfSection* section, u32 hash) {
+    for (u32 probe = 0; ; probe++) {
+        SymbolSlot* slot = symbol_map_slot(map, hash, probe);
+        if (!slot->index_plus_one)
+            return slot;
+        BarfSection* merged_section = &merged->sections[slot->index_plus_one - 1];
+        if (slot->hash == hash && merged_section->flags == section->flags && merged_section->entry_size == section->entry_size
+            && !strcmp(section->name, merged_section->name))
+            return slot;
+    }
+}
+
+// Returns the slot holding the first input section of the group 'name' or the
+// free slot where it belongs
+static SymbolSlot* group_map_find(SymbolMap* map, const char** group_names, const char* name, u32 hash) {
+    for (u32 probe = 0; ; probe++) {
+        SymbolSlot* slot = symbol_map_slot(map, hash, probe);
+        if (!slot->index_plus_one)
+            return slot;
+        if (slot->hash == hash && !strcmp(name, group_names[slot->index_plus_one - 1]))
+            return slot;
+    }
+}
+
+// Orders strings by their reversed bytes given their ends, a string sorts
+// right before the strings it is a tail of.
+static int compare_reversed(const char* a_end, u32 a_len, const char* b_end, u32 b_len) {
+    u32 len = a_len < b_len ? a_len : b_len;
+    for (u32 i = 1; i <= len; i++) {
+        u8 x = a_end[-(i64)i], y = b_end[-(i64)i];
+        if (x != y)
+            return x < y ? -1 : 1;
+    }
+    return a_len < b_len ? -1 : a_len > b_len ? 1 : 0;
+}
+
+// Rebuilds merged->strings with each name once. A name that is the tail of
+// another ("printf" of "log__printf") points into it instead of being stored.
+static bool barf_pack_strings(BarfObject* merged, Arena* arena) {
+    // Every string offset in the object, symbol names and then group names
+    u32 count = merged->header.symbol_count;
+    for (u32 i = 0; i < merged->header.section_count; i++) {
+        if (merged->sections[i].flags & BARF_FLAG_GROUP)
+            count++;
+    }
+    if (count == 0)
+        return true;
+
+    // By reference: the first reference to the same name and the new offset
+    // (only set for first references).
+    SymbolMap map;
+    u32** refs   = arena_alloc(arena, sizeof(u32*) * count);
+    u32*  first   = arena_alloc(arena, sizeof(u32) * count);
+    u32*  offsets = arena_alloc(arena, sizeof(u32) * count);
+    // Names to sort, one per first reference, and a buffer to sort them
+    typedef struct {
+        const char* end; // of the name, compared backwards
+        u32         length;
+        u32         ref_index;
+    } Name;
+    Name* unique  = arena_alloc(arena, sizeof(Name) * count);
+    Name* buffer  = arena_alloc(arena, sizeof(Name) * count);
+    char* strings = arena_alloc(arena, merged->header.string_size);
+    if (!refs || !first || !offsets || !unique || !buffer || !strings || !symbol_map_init(&map, count, arena))
+        return false;
+
+    u32 ref_count = 0;
+    for (u32 i = 0; i < merged->header.symbol_count; i++)
+        refs[ref_count++] = &merged->symbols[i].string_offset;
+    for (u32 i = 0; i < merged->header.section_count; i++) {
+        if (merged->sections[i].flags & BARF_FLAG_GROUP)
+            refs[ref_count++] = &merged->sections[i].group;
+    }
+
+    u32 unique_count = 0;
+    for (u32 i = 0; i < count; i++) {
+        const char* name = merged->strings + *refs[i];
+        u32 hash = symbol_hash(name);
+        SymbolSlot* slot;
+        for (u32 probe = 0; ; probe++) {
+            slot = symbol_map_slot(&map, hash, probe);
+            if (!slot->index_plus_one || (slot->hash == hash && !strcmp(name, merged->strings + *refs[slot->index_plus_one - 1])))
+                break;
+        }
+        if (!slot->index_plus_one) {
+            slot->hash = hash;
+            slot->index_plus_one = i + 1;
+            u32 len = strlen(name);
+            unique[unique_count++] = (Name){ name + len, len, i };
+        }
+        first[i] = slot->index_plus_one - 1;
+    }
+
+    // Bottom-up merge sort by reversed bytes, a name ends up right before
+    // the names it is a tail of.
+    Name* from = unique;
+    Name* to   = buffer;
+    for (u32 width = 1; width < unique_count; width *= 2) {
+        for (u32 lo = 0; lo < unique_count; lo += 2 * width) {
+            u32 mid = lo + width     < unique_count ? lo + width     : unique_count;
+            u32 hi  = lo + 2 * width < unique_count ? lo + 2 * width : unique_count;
+            u32 a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                if (compare_reversed(from[a].end, from[a].length, from[b].end, from[b].length) <= 0)
+                    to[k++] = from[a++];
+                else
+                    to[k++] = from[b++];
+            }
+            while (a < mid) to[k++] = from[a++];
+            while (b < hi)  to[k++] = from[b++];
+        }
+        Name* tmp = from; from = to; to = tmp;
+    }
+
+    // Walk from the back so the longest name of a tail chain is stored first
+    u32   string_size = 0;
+    Name* prev        = NULL;
+    for (u32 k = unique_count; k-- > 0;) {
+        Name* name = &from[k];
+        u32   si   = name->ref_index;
+        if (prev && name->length <= prev->length && !memcmp(prev->end - name->length, name->end - name->length, name->length)) {
+            offsets[si] = offsets[prev->ref_index] + prev->length - name->length;
+        } else {
+            offsets[si] = string_size;
+            memcpy(strings + string_size, name->end - name->length, name->length + 1);
+            string_size += name->length + 1;
+        }
+        prev = name;
+    }
+
+    for (u32 i = 0; i < count; i++)
+        *refs[i] = offsets[first[i]];
+    merged->strings = strings;
+    merged->header.string_size = string_size;
+    return true;
+}
+
+// Marks the input sections reachable through relocations from ba_entry, the kept
+// symbols and .refptr sections (pointers MinGW code loads symbols through) and
+// the symbols the relocations of those sections refer to. Returns 0 if
+// there is no root, -1 if out of memory.
+static int combine_mark_live(BarfObject* merged, SymbolMap* symbol_map, const BarfCombineOptions* options,
+                             BarfSection** input_sections, BarfRelocation** input_relocations, int section_count,
+                             u8* live, u8* symbol_used, Arena* arena) {
+    u32* stack = arena_alloc(arena, section_count * sizeof(u32));
+    u32  stack_len = 0;
+    if (!stack)
+        return -1;
+    #define MARK_SECTION(I) do { u32 _i = (I); if (!live[_i]) { live[_i] = 1; stack[stack_len++] = _i; } } while (0)
+
+    for (int i = -1; i < options->keep_count; i++) {
+        const char* name = i == -1 ? "ba_entry" : options->keep_symbols[i];
+        SymbolSlot* slot = symbol_map_find(symbol_map, merged, name, symbol_hash(name));
+        BarfSymbol* symbol = slot->index_plus_one ? &merged->symbols[slot->index_plus_one - 1] : NULL;
+        if (!symbol || symbol->type != BARF_SYMBOL_GLOBAL) {
+            if (i != -1)
+                log_warning("barf: Kept symbol '%s' is not defined\n", name);
+            continue;
+        }
+        MARK_SECTION(symbol->section_index);
+    }
+    for (int i = 0; i < section_count; i++) {
+        if (strstr(input_sections[i]->name, ".refptr"))
+            MARK_SECTION(i);
+    }
+    if (stack_len == 0)
+        return 0;
+
+    while (stack_len > 0) {
+        u32 fi = stack[--stack_len];
+        for (u32 ri = 0; ri < input_sections[fi]->relocation_count; ri++) {
+            u32 symbol_index = input_relocations[fi][ri].symbol_index;
+            BarfSymbol* symbol = &merged->symbols[symbol_index];
+            symbol_used[symbol_index] = 1;
+            if (symbol->type != BARF_SYMBOL_EXTERNAL)
+                MARK_SECTION(symbol->section_index);
+        }
+    }
+    #undef MARK_SECTION
+    return 1;
+}
+
+static u32 hash_bytes(u32 hash, const void* data, u64 size) {
+    // FNV-1a
+    const u8* bytes = data;
+    for (u64 i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+// Identical code folding. Read-only code sections with equal bytes and relocations
+// to equivalent targets are folded into the first of them. Targets are compared by
+// class, classes start out from the bytes and are split until they stop changing,
+// so functions calling each other fold as a group. 'folded_into' gets the section
+// each one is replaced by, folded sections are no longer live.
+// Returns the number of folded sections, -1 if out of memory.
+static int combine_fold_identical(BarfObject* merged, BarfSection** input_sections, char** input_data, BarfRelocation** input_relocations,
+                                  int section_count, u8* live, u32* folded_into, u64* folded_bytes, Arena* arena) {
+    u32* candidates   = arena_alloc(arena, section_count * sizeof(u32));
+    u32* static_hash  = arena_alloc(arena, section_count * sizeof(u32));
+    u32* classes      = arena_alloc(arena, section_count * sizeof(u32));
+    u32* next_classes = arena_alloc(arena, section_count * sizeof(u32));
+    u32  candidate_count = 0;
+    if (!candidates || !static_hash || !classes || !next_classes)
+        return -1;
+    for (int i = 0; i < section_count; i++) {
+        BarfSection* section = input_sections[i];
+        classes[i] = next_classes[i] = i;
+        if (!live[i] || !input_data[i] || !(section->flags & BARF_FLAG_EXEC) || (section->flags & (BARF_FLAG_WRITE|BARF_FLAG_IGNORE|BARF_FLAG_ZEROED)))
+            continue;
+        u32 hash = hash_bytes(2166136261u, &section->flags, sizeof(section->flags));
+        hash = hash_bytes(hash, &section->data_size, sizeof(section->data_size));
+        hash = hash_bytes(hash, &section->relocation_count, sizeof(section->relocation_count));
+        hash = hash_bytes(hash, input_data[i], section->data_size);
+        for (u32 ri = 0; ri < section->relocation_count; ri++) {
+            BarfRelocation* rel = &input_relocations[i][ri];
+            hash = hash_bytes(hash, &rel->type, sizeof(rel->type));
+            hash = hash_bytes(hash, &rel->offset, sizeof(rel->offset));
+            hash = hash_bytes(hash, &rel->addend, sizeof(rel->addend));
+        }
+        static_hash[i] = hash;
+        candidates[candidate_count++] = i;
+    }
+    if (candidate_count < 2)
+        return 0;
+
+    SymbolMap map;
+    if (!symbol_map_init(&map, candidate_count, arena))
+        return -1;
+
+    // Round 0 groups by bytes and relocations, later rounds also by the classes
+    // of relocation targets from the round before.
+    u32 class_count = 0;
+    for (int round = 0; ; round++) {
+        memset(map.slots, 0, sizeof(SymbolSlot) * (map.mask + 1));
+        u32 new_class_count = 0;
+        for (u32 c = 0; c < candidate_count; c++) {
+            u32 i = candidates[c];
+            BarfSection* section = input_sections[i];
+            u32 hash = static_hash[i];
+            if (round > 0) {
+                hash = hash_bytes(hash, &classes[i], sizeof(u32));
+                for (u32 ri = 0; ri < section->relocation_count; ri++) {
+                    BarfSymbol* target = &merged->symbols[input_relocations[i][ri].symbol_index];
+                    u32 target_class = target->type == BARF_SYMBOL_EXTERNAL ? ~input_relocations[i][ri].symbol_index : classes[target->section_index];
+                    hash = hash_bytes(hash, &target_class, sizeof(u32));
+                    hash = hash_bytes(hash, &target->offset, sizeof(u32));
+                }
+            }
+
+            SymbolSlot* slot;
+            for (u32 probe = 0; ; probe++) {
+                slot = symbol_map_slot(&map, hash, probe);
+                if (!slot->index_plus_one)
+                    break;
+                if (slot->hash != hash)
+                    continue;
+                u32 j = slot->index_plus_one - 1;
+                BarfSection* other = input_sections[j];
+                bool equal = section->flags == other->flags && section->data_size == other->data_size
+                    && section->relocation_count == other->relocation_count;
+                if (equal && round == 0)
+                    equal = !memcmp(input_data[i], input_data[j], section->data_size);
+                if (equal && round > 0)
+                    equal = classes[i] == classes[j];
+                for (u32 ri = 0; equal && ri < section->relocation_count; ri++) {
+                    BarfRelocation* a = &input_relocations[i][ri];
+                    BarfRelocation* b = &input_relocations[j][ri];
+                    equal = a->type == b->type && a->offset == b->offset && a->addend == b->addend;
+                    if (equal && round > 0) {
+                        BarfSymbol* ta = &merged->symbols[a->symbol_index];
+                        BarfSymbol* tb = &merged->symbols[b->symbol_index];
+                        if (ta->type == BARF_SYMBOL_EXTERNAL || tb->type == BARF_SYMBOL_EXTERNAL)
+                            equal = a->symbol_index == b->symbol_index;
+                        else
+                            equal = classes[ta->section_index] == classes[tb->section_index] && ta->offset == tb->offset;
+                    }
+                }
+                if (equal)
+                    break;
+            }
+            if (slot->index_plus_one) {
+                next_classes[i] = slot->index_plus_one - 1;
+            } else {
+                slot->hash = hash;
+                slot->index_plus_one = i + 1;
+                next_classes[i] = i;
+                new_class_count++;
+            }
+        }
+        for (u32 c = 0; c < candidate_count; c++)
+            classes[candidates[c]] = next_classes[candidates[c]];
+        // Classes only ever split, the same count means nothing changed
+        if (round > 0 && new_class_count == class_count)
+            break;
+        class_count = new_class_count;
+    }
+
+    int folded = 0;
+    for (u32 c = 0; c < candidate_count; c++) {
+        u32 i = candidates[c];
+        if (classes[i] == i)
+            continue;
+        folded_into[i] = classes[i];
+        live[i] = 0;
+        *folded_bytes += input_sections[i]->data_size;
+        folded++;
+    }
+    return folded;
+}
+
+// An entry of a mergeable section, a string or a constant
+typedef struct {
+    u32 section; // input section number
+    u32 offset;  // in the input section
+    u32 size;
+    u32 output;  // offset in the output section, of the shared copy for duplicates
+} MergeEntry;
+
+// Splits live mergeable sections into their entries, 'first_entry' and 'entry_count'
+// get the entries of each input section. Sections with relocations or a size that
+// isn't a multiple of the entry size are not split and have no entries.
+static MergeEntry* combine_split_entries(BarfSection** input_sections, char** input_data, int section_count, u8* live,
+                                         u32* first_entry, u32* entry_count, u32* total, Arena* arena) {
+    MergeEntry* entries = NULL;
+    // Count, then split
+    for (int pass = 0; pass < 2; pass++) {
+        u32 next = 0;
+        for (int fi = 0; fi < section_count; fi++) {
+            BarfSection* section = input_sections[fi];
+            u64 size = section->data_size;
+            u32 entry_size = section->entry_size;
+            if (!live[fi] || !input_data[fi] || !(section->flags & BARF_FLAG_MERGE) || entry_size == 0
+                || (section->flags & (BARF_FLAG_WRITE|BARF_FLAG_EXEC|BARF_FLAG_ZEROED|BARF_FLAG_IGNORE|BARF_FLAG_GROUP))
+                || section->relocation_count > 0 || size % entry_size != 0 || size > 0xFFFFFFFFull)
+                continue;
+
+            first_entry[fi] = next;
+            for (u64 offset = 0; offset < size;) {
+                u64 end = offset + entry_size;
+                if (section->flags & BARF_FLAG_STRINGS) {
+                    // Up to and including the terminator
+                    for (;; end += entry_size) {
+                        const char* c = input_data[fi] + end - entry_size;
+                        u32 zero = 0;
+                        while (zero < entry_size && c[zero] == 0)
+                            zero++;
+                        if (zero == entry_size || end == size)
+                            break;
+                    }
+                }
+                if (pass == 1)
+                    entries[next] = (MergeEntry){ fi, offset, end - offset, 0 };
+                next++;
+                offset = end;
+            }
+            entry_count[fi] = next - first_entry[fi];
+        }
+        if (pass == 0) {
+            *total = next;
+            if (next == 0)
+                return NULL;
+            // NULL with a nonzero total when out of memory
+            entries = arena_alloc(arena, next * sizeof(MergeEntry));
+            if (!entries)
+                return NULL;
+        }
+    }
+    return entries;
+}
+
+// Lays out the entries in their output sections, equal entries of an output section
+// share the first copy. The data of the output sections is put in 'output_data'.
+static bool combine_merge_entries(BarfObject* merged, BarfSection** input_sections, char** input_data, int* section_mapping,
+                                  MergeEntry* entries, u32 count, char** output_data, int* shared, u64* shared_bytes, Arena* arena) {
+    SymbolMap map;
+    if (!symbol_map_init(&map, count, arena))
+        return false;
+    for (u32 i = 0; i < count; i++) {
+        MergeEntry*  entry = &entries[i];
+        const char*  data  = input_data[entry->section] + entry->offset;
+        int          msi   = section_mapping[entry->section];
+        u16          alignment = input_sections[entry->section]->alignment ? input_sections[entry->section]->alignment : 1;
+        u32 hash = hash_bytes(2166136261u, &msi, sizeof(msi));
+        hash = hash_bytes(hash, &alignment, sizeof(alignment));
+        hash = hash_bytes(hash, data, entry->size);
+        SymbolSlot* slot;
+        for (u32 probe = 0; ; probe++) {
+            slot = symbol_map_slot(&map, hash, probe);
+            if (!slot->index_plus_one)
+                break;
+            MergeEntry* other = &entries[slot->index_plus_one - 1];
+            if (slot->hash == hash && other->size == entry->size && section_mapping[other->section] == msi
+                && input_sections[other->section]->alignment == input_sections[entry->section]->alignment
+                && !memcmp(data, input_data[other->section] + other->offset, entry->size))
+                break;
+        }
+        if (slot->index_plus_one) {
+            entry->output = entries[slot->index_plus_one - 1].output;
+            *shared_bytes += entry->size;
+            (*shared)++;
+            continue;
+        }
+        // Each entry keeps the alignment of its input section
+        BarfSection* section = &merged->sections[msi];
+        u64 offset = section->data_size;
+        offset += (alignment - (offset % alignment)) % alignment;
+        if (offset + entry->size > 0xFFFFFFFFull) {
+            // Symbol and relocation offsets are 32-bit
+            log_error("barf: Merged section '%s' would be larger than 4 GB\n", section->name);
+            return false;
+        }
+        entry->output = offset;
+        section->data_size = offset + entry->size;
+        slot->hash = hash;
+        slot->index_plus_one = i + 1;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        MergeEntry* entry = &entries[i];
+        int msi = section_mapping[entry->section];
+        if (!output_data[msi]) {
+            output_data[msi] = arena_alloc(arena, merged->sections[msi].data_size);
+            if (!output_data[msi])
+                return false;
+        }
+        // Duplicates copy the same bytes again
+        memcpy(output_data[msi] + entry->output, input_data[entry->section] + entry->offset, entry->size);
+    }
+    return true;
 }
 
-void transfer_bytes(FSHandle input, u64 in_offset, FSHandle output, u64 out_offset, u64 size) {
-    #define TRANSFER_BUFFER_SIZE 4096
-    static char buffer[TRANSFER_BUFFER_SIZE];
-    while (size > 0) {
-        u64 chunk_size = size < TRANSFER_BUFFER_SIZE ? size : TRANSFER_BUFFER_SIZE;
-        size_t read_bytes = fs__read(input, in_offset, buffer, chunk_size);
-        ASSERT(read_bytes == chunk_size);
-        size_t written_bytes = fs__write(output, out_offset, buffer, chunk_size);
-        ASSERT(written_bytes == chunk_size);
-        size -= chunk_size;
+// Offset in the output section of 'offset' in an input section split into
+// the 'count' entries at 'first'
+static u32 merge_entry_offset(MergeEntry* entries, u32 first, u32 count, u64 offset) {
+    u32 lo = first, hi = first + count - 1;
+    while (lo < hi) {
+        u32 mid = lo + (hi - lo + 1) / 2;
+        if (entries[mid].offset <= offset)
+            lo = mid;
+        else
+            hi = mid - 1;
     }
+    return entries[lo].output + (offset - entries[lo].offset);
 }
 
-bool barf_combine_to_artifact(int input_count, const char** input_files, const char* output) {
+bool barf_combine_to_artifact(int input_count, const char** input_files, const char* output, const BarfCombineOptions* options) {
     // FILE*       file   = NULL;
     // u8*         data   = NULL;
     // BarfObject* object = NULL;
@@ -905,43 +1680,55 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
 
     // then combine all BA files into one
 
-    int    ba_path_text_cap = 0x10000;
-    int    ba_path_text_len = 0;
-    char*  ba_path_text     = mem__alloc(ba_path_text_cap, NULL);
-    const char** ba_paths   = mem__alloc(sizeof(char*) * input_count, NULL);
-
-    for (int i=0;i<input_count;i++) {
-        const char* input = input_files[i];
-        char* ba_path = ba_path_text + ba_path_text_len;
-        ba_paths[i] = ba_path;
-        int input_len = strlen(input);
-        int dot = input_len-1;
-        while (dot > 0 && input[dot] != '.') dot--;
-        if (dot != -1)
-            input_len -= input_len - dot;
-        ba_path_text_len += 1 + snprintf(ba_path, ba_path_text_cap - ba_path_text_len, "%.*s~.ba", input_len, input);
-
-        // @TODO ba_path should be in temporary 'int' directory. Same directory
-        //   as the object files will work for now.
-        // @TODO If we want to be professional then we might want to handle
-        //   duplicate input, collision with some elf file being named the same as a barf file.
-
-        bool res;
-        res = barf_convert_from_coff(input, ba_path);
-        if (!res)
-            res = barf_convert_from_elf(input, ba_path);
-        if (!res)
-            ba_paths[i] = input;
-    }
-
-    BarfObject** objects = mem__alloc(sizeof(BarfObject*) * input_count, NULL);
+    // Metadata of the whole combine (paths, mappings, merged object) comes from
+    // one arena and is freed at once. Parsed objects come from an arena per thread.
+    BarfObject*    merged       = NULL;
+    BarfObject**   objects      = NULL;
+    CombineWorker* workers      = NULL;
+    int            thread_count = 0;
+    FSHandle       file         = FS_INVALID_HANDLE;
+    Arena*       arena    = arena_create();
+    if (!arena) {
+        log_error("barf: arena_create failed, when combining '%s'\n", output);
+        return false;
+    }
+
+    objects = arena_alloc(arena, sizeof(BarfObject*) * input_count);
+
+    thread_count = options ? options->thread_count : 0;
+    if (thread_count <= 0) {
+        CPUInfo cpu;
+        cpu__info(&cpu);
+        thread_count = cpu.logical_cores;
+    }
+    if (thread_count > input_count)
+        thread_count = input_count;
+
+    CombineWork work = { input_count, input_files, objects, options && options->write_converted, 0 };
+    workers = arena_alloc(arena, sizeof(CombineWorker) * thread_count);
+    for (int i = 0; i < thread_count; i++) {
+        workers[i].work  = &work;
+        workers[i].arena = arena_create();
+        if (!workers[i].arena) {
+            log_error("barf: arena_create failed, when combining '%s'\n", output);
+            goto cleanup;
+        }
+    }
+    for (int i = 1; i < thread_count; i++) {
+        // Fewer threads if one can't be started, the rest picks up the work
+        workers[i].thread = thread__create(combine_worker, &workers[i]);
+    }
+    combine_worker(&workers[0]);
+    for (int i = 1; i < thread_count; i++) {
+        if (workers[i].thread)
+            thread__join(workers[i].thread);
+    }
 
     int estimated_symbol_count = 0;
     int estimated_section_count = 0;
     int estimated_string_size = 0;
 
     for (int i=0; i<input_count;i++) {
-        objects[i] = barf_parse_header_from_file(ba_paths[i]);
         if (!objects[i]) {
             // already printed error
             goto cleanup;
@@ -956,66 +1743,104 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
         estimated_section_count += objects[i]->header.section_count;
         estimated_symbol_count  += objects[i]->header.symbol_count;
         estimated_string_size   += objects[i]->header.string_size;
+        for (int si = 0; si < objects[i]->header.section_count; si++) {
+            // Group names are copied once per output section
+            BarfSection* section = &objects[i]->sections[si];
+            if (section->flags & BARF_FLAG_GROUP)
+                estimated_string_size += strlen(objects[i]->strings + section->group) + 1;
+        }
     }
 
-    BarfObject* merged = mem__alloc(sizeof(BarfObject), NULL);
-    memset(merged, 0, sizeof(*merged));
+    merged = arena_alloc(arena, sizeof(BarfObject));
+    if (!merged) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
     merged->header.magic = BARF_MAGIC;
-    merged->header.version = 1;
+    merged->header.version = BARF_FORMAT_VERSION;
     memcpy(merged->header.target, objects[0]->header.target, sizeof(merged->header.target));
     
-    merged->sections = mem__alloc(sizeof(BarfSection) * estimated_section_count, NULL);
-    memset(merged->sections, 0, sizeof(BarfSection) * estimated_section_count);
+    merged->sections = arena_alloc(arena, sizeof(BarfSection) * estimated_section_count);
     // merged->header.section_count = estimated_section_count;
    
-    merged->relocations = mem__alloc(sizeof(BarfRelocation*) * estimated_section_count, NULL);
-    memset(merged->relocations, 0, sizeof(BarfRelocation*) * estimated_section_count);
-
-    merged->strings = mem__alloc(estimated_string_size, NULL);
+    merged->relocations = arena_alloc(arena, sizeof(BarfRelocation*) * estimated_section_count);
 
-    // @TODO We have tons of memory leaks here. Fix 'em up
+    merged->strings = arena_alloc(arena, estimated_string_size);
 
-    // @TODO The same strings may exist in some artifacts, especially symbol names. (only symbol names use string data at the moment)
-    //    We could create string data from symbols names anew.
+    // Names are appended as symbols are merged and packed afterwards (barf_pack_strings)
 
-    int* string_mapping = heap_alloc(input_count * sizeof(int));
-    int** section_mapping = heap_alloc(input_count * sizeof(int*));
-    for (int oi=0; oi<input_count;oi++) {
-        BarfObject* object = objects[oi];
-
-        // string_mapping[oi] = merged->header.string_size;
-        // memcpy(merged->strings + merged->header.string_size, object->strings, object->header.string_size);
-        // merged->header.string_size += object->header.string_size;
-
-        section_mapping[oi] = heap_alloc(object->header.section_count * sizeof(int));
-
-        for (int si=0;si<object->header.section_count;si++) {
-            BarfSection* section = &object->sections[si];
-            
-            // Map [object index, section index] to [merged section index]
-            section_mapping[oi][si] = merged->header.section_count;
-
-            BarfSection* merged_section = &merged->sections[merged->header.section_count];
-            merged->header.section_count++;
-
-            memcpy(merged_section->name, section->name, sizeof(section->name));
-            merged_section->alignment = section->alignment;
-            merged_section->flags = section->flags;
-            merged_section->relocation_count = section->relocation_count;
-            merged_section->data_size = section->data_size;
+    // Input sections are numbered across inputs, [object index, section index]
+    // is first_section[object index] + section index. Merged symbols refer to
+    // input sections by that number until the output sections are known.
+    u32* first_section = arena_alloc(arena, input_count * sizeof(u32));
+    BarfSection** input_sections = arena_alloc(arena, estimated_section_count * sizeof(BarfSection*));
+    char** input_data = arena_alloc(arena, estimated_section_count * sizeof(char*));
+    if (!merged->sections || !merged->relocations || !merged->strings || !first_section || !input_sections || !input_data) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    for (int oi=0, next=0; oi<input_count;oi++) {
+        first_section[oi] = next;
+        for (int si=0;si<objects[oi]->header.section_count;si++) {
+            input_data[next] = objects[oi]->section_data[si];
+            input_sections[next++] = &objects[oi]->sections[si];
+        }
+    }
 
-            merged_section->data_offset = section->data_offset;
-            merged_section->relocation_offset = section->relocation_offset;
+    // Sections of a group an earlier input already has are discarded, the
+    // first group with a name is kept (COMDAT, inline functions and templates)
+    u8*          discarded   = arena_alloc(arena, estimated_section_count);
+    const char** group_names = arena_alloc(arena, estimated_section_count * sizeof(char*));
+    u64          discarded_bytes = 0;
+    int          discarded_count = 0;
+    SymbolMap group_map;
+    if (!discarded || !group_names || !symbol_map_init(&group_map, estimated_section_count, arena)) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    for (int oi = 0; oi < input_count; oi++) {
+        for (int si = 0; si < objects[oi]->header.section_count; si++) {
+            u32 fi = first_section[oi] + si;
+            BarfSection* section = input_sections[fi];
+            if (!(section->flags & BARF_FLAG_GROUP))
+                continue;
+            const char* name = objects[oi]->strings + section->group;
+            group_names[fi] = name;
+            u32 hash = symbol_hash(name);
+            SymbolSlot* slot = group_map_find(&group_map, group_names, name, hash);
+            if (!slot->index_plus_one) {
+                slot->hash = hash;
+                slot->index_plus_one = fi + 1;
+                continue;
+            }
+            u32 kept = slot->index_plus_one - 1;
+            if (kept >= first_section[oi])
+                // Another section of the kept group
+                continue;
+            if ((section->flags | input_sections[kept]->flags) & BARF_FLAG_GROUP_UNIQUE) {
+                log_error("barf: Duplicate group %s, cannot combine! (second here %s)\n", name, input_files[oi]);
+                goto cleanup;
+            }
+            discarded[fi] = 1;
+            discarded_bytes += section->data_size;
+            discarded_count++;
         }
     }
+    if (discarded_count > 0)
+        log__printf("barf: dropped %d duplicate group sections (%llu bytes)\n", discarded_count, (unsigned long long)discarded_bytes);
 
     // Create a map from [symbol index] to [merged symbol index]
 
     // Merge external and global symbols, symbols, merg
-    merged->symbols = heap_alloc(sizeof(BarfSymbol) * estimated_symbol_count);
-    memset(merged->symbols, 0, sizeof(BarfSymbol) * estimated_symbol_count);
+    merged->symbols = arena_alloc(arena, sizeof(BarfSymbol) * estimated_symbol_count);
 
-    int** symbol_mapping = heap_alloc(input_count * sizeof(int*));
+    int** symbol_mapping = arena_alloc(arena, input_count * sizeof(int*));
+
+    SymbolMap symbol_map;
+    if (!merged->symbols || !symbol_mapping || !symbol_map_init(&symbol_map, estimated_symbol_count, arena)) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
 
     // @TODO Consider separating local,external,global symbol lists so
     //  it's easier to merge, add and remove the different types.
@@ -1026,7 +1851,11 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
 
     for (int bi=0;bi<input_count;bi++) {
         BarfObject* object = objects[bi];
-        symbol_mapping[bi] = heap_alloc(object->header.symbol_count * sizeof(int));
+        symbol_mapping[bi] = arena_alloc(arena, object->header.symbol_count * sizeof(int));
+        if (!symbol_mapping[bi]) {
+            log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+            goto cleanup;
+        }
         memset(symbol_mapping[bi], 0xDE, object->header.symbol_count * sizeof(int));
 
         
@@ -1034,7 +1863,12 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
             BarfSymbol* symbol = &object->symbols[si];
             const char* name = object->strings + symbol->string_offset;
 
-            if (symbol->type == BARF_SYMBOL_LOCAL) {
+            BarfSymbolType type = symbol->type;
+            if (type == BARF_SYMBOL_GLOBAL && discarded[first_section[bi] + symbol->section_index])
+                // Defined in a discarded group, resolves to the kept copy
+                type = BARF_SYMBOL_EXTERNAL;
+
+            if (type == BARF_SYMBOL_LOCAL) {
                 // Local symbols never collide. The name is not relevant.
                 
                 symbol_mapping[bi][si] = merged->header.symbol_count;
@@ -1043,7 +1877,7 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
 
                 merged_symbol->type = BARF_SYMBOL_LOCAL;
                 merged_symbol->offset = symbol->offset;
-                merged_symbol->section_index = section_mapping[bi][symbol->section_index];
+                merged_symbol->section_index = first_section[bi] + symbol->section_index;
                 merged_symbol->string_offset = merged->header.string_size;
 
                 int len = strlen(name);
@@ -1053,29 +1887,17 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
                 // debug("local %s\n", merged->strings + merged_symbol->string_offset);
 
                 continue;
-            } else if (symbol->type == BARF_SYMBOL_EXTERNAL) {
+            } else if (type == BARF_SYMBOL_EXTERNAL) {
                 // Duplicate of external symbols can be removed.
                 // If there is a global symbol then external shall be removed in favour of the global.
 
-                // Look for external name, don't add if we have it (fix symbol mapping)
-                // Look for global name, don't add if we have it (fix symbol mapping)
-                bool found = false;
-                for (int i=0;i<merged->header.symbol_count;i++) {
-                    BarfSymbol* merged_symbol = &merged->symbols[i];
-                    char* merge_name = merged->strings + merged_symbol->string_offset;
-
-                    if (merged_symbol->type != BARF_SYMBOL_EXTERNAL && merged_symbol->type != BARF_SYMBOL_GLOBAL)
-                        continue;
-
-                    if (!strcmp(name, merge_name)) {
-                        symbol_mapping[bi][si] = i;
-                        found = true;
-                        break;
-                    }
-                }
-
-                if (found)
+                // Look for external or global name, don't add if we have it (fix symbol mapping)
+                u32 hash = symbol_hash(name);
+                SymbolSlot* slot = symbol_map_find(&symbol_map, merged, name, hash);
+                if (slot->index_plus_one) {
+                    symbol_mapping[bi][si] = slot->index_plus_one - 1;
                     continue;
+                }
 
                 // Otherwise add external symbol.
                 symbol_mapping[bi][si] = merged->header.symbol_count;
@@ -1086,43 +1908,36 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
                 merged_symbol->offset = symbol->offset;
                 merged_symbol->section_index = -1;
                 merged_symbol->string_offset = merged->header.string_size;
+                slot->hash = hash;
+                slot->index_plus_one = merged->header.symbol_count;
 
                 int len = strlen(name);
                 memcpy(merged->strings + merged_symbol->string_offset, name, len+1);
                 merged->header.string_size += len + 1;
                 // debug("external %d %s\n", merged->header.symbol_count-1, merged->strings + merged_symbol->string_offset);
 
-            } else if (symbol->type == BARF_SYMBOL_GLOBAL) {
+            } else if (type == BARF_SYMBOL_GLOBAL) {
                 // Duplicates are not allowed.
 
                 // Check if we already added symbol name, error if we did
                 // Check if we have external name with, if so replace it with global
-                bool found = false;
-                for (int i=0;i<merged->header.symbol_count;i++) {
+                u32 hash = symbol_hash(name);
+                SymbolSlot* slot = symbol_map_find(&symbol_map, merged, name, hash);
+                if (slot->index_plus_one) {
+                    int i = slot->index_plus_one - 1;
                     BarfSymbol* merged_symbol = &merged->symbols[i];
-                    char* merge_name = merged->strings + merged_symbol->string_offset;
-
                     if (merged_symbol->type == BARF_SYMBOL_GLOBAL) {
-                        if (!strcmp(name, merge_name)) {
-                            // @TODO Do a search in previous artifacts and find where the first symbol came from.
-                            //    Error message is better if we show the two artifacts that have colliding symbols.
-                            log_error("barf: Duplicate global symbol %s, cannot combine! (second here %s)\n", name, input_files[bi]);
-                            goto cleanup;
-                        }
-                    } else if (merged_symbol->type == BARF_SYMBOL_EXTERNAL) {
-                        if (!strcmp(name, merge_name)) {
-                            merged_symbol->type = BARF_SYMBOL_GLOBAL;
-                            merged_symbol->section_index = section_mapping[bi][symbol->section_index];
-                            merged_symbol->offset = symbol->offset;
-                            symbol_mapping[bi][si] = i;
-                            found = true;
-                            break;
-                        }
+                        // @TODO Do a search in previous artifacts and find where the first symbol came from.
+                        //    Error message is better if we show the two artifacts that have colliding symbols.
+                        log_error("barf: Duplicate global symbol %s, cannot combine! (second here %s)\n", name, input_files[bi]);
+                        goto cleanup;
                     }
-                }
-
-                if (found)
+                    merged_symbol->type = BARF_SYMBOL_GLOBAL;
+                    merged_symbol->section_index = first_section[bi] + symbol->section_index;
+                    merged_symbol->offset = symbol->offset;
+                    symbol_mapping[bi][si] = i;
                     continue;
+                }
 
                 // Otherwise add a new global symbol
                 symbol_mapping[bi][si] = merged->header.symbol_count;
@@ -1131,32 +1946,36 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
 
                 merged_symbol->type = BARF_SYMBOL_GLOBAL;
                 merged_symbol->offset = symbol->offset;
-                merged_symbol->section_index = section_mapping[bi][symbol->section_index];
+                merged_symbol->section_index = first_section[bi] + symbol->section_index;
                 merged_symbol->string_offset = merged->header.string_size;
+                slot->hash = hash;
+                slot->index_plus_one = merged->header.symbol_count;
 
-                ASSERT(merged_symbol->section_index >= 0 && merged_symbol->section_index < merged->header.symbol_count);
+                ASSERT(merged_symbol->section_index < estimated_section_count);
 
                 int len = strlen(name);
                 memcpy(merged->strings + merged_symbol->string_offset, name, len+1);
                 merged->header.string_size += len + 1;
                 // debug("global %d %s\n", merged->header.symbol_count-1, merged->strings + merged_symbol->string_offset);
             } else {
-                log_error("barf: Unhandled symbol %s in %s\n", name, ba_paths[bi]);
+                log_error("barf: Unhandled symbol %s in %s\n", name, input_files[bi]);
             }
         }
     }
 
-    // Relocations
+    // Relocations of each input section, made to refer to merged symbols in
+    // place (the input objects are only read by the combine from here on)
+    BarfRelocation** input_relocations = arena_alloc(arena, estimated_section_count * sizeof(BarfRelocation*));
+    if (!input_relocations) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
     for (int bi = 0; bi < input_count; bi++) {
         BarfObject* object = objects[bi];
         for (int si = 0; si < object->header.section_count; si++) {
             BarfSection* section = &object->sections[si];
-
-            BarfSection* merged_section = &merged->sections[section_mapping[bi][si]];
-            merged_section->relocation_count = section->relocation_count;
-            BarfRelocation* relocations = heap_alloc(sizeof(BarfRelocation) * section->relocation_count);
-            merged->relocations[section_mapping[bi][si]] = relocations;
-            memcpy(relocations, object->relocations[si], sizeof(BarfRelocation) * section->relocation_count);
+            BarfRelocation* relocations = object->relocations[si];
+            input_relocations[first_section[bi] + si] = relocations;
 
             for (int ri = 0; ri < section->relocation_count; ri++) {
                 BarfRelocation* rel = &relocations[ri];
@@ -1166,11 +1985,285 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
         }
     }
 
-    // We can either merge sections or we can add sections to artifact, this means multiple .text sections.
-    // Human-wise it's hard to differentiate the sections, loader wise everything refers
-    // to sections by ID so it doesn't matter much?.
+    // Input sections that go to the output, all of them unless gc_sections
+    u8* live = arena_alloc(arena, estimated_section_count);
+    // Symbols referred to by relocations of live sections (only with gc_sections)
+    u8* symbol_used = arena_alloc(arena, merged->header.symbol_count);
+    if (!live || !symbol_used) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    bool gc_sections = options && options->gc_sections;
+    if (gc_sections) {
+        int marked = combine_mark_live(merged, &symbol_map, options, input_sections, input_relocations, estimated_section_count, live, symbol_used, arena);
+        if (marked < 0) {
+            log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+            goto cleanup;
+        }
+        if (!marked) {
+            log_warning("barf: No ba_entry or kept symbol to collect sections from, keeping all sections\n");
+            gc_sections = false;
+        }
+    }
+    if (!gc_sections)
+        memset(live, 1, estimated_section_count);
+    for (int fi = 0; fi < estimated_section_count; fi++) {
+        if (discarded[fi])
+            live[fi] = 0;
+    }
+
+    // Symbols of a folded section move to the section it was folded into
+    u32* folded_into = arena_alloc(arena, estimated_section_count * sizeof(u32));
+    if (!folded_into) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    for (int fi = 0; fi < estimated_section_count; fi++)
+        folded_into[fi] = fi;
+    if (options && options->fold_identical) {
+        u64 folded_bytes = 0;
+        int folded = combine_fold_identical(merged, input_sections, input_data, input_relocations, estimated_section_count, live, folded_into, &folded_bytes, arena);
+        if (folded < 0) {
+            log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+            goto cleanup;
+        }
+        log__printf("barf: icf folded %d sections (%llu bytes)\n", folded, (unsigned long long)folded_bytes);
+    }
+
+    bool merge_sections = options && options->merge_sections;
+    SymbolMap section_map;
+    if (merge_sections && !symbol_map_init(&section_map, estimated_section_count, arena)) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+
+    // Strings and constants of mergeable sections are stored once per output section
+    u32* first_entry = arena_alloc(arena, estimated_section_count * sizeof(u32));
+    u32* entry_count = arena_alloc(arena, estimated_section_count * sizeof(u32));
+    u32  merge_entry_count = 0;
+    if (!first_entry || !entry_count) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    MergeEntry* merge_entries = combine_split_entries(input_sections, input_data, estimated_section_count, live, first_entry, entry_count, &merge_entry_count, arena);
+    SymbolMap merge_map;
+    if ((merge_entry_count && !merge_entries) || !symbol_map_init(&merge_map, estimated_section_count, arena)) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+
+    // Output section of each live input section and where its data starts there
+    int* section_mapping = arena_alloc(arena, estimated_section_count * sizeof(int));
+    u64* section_base    = arena_alloc(arena, estimated_section_count * sizeof(u64));
+    u64  removed_bytes   = 0;
+    int  removed_count   = 0;
+    if (!section_mapping || !section_base) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    for (int fi = 0; fi < estimated_section_count; fi++) {
+        BarfSection* section = input_sections[fi];
+        section_mapping[fi] = -1;
+        if (!live[fi]) {
+            if (folded_into[fi] != fi || discarded[fi])
+                continue;
+            removed_bytes += section->data_size;
+            removed_count++;
+            continue;
+        }
+
+        if (entry_count[fi]) {
+            // Entries go to the output section with the same name, flags and
+            // entry size, combine_merge_entries places them.
+            u32 hash = symbol_hash(section->name) ^ section->entry_size * 0x9E3779B1u;
+            SymbolSlot* slot = section_map_find(&merge_map, merged, section, hash);
+            if (!slot->index_plus_one) {
+                slot->hash = hash;
+                slot->index_plus_one = merged->header.section_count + 1;
+                BarfSection* merged_section = &merged->sections[merged->header.section_count++];
+                memcpy(merged_section->name, section->name, sizeof(section->name));
+                merged_section->flags      = section->flags;
+                merged_section->entry_size = section->entry_size;
+            }
+            BarfSection* merged_section = &merged->sections[slot->index_plus_one - 1];
+            if (merged_section->alignment < section->alignment)
+                merged_section->alignment = section->alignment;
+            section_mapping[fi] = slot->index_plus_one - 1;
+            section_base[fi]    = 0;
+            continue;
+        }
+
+        if (merge_sections && !(section->flags & BARF_FLAG_GROUP)) {
+            // Append to the merged section with the same name and flags,
+            // the data keeps its own alignment within it. Group sections stay
+            // apart so a later combine can still drop them.
+            u32 hash = symbol_hash(section->name) ^ section->flags * 0x9E3779B1u;
+            SymbolSlot* slot = section_map_find(&section_map, merged, section, hash);
+            if (slot->index_plus_one) {
+                int msi = slot->index_plus_one - 1;
+                BarfSection* merged_section = &merged->sections[msi];
+                u64 alignment = section->alignment ? section->alignment : 1;
+                u64 base = merged_section->data_size;
+                base += (alignment - (base % alignment)) % alignment;
+                if (base + section->data_size > 0xFFFFFFFFull) {
+                    // Symbol and relocation offsets are 32-bit
+                    log_error("barf: Merged section '%s' would be larger than 4 GB\n", section->name);
+                    goto cleanup;
+                }
+
+                section_mapping[fi] = msi;
+                section_base[fi]    = base;
+                merged_section->data_size = base + section->data_size;
+                merged_section->relocation_count += section->relocation_count;
+                if (merged_section->alignment < section->alignment)
+                    merged_section->alignment = section->alignment;
+                continue;
+            }
+            slot->hash = hash;
+            slot->index_plus_one = merged->header.section_count + 1;
+        }
+        
+        // Map [input section] to [merged section index]
+        section_mapping[fi] = merged->header.section_count;
+
+        BarfSection* merged_section = &merged->sections[merged->header.section_count];
+        merged->header.section_count++;
+
+        memcpy(merged_section->name, section->name, sizeof(section->name));
+        merged_section->alignment = section->alignment;
+        merged_section->flags = section->flags;
+        merged_section->relocation_count = section->relocation_count;
+        merged_section->data_size = section->data_size;
+        merged_section->entry_size = section->entry_size;
+        if (section->flags & BARF_FLAG_GROUP) {
+            int len = strlen(group_names[fi]);
+            merged_section->group = merged->header.string_size;
+            memcpy(merged->strings + merged_section->group, group_names[fi], len+1);
+            merged->header.string_size += len + 1;
+        }
+
+        // Offsets are set when the output is written, sections without
+        // relocations keep a zero relocation_offset.
+        merged_section->data_offset = 0;
+        merged_section->relocation_offset = 0;
+    }
+
+    char** output_data = arena_alloc(arena, sizeof(char*) * (merged->header.section_count + 1));
+    if (!output_data) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    if (merge_entry_count) {
+        int shared       = 0;
+        u64 shared_bytes = 0;
+        if (!combine_merge_entries(merged, input_sections, input_data, section_mapping, merge_entries, merge_entry_count, output_data, &shared, &shared_bytes, arena)) {
+            log_error("barf: Could not merge strings and constants, when combining '%s'\n", output);
+            goto cleanup;
+        }
+        if (shared > 0)
+            log__printf("barf: shared %d duplicate strings and constants (%llu bytes)\n", shared, (unsigned long long)shared_bytes);
+
+        // A relocation through a section symbol refers to the entry at the symbol
+        // plus the addend (like ld), the addend is moved to that entry.
+        for (int fi = 0; fi < estimated_section_count; fi++) {
+            if (section_mapping[fi] == -1)
+                continue;
+            for (u32 ri = 0; ri < input_sections[fi]->relocation_count; ri++) {
+                BarfRelocation* rel = &input_relocations[fi][ri];
+                BarfSymbol* symbol = &merged->symbols[rel->symbol_index];
+                if (symbol->type == BARF_SYMBOL_EXTERNAL || !entry_count[symbol->section_index] || merged->strings[symbol->string_offset])
+                    continue;
+                u32 tfi = symbol->section_index;
+                i64 target = (i64)symbol->offset + rel->addend;
+                if (target < 0 || target >= (i64)input_sections[tfi]->data_size)
+                    continue;
+                rel->addend = (i64)merge_entry_offset(merge_entries, first_entry[tfi], entry_count[tfi], target)
+                            - (i64)merge_entry_offset(merge_entries, first_entry[tfi], entry_count[tfi], symbol->offset);
+            }
+        }
+    }
+
+    // Move symbols to their output sections, drop the ones of removed sections
+    // and externals nothing refers to anymore.
+    u32* symbol_renumber = arena_alloc(arena, merged->header.symbol_count * sizeof(u32));
+    if (!symbol_renumber) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    memset(symbol_renumber, 0xFF, merged->header.symbol_count * sizeof(u32));
+    u32 symbol_count = 0;
+    for (u32 i = 0; i < merged->header.symbol_count; i++) {
+        BarfSymbol* symbol = &merged->symbols[i];
+        if (symbol->type == BARF_SYMBOL_EXTERNAL) {
+            if (gc_sections && !symbol_used[i])
+                continue;
+        } else {
+            u32 fi = folded_into[symbol->section_index];
+            if (!live[fi])
+                continue;
+            symbol->section_index = section_mapping[fi];
+            if (entry_count[fi])
+                symbol->offset = merge_entry_offset(merge_entries, first_entry[fi], entry_count[fi], symbol->offset);
+            else
+                symbol->offset += section_base[fi];
+        }
+        symbol_renumber[i] = symbol_count;
+        merged->symbols[symbol_count++] = *symbol;
+    }
+    if (gc_sections) {
+        log__printf("barf: gc-sections removed %d of %d sections (%llu bytes) and %u of %u symbols\n",
+            removed_count, estimated_section_count, (unsigned long long)removed_bytes,
+            merged->header.symbol_count - symbol_count, merged->header.symbol_count);
+    }
+    merged->header.symbol_count = symbol_count;
+
+    if (!barf_pack_strings(merged, arena)) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+
+    // Relocations, appended in input order when sections are merged
+    u32* relocations_used = arena_alloc(arena, sizeof(u32) * merged->header.section_count);
+    if (!relocations_used) {
+        log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+        goto cleanup;
+    }
+    for (int msi = 0; msi < merged->header.section_count; msi++) {
+        merged->relocations[msi] = arena_alloc(arena, sizeof(BarfRelocation) * merged->sections[msi].relocation_count);
+        if (!merged->relocations[msi]) {
+            log_error("barf: arena_alloc failed, when combining '%s'\n", output);
+            goto cleanup;
+        }
+    }
+    for (int fi = 0; fi < estimated_section_count; fi++) {
+        int msi = section_mapping[fi];
+        if (msi == -1)
+            continue;
+        BarfSection* section = input_sections[fi];
+
+        for (int ri = 0; ri < section->relocation_count; ri++) {
+            BarfRelocation rel = input_relocations[fi][ri];
+
+            if (symbol_renumber[rel.symbol_index] == 0xFFFFFFFF) {
+                // A local symbol of a discarded group section, the kept copy may differ.
+                // Unwind info of the discarded copy is left unrelocated like ld does.
+                if ((section->flags & BARF_FLAG_IGNORE) || !strcmp(section->name, ".eh_frame"))
+                    continue;
+                log_error("barf: Section '%s' refers to a symbol in a discarded group section, cannot combine!\n", section->name);
+                goto cleanup;
+            }
+            rel.symbol_index = symbol_renumber[rel.symbol_index];
+            rel.offset += section_base[fi];
+            merged->relocations[msi][relocations_used[msi]++] = rel;
+        }
+    }
+    for (int msi = 0; msi < merged->header.section_count; msi++)
+        merged->sections[msi].relocation_count = relocations_used[msi];
+
+    // Sections are added to the artifact as they are (multiple .text sections) unless
+    // merge_sections is set. The loader refers to sections by ID so both work, merged
+    // sections mean fewer segments to map.
 
-    FSHandle file;
     file = fs__open(output, FS_WRITE);
     if (IS_INVALID_FS_HANDLE(file)) {
         log_error("barf: Could not open '%s'\n", output);
@@ -1186,40 +2279,42 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
     
     u64 next_section_data_offset = sizeof(merged->header) + size_of_sections + size_of_symbols + merged->header.string_size;
 
-    for (int bi=0;bi<input_count;bi++) {
-        BarfObject* prev_object = objects[bi];
-        FSHandle in_file = fs__open(ba_paths[bi], FS_READ);
-        for (int si=0;si<prev_object->header.section_count;si++) {
-            BarfSection* prev_section = &prev_object->sections[si];
-            BarfSection* section = &merged->sections[section_mapping[bi][si]];
-
-            next_section_data_offset += (section->alignment - (next_section_data_offset % section->alignment)) % section->alignment;
-
-            u64 new_offset = next_section_data_offset;
-
-
-            transfer_bytes(in_file, prev_section->data_offset, file, next_section_data_offset, prev_section->data_size);
+    // Layout of the merged sections, relocations follow the data of their section
+    for (int msi = 0; msi < merged->header.section_count; msi++) {
+        BarfSection* section = &merged->sections[msi];
 
-            // fseek(file, next_section_data_offset, SEEK_SET);
-            // fwrite(data + section->data_offset, 1, section->data_size, file);
-
-            next_section_data_offset += section->data_size;
-                section->data_offset = new_offset;
+        next_section_data_offset += (section->alignment - (next_section_data_offset % section->alignment)) % section->alignment;
+        section->data_offset = next_section_data_offset;
+        next_section_data_offset += section->data_size;
 
-            if (section->relocation_count > 0) {
-                next_section_data_offset += (8 - (next_section_data_offset % 8)) % 8;
+        if (section->relocation_count > 0) {
+            next_section_data_offset += (8 - (next_section_data_offset % 8)) % 8;
+            section->relocation_offset = next_section_data_offset;
 
-                new_offset = next_section_data_offset;
+            size_t written_elements = fs__write(file, next_section_data_offset, merged->relocations[msi], sizeof(BarfRelocation) * section->relocation_count);
+            ASSERT(written_elements == sizeof(BarfRelocation) * section->relocation_count);
 
-                // transfer_bytes(in_file, prev_section->data_offset, file, next_section_data_offset, prev_section->data_size);
-                size_t written_elements = fs__write(file, next_section_data_offset, merged->relocations[section_mapping[bi][si]], sizeof(BarfRelocation) * section->relocation_count);
-                ASSERT(written_elements == sizeof(BarfRelocation) * section->relocation_count);
-                section->relocation_offset = new_offset;
+            next_section_data_offset += section->relocation_count * sizeof(BarfRelocation);
+        }
+    }
 
-                next_section_data_offset += section->relocation_count * sizeof(BarfRelocation);
-            }
+    // Section data straight from the inputs, zeroed sections leave a hole
+    for (int bi=0;bi<input_count;bi++) {
+        BarfObject* prev_object = objects[bi];
+        fs__advise(prev_object->mapping, prev_object->mapping_size, FS_MAP_SEQUENTIAL);
+        for (int si=0;si<prev_object->header.section_count;si++) {
+            int fi = first_section[bi] + si;
+            if (section_mapping[fi] == -1 || entry_count[fi])
+                continue;
+            BarfSection* section = &merged->sections[section_mapping[fi]];
+            if (prev_object->section_data[si])
+                fs__write(file, section->data_offset + section_base[fi], prev_object->section_data[si], prev_object->sections[si].data_size);
         }
-        fs__close(in_file);
+    }
+    
+    for (int msi = 0; msi < merged->header.section_count; msi++) {
+        if (output_data[msi])
+            fs__write(file, merged->sections[msi].data_offset, output_data[msi], merged->sections[msi].data_size);
     }
     
     merged->header.total_size = next_section_data_offset;
@@ -1234,32 +2329,18 @@ bool barf_combine_to_artifact(int input_count, const char** input_files, const c
     
     file_write(file, &fs_head, merged->strings, merged->header.string_size);
     
-    // @TODO Free input objects
     fs__close(file);
-    heap_free(merged);
+    combine_destroy_workers(workers, thread_count, objects, input_count);
+    arena_destroy(arena);
 
     return true;
 
 
 cleanup:
-    // if (file)
-    //     fclose(file);
-    // if (data)
-    //     free(data);
-    if (merged)
-        heap_free(merged);
-    if (objects) {
-        for (int i=0;i<input_count;i++) {
-            if (objects[i]) {
-                heap_free(objects[i]);
-            }
-        }
-        heap_free(objects);
-    }
-    if (ba_path_text)
-        heap_free(ba_path_text);
-    if (ba_paths)
-        heap_free(ba_paths);
+    if (!IS_INVALID_FS_HANDLE(file))
+        fs__close(file);
+    combine_destroy_workers(workers, thread_count, objects, input_count);
+    arena_destroy(arena);
     return false;
 }
 
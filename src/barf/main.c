@@ -21,11 +21,16 @@ int ba_main(int argc, char** argv) {
 
     const char* output_file = NULL;
 
+    BarfCombineOptions combine_options = { 0 };
+
     int user_arg_index = -1;
 
     const char** input_files = mem__alloc(50 * sizeof(char*), NULL);
     int input_files_len = 0;
 
+    const char** keep_symbols = mem__alloc(50 * sizeof(char*), NULL);
+    combine_options.keep_symbols = keep_symbols;
+
     int argi = 1;
     while (argi < argc) {
         const char* arg = argv[argi];
@@ -55,6 +60,30 @@ int ba_main(int argc, char** argv) {
             }
             output_file = argv[argi];
             argi++;
+        } else if (!strcmp(arg, "-j")) {
+            if (argi >= argc) {
+                log__printf("ERROR barf: Expected thread count after '%s'\n", arg);
+                return 1;
+            }
+            combine_options.thread_count = strtol(argv[argi], NULL, 10);
+            argi++;
+        } else if (!strcmp(arg, "--save-temps")) {
+            combine_options.write_converted = true;
+        } else if (!strcmp(arg, "--merge-sections")) {
+            combine_options.merge_sections = true;
+        } else if (!strcmp(arg, "--gc-sections")) {
+            combine_options.gc_sections = true;
+        } else if (!strcmp(arg, "--icf")) {
+            combine_options.fold_identical = true;
+        } else if (!strcmp(arg, "--keep")) {
+            if (argi >= argc) {
+                log__printf("ERROR barf: Expected symbol after '%s'\n", arg);
+                return 1;
+            }
+            // @TODO realloc
+            ASSERT(combine_options.keep_count < 50);
+            keep_symbols[combine_options.keep_count++] = argv[argi];
+            argi++;
         } else {
             // @TODO realloc
             ASSERT(input_files_len < 50);
@@ -69,6 +98,12 @@ int ba_main(int argc, char** argv) {
         log__printf("  barf -d file.ba                 Dump BARF information\n");
         log__printf("  barf -c -o file.ba <ofiles...>  Convert/combine COFF/ELF/BA to BA\n");
         log__printf("  barf -c -o file.o <bfiles...>   Convert BARF to ELF\n");
+        log__printf("  barf -c -j N ...                Combine with N threads (default one per core)\n");
+        log__printf("  barf -c --save-temps ...        Also write converted inputs as <input>~.ba\n");
+        log__printf("  barf -c --merge-sections ...    One output section per section name and flags\n");
+        log__printf("  barf -c --gc-sections ...       Drop sections unreachable from ba_entry\n");
+        log__printf("  barf -c --keep NAME ...         Also keep global NAME with --gc-sections\n");
+        log__printf("  barf -c --icf ...               Fold identical code sections\n");
         return 0;
     }
 
@@ -90,7 +125,7 @@ int ba_main(int argc, char** argv) {
     }
 
     if (combine) {
-        bool res = barf_combine_to_artifact(input_files_len, input_files, output_file);
+        bool res = barf_combine_to_artifact(input_files_len, input_files, output_file, &combine_options);
         if (!res) {
             return 1;
         }
@@ -136,6 +171,7 @@ int ba_entry(const char* path, const char* data, int size) {
 #if defined(OS_WINDOWS) || defined(OS_LINUX)
 
 int main(int argc, char** argv) {
+    log__install_crash_handlers();
     return ba_main(argc, argv);
 }
 
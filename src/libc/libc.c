@@ -3,13 +3,16 @@
  * Generated by ChatGPT
  *
  * Minimal standalone libc implementations:
- * strcmp, strncmp, memcpy, memset, strchr, vsnprintf, snprintf
+ * strlen, strnlen, strcpy, strcmp, strncmp, strchr, strrchr, memchr, strstr,
+ * memcpy, memmove, memset, memcmp, vsnprintf, snprintf, strtol, strtoll,
+ * strtoul, strtoull, strtod, strtof
  *
  * File: /d:/dev/barf/src/libc/libc.c
  *
- * These implementations are simple, portable, and do not depend on
- * other libc functions. vsnprintf/snprintf implement a small subset of printf
- * format specifiers: %s, %c, %d, %i, %u, %x, %X, %p, and %%.
+ * These implementations do not depend on other libc functions. vsnprintf/snprintf
+ * support the C99 conversions d i u o x X c s p n f F e E g G a A % with flags,
+ * width, precision (both may be *) and the length modifiers hh h l ll j z t L.
+ * L reads a long double and formats it as a double.
  *
  * vsnprintf follows C99 semantics: it returns the number of characters
  * that would have been written (excluding the terminating null byte),
@@ -22,321 +25,2307 @@
 #include <stdint.h>
 
 
-/* strlen: return length of string */
-size_t strlen(const char *a) {
-    size_t length = 0;
-    while (a[length] != 0) length++;
-    return length;
-}
+/*
+ * Memory routines
+ *
+ * Dispatch on size. Small sizes use two (or four) possibly overlapping loads
+ * that are all done before any store, so they are also safe for memmove.
+ * Large copies align the destination to 32 bytes and move 128 bytes per
+ * iteration. Copies and fills bigger than LIBC_NON_TEMPORAL_THRESHOLD bypass
+ * the cache with streaming stores, the data would only evict everything else.
+ *
+ * Artifacts are built without -O, the attribute below keeps these optimized
+ * and stops GCC from turning the loops back into calls to memcpy/memset.
+ */
 
-/* memcpy: copy n bytes from src to dst. Behavior for overlapping regions
-   is undefined (like the standard memcpy). */
-char* strcpy(char *dst, const char *src)
+#if defined(__GNUC__) && !defined(__clang__)
+    #define LIBC_FAST __attribute__((optimize("O2", "no-tree-loop-distribute-patterns")))
+#else
+    #define LIBC_FAST
+#endif
+
+#define LIBC_NON_TEMPORAL_THRESHOLD (4 * 1024 * 1024) // about the L3 share of one core
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+typedef uint16_t libc_u16 __attribute__((aligned(1), may_alias));
+typedef uint32_t libc_u32 __attribute__((aligned(1), may_alias));
+typedef uint64_t libc_u64 __attribute__((aligned(1), may_alias));
+
+/* Copies up to 16 bytes, loads before stores */
+static inline __attribute__((always_inline)) void copy_16(unsigned char *d, const unsigned char *s, size_t n)
 {
-    int length = 0;
-    while (src[length] != 0) {
-        dst[length] = src[length];
-        length++;
+    if (n >= 8) {
+        uint64_t a = *(const libc_u64 *)s;
+        uint64_t b = *(const libc_u64 *)(s + n - 8);
+        *(libc_u64 *)d = a;
+        *(libc_u64 *)(d + n - 8) = b;
+    } else if (n >= 4) {
+        uint32_t a = *(const libc_u32 *)s;
+        uint32_t b = *(const libc_u32 *)(s + n - 4);
+        *(libc_u32 *)d = a;
+        *(libc_u32 *)(d + n - 4) = b;
+    } else if (n >= 2) {
+        uint16_t a = *(const libc_u16 *)s;
+        uint16_t b = *(const libc_u16 *)(s + n - 2);
+        *(libc_u16 *)d = a;
+        *(libc_u16 *)(d + n - 2) = b;
+    } else if (n == 1) {
+        *d = *s;
     }
-    return dst;
 }
 
-/* strcmp: compare two NUL-terminated strings */
-int strcmp(const char *a, const char *b)
+#ifdef __AVX2__
+
+/* Copies up to 128 bytes, loads before stores */
+static inline __attribute__((always_inline)) void copy_128(unsigned char *d, const unsigned char *s, size_t n)
 {
-    const unsigned char *ua = (const unsigned char *)a;
-    const unsigned char *ub = (const unsigned char *)b;
-    while (*ua && (*ua == *ub)) {
-        ua++;
-        ub++;
+    if (n <= 16) {
+        copy_16(d, s, n);
+    } else if (n <= 32) {
+        __m128i a = _mm_loadu_si128((const __m128i *)s);
+        __m128i b = _mm_loadu_si128((const __m128i *)(s + n - 16));
+        _mm_storeu_si128((__m128i *)d, a);
+        _mm_storeu_si128((__m128i *)(d + n - 16), b);
+    } else if (n <= 64) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)s);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+        _mm256_storeu_si256((__m256i *)d, a);
+        _mm256_storeu_si256((__m256i *)(d + n - 32), b);
+    } else {
+        __m256i a = _mm256_loadu_si256((const __m256i *)s);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(s + n - 64));
+        __m256i e = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+        _mm256_storeu_si256((__m256i *)d, a);
+        _mm256_storeu_si256((__m256i *)(d + 32), b);
+        _mm256_storeu_si256((__m256i *)(d + n - 64), c);
+        _mm256_storeu_si256((__m256i *)(d + n - 32), e);
     }
-    return (int)(*ua - *ub);
 }
 
-/* strncmp: compare up to n bytes of two NUL-terminated strings */
-int strncmp(const char *a, const char *b, size_t n)
+/* memcpy: copy n bytes from src to dst. Behavior for overlapping regions
+   is undefined (like the standard memcpy). */
+LIBC_FAST void *memcpy(void *dst, const void *src, size_t n)
 {
-    const unsigned char *ua = (const unsigned char *)a;
-    const unsigned char *ub = (const unsigned char *)b;
-    size_t i = 0;
-    if (n == 0) return 0;
-    while (i < n && *ua && (*ua == *ub)) {
-        ua++;
-        ub++;
-        i++;
-        if (i == n) break;
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+    if (n <= 128) {
+        copy_128(d, s, n);
+        return dst;
     }
-    if (i == n) return 0;
-    return (int)(*ua - *ub);
+
+    /* The last 128 bytes are written from registers after the loop */
+    __m256i head  = _mm256_loadu_si256((const __m256i *)s);
+    __m256i tail0 = _mm256_loadu_si256((const __m256i *)(s + n - 128));
+    __m256i tail1 = _mm256_loadu_si256((const __m256i *)(s + n - 96));
+    __m256i tail2 = _mm256_loadu_si256((const __m256i *)(s + n - 64));
+    __m256i tail3 = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+    unsigned char *end = d + n - 128;
+
+    /* Align the destination, the first 32 bytes are covered by 'head' */
+    size_t skew = 32 - ((uintptr_t)d & 31);
+    _mm256_storeu_si256((__m256i *)d, head);
+    d += skew;
+    s += skew;
+
+    if (n >= LIBC_NON_TEMPORAL_THRESHOLD) {
+        for (; d < end; d += 128, s += 128) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)s);
+            __m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+            __m256i c = _mm256_loadu_si256((const __m256i *)(s + 64));
+            __m256i e = _mm256_loadu_si256((const __m256i *)(s + 96));
+            _mm256_stream_si256((__m256i *)d, a);
+            _mm256_stream_si256((__m256i *)(d + 32), b);
+            _mm256_stream_si256((__m256i *)(d + 64), c);
+            _mm256_stream_si256((__m256i *)(d + 96), e);
+        }
+        _mm_sfence();
+    } else {
+        for (; d < end; d += 128, s += 128) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)s);
+            __m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+            __m256i c = _mm256_loadu_si256((const __m256i *)(s + 64));
+            __m256i e = _mm256_loadu_si256((const __m256i *)(s + 96));
+            _mm256_store_si256((__m256i *)d, a);
+            _mm256_store_si256((__m256i *)(d + 32), b);
+            _mm256_store_si256((__m256i *)(d + 64), c);
+            _mm256_store_si256((__m256i *)(d + 96), e);
+        }
+    }
+    _mm256_storeu_si256((__m256i *)end, tail0);
+    _mm256_storeu_si256((__m256i *)(end + 32), tail1);
+    _mm256_storeu_si256((__m256i *)(end + 64), tail2);
+    _mm256_storeu_si256((__m256i *)(end + 96), tail3);
+    return dst;
 }
 
-/* memcpy: copy n bytes from src to dst. Behavior for overlapping regions
-   is undefined (like the standard memcpy). */
-void *memcpy(void *dst, const void *src, size_t n)
+/* memmove: like memcpy but the regions may overlap */
+LIBC_FAST void *memmove(void *dst, const void *src, size_t n)
 {
     unsigned char *d = (unsigned char *)dst;
     const unsigned char *s = (const unsigned char *)src;
-    size_t i;
-    for (i = 0; i < n; ++i)
-        d[i] = s[i];
+    if (n <= 128) {
+        copy_128(d, s, n);
+        return dst;
+    }
+    if ((uintptr_t)d - (uintptr_t)s >= n && (uintptr_t)s - (uintptr_t)d >= n)
+        return memcpy(dst, src, n);
+
+    /* The regions overlap. The first and last 32 bytes are stored last, from
+       registers, so the loop can use aligned stores without overwriting source
+       bytes it hasn't read yet. */
+    __m256i head = _mm256_loadu_si256((const __m256i *)s);
+    __m256i tail = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+    if (d < s) {
+        /* Copy forwards */
+        unsigned char *end = d + n - 32;
+        size_t skew = 32 - ((uintptr_t)d & 31);
+        unsigned char *p = d + skew;
+        s += skew;
+        for (; p + 128 <= end; p += 128, s += 128) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)s);
+            __m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+            __m256i c = _mm256_loadu_si256((const __m256i *)(s + 64));
+            __m256i e = _mm256_loadu_si256((const __m256i *)(s + 96));
+            _mm256_store_si256((__m256i *)p, a);
+            _mm256_store_si256((__m256i *)(p + 32), b);
+            _mm256_store_si256((__m256i *)(p + 64), c);
+            _mm256_store_si256((__m256i *)(p + 96), e);
+        }
+        for (; p < end; p += 32, s += 32)
+            _mm256_store_si256((__m256i *)p, _mm256_loadu_si256((const __m256i *)s));
+    } else {
+        /* Copy backwards */
+        unsigned char *start = d + 32;
+        size_t skew = (uintptr_t)(d + n) & 31;
+        if (skew == 0)
+            skew = 32;
+        unsigned char *p = d + n - skew;
+        const unsigned char *q = s + n - skew;
+        for (; p - 128 >= start; p -= 128, q -= 128) {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(q - 32));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(q - 64));
+            __m256i c = _mm256_loadu_si256((const __m256i *)(q - 96));
+            __m256i e = _mm256_loadu_si256((const __m256i *)(q - 128));
+            _mm256_store_si256((__m256i *)(p - 32), a);
+            _mm256_store_si256((__m256i *)(p - 64), b);
+            _mm256_store_si256((__m256i *)(p - 96), c);
+            _mm256_store_si256((__m256i *)(p - 128), e);
+        }
+        for (; p > start; p -= 32, q -= 32)
+            _mm256_store_si256((__m256i *)(p - 32), _mm256_loadu_si256((const __m256i *)(q - 32)));
+    }
+    _mm256_storeu_si256((__m256i *)d, head);
+    _mm256_storeu_si256((__m256i *)(d + n - 32), tail);
     return dst;
 }
 
 /* memset: set n bytes of s to byte value c */
-void *memset(void *s, int c, size_t n)
+LIBC_FAST void *memset(void *s, int c, size_t n)
 {
     unsigned char *p = (unsigned char *)s;
-    unsigned char uc = (unsigned char)c;
-    size_t i;
-    for (i = 0; i < n; ++i)
-        p[i] = uc;
+    if (n <= 16) {
+        uint64_t v = (unsigned char)c * 0x0101010101010101ull;
+        if (n >= 8) {
+            *(libc_u64 *)p = v;
+            *(libc_u64 *)(p + n - 8) = v;
+        } else if (n >= 4) {
+            *(libc_u32 *)p = (uint32_t)v;
+            *(libc_u32 *)(p + n - 4) = (uint32_t)v;
+        } else if (n >= 2) {
+            *(libc_u16 *)p = (uint16_t)v;
+            *(libc_u16 *)(p + n - 2) = (uint16_t)v;
+        } else if (n == 1) {
+            *p = (unsigned char)c;
+        }
+        return s;
+    }
+    __m256i v = _mm256_set1_epi8((char)c);
+    if (n <= 32) {
+        _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+        _mm_storeu_si128((__m128i *)(p + n - 16), _mm256_castsi256_si128(v));
+        return s;
+    }
+    if (n <= 64) {
+        _mm256_storeu_si256((__m256i *)p, v);
+        _mm256_storeu_si256((__m256i *)(p + n - 32), v);
+        return s;
+    }
+    if (n <= 128) {
+        _mm256_storeu_si256((__m256i *)p, v);
+        _mm256_storeu_si256((__m256i *)(p + 32), v);
+        _mm256_storeu_si256((__m256i *)(p + n - 64), v);
+        _mm256_storeu_si256((__m256i *)(p + n - 32), v);
+        return s;
+    }
+
+    unsigned char *end = p + n - 128;
+    _mm256_storeu_si256((__m256i *)p, v);
+    p += 32 - ((uintptr_t)p & 31);
+    if (n >= LIBC_NON_TEMPORAL_THRESHOLD) {
+        for (; p < end; p += 128) {
+            _mm256_stream_si256((__m256i *)p, v);
+            _mm256_stream_si256((__m256i *)(p + 32), v);
+            _mm256_stream_si256((__m256i *)(p + 64), v);
+            _mm256_stream_si256((__m256i *)(p + 96), v);
+        }
+        _mm_sfence();
+    } else {
+        for (; p < end; p += 128) {
+            _mm256_store_si256((__m256i *)p, v);
+            _mm256_store_si256((__m256i *)(p + 32), v);
+            _mm256_store_si256((__m256i *)(p + 64), v);
+            _mm256_store_si256((__m256i *)(p + 96), v);
+        }
+    }
+    _mm256_storeu_si256((__m256i *)end, v);
+    _mm256_storeu_si256((__m256i *)(end + 32), v);
+    _mm256_storeu_si256((__m256i *)(end + 64), v);
+    _mm256_storeu_si256((__m256i *)(end + 96), v);
     return s;
 }
 
-/* strchr: locate first occurrence of character c in string s */
-char *strchr(const char *s, int c)
+/* Index of the first differing byte in two 32 byte blocks, or 32 if equal */
+static inline __attribute__((always_inline)) unsigned diff_32(const unsigned char *a, const unsigned char *b)
 {
-    unsigned char uc = (unsigned char)c;
-    while (*s) {
-        if ((unsigned char)*s == uc)
-            return (char *)s;
-        s++;
-    }
-    if (uc == 0) /* NUL terminator requested */
-        return (char *)s;
-    return NULL;
+    __m256i x = _mm256_loadu_si256((const __m256i *)a);
+    __m256i y = _mm256_loadu_si256((const __m256i *)b);
+    uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+    return mask ? (unsigned)__builtin_ctz(mask) : 32;
 }
 
-// #include <ctype.h>
-#include <limits.h>
-
-unsigned long strtoul(const char *nptr, char **endptr, int base)
+/* memcmp: compare n bytes as unsigned chars */
+LIBC_FAST int memcmp(const void *a, const void *b, size_t n)
 {
-    const char *s = nptr;
-    unsigned long result = 0;
-    int negative = 0;
-    int any = 0;
+    const unsigned char *pa = (const unsigned char *)a;
+    const unsigned char *pb = (const unsigned char *)b;
+    if (n < 32) {
+        /* Two overlapping loads, byte swapped so the integer compare gives memory order */
+        uint64_t x, y;
+        if (n >= 16) {
+            __m128i x0 = _mm_loadu_si128((const __m128i *)pa);
+            __m128i y0 = _mm_loadu_si128((const __m128i *)pb);
+            uint32_t mask = 0xffff ^ (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x0, y0));
+            if (!mask) {
+                pa += n - 16;
+                pb += n - 16;
+                x0 = _mm_loadu_si128((const __m128i *)pa);
+                y0 = _mm_loadu_si128((const __m128i *)pb);
+                mask = 0xffff ^ (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x0, y0));
+                if (!mask)
+                    return 0;
+            }
+            unsigned i = __builtin_ctz(mask);
+            return (int)pa[i] - (int)pb[i];
+        } else if (n >= 8) {
+            x = *(const libc_u64 *)pa;
+            y = *(const libc_u64 *)pb;
+            if (x == y) {
+                x = *(const libc_u64 *)(pa + n - 8);
+                y = *(const libc_u64 *)(pb + n - 8);
+            }
+            x = __builtin_bswap64(x);
+            y = __builtin_bswap64(y);
+        } else if (n >= 4) {
+            x = (uint64_t)__builtin_bswap32(*(const libc_u32 *)pa) << 32 | __builtin_bswap32(*(const libc_u32 *)(pa + n - 4));
+            y = (uint64_t)__builtin_bswap32(*(const libc_u32 *)pb) << 32 | __builtin_bswap32(*(const libc_u32 *)(pb + n - 4));
+        } else if (n > 0) {
+            x = (uint32_t)pa[0] << 16 | (uint32_t)pa[n / 2] << 8 | pa[n - 1];
+            y = (uint32_t)pb[0] << 16 | (uint32_t)pb[n / 2] << 8 | pb[n - 1];
+        } else {
+            return 0;
+        }
+        return (x > y) - (x < y);
+    }
 
+    size_t i = 0;
+    for (; i + 128 <= n; i += 128) {
+        __m256i e0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pa + i)), _mm256_loadu_si256((const __m256i *)(pb + i)));
+        __m256i e1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pa + i + 32)), _mm256_loadu_si256((const __m256i *)(pb + i + 32)));
+        __m256i e2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pa + i + 64)), _mm256_loadu_si256((const __m256i *)(pb + i + 64)));
+        __m256i e3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(pa + i + 96)), _mm256_loadu_si256((const __m256i *)(pb + i + 96)));
+        __m256i eq = _mm256_and_si256(_mm256_and_si256(e0, e1), _mm256_and_si256(e2, e3));
+        if ((uint32_t)_mm256_movemask_epi8(eq) != 0xffffffffu)
+            break;
+    }
+    /* Less than 128 bytes left, or a difference in the next 128. The last block
+       overlaps the one before it so nothing is read past the end. */
+    for (;;) {
+        if (i + 32 > n)
+            i = n - 32;
+        unsigned k = diff_32(pa + i, pb + i);
+        if (k < 32)
+            return (int)pa[i + k] - (int)pb[i + k];
+        i += 32;
+        if (i >= n)
+            return 0;
+    }
+}
 
+#else
 
-    // Skip leading whitespace
-    while (s[0] == ' ' || s[0] == '\t' || s[0] == '\n' || s[0] == '\r')
-        s++;
+/* Portable versions, a machine word at a time */
 
-    // Optional sign
-    if (*s == '+') {
-        s++;
-    } else if (*s == '-') {
-        negative = 1;
-        s++;
+LIBC_FAST void *memcpy(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+    if (n <= 16) {
+        copy_16(d, s, n);
+        return dst;
     }
+    uint64_t tail = *(const libc_u64 *)(s + n - 8);
+    unsigned char *end = d + n - 8;
+    for (; d < end; d += 8, s += 8)
+        *(libc_u64 *)d = *(const libc_u64 *)s;
+    *(libc_u64 *)end = tail;
+    return dst;
+}
 
-    // Base detection
-    if (base == 0) {
-        if (*s == '0') {
-            if (s[1] == 'x' || s[1] == 'X') {
-                base = 16;
-                s += 2;
-            } else {
-                base = 8;
-                s++;
-            }
-        } else {
-            base = 10;
+LIBC_FAST void *memmove(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+    if (n <= 16) {
+        copy_16(d, s, n);
+    } else if ((uintptr_t)d - (uintptr_t)s >= n) {
+        memcpy(d, s, n);
+    } else {
+        while (n >= 8) {
+            n -= 8;
+            *(libc_u64 *)(d + n) = *(const libc_u64 *)(s + n);
         }
-    } else if (base == 16) {
-        if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
-            s += 2;
+        while (n > 0) {
+            n--;
+            d[n] = s[n];
         }
     }
+    return dst;
+}
 
-    unsigned long cutoff = ULONG_MAX / base;
-    unsigned long cutlim = ULONG_MAX % base;
+LIBC_FAST void *memset(void *s, int c, size_t n)
+{
+    unsigned char *p = (unsigned char *)s;
+    uint64_t v = (unsigned char)c * 0x0101010101010101ull;
+    for (; n >= 8; n -= 8, p += 8)
+        *(libc_u64 *)p = v;
+    for (; n > 0; n--, p++)
+        *p = (unsigned char)c;
+    return s;
+}
 
-    for (; *s; s++) {
-        int digit;
+LIBC_FAST int memcmp(const void *a, const void *b, size_t n)
+{
+    const unsigned char *pa = (const unsigned char *)a;
+    const unsigned char *pb = (const unsigned char *)b;
+    for (; n > 0; n--, pa++, pb++) {
+        if (*pa != *pb)
+            return (int)*pa - (int)*pb;
+    }
+    return 0;
+}
 
-        if (*s >= '0' && *s <= '9')
-            digit = *s - '0';
-        else if (*s >= 'A' && *s <= 'Z')
-            digit = *s - 'A' + 10;
-        else if (*s >= 'a' && *s <= 'z')
-            digit = *s - 'a' + 10;
-        else
-            break;
+#endif
 
-        if (digit >= base)
-            break;
+/*
+ * String routines
+ *
+ * Strings have no known length so loads must not touch a page past the
+ * terminator. Single string scans load aligned 32 byte blocks, an aligned
+ * block never crosses a page, and ignore the bytes before the start. Routines
+ * reading two strings at different alignments fall back to bytes for the one
+ * block where either string is about to cross a page.
+ */
 
-        if (result > cutoff || (result == cutoff && digit > cutlim)) {
-            result = ULONG_MAX; // overflow
-            any = -1;
-        } else {
-            any = 1;
-            result = result * base + digit;
-        }
-    }
+#define LIBC_PAGE_SIZE 4096
 
-    if (endptr)
-        *endptr = (char *)(any ? s : nptr);
+/* True if a load of size bytes at p could touch the next page */
+#define LIBC_CROSSES_PAGE(p, size) (((uintptr_t)(p) & (LIBC_PAGE_SIZE - 1)) > LIBC_PAGE_SIZE - (size))
 
-    if (negative)
-        return (unsigned long)(-result);
+/* Reads past the terminator are intended, don't let AddressSanitizer builds flag them */
+#if defined(__GNUC__)
+    #define LIBC_STRING LIBC_FAST __attribute__((no_sanitize_address))
+#else
+    #define LIBC_STRING LIBC_FAST
+#endif
 
-    return result;
-}
+#ifdef __AVX2__
 
+/* Bits for bytes equal to c in the aligned block at p */
+static inline __attribute__((always_inline)) uint32_t match_32(const char *p, __m256i c)
+{
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), c));
+}
 
+/* Bits for bytes that are zero or c in the aligned block at p, 'ch' holds c in every byte */
+static inline __attribute__((always_inline)) uint32_t match_zero_or_32(const char *p, __m256i ch)
+{
+    __m256i x = _mm256_load_si256((const __m256i *)p);
+    __m256i y = _mm256_min_epu8(_mm256_xor_si256(x, ch), x);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(y, _mm256_setzero_si256()));
+}
 
+/* Finds the first byte that is zero or c, starting at the 32 byte aligned p.
+   Moves to 128 byte alignment and then tests 128 bytes per iteration, an aligned
+   128 byte block doesn't cross a page either. */
+static inline __attribute__((always_inline)) const char *find_zero_or(const char *p, __m256i ch)
+{
+    uint32_t mask;
+    while ((uintptr_t)p & 127) {
+        mask = match_zero_or_32(p, ch);
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    for (;; p += 128) {
+        __m256i a = _mm256_load_si256((const __m256i *)p);
+        __m256i b = _mm256_load_si256((const __m256i *)(p + 32));
+        __m256i c = _mm256_load_si256((const __m256i *)(p + 64));
+        __m256i d = _mm256_load_si256((const __m256i *)(p + 96));
+        a = _mm256_min_epu8(_mm256_xor_si256(a, ch), a);
+        b = _mm256_min_epu8(_mm256_xor_si256(b, ch), b);
+        c = _mm256_min_epu8(_mm256_xor_si256(c, ch), c);
+        d = _mm256_min_epu8(_mm256_xor_si256(d, ch), d);
+        __m256i m = _mm256_min_epu8(_mm256_min_epu8(a, b), _mm256_min_epu8(c, d));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(m, zero)))
+            break;
+    }
+    for (;; p += 32) {
+        mask = match_zero_or_32(p, ch);
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+}
 
-/* Internal helpers for snprintf/vsnprintf implementation */
+/* strlen: return length of string */
+LIBC_STRING size_t strlen(const char *a)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const char *p = (const char *)((uintptr_t)a & ~(uintptr_t)31);
+    uint32_t mask = match_32(p, zero) >> (a - p);
+    if (mask)
+        return __builtin_ctz(mask);
+    return (size_t)(find_zero_or(p + 32, zero) - a);
+}
 
-/* Append a single character to buffer if space remains. Always
-   increments *written (the would-be total). */
-static void sb_putc(char *buf, size_t size, size_t *pos, char ch)
+/* strnlen: length of s, at most n */
+LIBC_STRING size_t strnlen(const char *s, size_t n)
 {
-    if (*pos + 1 < size) {
-        buf[*pos] = ch;
+    if (n == 0)
+        return 0;
+    const __m256i zero = _mm256_setzero_si256();
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    uint32_t mask = match_32(p, zero) >> (s - p);
+    size_t length;
+    if (mask) {
+        length = __builtin_ctz(mask);
+        return length < n ? length : n;
+    }
+    for (;;) {
+        p += 32;
+        size_t at = (size_t)(p - s);
+        if (at >= n)
+            return n;
+        mask = match_32(p, zero);
+        if (mask) {
+            length = at + __builtin_ctz(mask);
+            return length < n ? length : n;
+        }
     }
-    (*pos)++;
 }
 
-/* Append a NUL-terminated string to buffer, return length added */
-static void sb_puts(char *buf, size_t size, size_t *pos, const char *s)
+/* Bytes from p to the end of its page */
+static inline __attribute__((always_inline)) size_t page_left(const void *p)
 {
-    while (*s) {
-        sb_putc(buf, size, pos, *s++);
-    }
+    return LIBC_PAGE_SIZE - ((uintptr_t)p & (LIBC_PAGE_SIZE - 1));
 }
 
-/* Convert unsigned integer value to string in given base.
-   digits buffer must be large enough. Produces digits in reverse order. Returns length. */
-static int utoa_rev(unsigned long long value, unsigned int base, char *digits, int uppercase)
+/* Compares at most 'limit' bytes, stopping at a difference or terminator, a word
+   at a time. Returns 1 and sets result if it stopped, 0 to continue after them. */
+static inline __attribute__((always_inline)) int compare_bytes(const unsigned char *a, const unsigned char *b, size_t limit, int *result)
 {
-    const char *low = "0123456789abcdef";
-    const char *up  = "0123456789ABCDEF";
-    const char *map = uppercase ? up : low;
-    int len = 0;
-    if (value == 0) {
-        digits[len++] = '0';
-        return len;
+    size_t i = 0;
+    for (; i + 8 <= limit; i += 8) {
+        uint64_t x = *(const libc_u64 *)(a + i);
+        uint64_t y = *(const libc_u64 *)(b + i);
+        if (x != y || ((x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull))
+            break;
     }
-    while (value != 0) {
-        digits[len++] = map[value % base];
-        value /= base;
+    for (; i < limit; i++) {
+        if (a[i] != b[i] || a[i] == 0) {
+            *result = (int)a[i] - (int)b[i];
+            return 1;
+        }
     }
-    return len;
+    return 0;
 }
 
-/* vsnprintf: minimal implementation using a va_list */
-int vsnprintf(char *str, size_t size, const char *fmt, va_list ap)
+/* Bits for bytes that differ or are the terminator in the 32 bytes at a and b */
+static inline __attribute__((always_inline)) uint32_t stop_32(const unsigned char *a, const unsigned char *b)
 {
-    size_t pos = 0; /* number of characters that would have been written (excluding final NUL) */
+    __m256i x = _mm256_loadu_si256((const __m256i *)a);
+    __m256i y = _mm256_loadu_si256((const __m256i *)b);
+    __m256i same = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, _mm256_setzero_si256()), _mm256_cmpeq_epi8(x, y));
+    return ~(uint32_t)_mm256_movemask_epi8(same);
+}
 
-    while (*fmt) {
-        if (*fmt != '%') {
-            sb_putc(str, size, &pos, *fmt++);
+/* strcmp: compare two NUL-terminated strings */
+LIBC_STRING int strcmp(const char *a, const char *b)
+{
+    const unsigned char *ua = (const unsigned char *)a;
+    const unsigned char *ub = (const unsigned char *)b;
+    int result;
+    for (;;) {
+        if (LIBC_CROSSES_PAGE(ua, 64) || LIBC_CROSSES_PAGE(ub, 64)) {
+            /* Up to the first page boundary, then the vector loop continues */
+            size_t k = page_left(ua) < page_left(ub) ? page_left(ua) : page_left(ub);
+            if (compare_bytes(ua, ub, k, &result))
+                return result;
+            ua += k;
+            ub += k;
             continue;
         }
+        uint64_t mask = stop_32(ua, ub) | (uint64_t)stop_32(ua + 32, ub + 32) << 32;
+        if (mask) {
+            unsigned i = __builtin_ctzll(mask);
+            return (int)ua[i] - (int)ub[i];
+        }
+        ua += 64;
+        ub += 64;
+    }
+}
 
-        /* handle format */
-        fmt++; /* skip '%' */
-        if (*fmt == '%') {
-            sb_putc(str, size, &pos, '%');
-            fmt++;
+/* strncmp: compare up to n bytes of two NUL-terminated strings */
+LIBC_STRING int strncmp(const char *a, const char *b, size_t n)
+{
+    const unsigned char *ua = (const unsigned char *)a;
+    const unsigned char *ub = (const unsigned char *)b;
+    int result;
+    while (n > 0) {
+        if (LIBC_CROSSES_PAGE(ua, 32) || LIBC_CROSSES_PAGE(ub, 32)) {
+            size_t k = page_left(ua) < page_left(ub) ? page_left(ua) : page_left(ub);
+            if (k > n)
+                k = n;
+            if (compare_bytes(ua, ub, k, &result))
+                return result;
+            ua += k;
+            ub += k;
+            n -= k;
             continue;
         }
+        uint32_t mask = stop_32(ua, ub);
+        if (mask) {
+            unsigned i = __builtin_ctz(mask);
+            return i < n ? (int)ua[i] - (int)ub[i] : 0;
+        }
+        if (n <= 32)
+            break;
+        ua += 32;
+        ub += 32;
+        n -= 32;
+    }
+    return 0;
+}
 
-        /* No support for flags, width, precision, or length modifiers except pointer */
-        int uppercase = 0;
-        switch (*fmt) {
-            case 's': {
-                const char *s = va_arg(ap, const char *);
-                if (!s) s = "(null)";
-                sb_puts(str, size, &pos, s);
-                fmt++;
-                break;
-            }
-            case 'c': {
-                int c = va_arg(ap, int);
-                sb_putc(str, size, &pos, (char)c);
-                fmt++;
-                break;
-            }
-            case 'd':
-            case 'i': {
-                int v = va_arg(ap, int);
-                unsigned int uv;
-                if (v < 0) {
-                    sb_putc(str, size, &pos, '-');
-                    uv = (unsigned int)(-(long long)v);
-                } else {
-                    uv = (unsigned int)v;
-                }
-                char rev[32];
-                int rl = utoa_rev((unsigned long long)uv, 10, rev, 0);
-                for (int i = rl - 1; i >= 0; --i) sb_putc(str, size, &pos, rev[i]);
-                fmt++;
-                break;
-            }
-            case 'u': {
-                unsigned int uv = va_arg(ap, unsigned int);
-                char rev[32];
-                int rl = utoa_rev((unsigned long long)uv, 10, rev, 0);
-                for (int i = rl - 1; i >= 0; --i) sb_putc(str, size, &pos, rev[i]);
-                fmt++;
-                break;
-            }
-            case 'x':
-            case 'X': {
-                if (*fmt == 'X') uppercase = 1;
-                unsigned int uv = va_arg(ap, unsigned int);
-                char rev[32];
-                int rl = utoa_rev((unsigned long long)uv, 16, rev, uppercase);
-                for (int i = rl - 1; i >= 0; --i) sb_putc(str, size, &pos, rev[i]);
-                fmt++;
-                break;
-            }
-            case 'p': {
-                void *p = va_arg(ap, void *);
-                unsigned long long addr = (unsigned long long)(uintptr_t)p;
-                sb_puts(str, size, &pos, "0x");
-                char rev[32];
-                int rl = utoa_rev(addr, 16, rev, 0);
-                for (int i = rl - 1; i >= 0; --i) sb_putc(str, size, &pos, rev[i]);
-                fmt++;
+/* strchr: locate first occurrence of character c in string s */
+LIBC_STRING char *strchr(const char *s, int c)
+{
+    const __m256i ch = _mm256_set1_epi8((char)c);
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    uint32_t mask = match_zero_or_32(p, ch) >> (s - p) << (s - p);
+    if (mask)
+        p += __builtin_ctz(mask);
+    else
+        p = find_zero_or(p + 32, ch);
+    return *p == (char)c ? (char *)p : NULL;
+}
+
+/* strrchr: locate last occurrence of character c in string s */
+LIBC_STRING char *strrchr(const char *s, int c)
+{
+    if ((char)c == 0)
+        return (char *)s + strlen(s);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ch = _mm256_set1_epi8((char)c);
+    const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+    const char *last = NULL;
+    unsigned skip = (unsigned)(s - p);
+    uint32_t zeros = match_32(p, zero) >> skip << skip;
+    uint32_t chars = match_32(p, ch) >> skip << skip;
+    for (;;) {
+        if (zeros) {
+            chars &= zeros ^ (zeros - 1); // up to the terminator
+            if (chars)
+                last = p + 31 - __builtin_clz(chars);
+            return (char *)last;
+        }
+        if (chars)
+            last = p + 31 - __builtin_clz(chars);
+        p += 32;
+        zeros = match_32(p, zero);
+        chars = match_32(p, ch);
+    }
+}
+
+/* memchr: locate first byte c in the n bytes at s */
+LIBC_STRING void *memchr(const void *s, int c, size_t n)
+{
+    if (n == 0)
+        return NULL;
+    /* Aligned blocks that hold at least one byte of the range are safe to load */
+    const __m256i ch = _mm256_set1_epi8((char)c);
+    const char *start = (const char *)s;
+    const char *p = (const char *)((uintptr_t)start & ~(uintptr_t)31);
+    size_t skip = (size_t)(start - p);
+    size_t left = n + skip; // bytes from p to the end of the range
+    uint32_t mask = match_32(p, ch) >> skip << skip;
+    for (;;) {
+        if (left < 32)
+            mask &= (1u << left) - 1;
+        if (mask)
+            return (void *)(p + __builtin_ctz(mask));
+        if (left <= 32)
+            return NULL;
+        p += 32;
+        left -= 32;
+        for (; left >= 128; p += 128, left -= 128) {
+            __m256i a = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), ch);
+            __m256i b = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(p + 32)), ch);
+            __m256i c = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(p + 64)), ch);
+            __m256i d = _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)(p + 96)), ch);
+            if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d))))
                 break;
-            }
-            default:
-                /* Unknown specifier: treat literally (write '%' and the char) */
-                sb_putc(str, size, &pos, '%');
-                if (*fmt) {
-                    sb_putc(str, size, &pos, *fmt);
-                    fmt++;
-                }
+        }
+        if (left == 0)
+            return NULL;
+        mask = match_32(p, ch);
+    }
+}
+
+/* strstr: locate the first occurrence of needle in haystack */
+LIBC_STRING char *strstr(const char *haystack, const char *needle)
+{
+    size_t m = strlen(needle);
+    if (m == 0)
+        return (char *)haystack;
+    if (m == 1)
+        return strchr(haystack, needle[0]);
+    size_t h = strlen(haystack);
+    if (m > h)
+        return NULL;
+
+    /* Candidates match both the first and the last byte of the needle,
+       only those are compared in full */
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t last_start = h - m; // last position the needle fits
+    size_t i = 0;
+    for (; i <= last_start; i += 32) {
+        /* Past the end of the haystack loads are fine as long as they stay in the page,
+           candidates there are masked off */
+        uint32_t valid = ~0u;
+        if (i + m - 1 + 32 > h) {
+            if (LIBC_CROSSES_PAGE(haystack + i, 32) || LIBC_CROSSES_PAGE(haystack + i + m - 1, 32))
                 break;
+            if (last_start - i < 31)
+                valid = (1u << (last_start - i + 1)) - 1;
         }
+        __m256i f = _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i *)(haystack + i)));
+        __m256i l = _mm256_cmpeq_epi8(last, _mm256_loadu_si256((const __m256i *)(haystack + i + m - 1)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(f, l)) & valid;
+        while (mask) {
+            unsigned k = __builtin_ctz(mask);
+            if (memcmp(haystack + i + k + 1, needle + 1, m - 2) == 0)
+                return (char *)haystack + i + k;
+            mask &= mask - 1;
+        }
+    }
+    for (; i <= last_start; i++) {
+        if (haystack[i] == needle[0] && memcmp(haystack + i + 1, needle + 1, m - 1) == 0)
+            return (char *)haystack + i;
     }
+    return NULL;
+}
+
+#else
+
+/* strlen: return length of string */
+size_t strlen(const char *a) {
+    size_t length = 0;
+    while (a[length] != 0) length++;
+    return length;
+}
+
+/* strnlen: length of s, at most n */
+size_t strnlen(const char *s, size_t n)
+{
+    size_t length = 0;
+    while (length < n && s[length] != 0) length++;
+    return length;
+}
 
-    /* Null-terminate if possible */
-    if (size > 0) {
-        size_t nulpos = (pos < size) ? pos : (size - 1);
-        str[nulpos] = '\0';
+/* strcmp: compare two NUL-terminated strings */
+int strcmp(const char *a, const char *b)
+{
+    const unsigned char *ua = (const unsigned char *)a;
+    const unsigned char *ub = (const unsigned char *)b;
+    while (*ua && (*ua == *ub)) {
+        ua++;
+        ub++;
     }
+    return (int)(*ua - *ub);
+}
 
-    /* Return number of characters that would have been written (not counting final NUL) */
-    if (pos > (size_t)INTPTR_MAX) /* avoid returning absurd huge values on overflow */
-        return (int)INTPTR_MAX;
-    return (int)pos;
+/* strncmp: compare up to n bytes of two NUL-terminated strings */
+int strncmp(const char *a, const char *b, size_t n)
+{
+    const unsigned char *ua = (const unsigned char *)a;
+    const unsigned char *ub = (const unsigned char *)b;
+    for (; n > 0; n--, ua++, ub++) {
+        if (*ua != *ub || *ua == 0)
+            return (int)*ua - (int)*ub;
+    }
+    return 0;
 }
 
-/* snprintf: convenience wrapper around vsnprintf */
-int snprintf(char *str, size_t size, const char *fmt, ...)
+/* strchr: locate first occurrence of character c in string s */
+char *strchr(const char *s, int c)
 {
-    va_list ap;
-    int ret;
-    va_start(ap, fmt);
-    ret = vsnprintf(str, size, fmt, ap);
-    va_end(ap);
-    return ret;
+    unsigned char uc = (unsigned char)c;
+    while (*s) {
+        if ((unsigned char)*s == uc)
+            return (char *)s;
+        s++;
+    }
+    if (uc == 0) /* NUL terminator requested */
+        return (char *)s;
+    return NULL;
+}
+
+/* strrchr: locate last occurrence of character c in string s */
+char *strrchr(const char *s, int c)
+{
+    const char *last = NULL;
+    do {
+        if (*s == (char)c)
+            last = s;
+    } while (*s++);
+    return (char *)last;
+}
+
+/* memchr: locate first byte c in the n bytes at s */
+void *memchr(const void *s, int c, size_t n)
+{
+    const unsigned char *p = (const unsigned char *)s;
+    for (; n > 0; n--, p++) {
+        if (*p == (unsigned char)c)
+            return (void *)p;
+    }
+    return NULL;
+}
+
+/* strstr: locate the first occurrence of needle in haystack */
+char *strstr(const char *haystack, const char *needle)
+{
+    size_t m = strlen(needle);
+    for (; *haystack; haystack++) {
+        if (strncmp(haystack, needle, m) == 0)
+            return (char *)haystack;
+    }
+    return m == 0 ? (char *)haystack : NULL;
+}
+
+#endif
+
+/* strcpy: copy src including the terminator to dst */
+char *strcpy(char *dst, const char *src)
+{
+    memcpy(dst, src, strlen(src) + 1);
+    return dst;
+}
+
+// #include <ctype.h>
+#include <limits.h>
+
+/*
+ * Formatted output
+ *
+ * Literal runs between conversions are found with strchr and copied in one go.
+ * Integers are converted two digits at a time from a table. Floating point
+ * conversions are exact and round half to even like glibc: values that scale
+ * to an integer below 2^53 with a power of ten are converted with one exact
+ * multiplication, the rest with big integer arithmetic.
+ */
+
+/* Output buffer, pos counts everything that would have been written */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t pos;
+} PrintOut;
+
+static inline __attribute__((always_inline)) void out_write(PrintOut *out, const char *s, size_t n)
+{
+    size_t room = out->pos + 1 < out->size ? out->size - 1 - out->pos : 0;
+    if (n <= room && n <= 16)
+        copy_16((unsigned char *)out->buf + out->pos, (const unsigned char *)s, n);
+    else if (room > 0)
+        memcpy(out->buf + out->pos, s, n < room ? n : room);
+    out->pos += n;
+}
+
+static inline __attribute__((always_inline)) void out_fill(PrintOut *out, char c, size_t n)
+{
+    if (n == 0)
+        return;
+    size_t room = out->pos + 1 < out->size ? out->size - 1 - out->pos : 0;
+    if (room > 0)
+        memset(out->buf + out->pos, c, n < room ? n : room);
+    out->pos += n;
+}
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* Writes the digits of v ending at end, returns the start */
+static inline __attribute__((always_inline)) char *format_decimal(char *end, uint64_t v)
+{
+    while (v >= 100) {
+        uint64_t q = v / 100;
+        end -= 2;
+        *(libc_u16 *)end = *(const libc_u16 *)(digit_pairs + (v - q * 100) * 2);
+        v = q;
+    }
+    if (v >= 10) {
+        end -= 2;
+        *(libc_u16 *)end = *(const libc_u16 *)(digit_pairs + v * 2);
+    } else {
+        *--end = (char)('0' + v);
+    }
+    return end;
+}
+
+static char *format_hex(char *end, uint64_t v, int uppercase)
+{
+    const char *map = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = map[v & 15];
+        v >>= 4;
+    } while (v);
+    return end;
+}
+
+static char *format_octal(char *end, uint64_t v)
+{
+    do {
+        *--end = (char)('0' + (v & 7));
+        v >>= 3;
+    } while (v);
+    return end;
+}
+
+#define FMT_LEFT  0x01
+#define FMT_PLUS  0x02
+#define FMT_SPACE 0x04
+#define FMT_ALT   0x08
+#define FMT_ZERO  0x10
+#define FMT_UPPER 0x20
+
+typedef struct {
+    int flags;
+    int width;
+    int precision; /* -1 when not given */
+} PrintSpec;
+
+/* Writes prefix (sign, 0x) + zeros + body with width padding. zeros are the
+   precision zeros of integers, they don't count as padding. */
+static inline __attribute__((always_inline)) void out_padded(PrintOut *out, const PrintSpec *spec, const char *prefix, size_t prefix_len, size_t zeros, const char *body, size_t body_len)
+{
+    size_t len = prefix_len + zeros + body_len;
+    size_t pad = spec->width > 0 && (size_t)spec->width > len ? (size_t)spec->width - len : 0;
+    if (!(spec->flags & (FMT_LEFT | FMT_ZERO)))
+        out_fill(out, ' ', pad);
+    out_write(out, prefix, prefix_len);
+    if ((spec->flags & (FMT_LEFT | FMT_ZERO)) == FMT_ZERO)
+        out_fill(out, '0', pad);
+    out_fill(out, '0', zeros);
+    out_write(out, body, body_len);
+    if (spec->flags & FMT_LEFT)
+        out_fill(out, ' ', pad);
+}
+
+static void format_integer(PrintOut *out, PrintSpec *spec, uint64_t v, int negative, int base)
+{
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *start;
+    char prefix[2];
+    size_t prefix_len = 0;
+
+    if (base == 10)
+        start = format_decimal(end, v);
+    else if (base == 16)
+        start = format_hex(end, v, spec->flags & FMT_UPPER);
+    else
+        start = format_octal(end, v);
+    size_t len = (size_t)(end - start);
+
+    if (spec->precision >= 0) {
+        spec->flags &= ~FMT_ZERO;
+        if (spec->precision == 0 && v == 0)
+            len = 0;
+    }
+    size_t zeros = spec->precision > 0 && (size_t)spec->precision > len ? (size_t)spec->precision - len : 0;
+
+    if (negative)
+        prefix[prefix_len++] = '-';
+    else if (spec->flags & FMT_PLUS)
+        prefix[prefix_len++] = '+';
+    else if (spec->flags & FMT_SPACE)
+        prefix[prefix_len++] = ' ';
+    if (spec->flags & FMT_ALT) {
+        if (base == 16 && v != 0) {
+            prefix[prefix_len++] = '0';
+            prefix[prefix_len++] = (spec->flags & FMT_UPPER) ? 'X' : 'x';
+        } else if (base == 8 && zeros == 0 && (len == 0 || *start != '0')) {
+            zeros = 1;
+        }
+    }
+    out_padded(out, spec, prefix, prefix_len, zeros, end - len, len);
+}
+
+/* Big unsigned integer for exact float to decimal conversion. 36 words hold
+   the largest double (2^1024) and the fractions of the smallest (2^-1074)
+   times 10^9. */
+typedef struct {
+    uint32_t w[36];
+    int n;
+} PrintBig;
+
+static void big_mul_small(PrintBig *b, uint32_t m)
+{
+    uint64_t carry = 0;
+    for (int i = 0; i < b->n; i++) {
+        uint64_t t = (uint64_t)b->w[i] * m + carry;
+        b->w[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    if (carry)
+        b->w[b->n++] = (uint32_t)carry;
+}
+
+static uint32_t big_div_small(PrintBig *b, uint32_t d)
+{
+    uint64_t rem = 0;
+    for (int i = b->n - 1; i >= 0; i--) {
+        uint64_t t = rem << 32 | b->w[i];
+        b->w[i] = (uint32_t)(t / d);
+        rem = t % d;
+    }
+    while (b->n > 0 && b->w[b->n - 1] == 0)
+        b->n--;
+    return (uint32_t)rem;
+}
+
+/* Decimal digits of m * 2^e, integer digits first, then the fraction 9 digits
+   at a time. The fraction is frac / 2^shift. */
+typedef struct {
+    char int_digits[320];
+    int int_len;
+    int int_pos;
+    PrintBig frac;
+    int shift;
+    char chunk[9];
+    int chunk_pos;
+} FloatDigits;
+
+static void float_digits_init(FloatDigits *g, uint64_t m, int e)
+{
+    PrintBig integer = { { 0 }, 0 };
+    g->int_len = 0;
+    g->int_pos = 0;
+    g->chunk_pos = 9;
+    g->frac.n = 0;
+    g->shift = 0;
+
+    if (e >= 0) {
+        int word = e / 32;
+        unsigned __int128 v = (unsigned __int128)m << (e % 32);
+        integer.w[word] = (uint32_t)v;
+        integer.w[word + 1] = (uint32_t)(v >> 32);
+        integer.w[word + 2] = (uint32_t)(v >> 64);
+        integer.n = word + 3;
+    } else {
+        int shift = -e;
+        uint64_t int_part = shift < 64 ? m >> shift : 0;
+        uint64_t frac_part = shift < 64 ? m & ((1ull << shift) - 1) : m;
+        integer.w[0] = (uint32_t)int_part;
+        integer.w[1] = (uint32_t)(int_part >> 32);
+        integer.n = 2;
+        g->frac.w[0] = (uint32_t)frac_part;
+        g->frac.w[1] = (uint32_t)(frac_part >> 32);
+        g->frac.n = 2;
+        while (g->frac.n > 0 && g->frac.w[g->frac.n - 1] == 0)
+            g->frac.n--;
+        g->shift = shift;
+    }
+    while (integer.n > 0 && integer.w[integer.n - 1] == 0)
+        integer.n--;
+
+    /* Integer digits, 9 at a time from the bottom */
+    char *end = g->int_digits + sizeof(g->int_digits);
+    char *p = end;
+    while (integer.n > 0) {
+        uint32_t chunk = big_div_small(&integer, 1000000000);
+        char *stop = p - 9;
+        if (integer.n > 0) {
+            while (p > stop) {
+                *--p = (char)('0' + chunk % 10);
+                chunk /= 10;
+            }
+        } else {
+            p = format_decimal(p, chunk);
+        }
+    }
+    g->int_len = (int)(end - p);
+    memmove(g->int_digits, p, (size_t)g->int_len);
+}
+
+static int float_digits_next(FloatDigits *g)
+{
+    if (g->int_pos < g->int_len)
+        return g->int_digits[g->int_pos++];
+    if (g->chunk_pos == 9) {
+        if (g->frac.n == 0)
+            return '0';
+        big_mul_small(&g->frac, 1000000000);
+        /* The chunk is frac >> shift, below 10^9 so it spans at most two words */
+        int word = g->shift / 32, bit = g->shift % 32;
+        uint64_t top = (uint64_t)(word + 1 < g->frac.n ? g->frac.w[word + 1] : 0) << 32 | (word < g->frac.n ? g->frac.w[word] : 0);
+        uint32_t chunk = (uint32_t)(top >> bit);
+        for (int i = word + 1; i < g->frac.n; i++)
+            g->frac.w[i] = 0;
+        if (word < g->frac.n)
+            g->frac.w[word] &= (1u << bit) - 1;
+        if (g->frac.n > word + 1)
+            g->frac.n = word + 1;
+        while (g->frac.n > 0 && g->frac.w[g->frac.n - 1] == 0)
+            g->frac.n--;
+        for (int i = 8; i >= 0; i--) {
+            g->chunk[i] = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+        g->chunk_pos = 0;
+    }
+    return g->chunk[g->chunk_pos++];
+}
+
+/* True if any digit after the ones already read is not zero */
+static int float_digits_rest(FloatDigits *g)
+{
+    for (int i = g->int_pos; i < g->int_len; i++) {
+        if (g->int_digits[i] != '0')
+            return 1;
+    }
+    for (int i = g->chunk_pos; i < 9; i++) {
+        if (g->chunk[i] != '0')
+            return 1;
+    }
+    return g->frac.n != 0;
+}
+
+#define FLOAT_MAX_DIGITS 1100 /* more than any double has, the rest are zeros */
+
+/* Rounds the n digits in d half to even given the next digit and whether
+   anything after it is non zero. Returns 1 if it carried into a new leading
+   digit, d then holds n + 1 digits. */
+static int round_digits(char *d, int n, int next, int rest)
+{
+    if (next < '5' || (next == '5' && !rest && (n == 0 || !((d[n - 1] - '0') & 1))))
+        return 0;
+    int i = n - 1;
+    while (i >= 0 && d[i] == '9')
+        d[i--] = '0';
+    if (i >= 0) {
+        d[i]++;
+        return 0;
+    }
+    memmove(d + 1, d, (size_t)n);
+    d[0] = '1';
+    return 1;
+}
+
+/* Splits a into high and low halves so products of halves are exact */
+static void split_double(double a, double *hi, double *lo)
+{
+    double c = 134217729.0 * a; /* 2^27 + 1 */
+    *hi = c - (c - a);
+    *lo = a - *hi;
+}
+
+static const double exact_powers_of_ten[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* x * 10^k rounded half to even to an integer, when that is below 2^53 and the
+   rounding is certain. x * 10^k = y + err exactly (Dekker's product). Returns 0
+   to fall back to the exact path. */
+static int scale_to_integer(double x, int k, uint64_t *result, double *y_out, double *err_out)
+{
+    if (k < 0 || k > 22)
+        return 0;
+    double p = exact_powers_of_ten[k];
+    double y = x * p;
+    if (!(y < 9007199254740992.0))
+        return 0;
+    double xh, xl, ph, pl;
+    split_double(x, &xh, &xl);
+    split_double(p, &ph, &pl);
+    double err = ((xh * ph - y) + xh * pl + xl * ph) + xl * pl;
+    uint64_t r = (uint64_t)y;
+    double t = (y - (double)r) + err; /* x * 10^k - r, within a few ulp of 1 */
+    if (t > -0.4999999 && t < 0.4999999)
+        *result = r;
+    else if (t > 0.5000001 && t < 1.4999999)
+        *result = r + 1;
+    else
+        return 0;
+    *y_out = y;
+    *err_out = err;
+    return 1;
+}
+
+/* Decimal digits of |x| (finite), value = 0.d[0]d[1]... * 10^dp.
+   Fixed: the digits up to 'precision' after the decimal point.
+   Otherwise: precision + 1 significant digits.
+   Returns the digit count, digits past it up to the requested count are zero. */
+static int float_to_digits(double x, int fixed, int precision, char *d, int *dp)
+{
+    union { double f; uint64_t u; } bits = { x };
+    uint64_t m = bits.u & ((1ull << 52) - 1);
+    int be = (int)((bits.u >> 52) & 0x7ff);
+    if (be == 0 && m == 0) {
+        int n = fixed ? 0 : precision + 1;
+        if (n > FLOAT_MAX_DIGITS)
+            n = FLOAT_MAX_DIGITS;
+        memset(d, '0', (size_t)n);
+        *dp = 1;
+        return n;
+    }
+    if (be == 0)
+        be = 1;
+    else
+        m |= 1ull << 52;
+    int e = be - 1075;
+    if (x < 0)
+        x = -x;
+
+    /* Fast path, exact integer scaling */
+    uint64_t r;
+    double y, err;
+    if (fixed) {
+        if (scale_to_integer(x, precision, &r, &y, &err)) {
+            char buf[24];
+            char *end = buf + sizeof(buf);
+            char *start = format_decimal(end, r);
+            int n = (int)(end - start);
+            memcpy(d, start, (size_t)n);
+            *dp = n - precision;
+            return n;
+        }
+    } else if (precision < 15) {
+        /* Estimate of the decimal exponent, then check that the scaled value has
+           exactly precision + 1 digits before rounding */
+        int x10 = ((e + 52) * 78913) >> 18; /* floor(log10(2^(e+52))) */
+        for (int attempt = 0; attempt < 2; attempt++) {
+            int k = precision - x10;
+            if (!scale_to_integer(x, k, &r, &y, &err))
+                break;
+            double low = exact_powers_of_ten[precision], high = exact_powers_of_ten[precision + 1];
+            if (y < low || (y == low && err < 0)) {
+                x10--;
+                continue;
+            }
+            if (y > high || (y == high && err >= 0)) {
+                x10++;
+                continue;
+            }
+            char buf[24];
+            char *end = buf + sizeof(buf);
+            char *start = format_decimal(end, r);
+            int n = (int)(end - start);
+            *dp = x10 + 1 + (n - precision - 1); /* r == 10^(precision+1) after a carry */
+            n = precision + 1;
+            memcpy(d, start, (size_t)n);
+            return n;
+        }
+    }
+
+    /* Exact path */
+    FloatDigits g;
+    float_digits_init(&g, m, e);
+    int n = 0, count;
+    if (g.int_len > 0) {
+        *dp = g.int_len;
+        count = fixed ? g.int_len + precision : precision + 1;
+    } else if (fixed) {
+        *dp = 0;
+        count = precision;
+    } else {
+        int zeros = 0;
+        int c;
+        while ((c = float_digits_next(&g)) == '0')
+            zeros++;
+        d[n++] = (char)c;
+        *dp = -zeros;
+        count = precision + 1;
+    }
+    int limit = count < FLOAT_MAX_DIGITS ? count : FLOAT_MAX_DIGITS;
+    while (n < limit)
+        d[n++] = (char)float_digits_next(&g);
+    if (count > FLOAT_MAX_DIGITS)
+        return n;
+    int next = float_digits_next(&g);
+    if (round_digits(d, n, next, float_digits_rest(&g))) {
+        (*dp)++;
+        if (fixed)
+            n++;
+    }
+    return n;
+}
+
+/* Digit at decimal position i (0 is the first digit left of the point is dp - 1) */
+static inline char digit_at(const char *d, int n, int i)
+{
+    return i >= 0 && i < n ? d[i] : '0';
+}
+
+static void format_float(PrintOut *out, PrintSpec *spec, double x, int conversion)
+{
+    union { double f; uint64_t u; } bits = { x };
+    int negative = (int)(bits.u >> 63);
+    int upper = conversion == 'F' || conversion == 'E' || conversion == 'G' || conversion == 'A';
+    char prefix[4];
+    size_t prefix_len = 0;
+    if (negative)
+        prefix[prefix_len++] = '-';
+    else if (spec->flags & FMT_PLUS)
+        prefix[prefix_len++] = '+';
+    else if (spec->flags & FMT_SPACE)
+        prefix[prefix_len++] = ' ';
+
+    if (((bits.u >> 52) & 0x7ff) == 0x7ff) {
+        const char *text = (bits.u & ((1ull << 52) - 1)) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+        spec->flags &= ~FMT_ZERO;
+        out_padded(out, spec, prefix, prefix_len, 0, text, 3);
+        return;
+    }
+
+    int lower = conversion | 0x20;
+    int precision = spec->precision < 0 ? 6 : spec->precision;
+    int alt = spec->flags & FMT_ALT;
+    char exponent[8];
+    int exponent_len = 0;
+    char d[FLOAT_MAX_DIGITS + 2];
+    int n, dp, frac;
+    int scientific;
+
+    if (lower == 'a') {
+        /* Hexadecimal: 0x1.<13 hex digits>p<exp>, like glibc */
+        uint64_t m = bits.u & ((1ull << 52) - 1);
+        int be = (int)((bits.u >> 52) & 0x7ff);
+        int e = be == 0 ? (m ? -1022 : 0) : be - 1023;
+        int lead = be == 0 ? 0 : 1;
+        const char *map = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        int digits = 13;
+        if (spec->precision >= 0 && spec->precision < 13) {
+            int drop = (13 - spec->precision) * 4;
+            uint64_t half = 1ull << (drop - 1);
+            uint64_t rest = m & ((1ull << drop) - 1);
+            m >>= drop;
+            uint64_t last = spec->precision ? m : (uint64_t)lead; /* digit that decides a tie */
+            if (rest > half || (rest == half && (last & 1))) {
+                m++;
+                if (m >> (spec->precision * 4)) {
+                    m &= (1ull << (spec->precision * 4)) - 1;
+                    lead++;
+                }
+            }
+            digits = spec->precision;
+        } else if (spec->precision < 0) {
+            while (digits > 0 && (m & 15) == 0) {
+                m >>= 4;
+                digits--;
+            }
+        }
+        prefix[prefix_len++] = '0';
+        prefix[prefix_len++] = upper ? 'X' : 'x';
+        n = 0;
+        d[n++] = map[lead];
+        if (digits > 0 || alt)
+            d[n++] = '.';
+        for (int i = digits - 1; i >= 0; i--)
+            d[n++] = map[i < 16 ? (m >> (i * 4)) & 15 : 0];
+        int extra = spec->precision > 13 ? spec->precision - 13 : 0;
+        char *end = exponent + sizeof(exponent);
+        char *start = format_decimal(end, (uint64_t)(e < 0 ? -e : e));
+        *--start = e < 0 ? '-' : '+';
+        *--start = upper ? 'P' : 'p';
+        exponent_len = (int)(end - start);
+        memmove(exponent, start, (size_t)exponent_len);
+
+        size_t len = prefix_len + (size_t)n + (size_t)extra + (size_t)exponent_len;
+        size_t pad = spec->width > 0 && (size_t)spec->width > len ? (size_t)spec->width - len : 0;
+        if (!(spec->flags & (FMT_LEFT | FMT_ZERO)))
+            out_fill(out, ' ', pad);
+        out_write(out, prefix, prefix_len);
+        if ((spec->flags & (FMT_LEFT | FMT_ZERO)) == FMT_ZERO)
+            out_fill(out, '0', pad);
+        out_write(out, d, (size_t)n);
+        out_fill(out, '0', (size_t)extra);
+        out_write(out, exponent, (size_t)exponent_len);
+        if (spec->flags & FMT_LEFT)
+            out_fill(out, ' ', pad);
+        return;
+    }
+
+    if (lower == 'f') {
+        n = float_to_digits(x, 1, precision, d, &dp);
+        scientific = 0;
+        frac = precision;
+    } else if (lower == 'e') {
+        n = float_to_digits(x, 0, precision, d, &dp);
+        scientific = 1;
+        frac = precision;
+    } else {
+        /* %g: P significant digits, fixed if the exponent is in [-4, P) */
+        int P = precision == 0 ? 1 : precision;
+        n = float_to_digits(x, 0, P - 1, d, &dp);
+        int X = (bits.u << 1) == 0 ? 0 : dp - 1;
+        if (X >= -4 && X < P) {
+            scientific = 0;
+            frac = P - 1 - X;
+        } else {
+            scientific = 1;
+            frac = P - 1;
+        }
+        if (!alt) {
+            /* Drop trailing zeros */
+            int last = scientific ? frac : dp - 1 + frac; /* index of the last digit */
+            while (frac > 0 && digit_at(d, n, last) == '0') {
+                frac--;
+                last--;
+            }
+        }
+    }
+
+    size_t int_len;
+    if (scientific) {
+        int X = (bits.u << 1) == 0 ? 0 : dp - 1;
+        char *end = exponent + sizeof(exponent);
+        char *start = format_decimal(end, (uint64_t)(X < 0 ? -X : X));
+        if (end - start < 2)
+            *--start = '0';
+        *--start = X < 0 ? '-' : '+';
+        *--start = upper ? 'E' : 'e';
+        exponent_len = (int)(end - start);
+        memmove(exponent, start, (size_t)exponent_len);
+        int_len = 1;
+    } else {
+        int_len = dp > 0 ? (size_t)dp : 1;
+    }
+
+    int point = frac > 0 || alt;
+    size_t len = prefix_len + int_len + (size_t)point + (size_t)frac + (size_t)exponent_len;
+    size_t pad = spec->width > 0 && (size_t)spec->width > len ? (size_t)spec->width - len : 0;
+    if (!(spec->flags & (FMT_LEFT | FMT_ZERO)))
+        out_fill(out, ' ', pad);
+    out_write(out, prefix, prefix_len);
+    if ((spec->flags & (FMT_LEFT | FMT_ZERO)) == FMT_ZERO)
+        out_fill(out, '0', pad);
+
+    /* Digits before the point, then after it. first is the index in d of the
+       first digit after the point. */
+    int first;
+    if (scientific) {
+        out_write(out, d, 1);
+        first = 1;
+    } else {
+        if (dp <= 0) {
+            out_write(out, "0", 1);
+        } else {
+            int have = dp < n ? dp : n;
+            out_write(out, d, (size_t)have);
+            out_fill(out, '0', (size_t)(dp - have));
+        }
+        first = dp;
+    }
+    if (point)
+        out_write(out, ".", 1);
+    if (frac > 0) {
+        int i = first;
+        if (i < 0) {
+            int zeros = -i < frac ? -i : frac;
+            out_fill(out, '0', (size_t)zeros);
+            i += zeros;
+        }
+        int end = first + frac;
+        if (i < n && i < end) {
+            int stop = n < end ? n : end;
+            out_write(out, d + i, (size_t)(stop - i));
+            i = stop;
+        }
+        out_fill(out, '0', (size_t)(end - i));
+    }
+    out_write(out, exponent, (size_t)exponent_len);
+    if (spec->flags & FMT_LEFT)
+        out_fill(out, ' ', pad);
+}
+
+/* vsnprintf: C99 formatted output to a buffer, see the top of the file */
+LIBC_FAST int vsnprintf(char *str, size_t size, const char *fmt, va_list ap)
+{
+    PrintOut out = { str, size, 0 };
+    va_list args;
+    va_copy(args, ap);
+
+    for (;;) {
+        /* Short runs are scanned here, longer ones with the vectorized strchr */
+        const char *percent = fmt;
+        while (*percent && *percent != '%' && percent - fmt < 16)
+            percent++;
+        if (*percent && *percent != '%')
+            percent = strchr(percent, '%');
+        if (!percent || !*percent) {
+            out_write(&out, fmt, percent ? (size_t)(percent - fmt) : strlen(fmt));
+            break;
+        }
+        out_write(&out, fmt, (size_t)(percent - fmt));
+        fmt = percent + 1;
+
+        PrintSpec spec = { 0, 0, -1 };
+        for (;; fmt++) {
+            if (*fmt == '-') spec.flags |= FMT_LEFT;
+            else if (*fmt == '+') spec.flags |= FMT_PLUS;
+            else if (*fmt == ' ') spec.flags |= FMT_SPACE;
+            else if (*fmt == '#') spec.flags |= FMT_ALT;
+            else if (*fmt == '0') spec.flags |= FMT_ZERO;
+            else break;
+        }
+        if (*fmt == '*') {
+            spec.width = va_arg(args, int);
+            if (spec.width < 0) {
+                spec.flags |= FMT_LEFT;
+                spec.width = -spec.width;
+            }
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9')
+                spec.width = spec.width * 10 + (*fmt++ - '0');
+        }
+        if (*fmt == '.') {
+            fmt++;
+            spec.precision = 0;
+            if (*fmt == '*') {
+                spec.precision = va_arg(args, int);
+                if (spec.precision < 0)
+                    spec.precision = -1;
+                fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9')
+                    spec.precision = spec.precision * 10 + (*fmt++ - '0');
+            }
+        }
+
+        /* Length in bytes of the integer argument, 0 for int */
+        int length = 0;
+        switch (*fmt) {
+            case 'h': fmt++; length = 2; if (*fmt == 'h') { fmt++; length = 1; } break;
+            case 'l': fmt++; length = 8; if (*fmt == 'l') fmt++; break;
+            case 'j': case 'z': case 't': fmt++; length = 8; break;
+            case 'L': fmt++; length = 16; break;
+        }
+
+        int conversion = *fmt;
+        if (conversion == 0)
+            break;
+        fmt++;
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                int64_t v;
+                if (length == 8) v = va_arg(args, int64_t);
+                else if (length == 2) v = (short)va_arg(args, int);
+                else if (length == 1) v = (signed char)va_arg(args, int);
+                else v = va_arg(args, int);
+                format_integer(&out, &spec, v < 0 ? 0 - (uint64_t)v : (uint64_t)v, v < 0, 10);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o': {
+                uint64_t v;
+                if (length == 8) v = va_arg(args, uint64_t);
+                else if (length == 2) v = (unsigned short)va_arg(args, unsigned int);
+                else if (length == 1) v = (unsigned char)va_arg(args, unsigned int);
+                else v = va_arg(args, unsigned int);
+                spec.flags &= ~(FMT_PLUS | FMT_SPACE);
+                if (conversion == 'X')
+                    spec.flags |= FMT_UPPER;
+                format_integer(&out, &spec, v, 0, conversion == 'u' ? 10 : conversion == 'o' ? 8 : 16);
+                break;
+            }
+            case 'p': {
+                void *p = va_arg(args, void *);
+                if (!p) {
+                    spec.precision = -1;
+                    spec.flags &= ~FMT_ZERO;
+                    out_padded(&out, &spec, "", 0, 0, "(nil)", 5);
+                } else {
+                    spec.flags |= FMT_ALT;
+                    format_integer(&out, &spec, (uint64_t)(uintptr_t)p, 0, 16);
+                }
+                break;
+            }
+            case 'c': {
+                char c = (char)va_arg(args, int);
+                spec.flags &= ~FMT_ZERO;
+                out_padded(&out, &spec, "", 0, 0, &c, 1);
+                break;
+            }
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                if (!s)
+                    s = spec.precision < 0 || spec.precision >= 6 ? "(null)" : "";
+                size_t len = spec.precision >= 0 ? strnlen(s, (size_t)spec.precision) : strlen(s);
+                spec.flags &= ~FMT_ZERO;
+                out_padded(&out, &spec, "", 0, 0, s, len);
+                break;
+            }
+            case 'f': case 'F':
+            case 'e': case 'E':
+            case 'g': case 'G':
+            case 'a': case 'A': {
+                double v = length == 16 ? (double)va_arg(args, long double) : va_arg(args, double);
+                if (spec.flags & FMT_LEFT)
+                    spec.flags &= ~FMT_ZERO;
+                format_float(&out, &spec, v, conversion);
+                break;
+            }
+            case 'n': {
+                void *p = va_arg(args, void *);
+                if (length == 8) *(int64_t *)p = (int64_t)out.pos;
+                else if (length == 2) *(short *)p = (short)out.pos;
+                else if (length == 1) *(signed char *)p = (signed char)out.pos;
+                else *(int *)p = (int)out.pos;
+                break;
+            }
+            case '%':
+                out_write(&out, "%", 1);
+                break;
+            default:
+                /* Unknown conversion, written as is */
+                out_write(&out, percent, (size_t)(fmt - percent));
+                break;
+        }
+    }
+    va_end(args);
+
+    if (size > 0)
+        str[out.pos < size ? out.pos : size - 1] = '\0';
+    if (out.pos > (size_t)INT_MAX)
+        return INT_MAX;
+    return (int)out.pos;
+}
+
+/* snprintf: convenience wrapper around vsnprintf */
+int snprintf(char *str, size_t size, const char *fmt, ...)
+{
+    va_list ap;
+    int ret;
+    va_start(ap, fmt);
+    ret = vsnprintf(str, size, fmt, ap);
+    va_end(ap);
+    return ret;
+}
+
+
+/*
+ * Number parsing
+ *
+ * Decimal digits are read eight at a time with SWAR arithmetic while the eight
+ * bytes stay inside the page, digits past the 19 that fit in 64 bits are
+ * skipped 32 at a time with AVX2. strtod and strtof are correctly rounded: up
+ * to 19 significant digits with a small power of ten are converted with a
+ * single exact floating point operation (Clinger's fast path), everything else
+ * goes through a decimal big number that is shifted by powers of two until the
+ * binary mantissa can be read off it.
+ *
+ * There is no errno, overflow shows as the saturated result.
+ */
+
+typedef struct {
+    int mantissa_bits;
+    int exponent_bits;
+    int bias; /* unbiased exponent = biased exponent + bias */
+} FloatFormat;
+
+static const FloatFormat double_format = { 52, 11, -1023 };
+static const FloatFormat float_format  = { 23, 8, -127 };
+
+static inline int is_space(int c)
+{
+    return c == ' ' || (unsigned)(c - '\t') < 5;
+}
+
+/* Value of an ASCII digit or letter, 36 or more for anything else */
+static inline int digit_value(int c)
+{
+    if ((unsigned)(c - '0') < 10)
+        return c - '0';
+    if ((unsigned)((c | 0x20) - 'a') < 26)
+        return (c | 0x20) - 'a' + 10;
+    return 36;
+}
+
+/* True if all 8 bytes of v are ASCII digits */
+static inline int is_eight_digits(uint64_t v)
+{
+    return ((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/* Value of 8 ASCII digits, the first one in the lowest byte */
+static inline uint32_t parse_eight_digits(uint64_t v)
+{
+    v -= 0x3030303030303030ull;
+    v = v * 10 + (v >> 8);
+    v = ((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32)) +
+         ((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))) >> 32;
+    return (uint32_t)v;
+}
+
+/* Parses the magnitude of an integer, sets *overflow if it doesn't fit in 64 bits */
+static LIBC_STRING unsigned long long parse_integer(const char *nptr, char **endptr, int base, int *negative, int *overflow)
+{
+    const char *s = nptr;
+    while (is_space((unsigned char)*s))
+        s++;
+    *negative = 0;
+    *overflow = 0;
+    if (*s == '+' || *s == '-')
+        *negative = *s++ == '-';
+
+    if ((base == 0 || base == 16) && s[0] == '0' && (s[1] | 0x20) == 'x' && digit_value((unsigned char)s[2]) < 16) {
+        s += 2;
+        base = 16;
+    } else if (base == 0) {
+        base = s[0] == '0' ? 8 : 10;
+    }
+    if (base < 2 || base > 36) {
+        if (endptr)
+            *endptr = (char *)nptr;
+        return 0;
+    }
+
+    const char *digits = s;
+    unsigned long long result = 0;
+    if (base == 10) {
+        /* Two blocks of eight digits can't overflow */
+        while (s - digits < 16 && !LIBC_CROSSES_PAGE(s, 8)) {
+            uint64_t v = *(const libc_u64 *)s;
+            if (!is_eight_digits(v))
+                break;
+            result = result * 100000000 + parse_eight_digits(v);
+            s += 8;
+        }
+    }
+
+    unsigned long long cutoff = ULLONG_MAX / (unsigned)base;
+    int cutlim = (int)(ULLONG_MAX % (unsigned)base);
+    for (;; s++) {
+        int digit = digit_value((unsigned char)*s);
+        if (digit >= base)
+            break;
+        if (result > cutoff || (result == cutoff && digit > cutlim))
+            *overflow = 1;
+        else
+            result = result * (unsigned)base + (unsigned)digit;
+    }
+
+    if (endptr)
+        *endptr = (char *)(s == digits ? nptr : s);
+    return *overflow ? ULLONG_MAX : result;
+}
+
+/* strtol: convert the initial part of nptr to a long, saturates on overflow */
+LIBC_FAST long strtol(const char *nptr, char **endptr, int base)
+{
+    int negative, overflow;
+    unsigned long long v = parse_integer(nptr, endptr, base, &negative, &overflow);
+    if (overflow || v > (unsigned long long)LONG_MAX + negative)
+        return negative ? LONG_MIN : LONG_MAX;
+    return negative ? (long)(0 - v) : (long)v;
+}
+
+/* strtoll: convert the initial part of nptr to a long long, saturates on overflow */
+LIBC_FAST long long strtoll(const char *nptr, char **endptr, int base)
+{
+    int negative, overflow;
+    unsigned long long v = parse_integer(nptr, endptr, base, &negative, &overflow);
+    if (overflow || v > (unsigned long long)LLONG_MAX + negative)
+        return negative ? LLONG_MIN : LLONG_MAX;
+    return negative ? (long long)(0 - v) : (long long)v;
+}
+
+/* strtoul: convert the initial part of nptr to an unsigned long, a leading - negates */
+LIBC_FAST unsigned long strtoul(const char *nptr, char **endptr, int base)
+{
+    int negative, overflow;
+    unsigned long long v = parse_integer(nptr, endptr, base, &negative, &overflow);
+    if (overflow || v > ULONG_MAX)
+        return ULONG_MAX;
+    return negative ? 0 - (unsigned long)v : (unsigned long)v;
+}
+
+/* strtoull: convert the initial part of nptr to an unsigned long long, a leading - negates */
+LIBC_FAST unsigned long long strtoull(const char *nptr, char **endptr, int base)
+{
+    int negative, overflow;
+    unsigned long long v = parse_integer(nptr, endptr, base, &negative, &overflow);
+    if (overflow)
+        return ULLONG_MAX;
+    return negative ? 0 - v : v;
+}
+
+/* Accumulates decimal digits into *w while it has fewer than 19, counts all of them in *count */
+static LIBC_STRING const char *parse_digits(const char *s, uint64_t *w, int *count)
+{
+    uint64_t v = *w;
+    int n = *count;
+    while (n <= 19 - 8 && !LIBC_CROSSES_PAGE(s, 8)) {
+        uint64_t x = *(const libc_u64 *)s;
+        if (!is_eight_digits(x))
+            break;
+        v = v * 100000000 + parse_eight_digits(x);
+        s += 8;
+        n += 8;
+    }
+    for (; n < 19 && (unsigned)(*s - '0') < 10; s++, n++)
+        v = v * 10 + (unsigned)(*s - '0');
+    *w = v;
+
+    /* The rest only changes the count */
+#ifdef __AVX2__
+    const __m256i zero = _mm256_set1_epi8('0'), nine = _mm256_set1_epi8(9);
+    while ((unsigned)(*s - '0') < 10 && !LIBC_CROSSES_PAGE(s, 32)) {
+        __m256i x = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i *)s), zero);
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(x, nine), x));
+        unsigned k = mask ? (unsigned)__builtin_ctz(mask) : 32;
+        s += k;
+        n += (int)k;
+    }
+#else
+    while (!LIBC_CROSSES_PAGE(s, 8) && is_eight_digits(*(const libc_u64 *)s)) {
+        s += 8;
+        n += 8;
+    }
+#endif
+    for (; (unsigned)(*s - '0') < 10; s++)
+        n++;
+    *count = n;
+    return s;
+}
+
+/* Rounds m * 2^e to the format half to even, sticky tells whether anything
+   non zero was dropped below m. m is not zero. */
+static LIBC_FAST uint64_t round_binary(uint64_t m, int e, int sticky, const FloatFormat *f)
+{
+    int top = 63 - __builtin_clzll(m);
+    int drop = top - f->mantissa_bits;
+    int min_exponent = f->bias + 1;
+    if (e + top < min_exponent)
+        drop += min_exponent - (e + top); /* subnormal, fewer bits are left */
+
+    if (drop > 64) {
+        m = 0;
+    } else if (drop > 0) {
+        uint64_t rest = drop == 64 ? m : m & ((1ull << drop) - 1);
+        uint64_t half = 1ull << (drop - 1);
+        m = drop == 64 ? 0 : m >> drop;
+        if (rest > half || (rest == half && (sticky || (m & 1))))
+            m++;
+    } else {
+        m <<= -drop;
+    }
+    e += drop;
+    if (m == 2ull << f->mantissa_bits) {
+        m >>= 1;
+        e++;
+    }
+
+    uint64_t max_biased = (1u << f->exponent_bits) - 1;
+    if (m < 1ull << f->mantissa_bits)
+        return m; /* subnormal or zero */
+    if (e + f->mantissa_bits - f->bias >= (int)max_biased)
+        return max_biased << f->mantissa_bits;
+    return (m & ((1ull << f->mantissa_bits) - 1)) | (uint64_t)(e + f->mantissa_bits - f->bias) << f->mantissa_bits;
+}
+
+#define DECIMAL_MAX_DIGITS 800 /* enough to decide every halfway case of a double */
+
+/* Value is 0.digits * 10^point, digits are 0 to 9 without trailing zeros */
+typedef struct {
+    int count;
+    int point;
+    int truncated; /* non zero digits were dropped after the last one */
+    unsigned char digits[DECIMAL_MAX_DIGITS];
+} ParseDecimal;
+
+static void decimal_trim(ParseDecimal *d)
+{
+    while (d->count > 0 && d->digits[d->count - 1] == 0)
+        d->count--;
+    if (d->count == 0)
+        d->point = 0;
+}
+
+/* Divides by 2^k, k is at most 60 */
+static LIBC_FAST void decimal_right_shift(ParseDecimal *d, int k)
+{
+    int r = 0, w = 0;
+    uint64_t n = 0;
+    for (; (n >> k) == 0; r++) {
+        if (r >= d->count) {
+            if (n == 0) {
+                d->count = 0;
+                return;
+            }
+            while ((n >> k) == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = n * 10 + d->digits[r];
+    }
+    d->point -= r - 1;
+
+    uint64_t mask = (1ull << k) - 1;
+    for (; r < d->count; r++) {
+        d->digits[w++] = (unsigned char)(n >> k);
+        n = (n & mask) * 10 + d->digits[r];
+    }
+    while (n > 0) {
+        unsigned digit = (unsigned)(n >> k);
+        if (w < DECIMAL_MAX_DIGITS)
+            d->digits[w++] = (unsigned char)digit;
+        else if (digit > 0)
+            d->truncated = 1;
+        n = (n & mask) * 10;
+    }
+    d->count = w;
+    decimal_trim(d);
+}
+
+/* Multiplies by 2^k, k is at most 60 */
+static LIBC_FAST void decimal_left_shift(ParseDecimal *d, int k)
+{
+    unsigned char out[DECIMAL_MAX_DIGITS + 20];
+    int pos = (int)sizeof(out);
+    uint64_t carry = 0;
+    for (int i = d->count - 1; i >= 0; i--) {
+        uint64_t n = ((uint64_t)d->digits[i] << k) + carry;
+        carry = n / 10;
+        out[--pos] = (unsigned char)(n - carry * 10);
+    }
+    while (carry > 0) {
+        uint64_t q = carry / 10;
+        out[--pos] = (unsigned char)(carry - q * 10);
+        carry = q;
+    }
+
+    int count = (int)sizeof(out) - pos;
+    d->point += count - d->count;
+    if (count > DECIMAL_MAX_DIGITS) {
+        for (int i = DECIMAL_MAX_DIGITS; i < count; i++)
+            d->truncated |= out[pos + i] != 0;
+        count = DECIMAL_MAX_DIGITS;
+    }
+    memcpy(d->digits, out + pos, (size_t)count);
+    d->count = count;
+    decimal_trim(d);
+}
+
+/* The integer part rounded half to even */
+static LIBC_FAST uint64_t decimal_rounded_integer(const ParseDecimal *d)
+{
+    if (d->point > 20)
+        return ~0ull;
+    int i = 0;
+    uint64_t n = 0;
+    for (; i < d->point && i < d->count; i++)
+        n = n * 10 + d->digits[i];
+    for (; i < d->point; i++)
+        n *= 10;
+
+    int at = d->point;
+    if (at >= 0 && at < d->count) {
+        if (d->digits[at] == 5 && at + 1 == d->count)
+            n += d->truncated || (at > 0 && (d->digits[at - 1] & 1));
+        else
+            n += d->digits[at] >= 5;
+    }
+    return n;
+}
+
+/* Bits of the float nearest to d, the sign is left to the caller */
+static LIBC_FAST uint64_t decimal_to_bits(ParseDecimal *d, const FloatFormat *f)
+{
+    static const int shifts[9] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 }; /* 2^shifts[n] < 10^n */
+    uint64_t max_biased = (1u << f->exponent_bits) - 1;
+    int exponent = 0;
+
+    if (d->count == 0 || d->point < -330)
+        return 0;
+    if (d->point > 310)
+        return max_biased << f->mantissa_bits;
+
+    /* Scale into [0.5, 1) */
+    while (d->point > 0) {
+        int n = d->point >= 9 ? 27 : shifts[d->point];
+        decimal_right_shift(d, n);
+        exponent += n;
+    }
+    while (d->point < 0 || (d->point == 0 && d->digits[0] < 5)) {
+        int n = -d->point >= 9 ? 27 : shifts[-d->point];
+        decimal_left_shift(d, n);
+        exponent -= n;
+    }
+
+    /* Now [1, 2), below the smallest normal exponent the mantissa loses bits */
+    exponent--;
+    if (exponent < f->bias + 1) {
+        int n = f->bias + 1 - exponent;
+        for (; n > 60; n -= 60)
+            decimal_right_shift(d, 60);
+        decimal_right_shift(d, n);
+        exponent = f->bias + 1;
+    }
+    if (exponent - f->bias >= (int)max_biased)
+        return max_biased << f->mantissa_bits;
+
+    decimal_left_shift(d, 1 + f->mantissa_bits);
+    uint64_t mantissa = decimal_rounded_integer(d);
+    if (mantissa == 2ull << f->mantissa_bits) {
+        mantissa >>= 1;
+        exponent++;
+        if (exponent - f->bias >= (int)max_biased)
+            return max_biased << f->mantissa_bits;
+    }
+    if (!(mantissa & (1ull << f->mantissa_bits)))
+        exponent = f->bias;
+    return (mantissa & ((1ull << f->mantissa_bits) - 1)) | (uint64_t)(exponent - f->bias) << f->mantissa_bits;
+}
+
+/* 10^q for q from POWER_MIN to POWER_MAX as 128 bit mantissas truncated from the
+   exact value, 10^q = (hi * 2^64 + lo + fraction) * 2^exponent. Computed on first
+   use with the big integers of vsnprintf. */
+#define POWER_MIN -342 /* below, 19 digits round to zero */
+#define POWER_MAX 308
+#define POWER_COUNT (POWER_MAX - POWER_MIN + 1)
+
+static uint64_t power_hi[POWER_COUNT];
+static uint64_t power_lo[POWER_COUNT];
+static int16_t power_exponent[POWER_COUNT];
+static int powers_ready;
+
+/* The top 128 bits of b, sets *length to its bit length */
+static unsigned __int128 big_top_128(const PrintBig *b, int *length)
+{
+    int i = b->n - 1;
+    int have = 32 - __builtin_clz(b->w[i]);
+    *length = 32 * i + have;
+    unsigned __int128 r = b->w[i--];
+    for (; have + 32 <= 128 && i >= 0; i--, have += 32)
+        r = r << 32 | b->w[i];
+    int need = 128 - have;
+    if (need > 0) {
+        r <<= need;
+        if (i >= 0)
+            r |= b->w[i] >> (32 - need);
+    }
+    return r;
+}
+
+static void store_power(int q, unsigned __int128 m, int exponent)
+{
+    power_hi[q - POWER_MIN] = (uint64_t)(m >> 64);
+    power_lo[q - POWER_MIN] = (uint64_t)m;
+    power_exponent[q - POWER_MIN] = (int16_t)exponent;
+}
+
+static LIBC_FAST void init_powers_of_ten(void)
+{
+    /* 10^q = 5^q * 2^q */
+    PrintBig b = { { 1 }, 1 };
+    int length;
+    for (int q = 0; q <= POWER_MAX; q++) {
+        unsigned __int128 m = big_top_128(&b, &length);
+        store_power(q, m, q + length - 128);
+        big_mul_small(&b, 5);
+    }
+
+    /* 10^-k = 2^-k * 2^-1150 * 2^1150 / 5^k, dividing the floor again stays exact */
+    PrintBig x = { { 0 }, 36 };
+    x.w[35] = 1u << 30;
+    for (int k = 1; k <= -POWER_MIN; k++) {
+        big_div_small(&x, 5);
+        unsigned __int128 m = big_top_128(&x, &length);
+        store_power(-k, m, length - 128 - 1150 - k);
+    }
+    __atomic_store_n(&powers_ready, 1, __ATOMIC_RELEASE);
+}
+
+/* Nearest float to w * 10^q from the truncated power, the error only moves the
+   product by one in its lowest bit. Returns 0 when that could change the
+   rounding or the result is subnormal, the exact path decides those. */
+static LIBC_FAST int scale_power_of_ten(uint64_t w, int q, const FloatFormat *f, uint64_t *bits)
+{
+    if (!__atomic_load_n(&powers_ready, __ATOMIC_ACQUIRE))
+        init_powers_of_ten();
+
+    int s = __builtin_clzll(w);
+    w <<= s;
+    int i = q - POWER_MIN;
+    unsigned __int128 low = (unsigned __int128)w * power_lo[i];
+    unsigned __int128 high = (unsigned __int128)w * power_hi[i] + (uint64_t)(low >> 64);
+
+    /* The value is in [high, high + 1) * 2^(power_exponent + 64 - s) */
+    int top = (int)(high >> 127) ? 127 : 126;
+    int exponent = power_exponent[i] + 64 - s + top;
+    if (exponent < f->bias + 1)
+        return 0;
+    int drop = top - f->mantissa_bits;
+    unsigned __int128 below_mask = ((unsigned __int128)1 << (drop - 1)) - 1;
+    unsigned __int128 below = high & below_mask;
+    if (below == 0 || below == below_mask)
+        return 0;
+
+    uint64_t m = (uint64_t)(high >> drop) + (uint64_t)((high >> (drop - 1)) & 1);
+    if (m == 2ull << f->mantissa_bits) {
+        m >>= 1;
+        exponent++;
+    }
+    uint64_t max_biased = (1u << f->exponent_bits) - 1;
+    if (exponent - f->bias >= (int)max_biased)
+        *bits = max_biased << f->mantissa_bits;
+    else
+        *bits = (m & ((1ull << f->mantissa_bits) - 1)) | (uint64_t)(exponent - f->bias) << f->mantissa_bits;
+    return 1;
+}
+
+/* Case insensitive prefix match against a lowercase word */
+static int match_word(const char *s, const char *word)
+{
+    for (; *word; s++, word++) {
+        if ((*s | 0x20) != *word)
+            return 0;
+    }
+    return 1;
+}
+
+/* Hexadecimal float after the 0x, value is m * 2^e */
+static LIBC_FAST uint64_t parse_hex_float(const char **str, const FloatFormat *f)
+{
+    const char *s = *str;
+    uint64_t m = 0;
+    int e = 0, sticky = 0, seen_point = 0;
+    for (;; s++) {
+        if (*s == '.' && !seen_point) {
+            seen_point = 1;
+            continue;
+        }
+        int digit = digit_value((unsigned char)*s);
+        if (digit >= 16)
+            break;
+        if (m < 1ull << 60) {
+            m = m * 16 + (unsigned)digit;
+            e -= seen_point ? 4 : 0;
+        } else {
+            sticky |= digit != 0;
+            e += seen_point ? 0 : 4;
+        }
+    }
+    if ((*s | 0x20) == 'p') {
+        const char *p = s + 1;
+        int negative = *p == '-';
+        if (*p == '+' || *p == '-')
+            p++;
+        if ((unsigned)(*p - '0') < 10) {
+            int exponent = 0;
+            for (; (unsigned)(*p - '0') < 10; p++) {
+                if (exponent < 100000)
+                    exponent = exponent * 10 + (*p - '0');
+            }
+            e += negative ? -exponent : exponent;
+            s = p;
+        }
+    }
+    *str = s;
+    return m == 0 ? 0 : round_binary(m, e, sticky, f);
+}
+
+/* Parses a decimal or hexadecimal float, inf or nan, returns the bits in format f */
+static LIBC_STRING uint64_t parse_float(const char *nptr, char **endptr, const FloatFormat *f)
+{
+    const char *s = nptr;
+    while (is_space((unsigned char)*s))
+        s++;
+    uint64_t sign = 0;
+    if (*s == '+' || *s == '-')
+        sign = (uint64_t)(*s++ == '-') << (f->mantissa_bits + f->exponent_bits);
+    uint64_t infinity = ((1ull << f->exponent_bits) - 1) << f->mantissa_bits;
+
+    if (s[0] == '0' && (s[1] | 0x20) == 'x' &&
+        (digit_value((unsigned char)s[2]) < 16 || (s[2] == '.' && digit_value((unsigned char)s[3]) < 16))) {
+        s += 2;
+        uint64_t bits = parse_hex_float(&s, f);
+        if (endptr)
+            *endptr = (char *)s;
+        return sign | bits;
+    }
+    if (match_word(s, "inf")) {
+        s += match_word(s, "infinity") ? 8 : 3;
+        if (endptr)
+            *endptr = (char *)s;
+        return sign | infinity;
+    }
+    if (match_word(s, "nan")) {
+        s += 3;
+        if (*s == '(') {
+            const char *p = s + 1;
+            while (digit_value((unsigned char)*p) < 36 || *p == '_')
+                p++;
+            if (*p == ')')
+                s = p + 1;
+        }
+        if (endptr)
+            *endptr = (char *)s;
+        return sign | infinity | 1ull << (f->mantissa_bits - 1);
+    }
+
+    /* value = w * 10^(point - count + exponent) when count <= 19 */
+    const char *mantissa = s;
+    uint64_t w = 0;
+    int count = 0, point = 0, any = 0;
+    while (*s == '0') {
+        s++;
+        any = 1;
+    }
+    const char *integer = s;
+    s = parse_digits(s, &w, &count);
+    any |= s != integer;
+    point = count;
+    if (*s == '.') {
+        s++;
+        const char *fraction = s;
+        if (count == 0) {
+            while (*s == '0')
+                s++;
+            point = -(int)(s - fraction);
+        }
+        s = parse_digits(s, &w, &count);
+        any |= s != fraction;
+    }
+    if (!any) {
+        if (endptr)
+            *endptr = (char *)nptr;
+        return 0;
+    }
+    const char *mantissa_end = s;
+
+    int exponent = 0;
+    if ((*s | 0x20) == 'e') {
+        const char *p = s + 1;
+        int negative = *p == '-';
+        if (*p == '+' || *p == '-')
+            p++;
+        if ((unsigned)(*p - '0') < 10) {
+            for (; (unsigned)(*p - '0') < 10; p++) {
+                if (exponent < 100000)
+                    exponent = exponent * 10 + (*p - '0');
+            }
+            if (negative)
+                exponent = -exponent;
+            s = p;
+        }
+    }
+    if (endptr)
+        *endptr = (char *)s;
+    if (count == 0)
+        return sign;
+
+    /* Clinger: w and the power of ten are exact, one rounding gives the nearest */
+    int q = point - count + exponent;
+    if (count <= 19) {
+        if (f == &double_format && w <= 1ull << 53) {
+            union { double d; uint64_t u; } v;
+            if (q >= -22 && q <= 22) {
+                v.d = q < 0 ? (double)w / exact_powers_of_ten[-q] : (double)w * exact_powers_of_ten[q];
+                return sign | v.u;
+            }
+            if (q > 22 && q <= 22 + 15 && w <= (1ull << 53) / (uint64_t)exact_powers_of_ten[q - 22]) {
+                v.d = (double)(w * (uint64_t)exact_powers_of_ten[q - 22]) * exact_powers_of_ten[22];
+                return sign | v.u;
+            }
+        } else if (f == &float_format && w <= 1ull << 24 && q >= -10 && q <= 10) {
+            union { float f; uint32_t u; } v;
+            float p = (float)exact_powers_of_ten[q < 0 ? -q : q];
+            v.f = q < 0 ? (float)w / p : (float)w * p;
+            return sign | v.u;
+        }
+        uint64_t bits;
+        if (q >= POWER_MIN && q <= POWER_MAX && scale_power_of_ten(w, q, f, &bits))
+            return sign | bits;
+    }
+
+    /* Exact decimal from the digits */
+    ParseDecimal d;
+    d.count = 0;
+    d.truncated = 0;
+    d.point = point + exponent;
+    for (const char *p = mantissa; p < mantissa_end; p++) {
+        if (*p == '.' || (d.count == 0 && *p == '0'))
+            continue;
+        if (d.count < DECIMAL_MAX_DIGITS)
+            d.digits[d.count++] = (unsigned char)(*p - '0');
+        else if (*p != '0')
+            d.truncated = 1;
+    }
+    decimal_trim(&d);
+    return sign | decimal_to_bits(&d, f);
+}
+
+/* strtod: convert the initial part of nptr to the nearest double */
+LIBC_FAST double strtod(const char *nptr, char **endptr)
+{
+    union { double d; uint64_t u; } v;
+    v.u = parse_float(nptr, endptr, &double_format);
+    return v.d;
+}
+
+/* strtof: convert the initial part of nptr to the nearest float */
+LIBC_FAST float strtof(const char *nptr, char **endptr)
+{
+    union { float f; uint32_t u; } v;
+    v.u = (uint32_t)parse_float(nptr, endptr, &float_format);
+    return v.f;
 }
@@ -0,0 +1,32 @@
+/*
+ * Renames the libc functions to libc_* so src/libc/libc.c can be included next
+ * to the system libc, benchmarks and tests compare the two:
+ *
+ *   #include "libc/libc_rename.h"
+ *   #include "libc/libc.c"
+ *   #include "libc/libc_unrename.h" // leave out to keep calling libc_*
+ *
+ * No include guard, the pair can be included more than once.
+ */
+
+#define strlen    libc_strlen
+#define strnlen   libc_strnlen
+#define strcpy    libc_strcpy
+#define strcmp    libc_strcmp
+#define strncmp   libc_strncmp
+#define strchr    libc_strchr
+#define strrchr   libc_strrchr
+#define memchr    libc_memchr
+#define strstr    libc_strstr
+#define memcpy    libc_memcpy
+#define memmove   libc_memmove
+#define memset    libc_memset
+#define memcmp    libc_memcmp
+#define strtol    libc_strtol
+#define strtoll   libc_strtoll
+#define strtoul   libc_strtoul
+#define strtoull  libc_strtoull
+#define strtod    libc_strtod
+#define strtof    libc_strtof
+#define vsnprintf libc_vsnprintf
+#define snprintf  libc_snprintf
@@ -0,0 +1,23 @@
+/* Undoes libc_rename.h, the names refer to the system libc again */
+
+#undef strlen
+#undef strnlen
+#undef strcpy
+#undef strcmp
+#undef strncmp
+#undef strchr
+#undef strrchr
+#undef memchr
+#undef strstr
+#undef memcpy
+#undef memmove
+#undef memset
+#undef memcmp
+#undef strtol
+#undef strtoll
+#undef strtoul
+#undef strtoull
+#undef strtod
+#undef strtof
+#undef vsnprintf
+#undef snprintf
@@ -1 +1,788 @@
+/*
+ * Minimal standalone libm:
+ * exp, log, pow, sin, cos, tanh, sqrt and their float versions, plus array
+ * versions (exp_array, expf_array, ...) that process buffers.
+ *
+ * Every function is one kernel written with GCC vector extensions on four
+ * doubles. Built with -mavx2 it is AVX2 code, without it the compiler splits it
+ * into SSE2 halves. Scalar calls run the kernel on one lane, the array versions
+ * four elements at a time. Both produce the same bits. Float functions convert
+ * to double, run the double kernel and round once at the end.
+ *
+ * Error bounds in ULP of the result, with the largest error seen over 10^6
+ * random arguments per range against long double, tests/math checks them
+ * against correctly rounded references:
+ *
+ *     exp   < 1     (0.88)  fdlibm reduction and rational approximation
+ *     log   < 1     (0.75)  fdlibm polynomial
+ *     pow   < 1     (0.87)  double-double log from a table, exp of the double-double product
+ *     sin   < 1     (0.79)  Cody-Waite reduction below 2^20 pi/2, Payne-Hanek above
+ *     cos   < 1     (0.79)
+ *     tanh  < 1.5   (1.42)  Taylor series below 0.55, 1 - 2/(exp(2x) + 1) above
+ *     sqrt  0.5             correctly rounded (sqrtpd)
+ *     float versions  0.5 + 2^-28, double rounding only matters next to halfway cases
+ *
+ * Special values (inf, nan, signed zeros) follow C99 Annex F. There is no errno.
+ */
 
+#include <stdint.h>
+#include <stddef.h>
+
+#include <immintrin.h>
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #define LIBM_FAST __attribute__((optimize("O2", "no-tree-loop-distribute-patterns")))
+    /* The kernels are always inlined, passing vectors by value never crosses a call */
+    #pragma GCC diagnostic ignored "-Wpsabi"
+#else
+    #define LIBM_FAST
+#endif
+
+#define LIBM_INLINE static inline __attribute__((always_inline))
+
+typedef double  vdouble __attribute__((vector_size(32)));
+typedef int64_t vlong   __attribute__((vector_size(32)));
+
+/* Unaligned loads and stores of whole vectors */
+typedef double  vdouble_u __attribute__((vector_size(32), aligned(8)));
+
+LIBM_INLINE vdouble v_splat(double x)
+{
+    return (vdouble){ x, x, x, x };
+}
+
+LIBM_INLINE vdouble as_double(vlong x)
+{
+    return (vdouble)x;
+}
+
+LIBM_INLINE vlong as_long(vdouble x)
+{
+    return (vlong)x;
+}
+
+/* Lanes of a where mask is set, b elsewhere */
+LIBM_INLINE vdouble v_select(vlong mask, vdouble a, vdouble b)
+{
+    return as_double((mask & as_long(a)) | (~mask & as_long(b)));
+}
+
+LIBM_INLINE int v_any(vlong mask)
+{
+    return (mask[0] | mask[1] | mask[2] | mask[3]) != 0;
+}
+
+LIBM_INLINE vdouble v_abs(vdouble x)
+{
+    return as_double(as_long(x) & 0x7FFFFFFFFFFFFFFF);
+}
+
+LIBM_INLINE vdouble v_copysign(vdouble x, vdouble sign)
+{
+    return as_double((as_long(x) & 0x7FFFFFFFFFFFFFFF) | (as_long(sign) & (int64_t)0x8000000000000000));
+}
+
+#define ROUND_SHIFT 0x1.8p52 /* adding it rounds to an integer, the low bits hold it */
+
+/* Nearest integer for |x| < 2^51, as a double and in *n */
+LIBM_INLINE vdouble round_to_int(vdouble x, vlong *n)
+{
+    vdouble t = x + ROUND_SHIFT;
+    *n = as_long(t) - as_long(v_splat(ROUND_SHIFT));
+    return t - ROUND_SHIFT;
+}
+
+/* n as a double for |n| < 2^51 */
+LIBM_INLINE vdouble int_to_double(vlong n)
+{
+    return as_double(n + as_long(v_splat(ROUND_SHIFT))) - ROUND_SHIFT;
+}
+
+/* 2^n for n in the normal exponent range */
+LIBM_INLINE vdouble power_of_two(vlong n)
+{
+    return as_double((n + 1023) << 52);
+}
+
+/* Double-double helpers, the exact sum and product of two doubles */
+
+LIBM_INLINE vdouble two_sum(vdouble a, vdouble b, vdouble *err)
+{
+    vdouble s = a + b;
+    vdouble bb = s - a;
+    *err = (a - (s - bb)) + (b - bb);
+    return s;
+}
+
+/* |a| >= |b| */
+LIBM_INLINE vdouble fast_two_sum(vdouble a, vdouble b, vdouble *err)
+{
+    vdouble s = a + b;
+    *err = b - (s - a);
+    return s;
+}
+
+LIBM_INLINE vdouble two_product(vdouble a, vdouble b, vdouble *err)
+{
+    const double split = 134217729.0; /* 2^27 + 1, Dekker */
+    vdouble p = a * b;
+    vdouble ca = a * split, cb = b * split;
+    vdouble ah = ca - (ca - a), al = a - ah;
+    vdouble bh = cb - (cb - b), bl = b - bh;
+    *err = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    return p;
+}
+
+
+/*
+ * exp
+ *
+ * x = k ln2 + r with |r| <= ln2/2, exp(r) from fdlibm's rational form
+ * 1 + 2r / (2 - R(r)) and 2^k applied in two steps so subnormal results and
+ * 2^1024 overflow come out of the multiplication.
+ */
+
+static const double ln2_hi = 6.93147180369123816490e-01; /* 32 bits, k * ln2_hi is exact */
+static const double ln2_lo = 1.90821492927058770002e-10;
+static const double inv_ln2 = 1.44269504088896338700e+00;
+
+static const double exp_p1 =  1.66666666666666019037e-01;
+static const double exp_p2 = -2.77777777770155933842e-03;
+static const double exp_p3 =  6.61375632143793436117e-05;
+static const double exp_p4 = -1.65339022054652515390e-06;
+static const double exp_p5 =  4.13813679705723846039e-08;
+
+/* exp(x + tail) for a tail far below the last bit of x */
+LIBM_INLINE vdouble exp_kernel(vdouble x, vdouble tail)
+{
+    /* Past these the result is inf or 0 anyway, keeps k small */
+    x = v_select(x > 710.0, v_splat(710.0), x);
+    x = v_select(x < -746.0, v_splat(-746.0), x);
+
+    vlong k;
+    vdouble kd = round_to_int(x * inv_ln2, &k);
+    vdouble hi = x - kd * ln2_hi;
+    vdouble lo = kd * ln2_lo - tail;
+    vdouble r = hi - lo;
+
+    vdouble t = r * r;
+    vdouble c = r - t * (exp_p1 + t * (exp_p2 + t * (exp_p3 + t * (exp_p4 + t * exp_p5))));
+    vdouble y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+
+    vlong k1 = k >> 1;
+    return y * power_of_two(k1) * power_of_two(k - k1);
+}
+
+
+/*
+ * log
+ *
+ * x = 2^k m with m in [sqrt(2)/2, sqrt(2)), f = m - 1, s = f / (2 + f) and
+ * log(m) = f - f^2/2 + s (f^2/2 + R(s^2)) with fdlibm's polynomial.
+ */
+
+static const double log_lg1 = 6.666666666666735130e-01;
+static const double log_lg2 = 3.999999999940941908e-01;
+static const double log_lg3 = 2.857142874366239149e-01;
+static const double log_lg4 = 2.222219843214978396e-01;
+static const double log_lg5 = 1.818357216161805012e-01;
+static const double log_lg6 = 1.531383769920937332e-01;
+static const double log_lg7 = 1.479819860511658591e-01;
+
+#define SQRT2 1.41421356237309504880
+
+/* Splits positive finite x into 2^k m, m in [sqrt(2)/2, sqrt(2)) */
+LIBM_INLINE vdouble split_exponent(vdouble x, vdouble *k)
+{
+    vlong subnormal = x < 0x1p-1022;
+    x = v_select(subnormal, x * 0x1p54, x);
+    vlong bits = as_long(x);
+    vlong e = ((bits >> 52) & 0x7FF) - 1023 - (subnormal & 54);
+    vdouble m = as_double((bits & 0x000FFFFFFFFFFFFF) | 0x3FF0000000000000);
+    vlong high = m > SQRT2;
+    m = v_select(high, m * 0.5, m);
+    *k = int_to_double(e - high);
+    return m;
+}
+
+LIBM_INLINE vdouble log_kernel(vdouble x)
+{
+    vlong ordinary = (x > 0.0) & (x < __builtin_inf());
+    vdouble k;
+    vdouble m = split_exponent(v_select(ordinary, x, v_splat(1.0)), &k);
+
+    vdouble f = m - 1.0;
+    vdouble s = f / (2.0 + f);
+    vdouble z = s * s;
+    vdouble w = z * z;
+    vdouble t1 = w * (log_lg2 + w * (log_lg4 + w * log_lg6));
+    vdouble t2 = z * (log_lg1 + w * (log_lg3 + w * (log_lg5 + w * log_lg7)));
+    vdouble hfsq = 0.5 * f * f;
+    vdouble y = k * ln2_hi - ((hfsq - (s * (hfsq + t1 + t2) + k * ln2_lo)) - f);
+
+    /* log(0) = -inf, log(inf) = inf, negative and nan give nan */
+    y = v_select(x == 0.0, v_splat(-__builtin_inf()), y);
+    y = v_select(x == __builtin_inf(), x, y);
+    return v_select(ordinary | (x == 0.0) | (x == __builtin_inf()), y, v_splat(__builtin_nan("")));
+}
+
+
+/*
+ * pow
+ *
+ * exp(y log|x|) needs log|x| to about 2^-70 so the product with y keeps all
+ * of its bits. log is computed as a double-double: x = 2^k m with m in [1, 2),
+ * c is a table value close to 1/m and
+ *
+ *     log(x) = k ln2 - log(c) + log(1 + r),  r = m c - 1, |r| < 2^-7
+ *
+ * r is exact and the series of log(1 + r) only needs its r^2 term in
+ * double-double. For m >= 1.5 the table holds -log(2c) and k is one more, so
+ * the intervals next to x = 1 on both sides have 2c = 1 or c = 1: log(x) is
+ * just the series there and keeps its relative accuracy. The table of c and
+ * -log(c) is computed on first use with a double-double series.
+ */
+
+#define POW_TABLE_BITS 7
+#define POW_TABLE_SIZE (1 << POW_TABLE_BITS)
+
+static double pow_inverse[POW_TABLE_SIZE];   /* c, 1/m rounded to 20 bits */
+static double pow_log_hi[POW_TABLE_SIZE];    /* -log(c), -log(2c) in the upper half */
+static double pow_log_lo[POW_TABLE_SIZE];
+static int pow_table_ready;
+
+
+/* (a_hi + a_lo) / (b_hi + b_lo) as a double-double */
+LIBM_INLINE vdouble dd_divide(vdouble a_hi, vdouble a_lo, vdouble b_hi, vdouble b_lo, vdouble *lo)
+{
+    vdouble q = a_hi / b_hi;
+    vdouble p_err, p = two_product(q, b_hi, &p_err);
+    vdouble r = (((a_hi - p) - p_err) + a_lo - q * b_lo) / b_hi;
+    return fast_two_sum(q, r, lo);
+}
+
+static LIBM_FAST void init_pow_table(void)
+{
+    for (int i = 0; i < POW_TABLE_SIZE; i++) {
+        /* Middle of the interval of m, 1/m cut to 20 bits so m c stays close to 1 */
+        double m = 1.0 + (i + 0.5) / POW_TABLE_SIZE;
+        double c = (double)(int64_t)(0x1p20 / m) * 0x1p-20;
+        if (i == 0)
+            c = 1.0;
+        if (i == POW_TABLE_SIZE - 1)
+            c = 0.5;
+        double b = i >= POW_TABLE_SIZE / 2 ? 2.0 * c : c;
+
+        /* log(b) = 2 atanh(s), s = (b - 1) / (b + 1), summed in double-double from the smallest term */
+        vdouble s_lo, s = dd_divide(v_splat(b - 1.0), v_splat(0.0), v_splat(b + 1.0), v_splat(0.0), &s_lo);
+        vdouble s2_lo, s2 = two_product(s, s, &s2_lo);
+        s2_lo += 2.0 * s * s_lo;
+        vdouble sum = v_splat(0.0), sum_lo = v_splat(0.0);
+        for (int n = 61; n >= 1; n -= 2) {
+            /* sum = 1/n + s^2 sum */
+            vdouble p_err, p = two_product(sum, s2, &p_err);
+            p_err += sum * s2_lo + sum_lo * s2;
+            vdouble q_lo, q = dd_divide(v_splat(1.0), v_splat(0.0), v_splat((double)n), v_splat(0.0), &q_lo);
+            vdouble e, t = two_sum(q, p, &e);
+            sum = fast_two_sum(t, e + q_lo + p_err, &sum_lo);
+        }
+        vdouble r_err, r = two_product(sum, s, &r_err);
+        r_err += sum * s_lo + sum_lo * s;
+        r = fast_two_sum(r, r_err, &r_err);
+
+        pow_inverse[i] = c;
+        pow_log_hi[i] = -2.0 * r[0];
+        pow_log_lo[i] = -2.0 * r_err[0];
+    }
+    __atomic_store_n(&pow_table_ready, 1, __ATOMIC_RELEASE);
+}
+
+LIBM_INLINE vdouble gather(const double *table, vlong index)
+{
+#ifdef __AVX2__
+    return (vdouble)_mm256_i64gather_pd(table, (__m256i)index, 8);
+#else
+    return (vdouble){ table[index[0]], table[index[1]], table[index[2]], table[index[3]] };
+#endif
+}
+
+/* log(x) as hi + lo for positive finite x */
+LIBM_INLINE vdouble log_dd(vdouble x, vdouble *lo)
+{
+    vlong subnormal = x < 0x1p-1022;
+    x = v_select(subnormal, x * 0x1p54, x);
+    vlong bits = as_long(x);
+    vlong index = (bits >> (52 - POW_TABLE_BITS)) & (POW_TABLE_SIZE - 1);
+    vlong upper = index >= POW_TABLE_SIZE / 2;
+    vdouble k = int_to_double(((bits >> 52) & 0x7FF) - 1023 - (subnormal & 54) - upper);
+    vdouble m = as_double((bits & 0x000FFFFFFFFFFFFF) | 0x3FF0000000000000);
+
+    vdouble c = gather(pow_inverse, index);
+    vdouble lc_hi = gather(pow_log_hi, index);
+    vdouble lc_lo = gather(pow_log_lo, index);
+
+    /* r = m c - 1 exactly: c has 20 bits, the 33 high bits of m times c and
+       the low bits times c are exact, and so is subtracting 1 from the first */
+    vdouble m_hi = as_double(as_long(m) & (int64_t)0xFFFFFFFFFFF00000);
+    vdouble r_lo, r = two_sum(m_hi * c - 1.0, (m - m_hi) * c, &r_lo);
+
+    /* log(1 + r) = r - r^2/2 + r^3 (1/3 - r/4 + ... - r^7/10), |r| < 2^-7.
+       r^2 from the 26 high bits of r, whose square is exact */
+    vdouble r_hi = as_double(as_long(r) & (int64_t)0xFFFFFFFFF8000000);
+    vdouble h = -0.5 * (r_hi * r_hi);
+    vdouble h_lo = -0.5 * ((r - r_hi) * (r + r_hi)) - r * r_lo;
+    vdouble tail = 1.0 / 3 - r * (0.25 - r * (0.2 - r * (1.0 / 6 - r * (1.0 / 7 - r * (0.125 - r * (1.0 / 9 - r * 0.1))))));
+    tail *= r * r * r;
+
+    /* k ln2 + (-log c) + r + h + tail */
+    vdouble a = k * ln2_hi, a_lo = k * ln2_lo;
+    vdouble e1, s = two_sum(a, lc_hi, &e1);
+    vdouble e2; s = two_sum(s, r, &e2);
+    vdouble e3; s = two_sum(s, h, &e3);
+    vdouble rest = e1 + e2 + e3 + a_lo + lc_lo + r_lo + h_lo + tail;
+    return fast_two_sum(s, rest, lo);
+}
+
+/* True for lanes holding an integer, and in *odd for odd ones */
+LIBM_INLINE vlong is_integer(vdouble y, vlong *odd)
+{
+    vdouble ay = v_abs(y);
+    vlong n;
+    vlong small = ay < 0x1p52;
+    vdouble rounded = round_to_int(v_select(small, ay, v_splat(0.0)), &n);
+    vlong integer = ~small | (rounded == ay);
+    vlong low_bit = (small & n & 1) | (~small & as_long(ay) & 1);
+    *odd = integer & (ay < 0x1p53) & (low_bit != 0);
+    return integer;
+}
+
+LIBM_INLINE vdouble pow_kernel(vdouble x, vdouble y)
+{
+    const vdouble inf = v_splat(__builtin_inf());
+    vdouble ax = v_abs(x), ay = v_abs(y);
+
+    /* The ordinary path on finite non zero |x|, the rest is patched below */
+    vlong ordinary = (ax > 0.0) & (ax < inf);
+    vdouble l_lo, l = log_dd(v_select(ordinary, ax, v_splat(1.0)), &l_lo);
+    /* |log x| >= 2^-53 unless x = 1, so past |y| = 2^64 the result is 0, 1 or
+       inf already. Clamping keeps two_product's split of y from overflowing. */
+    vdouble yc = v_select(ay > 0x1p64, v_select(y < 0.0, v_splat(-0x1p64), v_splat(0x1p64)), y);
+    vdouble p_lo, p = two_product(yc, l, &p_lo);
+    p_lo += yc * l_lo;
+    p = fast_two_sum(p, p_lo, &p_lo);
+    /* Far outside the range of exp the product may have overflowed its error */
+    vdouble z = exp_kernel(p, v_select(v_abs(p) < 1000.0, p_lo, v_splat(0.0)));
+
+    /* Positive x and finite y are done, y = 0 gives exp(0) = 1 */
+    if (!v_any(~((x > 0.0) & (x < inf) & (ay < inf))))
+        return v_select(x == 1.0, v_splat(1.0), z);
+
+    vlong odd, integer = is_integer(y, &odd);
+
+    /* |x| = 0 or inf: 0 or inf depending on the sign of y */
+    vdouble edge = v_select((ax == 0.0) == (y < 0.0), inf, v_splat(0.0));
+    z = v_select(ordinary, z, edge);
+    /* y = inf: 1 at |x| = 1, else 0 or inf */
+    vdouble y_inf = v_select(ax == 1.0, v_splat(1.0), v_select((ax < 1.0) == (y < 0.0), inf, v_splat(0.0)));
+    z = v_select(ay == inf, y_inf, z);
+
+    /* Negative x: odd y keeps the sign, other integers drop it, the rest is nan */
+    vlong negative = as_long(x) < 0;
+    z = v_select(negative & odd, -z, z);
+    z = v_select(negative & ~integer & ordinary, v_splat(__builtin_nan("")), z);
+
+    /* nan in, nan out, except pow(x, 0) = pow(1, y) = 1 */
+    z = v_select((x != x) | (y != y), x + y, z);
+    return v_select((y == 0.0) | (x == 1.0), v_splat(1.0), z);
+}
+
+
+/*
+ * sin and cos
+ *
+ * x = n pi/2 + r with r as a double-double and |r| <= pi/4, then fdlibm's
+ * kernels by the quadrant n. Below 2^20 pi/2 pi/2 is subtracted in three
+ * parts (Cody-Waite, 151 bits), above that the lanes are reduced one at a time
+ * with the bits of 2/pi (Payne-Hanek).
+ */
+
+static const double inv_pio2 = 6.36619772367581382433e-01;
+static const double pio2_1   = 1.57079632673412561417e+00; /* first 33 bits of pi/2 */
+static const double pio2_2   = 6.07710050630396597660e-11; /* second 33 bits */
+static const double pio2_3   = 2.02226624871116645580e-21; /* third 33 bits */
+static const double pio2_3t  = 8.47842766036889956997e-32;
+
+#define PIO2_MEDIUM 1647099.3291652855 /* 2^20 pi/2 */
+
+/* 2/pi, 1280 bits after the binary point */
+static const uint64_t two_over_pi[20] = {
+    0xA2F9836E4E441529, 0xFC2757D1F534DDC0, 0xDB6295993C439041, 0xFE5163ABDEBBC561,
+    0xB7246E3A424DD2E0, 0x06492EEA09D1921C, 0xFE1DEB1CB129A73E, 0xE88235F52EBB4484,
+    0xE99C7026B45F7E41, 0x3991D639835339F4, 0x9C845F8BBDF9283B, 0x1FF897FFDE05980F,
+    0xEF2F118B5A0A6D1F, 0x6D367ECF27CB09B7, 0x4F463F669E5FEA2D, 0x7527BAC7EBE5F17B,
+    0x3D0739F78A5292EA, 0x6BFB5FB11F8D5D08, 0x56033046FC7B6BAB, 0xF0CFBC209AF4361D,
+};
+
+static const double pio2_hi = 0x1.921fb54442d18p+0;
+static const double pio2_lo = 0x1.1a62633145c07p-54;
+
+static const double sin_s1 = -1.66666666666666324348e-01;
+static const double sin_s2 =  8.33333333332248946124e-03;
+static const double sin_s3 = -1.98412698298579493134e-04;
+static const double sin_s4 =  2.75573137070700676789e-06;
+static const double sin_s5 = -2.50507602534068634195e-08;
+static const double sin_s6 =  1.58969099521155010221e-10;
+
+static const double cos_c1 =  4.16666666666666019037e-02;
+static const double cos_c2 = -1.38888888888741095749e-03;
+static const double cos_c3 =  2.48015872894767294178e-05;
+static const double cos_c4 = -2.75573143513906633035e-07;
+static const double cos_c5 =  2.08757232129817482790e-09;
+static const double cos_c6 = -1.13596475577881948265e-11;
+
+/* 64 bits of 2/pi starting at bit p after the point, bits before the point are 0 */
+static uint64_t two_over_pi_at(int p)
+{
+    if (p <= -64)
+        return 0;
+    if (p < 0)
+        return two_over_pi[0] >> -p;
+    int i = p / 64, b = p % 64;
+    return b ? two_over_pi[i] << b | two_over_pi[i + 1] >> (64 - b) : two_over_pi[i];
+}
+
+static double scale_by_power_of_two(double x, int n)
+{
+    union { double d; uint64_t u; } p;
+    p.u = (uint64_t)(n + 1023) << 52;
+    return x * p.d;
+}
+
+/* x mod pi/2 for finite |x| >= 2^20 pi/2, returns the quadrant */
+static LIBM_FAST int reduce_large(double x, double *y0, double *y1)
+{
+    union { double d; uint64_t u; } v = { x };
+    int negative = (int)(v.u >> 63);
+    int e = (int)((v.u >> 52) & 0x7FF) - 1075;
+    uint64_t m = (v.u & 0x000FFFFFFFFFFFFF) | 1ull << 52;
+
+    /* |x| 2/pi = m 2^e 2/pi, bits of 2/pi before p - 3 only add multiples of 8 */
+    int p = e - 3;
+    uint64_t w0 = two_over_pi_at(p), w1 = two_over_pi_at(p + 64), w2 = two_over_pi_at(p + 128);
+    unsigned __int128 a2 = (unsigned __int128)m * w2;
+    unsigned __int128 a1 = (unsigned __int128)m * w1 + (uint64_t)(a2 >> 64);
+    unsigned __int128 a0 = (unsigned __int128)m * w0 + (uint64_t)(a1 >> 64);
+    /* The product scaled by 2^-189: 3 integer bits and the fraction */
+    uint64_t p2 = (uint64_t)a0, p1 = (uint64_t)a1, p0 = (uint64_t)a2;
+    int n = (int)(p2 >> 61);
+    unsigned __int128 f = (unsigned __int128)(p2 << 3 | p1 >> 61) << 64 | (p1 << 3 | p0 >> 61);
+
+    /* Fractions of a half or more belong to the next quadrant */
+    int sign = 0;
+    if (f >> 127) {
+        n++;
+        f = -f;
+        sign = 1;
+    }
+    int shift = (uint64_t)(f >> 64) ? __builtin_clzll((uint64_t)(f >> 64)) : 64 + __builtin_clzll((uint64_t)f | 1);
+    f <<= shift;
+    uint64_t top = (uint64_t)(f >> 64), next = (uint64_t)f;
+    double hi = scale_by_power_of_two((double)(top >> 11), 11 - 64 - shift);
+    double lo = scale_by_power_of_two((double)((top & 0x7FF) << 53 | next >> 11), -117 - shift);
+
+    /* r = (hi + lo) pi/2 */
+    vdouble r_err, r = two_product(v_splat(hi), v_splat(pio2_hi), &r_err);
+    r_err += hi * pio2_lo + lo * pio2_hi;
+    r = fast_two_sum(r, r_err, &r_err);
+    if (sign ^ negative) {
+        r = -r;
+        r_err = -r_err;
+    }
+    *y0 = r[0];
+    *y1 = r_err[0];
+    return (negative ? -n : n) & 3;
+}
+
+/* r = x - n pi/2 as y0 + y1, returns n mod 4 */
+LIBM_INLINE vlong reduce_pio2(vdouble x, vdouble *y0, vdouble *y1)
+{
+    vlong large = (v_abs(x) >= PIO2_MEDIUM) & (v_abs(x) < __builtin_inf());
+    vlong n;
+    vdouble fn = round_to_int(v_select(large, v_splat(0.0), x) * inv_pio2, &n);
+
+    /* fn times each 33 bit part is exact, so is the first subtraction */
+    vdouble r = x - fn * pio2_1;
+    vdouble e1, e2;
+    r = two_sum(r, -(fn * pio2_2), &e1);
+    r = two_sum(r, -(fn * pio2_3), &e2);
+    *y0 = fast_two_sum(r, (e1 + e2) - fn * pio2_3t, y1);
+    /* Below pi/4 x is already reduced, this also keeps the sign of -0 */
+    vlong none = fn == 0.0;
+    *y0 = v_select(none, x, *y0);
+    *y1 = v_select(none, v_splat(0.0), *y1);
+
+    if (v_any(large)) {
+        for (int i = 0; i < 4; i++) {
+            if (!large[i])
+                continue;
+            /* Scalar calls have the same x in every lane */
+            if (i > 0 && large[i - 1] && x[i] == x[i - 1]) {
+                n[i] = n[i - 1];
+                (*y0)[i] = (*y0)[i - 1];
+                (*y1)[i] = (*y1)[i - 1];
+                continue;
+            }
+            double a, b;
+            n[i] = reduce_large(x[i], &a, &b);
+            (*y0)[i] = a;
+            (*y1)[i] = b;
+        }
+    }
+    return n & 3;
+}
+
+/* sin(x + y) for |x| <= pi/4 */
+LIBM_INLINE vdouble sin_kernel(vdouble x, vdouble y)
+{
+    vdouble z = x * x;
+    vdouble v = z * x;
+    vdouble r = sin_s2 + z * (sin_s3 + z * (sin_s4 + z * (sin_s5 + z * sin_s6)));
+    return x - ((z * (0.5 * y - v * r) - y) - v * sin_s1);
+}
+
+/* cos(x + y) for |x| <= pi/4 */
+LIBM_INLINE vdouble cos_kernel(vdouble x, vdouble y)
+{
+    vdouble z = x * x;
+    vdouble w = z * z;
+    vdouble r = z * (cos_c1 + z * (cos_c2 + z * cos_c3)) + w * w * (cos_c4 + z * (cos_c5 + z * cos_c6));
+    vdouble hz = 0.5 * z;
+    w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+/* sin(x + quadrant pi/2) */
+LIBM_INLINE vdouble sin_quadrant(vdouble x, vlong quadrant)
+{
+    vdouble y0, y1;
+    vlong n = reduce_pio2(x, &y0, &y1) + quadrant;
+    vdouble s = sin_kernel(y0, y1), c = cos_kernel(y0, y1);
+    vdouble r = v_select((n & 1) != 0, c, s);
+    return v_select((n & 2) != 0, -r, r);
+}
+
+LIBM_INLINE vdouble sin_v(vdouble x)
+{
+    return sin_quadrant(x, (vlong){ 0, 0, 0, 0 });
+}
+
+LIBM_INLINE vdouble cos_v(vdouble x)
+{
+    return sin_quadrant(x, (vlong){ 1, 1, 1, 1 });
+}
+
+
+/*
+ * tanh
+ *
+ * Odd Taylor series below 0.55, where its terms fall by 8 per power of x^2.
+ * Above, 1 - 2/(exp(2|x|) + 1) loses at most a bit to the subtraction.
+ */
+
+static const double tanh_taylor[18] = {
+    -0.33333333333333331,     0.13333333333333333,     -0.053968253968253971,
+     0.021869488536155203,   -0.0088632355299021973,    0.0035921280365724811,
+    -0.0014558343870513183,   0.00059002744094558595,  -0.00023912911424355248,
+     9.6915379569294509e-05, -3.9278323883316833e-05,   1.5918905069328964e-05,
+    -6.4516892156554306e-06,  2.6147711512907546e-06,  -1.0597268320104654e-06,
+     4.2949110782738057e-07, -1.7406618963571648e-07,   7.0546369464009681e-08,
+};
+
+LIBM_INLINE vdouble tanh_v(vdouble x)
+{
+    vdouble ax = v_abs(x);
+
+    vdouble z = x * x;
+    vdouble p = v_splat(tanh_taylor[17]);
+    for (int i = 16; i >= 0; i--)
+        p = tanh_taylor[i] + z * p;
+    vdouble small = ax + ax * (z * p);
+
+    vdouble e = exp_kernel(2.0 * ax, v_splat(0.0));
+    vdouble large = 1.0 - 2.0 / (e + 1.0);
+    return v_copysign(v_select(ax < 0.55, small, large), x);
+}
+
+
+/* sqrt: sqrtpd is correctly rounded */
+LIBM_INLINE vdouble sqrt_v(vdouble x)
+{
+#ifdef __AVX2__
+    return (vdouble)_mm256_sqrt_pd((__m256d)x);
+#else
+    __m128d lo = _mm_sqrt_pd(_mm_set_pd(x[1], x[0]));
+    __m128d hi = _mm_sqrt_pd(_mm_set_pd(x[3], x[2]));
+    return (vdouble){ _mm_cvtsd_f64(lo), _mm_cvtsd_f64(_mm_unpackhi_pd(lo, lo)), _mm_cvtsd_f64(hi), _mm_cvtsd_f64(_mm_unpackhi_pd(hi, hi)) };
+#endif
+}
+
+LIBM_INLINE vdouble exp_v(vdouble x)
+{
+    vdouble y = exp_kernel(x, v_splat(0.0));
+    return v_select(x != x, x + x, y);
+}
+
+LIBM_INLINE vdouble log_v(vdouble x)
+{
+    return log_kernel(x);
+}
+
+LIBM_INLINE vdouble pow_v(vdouble x, vdouble y)
+{
+    if (!__atomic_load_n(&pow_table_ready, __ATOMIC_ACQUIRE))
+        init_pow_table();
+    return pow_kernel(x, y);
+}
+
+/* Four floats widened to doubles and back. Without AVX one lane at a time,
+   GCC 12 crashes on __builtin_convertvector and vector initializers there */
+LIBM_INLINE vdouble load_floats(const float *x)
+{
+#ifdef __AVX2__
+    return (vdouble)_mm256_cvtps_pd(_mm_loadu_ps(x));
+#else
+    vdouble v;
+    for (int i = 0; i < 4; i++)
+        v[i] = x[i];
+    return v;
+#endif
+}
+
+LIBM_INLINE void store_floats(float *y, vdouble v)
+{
+#ifdef __AVX2__
+    _mm_storeu_ps(y, _mm256_cvtpd_ps((__m256d)v));
+#else
+    for (int i = 0; i < 4; i++)
+        y[i] = (float)v[i];
+#endif
+}
+
+
+/*
+ * Entry points
+ */
+
+#define LIBM_UNARY(name, kernel)                                                \
+    LIBM_FAST double name(double x)                                             \
+    {                                                                           \
+        return kernel(v_splat(x))[0];                                           \
+    }                                                                           \
+                                                                                \
+    LIBM_FAST float name##f(float x)                                            \
+    {                                                                           \
+        return (float)kernel(v_splat(x))[0];                                      \
+    }                                                                           \
+                                                                                \
+    LIBM_FAST void name##_array(double *y, const double *x, size_t n)           \
+    {                                                                           \
+        size_t i = 0;                                                           \
+        for (; i + 4 <= n; i += 4)                                              \
+            *(vdouble_u *)(y + i) = kernel(*(const vdouble_u *)(x + i));        \
+        if (i < n) {                                                            \
+            vdouble v = v_splat(0.0);                                           \
+            for (size_t j = 0; i + j < n; j++)                                  \
+                v[j] = x[i + j];                                                \
+            v = kernel(v);                                                      \
+            for (size_t j = 0; i + j < n; j++)                                  \
+                y[i + j] = v[j];                                                \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    LIBM_FAST void name##f_array(float *y, const float *x, size_t n)            \
+    {                                                                           \
+        size_t i = 0;                                                           \
+        for (; i + 4 <= n; i += 4) {                                            \
+            vdouble v = load_floats(x + i); \
+            store_floats(y + i, kernel(v));  \
+        }                                                                       \
+        if (i < n) {                                                            \
+            vdouble v = v_splat(0.0);                                           \
+            for (size_t j = 0; i + j < n; j++)                                  \
+                v[j] = x[i + j];                                                \
+            v = kernel(v);                                                      \
+            for (size_t j = 0; i + j < n; j++)                                  \
+                y[i + j] = (float)v[j];                                         \
+        }                                                                       \
+    }
+
+LIBM_UNARY(exp, exp_v)
+LIBM_UNARY(log, log_v)
+LIBM_UNARY(sin, sin_v)
+LIBM_UNARY(cos, cos_v)
+LIBM_UNARY(tanh, tanh_v)
+
+/* sqrt and sqrtf use the scalar instructions, the double rounding of a
+   float sqrt through double is harmless (53 >= 2 * 24 + 2) */
+LIBM_FAST double sqrt(double x)
+{
+    return _mm_cvtsd_f64(_mm_sqrt_sd(_mm_set_sd(x), _mm_set_sd(x)));
+}
+
+LIBM_FAST float sqrtf(float x)
+{
+    return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+}
+
+LIBM_FAST void sqrt_array(double *y, const double *x, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        *(vdouble_u *)(y + i) = sqrt_v(*(const vdouble_u *)(x + i));
+    for (; i < n; i++)
+        y[i] = sqrt(x[i]);
+}
+
+LIBM_FAST void sqrtf_array(float *y, const float *x, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i, _mm256_sqrt_ps(_mm256_loadu_ps(x + i)));
+#endif
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(y + i, _mm_sqrt_ps(_mm_loadu_ps(x + i)));
+    for (; i < n; i++)
+        y[i] = sqrtf(x[i]);
+}
+
+LIBM_FAST double pow(double x, double y)
+{
+    return pow_v(v_splat(x), v_splat(y))[0];
+}
+
+LIBM_FAST float powf(float x, float y)
+{
+    return (float)pow_v(v_splat(x), v_splat(y))[0];
+}
+
+LIBM_FAST void pow_array(double *z, const double *x, const double *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        *(vdouble_u *)(z + i) = pow_v(*(const vdouble_u *)(x + i), *(const vdouble_u *)(y + i));
+    for (; i < n; i++)
+        z[i] = pow(x[i], y[i]);
+}
+
+LIBM_FAST void powf_array(float *z, const float *x, const float *y, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vdouble a = load_floats(x + i);
+        vdouble b = load_floats(y + i);
+        store_floats(z + i, pow_v(a, b));
+    }
+    for (; i < n; i++)
+        z[i] = powf(x[i], y[i]);
+}
@@ -0,0 +1,37 @@
+/*
+ * Renames the libm functions to libm_* so src/libc/libm.c can be included next
+ * to the system libm, same use as libc_rename.h:
+ *
+ *   #include "libc/libm_rename.h"
+ *   #include "libc/libm.c"
+ *   #include "libc/libm_unrename.h" // leave out to keep calling libm_*
+ */
+
+#define exp         libm_exp
+#define expf        libm_expf
+#define exp_array   libm_exp_array
+#define expf_array  libm_expf_array
+#define log         libm_log
+#define logf        libm_logf
+#define log_array   libm_log_array
+#define logf_array  libm_logf_array
+#define pow         libm_pow
+#define powf        libm_powf
+#define pow_array   libm_pow_array
+#define powf_array  libm_powf_array
+#define sin         libm_sin
+#define sinf        libm_sinf
+#define sin_array   libm_sin_array
+#define sinf_array  libm_sinf_array
+#define cos         libm_cos
+#define cosf        libm_cosf
+#define cos_array   libm_cos_array
+#define cosf_array  libm_cosf_array
+#define tanh        libm_tanh
+#define tanhf       libm_tanhf
+#define tanh_array  libm_tanh_array
+#define tanhf_array libm_tanhf_array
+#define sqrt        libm_sqrt
+#define sqrtf       libm_sqrtf
+#define sqrt_array  libm_sqrt_array
+#define sqrtf_array libm_sqrtf_array
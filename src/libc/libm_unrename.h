@@ -0,0 +1,30 @@
+/* Undoes libm_rename.h, the names refer to the system libm again */
+
+#undef exp
+#undef expf
+#undef exp_array
+#undef expf_array
+#undef log
+#undef logf
+#undef log_array
+#undef logf_array
+#undef pow
+#undef powf
+#undef pow_array
+#undef powf_array
+#undef sin
+#undef sinf
+#undef sin_array
+#undef sinf_array
+#undef cos
+#undef cosf
+#undef cos_array
+#undef cosf_array
+#undef tanh
+#undef tanhf
+#undef tanh_array
+#undef tanhf_array
+#undef sqrt
+#undef sqrtf
+#undef sqrt_array
+#undef sqrtf_array
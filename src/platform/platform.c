@@ -1,7 +1,12 @@
+#ifdef OS_LINUX
+    #define _GNU_SOURCE // O_DIRECT, must come before any system header
+#endif
+
 #include "platform/platform.h"
 
 #ifdef OS_WINDOWS
     #define WIN32_MEAN_AND_LEAN
+    #define _WIN32_WINNT 0x0602 // WaitOnAddress
     #include "Windows.h"
     #include <stdarg.h>
     #include <stdio.h>
@@ -10,12 +15,26 @@
 #endif
 #ifdef OS_LINUX
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
     #include "sys/mman.h"
     #include <stdarg.h>
     #include <stdio.h>
     #include <string.h>
     #include <stdlib.h>
     #include <errno.h>
+    #include <limits.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+    #include <time.h>
+    #include <pthread.h>
+    #include <sys/uio.h>
+    #include <linux/io_uring.h>
+    #include <signal.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+    #include <x86intrin.h>
 #endif
 
 
@@ -50,164 +69,2060 @@ void ed__destroy(EDHandle handle) {
 // ##########################
 
 #if defined(OS_WINDOWS) || defined(OS_LINUX)
-    #define MAX_FILE_HANDLES 100
-    static FILE* handles[MAX_FILE_HANDLES];
-    static int handles_len;
+
+// Handle table
+//   Maps FSHandle to a native descriptor (fd on Linux, HANDLE on Windows).
+//   The table is a list of chunks where chunk k holds (FS_HANDLE_CHUNK_BASE << k) entries,
+//   so it grows without moving entries and 32 chunks cover every FSHandle value.
+//   Chunks are allocated on demand and never freed, which lets threads read entries without locks.
+//   Closed entries are pushed on a lock-free free list, the head is tagged to avoid ABA.
+
+#define FS_HANDLE_CHUNK_BASE  64
+#define FS_HANDLE_CHUNK_COUNT 32
+#define FS_NATIVE_INVALID     ((intptr_t)-1)
+
+typedef struct {
+    intptr_t native;
+    uint32_t next_free; // index + 1 of next entry in free list, 0 = end of list
+    uint32_t flags;
+} FSHandleEntry;
+
+static FSHandleEntry* handle_chunks[FS_HANDLE_CHUNK_COUNT];
+static uint32_t       handle_count;     // entries handed out so far (not reused ones)
+static uint64_t       handle_free_list; // (tag << 32) | (index + 1)
+
+static FSHandleEntry* fs_handle_entry(FSHandle handle, bool allocate_chunk) {
+    uint64_t biased = (uint64_t)handle + FS_HANDLE_CHUNK_BASE;
+    int chunk = 63 - __builtin_clzll(biased) - __builtin_ctz(FS_HANDLE_CHUNK_BASE);
+    uint64_t offset = biased - ((uint64_t)FS_HANDLE_CHUNK_BASE << chunk);
+    if (chunk >= FS_HANDLE_CHUNK_COUNT)
+        return NULL;
+
+    FSHandleEntry* entries = __atomic_load_n(&handle_chunks[chunk], __ATOMIC_ACQUIRE);
+    if (!entries) {
+        if (!allocate_chunk)
+            return NULL;
+        uint64_t size = sizeof(FSHandleEntry) * ((uint64_t)FS_HANDLE_CHUNK_BASE << chunk);
+        FSHandleEntry* new_entries = malloc(size);
+        if (!new_entries)
+            return NULL;
+        // 'handle_count' covers indices before their entry is stored, until then they read as invalid, not fd 0.
+        for (uint64_t i = 0; i < ((uint64_t)FS_HANDLE_CHUNK_BASE << chunk); i++)
+            new_entries[i] = (FSHandleEntry){ .native = FS_NATIVE_INVALID };
+        if (__atomic_compare_exchange_n(&handle_chunks[chunk], &entries, new_entries, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            entries = new_entries;
+        } else {
+            // Another thread allocated the chunk first, 'entries' holds their chunk.
+            free(new_entries);
+        }
+    }
+    return &entries[offset];
+}
+
+static void fs_handle_release(FSHandle handle, FSHandleEntry* entry) {
+    __atomic_store_n(&entry->native, FS_NATIVE_INVALID, __ATOMIC_RELEASE);
+    uint64_t head = __atomic_load_n(&handle_free_list, __ATOMIC_ACQUIRE);
+    while (true) {
+        __atomic_store_n(&entry->next_free, (uint32_t)head, __ATOMIC_RELAXED);
+        uint64_t new_head = ((head >> 32) + 1) << 32 | (handle + 1);
+        if (__atomic_compare_exchange_n(&handle_free_list, &head, new_head, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            break;
+    }
+}
+
+static FSHandle fs_handle_alloc(intptr_t native, uint32_t flags) {
+    FSHandle handle;
+    uint64_t head = __atomic_load_n(&handle_free_list, __ATOMIC_ACQUIRE);
+    while (true) {
+        uint32_t first = (uint32_t)head;
+        if (first == 0) {
+            handle = __atomic_fetch_add(&handle_count, 1, __ATOMIC_RELAXED);
+            if (handle == FS_INVALID_HANDLE)
+                return FS_INVALID_HANDLE;
+            break;
+        }
+        // Entry stays valid memory even if another thread pops it concurrently, chunks are never freed.
+        FSHandleEntry* entry = fs_handle_entry(first - 1, false);
+        uint32_t next = __atomic_load_n(&entry->next_free, __ATOMIC_RELAXED);
+        uint64_t new_head = ((head >> 32) + 1) << 32 | next;
+        if (__atomic_compare_exchange_n(&handle_free_list, &head, new_head, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            handle = first - 1;
+            break;
+        }
+    }
+
+    FSHandleEntry* entry = fs_handle_entry(handle, true);
+    if (!entry) {
+        // No memory for the chunk, give the index back. Undo the bump if nobody took an index since,
+        // otherwise a later allocation may have made the chunk and the index goes on the free list.
+        uint32_t expected = handle + 1;
+        if (!__atomic_compare_exchange_n(&handle_count, &expected, handle, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            entry = fs_handle_entry(handle, true);
+            if (entry)
+                fs_handle_release(handle, entry);
+        }
+        return FS_INVALID_HANDLE;
+    }
+    // Flags and native are stored before the handle is returned, fs_native pairs with the release.
+    entry->flags = flags;
+    __atomic_store_n(&entry->native, native, __ATOMIC_RELEASE);
+    return handle;
+}
+
+static intptr_t fs_native(FSHandle handle) {
+    if (handle >= __atomic_load_n(&handle_count, __ATOMIC_ACQUIRE))
+        return FS_NATIVE_INVALID;
+    FSHandleEntry* entry = fs_handle_entry(handle, false);
+    if (!entry)
+        return FS_NATIVE_INVALID;
+    return __atomic_load_n(&entry->native, __ATOMIC_ACQUIRE);
+}
+
 #endif
 
 FSHandle fs__open(const char* path, uint32_t flags) {
-    #if defined(OS_WINDOWS) || defined(OS_LINUX)
-        FILE* file;
-        if (flags & FS_WRITE) {
-            file = fopen(path, "wb");
+    #ifdef OS_LINUX
+        int open_flags = O_CLOEXEC;
+        if ((flags & FS_WRITE) && (flags & FS_READ)) {
+            open_flags |= O_CREAT | O_RDWR;
+        } else if (flags & FS_WRITE) {
+            open_flags |= O_CREAT | O_TRUNC | O_WRONLY;
         } else if (flags & FS_READ) {
-            file = fopen(path, "rb");
+            open_flags |= O_RDONLY;
+        } else {
+            return FS_INVALID_HANDLE;
         }
-        if (!file)
+        if (flags & FS_DIRECT)
+            open_flags |= O_DIRECT;
+
+        int fd = open(path, open_flags, 0644);
+        if (fd < 0)
             return FS_INVALID_HANDLE;
 
+        FSHandle handle = fs_handle_alloc(fd, flags);
+        if (handle == FS_INVALID_HANDLE) {
+            close(fd);
+            return FS_INVALID_HANDLE;
+        }
+        platform_log("Open [%d] = %s, %u\n", (int)handle, path, flags);
+        return handle;
+    #endif
+    #ifdef OS_WINDOWS
+        DWORD access = 0;
+        DWORD creation = 0;
+        if ((flags & FS_WRITE) && (flags & FS_READ)) {
+            access = GENERIC_READ | GENERIC_WRITE;
+            creation = OPEN_ALWAYS;
+        } else if (flags & FS_WRITE) {
+            access = GENERIC_WRITE;
+            creation = CREATE_ALWAYS;
+        } else if (flags & FS_READ) {
+            access = GENERIC_READ;
+            creation = OPEN_EXISTING;
+        } else {
+            return FS_INVALID_HANDLE;
+        }
+        DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+        if (flags & FS_DIRECT)
+            attributes |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH;
 
-        // @TODO Atomic operation
-        if (handles_len >= MAX_FILE_HANDLES)
+        HANDLE file = CreateFileA(path, access, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, creation, attributes, NULL);
+        if (file == INVALID_HANDLE_VALUE)
             return FS_INVALID_HANDLE;
-        FSHandle handle = handles_len;
-        handles[handles_len] = file;
-        handles_len++;
 
+        FSHandle handle = fs_handle_alloc((intptr_t)file, flags);
+        if (handle == FS_INVALID_HANDLE) {
+            CloseHandle(file);
+            return FS_INVALID_HANDLE;
+        }
         platform_log("Open [%d] = %s, %u\n", (int)handle, path, flags);
         return handle;
     #endif
 }
 void fs__close(FSHandle handle) {
     #if defined(OS_WINDOWS) || defined(OS_LINUX)
-        FILE* file = handles[handle];
+        if (handle >= __atomic_load_n(&handle_count, __ATOMIC_ACQUIRE))
+            return;
+        FSHandleEntry* entry = fs_handle_entry(handle, false);
+        if (!entry)
+            return;
+        // Exchange so closing the same handle twice from two threads only closes once.
+        intptr_t native = __atomic_exchange_n(&entry->native, FS_NATIVE_INVALID, __ATOMIC_ACQ_REL);
+        if (native == FS_NATIVE_INVALID)
+            return;
 
-        int res = fclose(file);
+        #ifdef OS_LINUX
+            close((int)native);
+        #endif
+        #ifdef OS_WINDOWS
+            CloseHandle((HANDLE)native);
+        #endif
 
-        // @TODO Atomic operation
-        handles[handle] = NULL;
-        while (handles_len > 0 && handles[handles_len-1] == NULL) {
-            handles_len--;
-        }
+        fs_handle_release(handle, entry);
         platform_log("Close [%d]\n", (int)handle);
     #endif
 }
 
 void fs__info(FSHandle handle, FSInfo* info) {
-    #if defined(OS_WINDOWS) || defined(OS_LINUX)
-        FILE* file = handles[handle];
-        
-        size_t cur_pos = ftell(file);
-        fseek(file, 0, SEEK_END);
-        size_t file_size = ftell(file);
-        fseek(file, cur_pos, SEEK_SET);
+    info->file_size = 0;
+    info->is_directory = false;
 
-        info->file_size = file_size;
-        info->is_directory = false;
-
-        platform_log("FSInfo [%d] = %u\n", (int)handle, (unsigned)file_size);
+    #ifdef OS_LINUX
+        struct stat st;
+        if (fstat((int)fs_native(handle), &st) < 0)
+            return;
+        info->file_size = st.st_size;
+        info->is_directory = S_ISDIR(st.st_mode);
     #endif
+    #ifdef OS_WINDOWS
+        BY_HANDLE_FILE_INFORMATION file_info;
+        if (!GetFileInformationByHandle((HANDLE)fs_native(handle), &file_info))
+            return;
+        info->file_size = ((uint64_t)file_info.nFileSizeHigh << 32) | file_info.nFileSizeLow;
+        info->is_directory = (file_info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    #endif
+
+    platform_log("FSInfo [%d] = %u\n", (int)handle, (unsigned)info->file_size);
+}
+
+#ifdef OS_WINDOWS
+// Positional read/write through an OVERLAPPED offset, the handle is synchronous so it completes immediately.
+static int64_t fs_windows_transfer(HANDLE file, uint64_t offset, void* buffer, uint64_t size, bool write) {
+    uint64_t total = 0;
+    while (total < size) {
+        uint64_t remaining = size - total;
+        DWORD chunk = remaining > 0x40000000 ? 0x40000000 : (DWORD)remaining;
+        OVERLAPPED overlapped = { 0 };
+        overlapped.Offset     = (DWORD)(offset + total);
+        overlapped.OffsetHigh = (DWORD)((offset + total) >> 32);
+        DWORD transferred = 0;
+        BOOL ok;
+        if (write)
+            ok = WriteFile(file, (char*)buffer + total, chunk, &transferred, &overlapped);
+        else
+            ok = ReadFile(file, (char*)buffer + total, chunk, &transferred, &overlapped);
+        if (!ok) {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+                break;
+            return total > 0 ? (int64_t)total : -(int64_t)GetLastError();
+        }
+        if (transferred == 0)
+            break;
+        total += transferred;
+    }
+    return total;
 }
+#endif
+
 uint64_t fs__read(FSHandle handle, uint64_t offset, void* buffer, uint64_t size) {
-    #if defined(OS_WINDOWS) || defined(OS_LINUX)
-        FILE* file = handles[handle];
-        fseek(file, offset, SEEK_SET);
-        size_t res = fread(buffer, 1, size, file);
-        
+    #ifdef OS_LINUX
+        int fd = (int)fs_native(handle);
+        uint64_t total = 0;
+        // pread may return less than requested (signals, huge sizes), only stop at end of file.
+        while (total < size) {
+            ssize_t res = pread(fd, (char*)buffer + total, size - total, offset + total);
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res <= 0)
+                break;
+            total += res;
+        }
+        platform_log("Read [%d] = %u\n", (int)handle, (unsigned)total);
+        return total;
+    #endif
+    #ifdef OS_WINDOWS
+        int64_t res = fs_windows_transfer((HANDLE)fs_native(handle), offset, buffer, size, false);
         platform_log("Read [%d] = %u\n", (int)handle, (unsigned)res);
-        return res;
+        return res < 0 ? 0 : res;
     #endif
 }
 uint64_t fs__write(FSHandle handle, uint64_t offset, void* buffer, uint64_t size) {
-    #if defined(OS_WINDOWS) || defined(OS_LINUX)
-        FILE* file = handles[handle];
-        fseek(file, offset, SEEK_SET);
-        size_t res = fwrite(buffer, 1, size, file);
+    #ifdef OS_LINUX
+        int fd = (int)fs_native(handle);
+        uint64_t total = 0;
+        while (total < size) {
+            ssize_t res = pwrite(fd, (char*)buffer + total, size - total, offset + total);
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res <= 0)
+                break;
+            total += res;
+        }
+        platform_log("Write [%d] %d, %d = written %u\n", (int)handle, (int)offset, (int)size, (unsigned)total);
+        return total;
+    #endif
+    #ifdef OS_WINDOWS
+        int64_t res = fs_windows_transfer((HANDLE)fs_native(handle), offset, buffer, size, true);
         platform_log("Write [%d] %d, %d = written %u\n", (int)handle, (int)offset, (int)size, (unsigned)res);
-        return res;
+        return res < 0 ? 0 : res;
+    #endif
+}
+
+// Mappings must start at a page (Linux) or allocation granularity (Windows) boundary.
+static uint64_t fs_map_alignment() {
+    #ifdef OS_WINDOWS
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        return system_info.dwAllocationGranularity;
+    #endif
+    #ifdef OS_LINUX
+        return getpagesize();
+    #endif
+}
+
+void fs__advise(void* address, uint64_t size, int hints) {
+    uint64_t alignment = fs_map_alignment();
+    uint64_t delta = (uint64_t)address % alignment;
+    address = (char*)address - delta;
+    size += delta;
+
+    #ifdef OS_LINUX
+        if (hints & FS_MAP_SEQUENTIAL)
+            madvise(address, size, MADV_SEQUENTIAL);
+        if (hints & FS_MAP_RANDOM)
+            madvise(address, size, MADV_RANDOM);
+        if (hints & FS_MAP_WILLNEED)
+            madvise(address, size, MADV_WILLNEED);
+    #endif
+    #ifdef OS_WINDOWS
+        // Windows has no read-ahead hints for views, only prefetching.
+        if (hints & FS_MAP_WILLNEED) {
+            WIN32_MEMORY_RANGE_ENTRY range = { address, size };
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+    #endif
+}
+
+void* fs__map(FSHandle handle, uint64_t offset, uint64_t size, int flags) {
+    // Empty mappings fail on both systems (mmap EINVAL, MapViewOfFile maps everything)
+    if (size == 0)
+        return NULL;
+
+    uint64_t alignment = fs_map_alignment();
+    uint64_t delta = offset % alignment;
+    uint64_t aligned_offset = offset - delta;
+    void* base = NULL;
+
+    #ifdef OS_LINUX
+        int prot = PROT_READ;
+        int map_flags = MAP_SHARED;
+        if (flags & FS_MAP_PRIVATE) {
+            prot |= PROT_WRITE;
+            map_flags = MAP_PRIVATE;
+        } else if (flags & FS_MAP_SHARED) {
+            prot |= PROT_WRITE;
+        }
+        base = mmap(NULL, size + delta, prot, map_flags, (int)fs_native(handle), aligned_offset);
+        if (base == MAP_FAILED) {
+            log__printf("barf: mmap of file failed, %s\n", strerror(errno));
+            return NULL;
+        }
+    #endif
+    #ifdef OS_WINDOWS
+        DWORD protect = PAGE_READONLY;
+        DWORD access  = FILE_MAP_READ;
+        if (flags & FS_MAP_PRIVATE) {
+            protect = PAGE_WRITECOPY;
+            access  = FILE_MAP_COPY;
+        } else if (flags & FS_MAP_SHARED) {
+            protect = PAGE_READWRITE;
+            access  = FILE_MAP_WRITE;
+        }
+        HANDLE mapping = CreateFileMappingA((HANDLE)fs_native(handle), NULL, protect, 0, 0, NULL);
+        if (!mapping) {
+            log__printf("barf: CreateFileMapping failed, win error %u\n", (unsigned)GetLastError());
+            return NULL;
+        }
+        base = MapViewOfFile(mapping, access, (DWORD)(aligned_offset >> 32), (DWORD)aligned_offset, size + delta);
+        // The view keeps the mapping object alive.
+        CloseHandle(mapping);
+        if (!base) {
+            log__printf("barf: MapViewOfFile failed, win error %u\n", (unsigned)GetLastError());
+            return NULL;
+        }
+    #endif
+
+    void* address = (char*)base + delta;
+    int hints = flags & (FS_MAP_SEQUENTIAL | FS_MAP_RANDOM | FS_MAP_WILLNEED);
+    if (hints)
+        fs__advise(address, size, hints);
+    return address;
+}
+
+void fs__unmap(void* address, uint64_t size) {
+    if (!address)
+        return;
+    uint64_t delta = (uint64_t)address % fs_map_alignment();
+    #ifdef OS_LINUX
+        munmap((char*)address - delta, size + delta);
+    #endif
+    #ifdef OS_WINDOWS
+        UnmapViewOfFile((char*)address - delta);
     #endif
 }
 
 // ##########################
-//      Memory
+//      Asynchronous File IO
 // ##########################
 
-void* mem__alloc(uint64_t size, void* old_ptr) {
-    if (size == 0) {
-        free(old_ptr);
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+#ifdef OS_LINUX
+static int fs_native_fd(FSHandle handle) {
+    return (int)fs_native(handle);
+}
+#endif
+#ifdef OS_WINDOWS
+static HANDLE fs_native_handle(FSHandle handle) {
+    return (HANDLE)fs_native(handle);
+}
+#endif
+
+typedef struct {
+    #ifdef OS_LINUX
+        pthread_t thread;
+    #endif
+    #ifdef OS_WINDOWS
+        HANDLE thread;
+    #endif
+    ThreadFN func;
+    void*    arg;
+} PlatformThread;
+
+#ifdef OS_LINUX
+static void* platform_thread_entry(void* arg) {
+    PlatformThread* thread = arg;
+    thread->func(thread->arg);
+    return NULL;
+}
+#endif
+#ifdef OS_WINDOWS
+static DWORD WINAPI platform_thread_entry(LPVOID arg) {
+    PlatformThread* thread = arg;
+    thread->func(thread->arg);
+    return 0;
+}
+#endif
+
+static bool platform_thread_start(PlatformThread* thread, ThreadFN func, void* arg) {
+    thread->func = func;
+    thread->arg  = arg;
+    #ifdef OS_LINUX
+        return 0 == pthread_create(&thread->thread, NULL, platform_thread_entry, thread);
+    #endif
+    #ifdef OS_WINDOWS
+        thread->thread = CreateThread(NULL, 0, platform_thread_entry, thread, 0, NULL);
+        return thread->thread != NULL;
+    #endif
+}
+static void platform_thread_join(PlatformThread* thread) {
+    #ifdef OS_LINUX
+        pthread_join(thread->thread, NULL);
+    #endif
+    #ifdef OS_WINDOWS
+        WaitForSingleObject(thread->thread, INFINITE);
+        CloseHandle(thread->thread);
+    #endif
+}
+
+struct Thread {
+    PlatformThread platform;
+};
+
+Thread* thread__create(ThreadFN func, void* arg) {
+    Thread* thread = mem__alloc(sizeof(Thread), NULL);
+    if (!thread)
+        return NULL;
+    if (!platform_thread_start(&thread->platform, func, arg)) {
+        mem__alloc(0, thread);
         return NULL;
-    } else if (!old_ptr) {
-        return malloc(size);
     }
-    return realloc(old_ptr, size);
+    return thread;
 }
 
-void* mem__map(void* address, uint64_t size, int flags) {
-    #ifdef OS_WINDOWS
-        return VirtualAlloc(NULL, size, MEM_COMMIT, PAGE_READWRITE);
+void thread__join(Thread* thread) {
+    platform_thread_join(&thread->platform);
+    mem__alloc(0, thread);
+}
+
+#define FS_QUEUE_MAX_WORKERS 8
+
+struct FSQueue {
+    uint32_t depth;
+    uint32_t inflight; // submitted but not yet returned by fs__complete
+    bool     use_uring;
+
+    #ifdef OS_LINUX
+        // io_uring
+        int       ring_fd;
+        void*     sq_ring;
+        void*     cq_ring;
+        uint64_t  sq_ring_size;
+        uint64_t  cq_ring_size;
+        struct io_uring_sqe* sqes;
+        uint64_t  sqes_size;
+        uint32_t* sq_head;
+        uint32_t* sq_tail;
+        uint32_t* sq_mask;
+        uint32_t* sq_array;
+        uint32_t* cq_head;
+        uint32_t* cq_tail;
+        uint32_t* cq_mask;
+        struct io_uring_cqe* cqes;
     #endif
+
+    // Thread pool fallback, requests and completions are ring buffers of 'depth' elements.
+    // With io_uring 'completions' holds requests rejected before they reach the kernel.
+    SyncMutex      mutex;
+    SyncCondition  work_available;
+    SyncCondition  work_done;
+    bool           stop;
+    FSRequest*     requests;
+    uint32_t       request_head;
+    uint32_t       request_count;
+    FSCompletion*  completions;
+    uint32_t       completion_head;
+    uint32_t       completion_count;
+    uint32_t       worker_count;
+    PlatformThread workers[FS_QUEUE_MAX_WORKERS];
+};
+
+// Largest transfer Linux does in one read or write, larger requests complete short.
+// Every backend cuts at the same size so results don't depend on the backend.
+#define FS_MAX_TRANSFER 0x7ffff000
+
+// Fits the 32-bit length of an SQE, 'size' is a buffer count for vectored ops
+// and more than the kernel takes fails with EINVAL.
+static uint32_t fs_request_length(const FSRequest* request) {
+    uint64_t max = request->op == FS_OP_READV || request->op == FS_OP_WRITEV ? INT32_MAX : FS_MAX_TRANSFER;
+    return request->size > max ? (uint32_t)max : (uint32_t)request->size;
+}
+
+static int64_t fs_execute_request(const FSRequest* request) {
     #ifdef OS_LINUX
-        int page_size = getpagesize();
-        uint64_t aligned_size = size % page_size == 0 ? size : size + (page_size - size) % page_size;
-        void* ptr = mmap(NULL, aligned_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
-        if (ptr == (void*)-1) {
-            log__printf("barf: mmap failed, %s\n", strerror(errno));
-            return NULL;
+        int fd = fs_native_fd(request->handle);
+        uint32_t length = fs_request_length(request);
+        ssize_t res;
+        switch (request->op) {
+            case FS_OP_READ:   res = pread(fd, request->buffer, length, request->offset);  break;
+            case FS_OP_WRITE:  res = pwrite(fd, request->buffer, length, request->offset); break;
+            case FS_OP_READV:  res = preadv(fd, (struct iovec*)request->buffer, (int)length, request->offset);  break;
+            case FS_OP_WRITEV: res = pwritev(fd, (struct iovec*)request->buffer, (int)length, request->offset); break;
+            default: return -EINVAL;
         }
-        return ptr;
+        return res < 0 ? -errno : res;
     #endif
-}
-void mem__mapflag(void* address, uint64_t size, int flags) {
     #ifdef OS_WINDOWS
-        int mem_flags;
-        if ((flags & MEM_EXEC) && (flags & MEM_WRITE)) {
-            mem_flags = PAGE_EXECUTE_READWRITE;
-        } else if ((flags & MEM_EXEC)) {
-            mem_flags = PAGE_EXECUTE;
-        } else if ((flags & MEM_WRITE)) {
-            mem_flags = PAGE_READWRITE;
-        } else {
-            mem_flags = PAGE_READONLY;
+        if (request->op < FS_OP_READ || request->op > FS_OP_WRITEV)
+            return -(int64_t)ERROR_INVALID_PARAMETER;
+        HANDLE file = fs_native_handle(request->handle);
+        FSBuffer single = { request->buffer, fs_request_length(request) };
+        FSBuffer* buffers = &single;
+        uint64_t  buffer_count = 1;
+        bool write = request->op == FS_OP_WRITE || request->op == FS_OP_WRITEV;
+        if (request->op == FS_OP_READV || request->op == FS_OP_WRITEV) {
+            buffers = request->buffer;
+            buffer_count = fs_request_length(request);
         }
-        DWORD prev_flags;
-        BOOL res = VirtualProtect(address, size, mem_flags, &prev_flags);
-        if (!res) {
-            DWORD val = GetLastError();
-            log__printf("flag_memory: win error %u\n", (unsigned)val);
+        int64_t total = 0;
+        uint64_t offset = request->offset;
+        for (uint64_t i = 0; i < buffer_count; i++) {
+            OVERLAPPED overlapped = { 0 };
+            overlapped.Offset     = (DWORD)offset;
+            overlapped.OffsetHigh = (DWORD)(offset >> 32);
+            DWORD transferred = 0;
+            DWORD size = buffers[i].size > FS_MAX_TRANSFER ? FS_MAX_TRANSFER : (DWORD)buffers[i].size;
+            BOOL ok;
+            if (write)
+                ok = WriteFile(file, buffers[i].data, size, &transferred, &overlapped);
+            else
+                ok = ReadFile(file, buffers[i].data, size, &transferred, &overlapped);
+            if (!ok && GetLastError() != ERROR_HANDLE_EOF)
+                return total > 0 ? total : -(int64_t)GetLastError();
+            total  += transferred;
+            offset += transferred;
+            if (transferred < buffers[i].size)
+                break;
         }
+        return total;
     #endif
+}
+
+static void fs_queue_worker(void* arg) {
+    FSQueue* queue = arg;
+    sync__mutex_lock(&queue->mutex);
+    while (true) {
+        while (queue->request_count == 0 && !queue->stop)
+            sync__cond_wait(&queue->work_available, &queue->mutex);
+        if (queue->request_count == 0 && queue->stop)
+            break;
+
+        FSRequest request = queue->requests[queue->request_head];
+        queue->request_head = (queue->request_head + 1) % queue->depth;
+        queue->request_count--;
+        sync__mutex_unlock(&queue->mutex);
+
+        FSCompletion completion;
+        completion.user_data = request.user_data;
+        completion.result    = fs_execute_request(&request);
+
+        sync__mutex_lock(&queue->mutex);
+        // Can't overflow, fs__submit never lets more than 'depth' requests be in flight.
+        uint32_t index = (queue->completion_head + queue->completion_count) % queue->depth;
+        queue->completions[index] = completion;
+        queue->completion_count++;
+        sync__cond_broadcast(&queue->work_done);
+    }
+    sync__mutex_unlock(&queue->mutex);
+}
+
+#ifdef OS_LINUX
+static int io_uring_setup(uint32_t entries, struct io_uring_params* params) {
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+static int io_uring_enter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static bool fs_queue_init_uring(FSQueue* queue) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // Kernel may be too old or io_uring disabled (containers, seccomp), caller falls back to threads.
+    int ring_fd = io_uring_setup(queue->depth, &params);
+    if (ring_fd < 0)
+        return false;
+
+    queue->ring_fd      = ring_fd;
+    queue->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    queue->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (queue->cq_ring_size > queue->sq_ring_size)
+            queue->sq_ring_size = queue->cq_ring_size;
+        queue->cq_ring_size = queue->sq_ring_size;
+    }
+
+    queue->sq_ring = mmap(NULL, queue->sq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (queue->sq_ring == MAP_FAILED)
+        goto failed;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        queue->cq_ring = queue->sq_ring;
+    } else {
+        queue->cq_ring = mmap(NULL, queue->cq_ring_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (queue->cq_ring == MAP_FAILED) {
+            munmap(queue->sq_ring, queue->sq_ring_size);
+            goto failed;
+        }
+    }
+
+    queue->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    queue->sqes = mmap(NULL, queue->sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (queue->sqes == MAP_FAILED) {
+        munmap(queue->sq_ring, queue->sq_ring_size);
+        if (queue->cq_ring != queue->sq_ring)
+            munmap(queue->cq_ring, queue->cq_ring_size);
+        goto failed;
+    }
+
+    queue->sq_head  = (uint32_t*)((char*)queue->sq_ring + params.sq_off.head);
+    queue->sq_tail  = (uint32_t*)((char*)queue->sq_ring + params.sq_off.tail);
+    queue->sq_mask  = (uint32_t*)((char*)queue->sq_ring + params.sq_off.ring_mask);
+    queue->sq_array = (uint32_t*)((char*)queue->sq_ring + params.sq_off.array);
+    queue->cq_head  = (uint32_t*)((char*)queue->cq_ring + params.cq_off.head);
+    queue->cq_tail  = (uint32_t*)((char*)queue->cq_ring + params.cq_off.tail);
+    queue->cq_mask  = (uint32_t*)((char*)queue->cq_ring + params.cq_off.ring_mask);
+    queue->cqes     = (struct io_uring_cqe*)((char*)queue->cq_ring + params.cq_off.cqes);
+
+    // Depth may be rounded up to a power of two by the kernel.
+    queue->depth = params.sq_entries;
+    return true;
+
+failed:
+    close(ring_fd);
+    return false;
+}
+#endif
+
+FSQueue* fs__queue_create(uint32_t depth) {
+    if (depth == 0)
+        return NULL;
+
+    FSQueue* queue = mem__alloc(sizeof(FSQueue), NULL);
+    if (!queue)
+        return NULL;
+    memset(queue, 0, sizeof(*queue));
+    queue->depth = depth;
+
     #ifdef OS_LINUX
-        int mem_flags = PROT_READ;
-        if ((flags & MEM_EXEC)) {
-            mem_flags |= PROT_EXEC;
-        } else if ((flags & MEM_WRITE)) {
-            mem_flags |= PROT_WRITE;
+        if (fs_queue_init_uring(queue)) {
+            queue->use_uring = true;
+            queue->completions = mem__alloc(queue->depth * sizeof(FSCompletion), NULL);
+            if (queue->completions)
+                return queue;
+            fs__queue_destroy(queue);
+            return NULL;
         }
-        int page_size = getpagesize();
-        uint64_t aligned_size = size % page_size == 0 ? size : size + (page_size - size) % page_size;
-        int res = mprotect(address, aligned_size, mem_flags);
-        if (res < 0) {
-            log__printf("barf: mprotect failed, %s\n", strerror(errno));
+    #endif
+
+    queue->requests    = mem__alloc(depth * sizeof(FSRequest), NULL);
+    queue->completions = mem__alloc(depth * sizeof(FSCompletion), NULL);
+    if (!queue->requests || !queue->completions)
+        goto failed;
+
+    CPUInfo cpu;
+    cpu__info(&cpu);
+    uint32_t worker_count = cpu.logical_cores < 2 ? 2 : cpu.logical_cores;
+    if (worker_count > FS_QUEUE_MAX_WORKERS)
+        worker_count = FS_QUEUE_MAX_WORKERS;
+    if (worker_count > depth)
+        worker_count = depth;
+
+    for (uint32_t i = 0; i < worker_count; i++) {
+        if (!platform_thread_start(&queue->workers[i], fs_queue_worker, queue))
+            break;
+        queue->worker_count++;
+    }
+    if (queue->worker_count == 0)
+        goto failed;
+    return queue;
+
+failed:
+    if (queue->requests)
+        mem__alloc(0, queue->requests);
+    if (queue->completions)
+        mem__alloc(0, queue->completions);
+    mem__alloc(0, queue);
+    return NULL;
+}
+
+void fs__queue_destroy(FSQueue* queue) {
+    if (!queue)
+        return;
+
+    // Drain so no buffers are written to after the caller frees them.
+    FSCompletion completions[32];
+    while (queue->inflight > 0) {
+        uint32_t min_count = queue->inflight < 32 ? queue->inflight : 32;
+        fs__complete(queue, completions, 32, min_count);
+    }
+
+    #ifdef OS_LINUX
+        if (queue->use_uring) {
+            munmap(queue->sqes, queue->sqes_size);
+            if (queue->cq_ring != queue->sq_ring)
+                munmap(queue->cq_ring, queue->cq_ring_size);
+            munmap(queue->sq_ring, queue->sq_ring_size);
+            close(queue->ring_fd);
+            if (queue->completions)
+                mem__alloc(0, queue->completions);
+            mem__alloc(0, queue);
+            return;
         }
     #endif
+
+    sync__mutex_lock(&queue->mutex);
+    queue->stop = true;
+    sync__cond_broadcast(&queue->work_available);
+    sync__mutex_unlock(&queue->mutex);
+    for (uint32_t i = 0; i < queue->worker_count; i++)
+        platform_thread_join(&queue->workers[i]);
+
+    mem__alloc(0, queue->requests);
+    mem__alloc(0, queue->completions);
+    mem__alloc(0, queue);
 }
-void mem__unmap(void* address, uint64_t size) {
-    #ifdef OS_WINDOWS
-        VirtualFree(address, size, MEM_RELEASE);
+
+uint32_t fs__submit(FSQueue* queue, const FSRequest* requests, uint32_t count) {
+    // We never let more requests be in flight than there is room for completions.
+    uint32_t room = queue->depth - queue->inflight;
+    if (count > room)
+        count = room;
+    if (count == 0)
+        return 0;
+
+    #ifdef OS_LINUX
+        if (queue->use_uring) {
+            uint32_t tail = *queue->sq_tail;
+            uint32_t mask = *queue->sq_mask;
+            for (uint32_t i = 0; i < count; i++) {
+                const FSRequest* request = &requests[i];
+                uint32_t index = tail & mask;
+                struct io_uring_sqe* sqe = &queue->sqes[index];
+                memset(sqe, 0, sizeof(*sqe));
+
+                switch (request->op) {
+                    case FS_OP_READ:   sqe->opcode = IORING_OP_READ;   break;
+                    case FS_OP_WRITE:  sqe->opcode = IORING_OP_WRITE;  break;
+                    case FS_OP_READV:  sqe->opcode = IORING_OP_READV;  break;
+                    case FS_OP_WRITEV: sqe->opcode = IORING_OP_WRITEV; break;
+                    default: {
+                        // Completes right away like the thread pool would, 'depth'
+                        // bounds these together with the requests in flight.
+                        uint32_t slot = (queue->completion_head + queue->completion_count) % queue->depth;
+                        queue->completions[slot].user_data = request->user_data;
+                        queue->completions[slot].result    = -EINVAL;
+                        queue->completion_count++;
+                        continue;
+                    }
+                }
+                sqe->fd        = fs_native_fd(request->handle);
+                sqe->off       = request->offset;
+                sqe->addr      = (uint64_t)request->buffer;
+                sqe->len       = fs_request_length(request);
+                sqe->user_data = request->user_data;
+
+                queue->sq_array[index] = index;
+                tail++;
+            }
+            // Kernel must see the entries before the new tail.
+            __atomic_store_n(queue->sq_tail, tail, __ATOMIC_RELEASE);
+
+            // Everything between the kernel's head and our tail is unsubmitted
+            uint32_t first = __atomic_load_n(queue->sq_head, __ATOMIC_ACQUIRE);
+            if (io_uring_enter(queue->ring_fd, tail - first, 0, 0) < 0) {
+                platform_log("io_uring_enter failed, %s\n", strerror(errno));
+            }
+            uint32_t head = __atomic_load_n(queue->sq_head, __ATOMIC_ACQUIRE);
+            uint32_t submitted = head - first;
+            if (head != tail) {
+                // The kernel stopped early (no memory, completion ring busy). Entries it
+                // didn't consume are withdrawn so the caller can submit them again, the
+                // queue is single-threaded and nothing else enters the ring meanwhile.
+                // Requests are consumed in order so the submitted ones are a prefix,
+                // rejected ones before the first withdrawn entry count as submitted.
+                __atomic_store_n(queue->sq_tail, head, __ATOMIC_RELEASE);
+                uint32_t accepted = 0, entries = 0;
+                for (uint32_t i = 0; i < count; i++) {
+                    bool valid = requests[i].op >= FS_OP_READ && requests[i].op <= FS_OP_WRITEV;
+                    if (valid && entries == submitted)
+                        break;
+                    entries += valid;
+                    accepted++;
+                }
+                // Rejections past the accepted prefix are taken back as well
+                for (uint32_t i = accepted; i < count; i++) {
+                    if (requests[i].op < FS_OP_READ || requests[i].op > FS_OP_WRITEV)
+                        queue->completion_count--;
+                }
+                count = accepted;
+            }
+            queue->inflight += count;
+            return count;
+        }
     #endif
+
+    sync__mutex_lock(&queue->mutex);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = (queue->request_head + queue->request_count) % queue->depth;
+        queue->requests[index] = requests[i];
+        queue->request_count++;
+    }
+    queue->inflight += count;
+    sync__cond_broadcast(&queue->work_available);
+    sync__mutex_unlock(&queue->mutex);
+    return count;
+}
+
+uint32_t fs__complete(FSQueue* queue, FSCompletion* completions, uint32_t max_count, uint32_t min_count) {
+    if (min_count > max_count)
+        min_count = max_count;
+    if (min_count > queue->inflight)
+        min_count = queue->inflight;
+
+    uint32_t count = 0;
+
     #ifdef OS_LINUX
-        munmap(address, size);
+        if (queue->use_uring) {
+            // Requests rejected by fs__submit first
+            while (queue->completion_count > 0 && count < max_count) {
+                completions[count++] = queue->completions[queue->completion_head];
+                queue->completion_head = (queue->completion_head + 1) % queue->depth;
+                queue->completion_count--;
+            }
+            while (true) {
+                uint32_t head = *queue->cq_head;
+                uint32_t tail = __atomic_load_n(queue->cq_tail, __ATOMIC_ACQUIRE);
+                uint32_t mask = *queue->cq_mask;
+                while (head != tail && count < max_count) {
+                    struct io_uring_cqe* cqe = &queue->cqes[head & mask];
+                    completions[count].user_data = cqe->user_data;
+                    completions[count].result    = cqe->res;
+                    count++;
+                    head++;
+                }
+                __atomic_store_n(queue->cq_head, head, __ATOMIC_RELEASE);
+
+                if (count >= min_count)
+                    break;
+
+                uint32_t unsubmitted = *queue->sq_tail - __atomic_load_n(queue->sq_head, __ATOMIC_ACQUIRE);
+                int res = io_uring_enter(queue->ring_fd, unsubmitted, min_count - count, IORING_ENTER_GETEVENTS);
+                if (res < 0 && errno != EINTR) {
+                    platform_log("io_uring_enter failed, %s\n", strerror(errno));
+                    break;
+                }
+            }
+            queue->inflight -= count;
+            return count;
+        }
     #endif
+
+    sync__mutex_lock(&queue->mutex);
+    while (true) {
+        while (queue->completion_count > 0 && count < max_count) {
+            completions[count++] = queue->completions[queue->completion_head];
+            queue->completion_head = (queue->completion_head + 1) % queue->depth;
+            queue->completion_count--;
+        }
+        if (count >= min_count)
+            break;
+        sync__cond_wait(&queue->work_done, &queue->mutex);
+    }
+    queue->inflight -= count;
+    sync__mutex_unlock(&queue->mutex);
+    return count;
 }
 
+#endif
 
 // ##########################
-//      Debug/logging
+//      Memory
 // ##########################
 
-void log__printf(const char* format, ...) {
-    va_list va;
-    va_start(va, format);
-    vfprintf(stderr, format, va);
-    va_end(va);
+// Built-in allocator
+//   Small sizes are rounded up to a size class. Each class has a central free list and every
+//   thread keeps a cache of free objects per class, so most allocations and frees are a
+//   pointer pop/push without atomics. Caches move objects to/from the central list in batches.
+//
+//   Objects live in 64 KB spans carved out of larger mem__map segments. A span starts with a
+//   header, spans are aligned so the header of any pointer is found by masking the address.
+//   Large allocations get their own mem__map region with the same header. A few freed large
+//   regions are kept per thread so alloc/free loops on big buffers don't hit mmap every time.
+
+#define MEM_SPAN_SIZE     (64 * 1024)
+#define MEM_SPAN_HEADER   64          // keeps objects 16-byte aligned
+#define MEM_SEGMENT_SIZE  (4 * 1024 * 1024)
+#define MEM_MAX_SMALL     (16 * 1024)
+#define MEM_SPAN_MAGIC    0x4E415053u // "SPAN"
+#define MEM_LARGE_CLASS   0xFFFFFFFFu
+#define MEM_LARGE_CACHED  8
+#define MEM_LARGE_CACHE_MAX (1024 * 1024) // bigger regions always go back to the OS
+
+typedef struct {
+    uint32_t magic;
+    uint32_t size_class;
+    uint64_t size;      // object size, or usable size of a large allocation
+    void*    map_base;  // large allocations, what to pass to mem__unmap
+    uint64_t map_size;
+} MemSpan;
+
+typedef struct MemFreeObject {
+    struct MemFreeObject* next;
+} MemFreeObject;
+
+typedef struct {
+    SyncMutex      mutex;
+    MemFreeObject* objects;
+} MemCentralList;
+
+static const uint32_t mem_class_sizes[] = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256, 320, 384, 448, 512,
+    640, 768, 896, 1024, 1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192,
+    10240, 12288, 14336, 16384,
+};
+#define MEM_CLASS_COUNT (sizeof(mem_class_sizes)/sizeof(*mem_class_sizes))
+
+typedef struct {
+    MemFreeObject* objects[MEM_CLASS_COUNT];
+    uint32_t       counts[MEM_CLASS_COUNT];
+    MemSpan*       large[MEM_LARGE_CACHED];
+    uint32_t       large_count;
+    bool           registered;
+} MemThreadCache;
+
+static uint8_t        mem_class_lookup[MEM_MAX_SMALL / 16 + 1]; // (size + 15) / 16 -> class
+static uint32_t       mem_class_batch[MEM_CLASS_COUNT];
+static MemCentralList mem_central[MEM_CLASS_COUNT];
+
+static SyncMutex mem_segment_mutex;
+static char*     mem_segment_head;
+static char*     mem_segment_end;
+
+static _Thread_local MemThreadCache mem_thread_cache;
+
+#ifdef OS_LINUX
+    static pthread_key_t mem_thread_key;
+#endif
+#ifdef OS_WINDOWS
+    static DWORD mem_thread_key;
+#endif
+
+static uint32_t mem_allocator; // MEM_ALLOCATOR_*, 0 until the first allocation or mem__set_allocator
+static SyncEvent mem_builtin_ready;
+
+static void mem_release_to_central(uint32_t size_class, uint32_t count) {
+    MemThreadCache* cache = &mem_thread_cache;
+    MemFreeObject* first = cache->objects[size_class];
+    MemFreeObject* last  = first;
+    for (uint32_t i = 1; i < count; i++)
+        last = last->next;
+    cache->objects[size_class] = last->next;
+    cache->counts[size_class] -= count;
+
+    MemCentralList* central = &mem_central[size_class];
+    sync__mutex_lock(&central->mutex);
+    last->next = central->objects;
+    central->objects = first;
+    sync__mutex_unlock(&central->mutex);
+}
+
+// Objects cached by a thread that exits would be lost otherwise.
+static void mem_thread_exit(void* arg) {
+    MemThreadCache* cache = &mem_thread_cache;
+    for (uint32_t c = 0; c < MEM_CLASS_COUNT; c++) {
+        if (cache->counts[c] > 0)
+            mem_release_to_central(c, cache->counts[c]);
+    }
+    for (uint32_t i = 0; i < cache->large_count; i++)
+        mem__unmap(cache->large[i]->map_base, cache->large[i]->map_size);
+    cache->large_count = 0;
+}
+
+// Makes sure mem_thread_exit runs for this thread.
+static void mem_register_thread(MemThreadCache* cache) {
+    if (!cache->registered) {
+        #ifdef OS_LINUX
+            pthread_setspecific(mem_thread_key, cache);
+        #endif
+        #ifdef OS_WINDOWS
+            FlsSetValue(mem_thread_key, cache);
+        #endif
+        cache->registered = true;
+    }
+}
+
+static void mem_builtin_init() {
+    uint32_t c = 0;
+    for (uint32_t i = 0; i < sizeof(mem_class_lookup); i++) {
+        while (mem_class_sizes[c] < i * 16)
+            c++;
+        mem_class_lookup[i] = c;
+    }
+    for (c = 0; c < MEM_CLASS_COUNT; c++) {
+        // Move about 32 KB per batch, small objects in bigger batches.
+        uint32_t batch = 32 * 1024 / mem_class_sizes[c];
+        mem_class_batch[c] = batch < 2 ? 2 : (batch > 64 ? 64 : batch);
+    }
+    #ifdef OS_LINUX
+        pthread_key_create(&mem_thread_key, mem_thread_exit);
+    #endif
+    #ifdef OS_WINDOWS
+        mem_thread_key = FlsAlloc((PFLS_CALLBACK_FUNCTION)mem_thread_exit);
+    #endif
+}
+
+static uint32_t mem_choose_allocator() {
+    uint32_t allocator = MEM_ALLOCATOR_MALLOC;
+    const char* env = getenv("BARF_ALLOCATOR");
+    if (env && !strcmp(env, "builtin"))
+        allocator = MEM_ALLOCATOR_BUILTIN;
+    mem__set_allocator(allocator);
+    return __atomic_load_n(&mem_allocator, __ATOMIC_ACQUIRE);
+}
+
+bool mem__set_allocator(uint32_t allocator) {
+    if (allocator != MEM_ALLOCATOR_MALLOC && allocator != MEM_ALLOCATOR_BUILTIN)
+        return false;
+    uint32_t current = 0;
+    if (!__atomic_compare_exchange_n(&mem_allocator, &current, allocator, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return current == allocator;
+    if (allocator == MEM_ALLOCATOR_BUILTIN) {
+        mem_builtin_init();
+        sync__event_set(&mem_builtin_ready);
+    }
+    return true;
+}
+
+static char* mem_span_alloc() {
+    sync__mutex_lock(&mem_segment_mutex);
+    if (mem_segment_head + MEM_SPAN_SIZE > mem_segment_end) {
+        // One extra span of room so we can align, the unaligned ends are never used.
+        uint64_t map_size = MEM_SEGMENT_SIZE + MEM_SPAN_SIZE;
+        char* segment = mem__map(NULL, map_size, MEM_READ|MEM_WRITE);
+        if (!segment) {
+            sync__mutex_unlock(&mem_segment_mutex);
+            return NULL;
+        }
+        mem_segment_head = (char*)(((uint64_t)segment + MEM_SPAN_SIZE - 1) & ~(uint64_t)(MEM_SPAN_SIZE - 1));
+        mem_segment_end  = segment + map_size;
+    }
+    char* span = mem_segment_head;
+    mem_segment_head += MEM_SPAN_SIZE;
+    sync__mutex_unlock(&mem_segment_mutex);
+    return span;
+}
+
+// Fills the thread cache with a batch of objects, returns false when out of memory.
+static bool mem_refill(uint32_t size_class) {
+    MemThreadCache* cache = &mem_thread_cache;
+    MemCentralList* central = &mem_central[size_class];
+    uint32_t batch = mem_class_batch[size_class];
+
+    mem_register_thread(cache);
+
+    sync__mutex_lock(&central->mutex);
+    if (!central->objects) {
+        sync__mutex_unlock(&central->mutex);
+
+        char* span_memory = mem_span_alloc();
+        if (!span_memory)
+            return false;
+        MemSpan* span = (MemSpan*)span_memory;
+        span->magic      = MEM_SPAN_MAGIC;
+        span->size_class = size_class;
+        span->size       = mem_class_sizes[size_class];
+
+        // Carve the span into a list of free objects
+        uint32_t count = (MEM_SPAN_SIZE - MEM_SPAN_HEADER) / span->size;
+        MemFreeObject* first = (MemFreeObject*)(span_memory + MEM_SPAN_HEADER);
+        MemFreeObject* object = first;
+        for (uint32_t i = 1; i < count; i++) {
+            object->next = (MemFreeObject*)((char*)object + span->size);
+            object = object->next;
+        }
+
+        sync__mutex_lock(&central->mutex);
+        object->next = central->objects;
+        central->objects = first;
+    }
+
+    MemFreeObject* first = central->objects;
+    MemFreeObject* last  = first;
+    uint32_t count = 1;
+    while (count < batch && last->next) {
+        last = last->next;
+        count++;
+    }
+    central->objects = last->next;
+    sync__mutex_unlock(&central->mutex);
+
+    last->next = cache->objects[size_class];
+    cache->objects[size_class] = first;
+    cache->counts[size_class] += count;
+    return true;
+}
+
+static void* mem_builtin_malloc(uint64_t size) {
+    if (size <= MEM_MAX_SMALL) {
+        uint32_t size_class = mem_class_lookup[(size + 15) / 16];
+        MemThreadCache* cache = &mem_thread_cache;
+        if (!cache->objects[size_class] && !mem_refill(size_class))
+            return NULL;
+        MemFreeObject* object = cache->objects[size_class];
+        cache->objects[size_class] = object->next;
+        cache->counts[size_class]--;
+        return object;
+    }
+
+    uint64_t page_size = 4096;
+    uint64_t usable    = (size + page_size - 1) & ~(page_size - 1);
+
+    // Reuse a cached region if it doesn't waste more than half of it
+    MemThreadCache* cache = &mem_thread_cache;
+    for (uint32_t i = 0; i < cache->large_count; i++) {
+        MemSpan* span = cache->large[i];
+        if (span->size >= usable && span->size / 2 <= usable) {
+            cache->large[i] = cache->large[--cache->large_count];
+            return (char*)span + MEM_SPAN_HEADER;
+        }
+    }
+
+    uint64_t map_size  = usable + MEM_SPAN_HEADER + MEM_SPAN_SIZE;
+    char* base = mem__map(NULL, map_size, MEM_READ|MEM_WRITE);
+    if (!base)
+        return NULL;
+    char* aligned = (char*)(((uint64_t)base + MEM_SPAN_SIZE - 1) & ~(uint64_t)(MEM_SPAN_SIZE - 1));
+    #ifdef OS_LINUX
+        // Give back the parts we only mapped for alignment.
+        uint64_t used = (usable + MEM_SPAN_HEADER + page_size - 1) & ~(page_size - 1);
+        if (aligned > base)
+            mem__unmap(base, aligned - base);
+        if (base + map_size > aligned + used)
+            mem__unmap(aligned + used, base + map_size - (aligned + used));
+        base = aligned;
+        map_size = used;
+    #endif
+    MemSpan* span = (MemSpan*)aligned;
+    span->magic      = MEM_SPAN_MAGIC;
+    span->size_class = MEM_LARGE_CLASS;
+    span->size       = usable;
+    span->map_base   = base;
+    span->map_size   = map_size;
+    return aligned + MEM_SPAN_HEADER;
+}
+
+static void mem_builtin_free(void* ptr) {
+    MemSpan* span = (MemSpan*)((uint64_t)ptr & ~(uint64_t)(MEM_SPAN_SIZE - 1));
+    MemThreadCache* cache = &mem_thread_cache;
+    if (span->size_class == MEM_LARGE_CLASS) {
+        if (span->size > MEM_LARGE_CACHE_MAX) {
+            mem__unmap(span->map_base, span->map_size);
+            return;
+        }
+        mem_register_thread(cache);
+        // Drop an entry when full
+        if (cache->large_count == MEM_LARGE_CACHED) {
+            mem__unmap(cache->large[0]->map_base, cache->large[0]->map_size);
+            cache->large[0] = cache->large[--cache->large_count];
+        }
+        cache->large[cache->large_count++] = span;
+        return;
+    }
+    uint32_t size_class = span->size_class;
+    MemFreeObject* object = ptr;
+    object->next = cache->objects[size_class];
+    cache->objects[size_class] = object;
+    cache->counts[size_class]++;
+    if (cache->counts[size_class] > 2 * mem_class_batch[size_class])
+        mem_release_to_central(size_class, mem_class_batch[size_class]);
+}
+
+static void* mem_builtin_alloc(uint64_t size, void* old_ptr) {
+    if (size == 0) {
+        if (old_ptr)
+            mem_builtin_free(old_ptr);
+        return NULL;
+    }
+    if (!old_ptr)
+        return mem_builtin_malloc(size);
+
+    MemSpan* span = (MemSpan*)((uint64_t)old_ptr & ~(uint64_t)(MEM_SPAN_SIZE - 1));
+    if (size <= span->size)
+        return old_ptr;
+    void* ptr = mem_builtin_malloc(size);
+    if (!ptr)
+        return NULL;
+    memcpy(ptr, old_ptr, span->size);
+    mem_builtin_free(old_ptr);
+    return ptr;
+}
+
+void* mem__alloc(uint64_t size, void* old_ptr) {
+    uint32_t allocator = __atomic_load_n(&mem_allocator, __ATOMIC_ACQUIRE);
+    if (allocator == 0)
+        allocator = mem_choose_allocator();
+
+    if (allocator == MEM_ALLOCATOR_BUILTIN) {
+        // Another thread may still be initializing the size class tables.
+        if (!sync__event_is_set(&mem_builtin_ready))
+            sync__event_wait(&mem_builtin_ready);
+        return mem_builtin_alloc(size, old_ptr);
+    }
+
+    if (size == 0) {
+        free(old_ptr);
+        return NULL;
+    } else if (!old_ptr) {
+        return malloc(size);
+    }
+    return realloc(old_ptr, size);
+}
+
+#ifdef OS_WINDOWS
+static DWORD mem_protection(int flags) {
+    if (!(flags & (MEM_READ|MEM_WRITE|MEM_EXEC)))
+        return PAGE_NOACCESS;
+    if ((flags & MEM_EXEC) && (flags & MEM_WRITE))
+        return PAGE_EXECUTE_READWRITE;
+    if ((flags & MEM_EXEC))
+        return PAGE_EXECUTE_READ;
+    if ((flags & MEM_WRITE))
+        return PAGE_READWRITE;
+    return PAGE_READONLY;
+}
+#endif
+#ifdef OS_LINUX
+static int mem_protection(int flags) {
+    int prot = PROT_NONE;
+    if (flags & MEM_READ)  prot |= PROT_READ;
+    if (flags & MEM_WRITE) prot |= PROT_WRITE;
+    if (flags & MEM_EXEC)  prot |= PROT_EXEC|PROT_READ;
+    return prot;
+}
+#endif
+
+// Widens [address, address+size) to whole pages.
+static void mem_page_range(void* address, uint64_t size, char** start, uint64_t* length) {
+    uint64_t page_size = mem__page_size();
+    uint64_t first = (uint64_t)address & ~(page_size - 1);
+    uint64_t last  = ((uint64_t)address + size + page_size - 1) & ~(page_size - 1);
+    *start  = (char*)first;
+    *length = last - first;
+}
+
+uint64_t mem__page_size() {
+    static uint64_t page_size;
+    if (!page_size) {
+        #ifdef OS_WINDOWS
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            page_size = info.dwPageSize;
+        #endif
+        #ifdef OS_LINUX
+            page_size = getpagesize();
+        #endif
+    }
+    return page_size;
+}
+
+void* mem__map(void* address, uint64_t size, int flags) {
+    #ifdef OS_WINDOWS
+        void* ptr = VirtualAlloc(address, size, MEM_RESERVE|MEM_COMMIT, mem_protection(flags));
+        if (!ptr && address)
+            ptr = VirtualAlloc(NULL, size, MEM_RESERVE|MEM_COMMIT, mem_protection(flags));
+        if (!ptr)
+            log__printf("barf: VirtualAlloc failed, win error %u\n", (unsigned)GetLastError());
+        return ptr;
+    #endif
+    #ifdef OS_LINUX
+        int page_size = getpagesize();
+        uint64_t aligned_size = size % page_size == 0 ? size : size + (page_size - size) % page_size;
+        void* ptr = mmap(address, aligned_size, mem_protection(flags), MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (ptr == (void*)-1) {
+            log__printf("barf: mmap failed, %s\n", strerror(errno));
+            return NULL;
+        }
+        return ptr;
+    #endif
+}
+void mem__mapflag(void* address, uint64_t size, int flags) {
+    #ifdef OS_WINDOWS
+        DWORD prev_flags;
+        BOOL res = VirtualProtect(address, size, mem_protection(flags), &prev_flags);
+        if (!res) {
+            DWORD val = GetLastError();
+            log__printf("flag_memory: win error %u\n", (unsigned)val);
+        }
+    #endif
+    #ifdef OS_LINUX
+        int page_size = getpagesize();
+        uint64_t aligned_size = size % page_size == 0 ? size : size + (page_size - size) % page_size;
+        int res = mprotect(address, aligned_size, mem_protection(flags));
+        if (res < 0) {
+            log__printf("barf: mprotect failed, %s\n", strerror(errno));
+        }
+    #endif
+}
+void mem__unmap(void* address, uint64_t size) {
+    #ifdef OS_WINDOWS
+        // Releases the whole region from VirtualAlloc, size must be 0
+        VirtualFree(address, 0, MEM_RELEASE);
+    #endif
+    #ifdef OS_LINUX
+        munmap(address, size);
+    #endif
+}
+
+void* mem__reserve(void* address, uint64_t size) {
+    #ifdef OS_WINDOWS
+        void* ptr = VirtualAlloc(address, size, MEM_RESERVE, PAGE_NOACCESS);
+        if (!ptr && address)
+            ptr = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+        if (!ptr)
+            log__printf("barf: VirtualAlloc reserve failed, win error %u\n", (unsigned)GetLastError());
+        return ptr;
+    #endif
+    #ifdef OS_LINUX
+        char* start;
+        uint64_t length;
+        mem_page_range(NULL, size, &start, &length);
+        // PROT_NONE + MAP_NORESERVE: only address space, no swap/commit charge until mem__commit
+        void* ptr = mmap(address, length, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+        if (ptr == (void*)-1) {
+            log__printf("barf: mmap reserve failed, %s\n", strerror(errno));
+            return NULL;
+        }
+        return ptr;
+    #endif
+}
+bool mem__commit(void* address, uint64_t size, int flags) {
+    char* start;
+    uint64_t length;
+    mem_page_range(address, size, &start, &length);
+    #ifdef OS_WINDOWS
+        if (!VirtualAlloc(start, length, MEM_COMMIT, mem_protection(flags))) {
+            log__printf("barf: VirtualAlloc commit failed, win error %u\n", (unsigned)GetLastError());
+            return false;
+        }
+        return true;
+    #endif
+    #ifdef OS_LINUX
+        // Pages are backed on first touch, the kernel hands out zero pages
+        if (mprotect(start, length, mem_protection(flags)) < 0) {
+            log__printf("barf: mprotect commit failed, %s\n", strerror(errno));
+            return false;
+        }
+        return true;
+    #endif
+}
+void mem__decommit(void* address, uint64_t size) {
+    char* start;
+    uint64_t length;
+    mem_page_range(address, size, &start, &length);
+    #ifdef OS_WINDOWS
+        VirtualFree(start, length, MEM_DECOMMIT);
+    #endif
+    #ifdef OS_LINUX
+        // Mapping fresh PROT_NONE pages on top drops the physical pages and the commit charge
+        // in one call (madvise(MADV_DONTNEED) + mprotect would leave the charge).
+        void* ptr = mmap(start, length, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE|MAP_FIXED, -1, 0);
+        if (ptr == (void*)-1)
+            log__printf("barf: mmap decommit failed, %s\n", strerror(errno));
+    #endif
+}
+
+
+// ##########################
+//      Synchronization
+// ##########################
+
+// How many times we poll a contended mutex before going to sleep in the kernel.
+// Critical sections are usually short so the owner often releases it while we spin.
+#define SYNC_SPIN_COUNT 100
+
+static void sync_wait(uint32_t* address, uint32_t expected) {
+    #ifdef OS_WINDOWS
+        WaitOnAddress(address, &expected, sizeof(expected), INFINITE);
+    #endif
+    #ifdef OS_LINUX
+        // Returns immediately with EAGAIN if *address != expected, caller re-checks state.
+        syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+    #endif
+}
+static void sync_wake(uint32_t* address, bool all) {
+    #ifdef OS_WINDOWS
+        if (all)
+            WakeByAddressAll(address);
+        else
+            WakeByAddressSingle(address);
+    #endif
+    #ifdef OS_LINUX
+        syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+    #endif
+}
+static inline void sync_pause() {
+    #if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+    #endif
+}
+
+// Mutex from Ulrich Drepper's "Futexes Are Tricky" (mutex3).
+void sync__mutex_lock(SyncMutex* mutex) {
+    uint32_t c = 0;
+    if (__atomic_compare_exchange_n(&mutex->state, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return;
+
+    for (int i = 0; i < SYNC_SPIN_COUNT; i++) {
+        sync_pause();
+        c = __atomic_load_n(&mutex->state, __ATOMIC_RELAXED);
+        if (c == 0 && __atomic_compare_exchange_n(&mutex->state, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return;
+        if (c == 2)
+            break;
+    }
+
+    // Mark as contended so the owner knows to wake us up.
+    c = __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE);
+    while (c != 0) {
+        sync_wait(&mutex->state, 2);
+        c = __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE);
+    }
+}
+bool sync__mutex_trylock(SyncMutex* mutex) {
+    uint32_t c = 0;
+    return __atomic_compare_exchange_n(&mutex->state, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+void sync__mutex_unlock(SyncMutex* mutex) {
+    if (__atomic_fetch_sub(&mutex->state, 1, __ATOMIC_RELEASE) != 1) {
+        __atomic_store_n(&mutex->state, 0, __ATOMIC_RELEASE);
+        sync_wake(&mutex->state, false);
+    }
+}
+
+void sync__cond_wait(SyncCondition* cond, SyncMutex* mutex) {
+    uint32_t sequence = __atomic_load_n(&cond->sequence, __ATOMIC_RELAXED);
+    sync__mutex_unlock(mutex);
+    // If a signal happened after we unlocked then sequence changed and wait returns immediately.
+    sync_wait(&cond->sequence, sequence);
+
+    // We don't know if other threads are sleeping on the mutex so we must
+    // assume they are (state 2) or they could miss their wakeup.
+    uint32_t c = __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE);
+    while (c != 0) {
+        sync_wait(&mutex->state, 2);
+        c = __atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE);
+    }
+}
+void sync__cond_signal(SyncCondition* cond) {
+    __atomic_fetch_add(&cond->sequence, 1, __ATOMIC_RELEASE);
+    sync_wake(&cond->sequence, false);
+}
+void sync__cond_broadcast(SyncCondition* cond) {
+    __atomic_fetch_add(&cond->sequence, 1, __ATOMIC_RELEASE);
+    sync_wake(&cond->sequence, true);
+}
+
+void sync__sem_wait(SyncSemaphore* sem) {
+    while (true) {
+        uint32_t c = __atomic_load_n(&sem->count, __ATOMIC_RELAXED);
+        while (c > 0) {
+            if (__atomic_compare_exchange_n(&sem->count, &c, c - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                return;
+        }
+        __atomic_fetch_add(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+        sync_wait(&sem->count, 0);
+        __atomic_fetch_sub(&sem->waiters, 1, __ATOMIC_RELAXED);
+    }
+}
+void sync__sem_post(SyncSemaphore* sem) {
+    __atomic_fetch_add(&sem->count, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sem->waiters, __ATOMIC_SEQ_CST) > 0)
+        sync_wake(&sem->count, false);
+}
+
+void sync__event_wait(SyncEvent* event) {
+    while (__atomic_load_n(&event->state, __ATOMIC_ACQUIRE) == 0) {
+        sync_wait(&event->state, 0);
+    }
+}
+void sync__event_set(SyncEvent* event) {
+    if (__atomic_exchange_n(&event->state, 1, __ATOMIC_RELEASE) == 0)
+        sync_wake(&event->state, true);
+}
+bool sync__event_is_set(SyncEvent* event) {
+    return __atomic_load_n(&event->state, __ATOMIC_ACQUIRE) != 0;
+}
+
+
+// ##########################
+//      Time
+// ##########################
+
+uint64_t time__monotonic() {
+    #ifdef OS_WINDOWS
+        static LARGE_INTEGER frequency;
+        if (frequency.QuadPart == 0)
+            QueryPerformanceFrequency(&frequency);
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        // Split to avoid overflow in counter * 1e9
+        uint64_t seconds = counter.QuadPart / frequency.QuadPart;
+        uint64_t rest    = counter.QuadPart % frequency.QuadPart;
+        return seconds * 1000000000ull + rest * 1000000000ull / frequency.QuadPart;
+    #endif
+    #ifdef OS_LINUX
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+    #endif
+}
+uint64_t time__wall() {
+    #ifdef OS_WINDOWS
+        FILETIME ft;
+        GetSystemTimePreciseAsFileTime(&ft);
+        uint64_t ticks = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+        // 100 ns ticks since 1601-01-01
+        return (ticks - 116444736000000000ull) * 100;
+    #endif
+    #ifdef OS_LINUX
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+    #endif
+}
+
+uint64_t time__cycles() {
+    #if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+    #else
+        return time__monotonic();
+    #endif
+}
+
+uint64_t time__cycle_frequency() {
+    static uint64_t frequency;
+    if (frequency)
+        return frequency;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        // Newer Intel CPUs report the TSC frequency, otherwise we measure it.
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0, NULL) >= 0x15) {
+            __cpuid(0x15, eax, ebx, ecx, edx);
+            if (eax != 0 && ebx != 0 && ecx != 0) {
+                frequency = (uint64_t)ecx * ebx / eax;
+                return frequency;
+            }
+        }
+        uint64_t start_ns = time__monotonic();
+        uint64_t start_cycles = time__cycles();
+        uint64_t end_ns;
+        do {
+            end_ns = time__monotonic();
+        } while (end_ns - start_ns < 10000000); // 10 ms
+        uint64_t end_cycles = time__cycles();
+        frequency = (end_cycles - start_cycles) * 1000000000ull / (end_ns - start_ns);
+    #else
+        frequency = 1000000000ull;
+    #endif
+    return frequency;
+}
+
+
+// ##########################
+//      CPU
+// ##########################
+
+#if defined(__x86_64__) || defined(__i386__)
+static void cpu_cache_sizes(CPUInfo* info, bool amd) {
+    // Intel leaf 4 and AMD leaf 0x8000001D have the same layout
+    unsigned int leaf = amd ? 0x8000001D : 4;
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(leaf & 0x80000000, NULL) < leaf)
+        return;
+
+    for (int sub = 0; sub < 16; sub++) {
+        __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+        int type = eax & 0x1F; // 0 = no more caches, 1 = data, 2 = instruction, 3 = unified
+        if (type == 0)
+            break;
+        if (type == 2)
+            continue;
+        int level = (eax >> 5) & 0x7;
+        uint32_t line_size  = (ebx & 0xFFF) + 1;
+        uint32_t partitions = ((ebx >> 12) & 0x3FF) + 1;
+        uint32_t ways       = ((ebx >> 22) & 0x3FF) + 1;
+        uint32_t sets       = ecx + 1;
+        uint32_t size = line_size * partitions * ways * sets;
+
+        if (level == 1) {
+            info->l1d_cache_size = size;
+            info->cache_line_size = line_size;
+        } else if (level == 2) {
+            info->l2_cache_size = size;
+        } else if (level == 3) {
+            info->l3_cache_size = size;
+        }
+    }
+}
+#endif
+
+void cpu__info(CPUInfo* info) {
+    static CPUInfo cached;
+    static bool    has_cached;
+    if (has_cached) {
+        *info = cached;
+        return;
+    }
+    memset(info, 0, sizeof(*info));
+
+    #ifdef OS_WINDOWS
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        info->logical_cores = system_info.dwNumberOfProcessors;
+    #endif
+    #ifdef OS_LINUX
+        info->logical_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+    info->physical_cores = info->logical_cores;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax, ebx, ecx, edx;
+        unsigned int max_leaf = __get_cpuid_max(0, NULL);
+        unsigned int max_ext_leaf = __get_cpuid_max(0x80000000, NULL);
+
+        __cpuid(0, eax, ebx, ecx, edx);
+        memcpy(info->vendor + 0, &ebx, 4);
+        memcpy(info->vendor + 4, &edx, 4);
+        memcpy(info->vendor + 8, &ecx, 4);
+        bool amd = !strcmp(info->vendor, "AuthenticAMD");
+
+        if (max_ext_leaf >= 0x80000004) {
+            unsigned int* brand = (unsigned int*)info->brand;
+            for (int i = 0; i < 3; i++) {
+                __cpuid(0x80000002 + i, brand[i*4 + 0], brand[i*4 + 1], brand[i*4 + 2], brand[i*4 + 3]);
+            }
+        }
+
+        bool os_avx = false;
+        bool os_avx512 = false;
+        if (max_leaf >= 1) {
+            __cpuid(1, eax, ebx, ecx, edx);
+            if (edx & bit_SSE2)   info->features |= CPU_FEATURE_SSE2;
+            if (ecx & bit_SSE4_2) info->features |= CPU_FEATURE_SSE42;
+            if (ecx & bit_POPCNT) info->features |= CPU_FEATURE_POPCNT;
+
+            // The OS must save the YMM/ZMM registers on context switch before we can use them.
+            if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+                unsigned int xcr0_lo, xcr0_hi;
+                __asm__ volatile ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0)); // _xgetbv requires -mxsave
+                uint64_t xcr0 = ((uint64_t)xcr0_hi << 32) | xcr0_lo;
+                os_avx    = (xcr0 & 0x6) == 0x6;
+                os_avx512 = os_avx && (xcr0 & 0xE0) == 0xE0;
+            }
+            if (os_avx) {
+                info->features |= CPU_FEATURE_AVX;
+                if (ecx & bit_FMA) info->features |= CPU_FEATURE_FMA;
+            }
+        }
+        if (max_leaf >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if (ebx & bit_BMI2) info->features |= CPU_FEATURE_BMI2;
+            if (os_avx && (ebx & bit_AVX2)) info->features |= CPU_FEATURE_AVX2;
+            if (os_avx512) {
+                if (ebx & bit_AVX512F)  info->features |= CPU_FEATURE_AVX512F;
+                if (ebx & bit_AVX512BW) info->features |= CPU_FEATURE_AVX512BW;
+                if (ebx & bit_AVX512VL) info->features |= CPU_FEATURE_AVX512VL;
+            }
+        }
+        if (max_ext_leaf >= 0x80000007) {
+            __cpuid(0x80000007, eax, ebx, ecx, edx);
+            if (edx & (1 << 8)) info->features |= CPU_FEATURE_INVARIANT_TSC;
+        }
+
+        // Hardware threads per core, used to go from logical to physical cores.
+        unsigned int threads_per_core = 1;
+        if (amd && max_ext_leaf >= 0x8000001E) {
+            __cpuid(0x8000001E, eax, ebx, ecx, edx);
+            threads_per_core = ((ebx >> 8) & 0xFF) + 1;
+        } else if (!amd && max_leaf >= 0xB) {
+            __cpuid_count(0xB, 0, eax, ebx, ecx, edx);
+            if (((ecx >> 8) & 0xFF) == 1) // SMT level
+                threads_per_core = ebx & 0xFFFF;
+        }
+        if (threads_per_core > 1 && info->logical_cores >= threads_per_core)
+            info->physical_cores = info->logical_cores / threads_per_core;
+
+        cpu_cache_sizes(info, amd);
+        if (info->l1d_cache_size == 0 && max_ext_leaf >= 0x80000006) {
+            // Older AMD CPUs
+            __cpuid(0x80000005, eax, ebx, ecx, edx);
+            info->l1d_cache_size  = (ecx >> 24) * 1024;
+            info->cache_line_size = ecx & 0xFF;
+            __cpuid(0x80000006, eax, ebx, ecx, edx);
+            info->l2_cache_size = (ecx >> 16) * 1024;
+            info->l3_cache_size = (edx >> 18) * 512 * 1024;
+        }
+    #endif
+
+    cached = *info;
+    has_cached = true;
+}
+
+
+// ##########################
+//      Debug/logging
+// ##########################
+
+// Every thread that logs owns a ring buffer (single producer). The flusher thread and
+// threads whose ring is full drain rings to stderr while holding log_output_mutex.
+// Rings are never freed, a ring of an exited thread is reused by a new thread.
+
+#define LOG_RING_SIZE       (64 * 1024)
+#define LOG_MESSAGE_MAX     1024 // formatted on the stack, longer messages use the heap
+#define LOG_FLUSH_DELAY_MS  10   // how long the flusher lets messages pile up before writing
+
+typedef struct LogRing {
+    struct LogRing* next;
+    uint32_t        in_use;
+    char            _pad0[64 - sizeof(void*) - sizeof(uint32_t)];
+    uint64_t        head; // written by the owning thread
+    char            _pad1[64 - sizeof(uint64_t)];
+    uint64_t        tail; // written by whoever drains
+    char            _pad2[64 - sizeof(uint64_t)];
+    char            data[LOG_RING_SIZE];
+} LogRing;
+
+static LogRing*  log_rings;
+static SyncMutex log_output_mutex;
+static uint32_t  log_pending;    // 1 when something was logged since the flusher last woke up
+static int       log_level;      // 0 until initialized
+static uint32_t  log_state;      // 0 = not started, 1 = starting, 2 = running, 3 = no flusher (write directly)
+static PlatformThread log_flusher;
+
+static _Thread_local LogRing* log_thread_ring;
+
+#ifdef OS_LINUX
+    static pthread_key_t log_thread_key;
+    static struct sigaction log_previous_actions[32];
+#endif
+#ifdef OS_WINDOWS
+    static DWORD log_thread_key;
+#endif
+
+static void log_output(const char* text, uint64_t size) {
+    while (size > 0) {
+        #ifdef OS_LINUX
+            ssize_t written = write(STDERR_FILENO, text, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+        #endif
+        #ifdef OS_WINDOWS
+            DWORD written = 0;
+            if (!WriteFile(GetStdHandle(STD_ERROR_HANDLE), text, size > 0x40000000 ? 0x40000000 : (DWORD)size, &written, NULL))
+                written = 0;
+        #endif
+        if (written <= 0)
+            return; // nowhere to write, drop it
+        text += written;
+        size -= written;
+    }
+}
+
+// Caller holds log_output_mutex (or we are crashing)
+static void log_drain(LogRing* ring) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = ring->tail;
+    if (head == tail)
+        return;
+    uint64_t start = tail % LOG_RING_SIZE;
+    uint64_t size  = head - tail;
+    uint64_t first = LOG_RING_SIZE - start < size ? LOG_RING_SIZE - start : size;
+    log_output(ring->data + start, first);
+    log_output(ring->data, size - first);
+    __atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+}
+
+static void log_drain_all() {
+    for (LogRing* ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next)
+        log_drain(ring);
+}
+
+static void log_flusher_main(void* arg) {
+    while (true) {
+        while (__atomic_load_n(&log_pending, __ATOMIC_SEQ_CST) == 0)
+            sync_wait(&log_pending, 0);
+
+        // Let messages pile up so we write them in a few big chunks
+        #ifdef OS_LINUX
+            struct timespec delay = { 0, LOG_FLUSH_DELAY_MS * 1000000 };
+            nanosleep(&delay, NULL);
+        #endif
+        #ifdef OS_WINDOWS
+            Sleep(LOG_FLUSH_DELAY_MS);
+        #endif
+
+        // Reset before draining, a message logged after this point wakes us again
+        __atomic_store_n(&log_pending, 0, __ATOMIC_SEQ_CST);
+        sync__mutex_lock(&log_output_mutex);
+        log_drain_all();
+        sync__mutex_unlock(&log_output_mutex);
+    }
+}
+
+static void log_release_ring(void* ring) {
+    // The flusher still writes out what's left in it
+    __atomic_store_n(&((LogRing*)ring)->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void log_at_exit() {
+    log__flush();
+}
+
+#ifdef OS_LINUX
+static void log_crash_handler(int sig) {
+    // Can't wait for a lock here, the crashing thread may hold it
+    bool locked = sync__mutex_trylock(&log_output_mutex);
+    log_drain_all();
+    if (locked)
+        sync__mutex_unlock(&log_output_mutex);
+    // Put back the default action and raise again, returning isn't enough for
+    // signals sent with kill or raise
+    sigaction(sig, &log_previous_actions[sig], NULL);
+    raise(sig);
+}
+#endif
+#ifdef OS_WINDOWS
+static LONG WINAPI log_crash_handler(EXCEPTION_POINTERS* info) {
+    bool locked = sync__mutex_trylock(&log_output_mutex);
+    log_drain_all();
+    if (locked)
+        sync__mutex_unlock(&log_output_mutex);
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+#endif
+
+static int log_level_from_env() {
+    const char* env = getenv("BARF_LOG_LEVEL");
+    if (!env)
+        return LOG_INFO;
+    if (!strcmp(env, "error"))   return LOG_ERROR;
+    if (!strcmp(env, "warning")) return LOG_WARNING;
+    if (!strcmp(env, "info"))    return LOG_INFO;
+    if (!strcmp(env, "debug"))   return LOG_DEBUG;
+    return LOG_INFO;
+}
+
+static void log_init() {
+    uint32_t state = 0;
+    if (!__atomic_compare_exchange_n(&log_state, &state, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // Someone else is starting the flusher
+        while (__atomic_load_n(&log_state, __ATOMIC_ACQUIRE) == 1)
+            sync_pause();
+        return;
+    }
+
+    int level = 0;
+    __atomic_compare_exchange_n(&log_level, &level, log_level_from_env(), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+    #ifdef OS_LINUX
+        pthread_key_create(&log_thread_key, log_release_ring);
+    #endif
+    #ifdef OS_WINDOWS
+        log_thread_key = FlsAlloc((PFLS_CALLBACK_FUNCTION)log_release_ring);
+    #endif
+    atexit(log_at_exit);
+
+    bool started = platform_thread_start(&log_flusher, log_flusher_main, NULL);
+    __atomic_store_n(&log_state, started ? 2 : 3, __ATOMIC_RELEASE);
+}
+
+static LogRing* log_acquire_ring() {
+    for (LogRing* ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        uint32_t in_use = 0;
+        if (__atomic_load_n(&ring->in_use, __ATOMIC_RELAXED) == 0
+        && __atomic_compare_exchange_n(&ring->in_use, &in_use, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return ring;
+    }
+    // Not mem__alloc, it may log
+    LogRing* ring = calloc(1, sizeof(LogRing));
+    if (!ring)
+        return NULL;
+    ring->in_use = 1;
+    ring->next = __atomic_load_n(&log_rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&log_rings, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return ring;
+}
+
+static void log_write(const char* text, uint64_t size) {
+    LogRing* ring = log_thread_ring;
+    if (!ring && __atomic_load_n(&log_state, __ATOMIC_ACQUIRE) == 2) {
+        ring = log_acquire_ring();
+        if (ring) {
+            log_thread_ring = ring;
+            #ifdef OS_LINUX
+                pthread_setspecific(log_thread_key, ring);
+            #endif
+            #ifdef OS_WINDOWS
+                FlsSetValue(log_thread_key, ring);
+            #endif
+        }
+    }
+    if (!ring) {
+        sync__mutex_lock(&log_output_mutex);
+        log_output(text, size);
+        sync__mutex_unlock(&log_output_mutex);
+        return;
+    }
+
+    uint64_t head = ring->head;
+    if (LOG_RING_SIZE - (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) < size) {
+        // Full, write out our own ring instead of dropping or reordering messages
+        sync__mutex_lock(&log_output_mutex);
+        log_drain(ring);
+        if (size > LOG_RING_SIZE) {
+            log_output(text, size);
+            sync__mutex_unlock(&log_output_mutex);
+            return;
+        }
+        sync__mutex_unlock(&log_output_mutex);
+    }
+
+    uint64_t start = head % LOG_RING_SIZE;
+    uint64_t first = LOG_RING_SIZE - start < size ? LOG_RING_SIZE - start : size;
+    memcpy(ring->data + start, text, first);
+    memcpy(ring->data, text + first, size - first);
+    __atomic_store_n(&ring->head, head + size, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&log_pending, __ATOMIC_SEQ_CST) == 0
+    && __atomic_exchange_n(&log_pending, 1, __ATOMIC_SEQ_CST) == 0)
+        sync_wake(&log_pending, false);
+}
+
+static void log_vprintf(int level, const char* format, va_list va) {
+    if (__atomic_load_n(&log_state, __ATOMIC_ACQUIRE) < 2)
+        log_init();
+    if (level > __atomic_load_n(&log_level, __ATOMIC_RELAXED))
+        return;
+
+    char buffer[LOG_MESSAGE_MAX];
+    va_list copy;
+    va_copy(copy, va);
+    int size = vsnprintf(buffer, sizeof(buffer), format, va);
+    if (size < 0) {
+        va_end(copy);
+        return;
+    }
+    if (size < sizeof(buffer)) {
+        log_write(buffer, size);
+    } else {
+        char* big = malloc(size + 1);
+        if (big) {
+            vsnprintf(big, size + 1, format, copy);
+            log_write(big, size);
+            free(big);
+        }
+    }
+    va_end(copy);
+}
+
+void log__printf(const char* format, ...) {
+    va_list va;
+    va_start(va, format);
+    log_vprintf(LOG_INFO, format, va);
+    va_end(va);
+}
+
+void log__message(int level, const char* format, ...) {
+    va_list va;
+    va_start(va, format);
+    log_vprintf(level, format, va);
+    va_end(va);
+}
+
+void log__set_level(int level) {
+    __atomic_store_n(&log_level, level, __ATOMIC_RELAXED);
+}
+
+void log__flush() {
+    sync__mutex_lock(&log_output_mutex);
+    log_drain_all();
+    sync__mutex_unlock(&log_output_mutex);
+}
+
+void log__install_crash_handlers() {
+    #ifdef OS_LINUX
+        int crash_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+        for (int i = 0; i < sizeof(crash_signals)/sizeof(*crash_signals); i++) {
+            int sig = crash_signals[i];
+            struct sigaction previous;
+            sigaction(sig, NULL, &previous);
+            // Leave handlers the application installed alone
+            if ((previous.sa_flags & SA_SIGINFO) || previous.sa_handler != SIG_DFL)
+                continue;
+            struct sigaction action = { 0 };
+            action.sa_handler = log_crash_handler;
+            action.sa_flags   = SA_NODEFER;
+            sigemptyset(&action.sa_mask);
+            sigaction(sig, &action, &log_previous_actions[sig]);
+        }
+    #endif
+    #ifdef OS_WINDOWS
+        LPTOP_LEVEL_EXCEPTION_FILTER previous = SetUnhandledExceptionFilter(log_crash_handler);
+        if (previous)
+            SetUnhandledExceptionFilter(previous);
+    #endif
 }
@@ -0,0 +1,20 @@
+#include "platform/platform.h"
+#include "comdat.h"
+
+int bump_other(int amount);
+
+int ba_entry(const char* path, const char* data, int size) {
+    int a = bump(1);
+    int b = bump_other(10);
+    int c = bump(100);
+    log__printf("bump %d %d %d\n", a, b, c);
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], 0, 0);
+}
+
+#endif
@@ -0,0 +1,27 @@
+/*
+    A function and its counter in a COMDAT group, like an inline function with
+    a static local in C++. Both objects of the test have a copy, one is kept.
+*/
+
+#ifdef OS_WINDOWS
+    #define GROUP(SECTION, FLAGS) ".section " SECTION "$bump,\"" FLAGS "\"\n.linkonce discard\n"
+    #define ARG "%ecx"
+#else
+    #define GROUP(SECTION, FLAGS) ".section " SECTION ".bump,\"" FLAGS "G\",@progbits,bump,comdat\n"
+    #define ARG "%edi"
+#endif
+
+__asm__(
+    GROUP(".data", "aw")
+    ".globl bump_count\n"
+    "bump_count: .long 0\n"
+    GROUP(".text", "ax")
+    ".globl bump\n"
+    "bump:\n"
+    "    addl " ARG ", bump_count(%rip)\n"
+    "    movl bump_count(%rip), %eax\n"
+    "    ret\n"
+    ".text\n"
+);
+
+int bump(int amount);
@@ -0,0 +1,5 @@
+#include "comdat.h"
+
+int bump_other(int amount) {
+    return bump(amount);
+}
@@ -0,0 +1,40 @@
+#include "platform/platform.h"
+
+/*
+    Functions in sections of their own, like -ffunction-sections, for --icf.
+    Copies fold, functions with equal bytes but different callees must not.
+    The even/odd pairs call each other, they fold as a group.
+    combine.expect checks the combiner folds square_b, apply_b, is_even_b and is_odd_b.
+*/
+
+#define FUNCTION(NAME) __attribute__((section(".text." #NAME), noinline)) NAME
+
+int FUNCTION(square_a)(int x) { return x * x; }
+int FUNCTION(square_b)(int x) { return x * x; }
+int FUNCTION(cube)(int x)     { return x * x * x; }
+
+// Same bytes, the callee decides
+int FUNCTION(apply_a)(int x) { return square_a(x) + 1; }
+int FUNCTION(apply_b)(int x) { return square_b(x) + 1; }
+int FUNCTION(apply_c)(int x) { return cube(x) + 1; }
+
+int is_odd_a(int n);
+int is_odd_b(int n);
+int FUNCTION(is_even_a)(int n) { return n == 0 ? 1 : is_odd_a(n - 1); }
+int FUNCTION(is_odd_a)(int n)  { return n == 0 ? 0 : is_even_a(n - 1); }
+int FUNCTION(is_even_b)(int n) { return n == 0 ? 1 : is_odd_b(n - 1); }
+int FUNCTION(is_odd_b)(int n)  { return n == 0 ? 0 : is_even_b(n - 1); }
+
+int ba_entry(const char* path, const char* data, int size) {
+    log__printf("apply %d %d %d\n", apply_a(3), apply_b(4), apply_c(3));
+    log__printf("even %d %d %d %d\n", is_even_a(10), is_even_b(7), is_odd_a(5), is_odd_b(8));
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], 0, 0);
+}
+
+#endif
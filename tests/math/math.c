@@ -0,0 +1,259 @@
+#include "platform/platform.h"
+
+/*
+    libm from src/libc against correctly rounded results from reference.py. Prints
+    the largest error of each function in ULP and checks it against the bound
+    documented in libm.c, then checks special values and that the array versions
+    give the same bits as the scalar functions, tails included.
+
+    The artifact is built with AVX2 and the native program without, both run
+    the same kernels and print the same numbers.
+*/
+
+#include "libc/libm_rename.h"
+#include "libc/libm.c"
+
+typedef struct {
+    double x, y;
+    double hi, lo; // exact result is hi + lo, hi correctly rounded to double
+} MathCase;
+
+#include "reference.h"
+
+typedef double (*MathFN)(double x, double y);
+typedef void   (*ArrayFN)(double* y, const double* x, size_t n);
+typedef void   (*ArrayFloatFN)(float* y, const float* x, size_t n);
+
+#define UNARY(name)                                                             \
+    static double run_##name(double x, double y) { return name(x); }           \
+    static double run_##name##f(double x, double y) { return name##f((float)x); }
+
+UNARY(exp)
+UNARY(log)
+UNARY(sin)
+UNARY(cos)
+UNARY(tanh)
+UNARY(sqrt)
+
+static double run_pow(double x, double y) { return pow(x, y); }
+static double run_powf(double x, double y) { return powf((float)x, (float)y); }
+
+typedef struct {
+    const char* name;
+    MathFN fn;
+    const MathCase* cases;
+    int count;
+    double bound;
+    bool single; // float function, the error is in float ULPs
+} MathTest;
+
+#define TEST(name, bound, single) { #name, run_##name, name##_cases, sizeof(name##_cases)/sizeof(*name##_cases), bound, single }
+
+static const MathTest tests[] = {
+    TEST(exp, 1, false),
+    TEST(log, 1, false),
+    TEST(pow, 1, false),
+    TEST(sin, 1, false),
+    TEST(cos, 1, false),
+    TEST(tanh, 1.5, false),
+    TEST(sqrt, 0.5, false),
+    TEST(expf, 0.5 + 0x1p-28, true),
+    TEST(logf, 0.5 + 0x1p-28, true),
+    TEST(powf, 0.5 + 0x1p-28, true),
+    TEST(sinf, 0.5 + 0x1p-28, true),
+    TEST(cosf, 0.5 + 0x1p-28, true),
+    TEST(tanhf, 0.5 + 0x1p-28, true),
+    TEST(sqrtf, 0.5, true),
+};
+
+static uint64_t bits(double x) {
+    union { double d; uint64_t u; } b = { x };
+    return b.u;
+}
+
+// 2^k for |k| <= 1023
+static double scale(int k) {
+    union { uint64_t u; double d; } b = { (uint64_t)(k + 1023) << 52 };
+    return b.d;
+}
+
+// |got - exact| in ULPs of the exact result, subnormals have the ULP of the smallest normal
+static double ulp_error(double got, const MathCase* c, bool single) {
+    if (got != got)
+        return 1e9; // nan, every case has a number as the exact result
+    if (c->hi == __builtin_inf() || c->hi == -__builtin_inf())
+        return got == c->hi ? 0 : 1e9;
+    int mantissa_bits = single ? 23 : 52;
+    int min_exponent = single ? -126 : -1022;
+    int e = (int)((bits(c->hi) >> 52) & 0x7FF) - 1023;
+    if (e < min_exponent)
+        e = min_exponent;
+    int k = mantissa_bits - e;
+    double error = (got - c->hi) - c->lo;
+    if (error < 0)
+        error = -error;
+    return error * scale(k / 2) * scale(k - k / 2);
+}
+
+typedef struct {
+    const char* name;
+    double got, expected;
+} Special;
+
+static int failures;
+
+static void check_specials(void) {
+    double inf = __builtin_inf(), nan = __builtin_nan("");
+    Special specials[] = {
+        { "exp(-inf)",      exp(-inf),         0 },
+        { "exp(inf)",       exp(inf),          inf },
+        { "exp(nan)",       exp(nan),          nan },
+        { "exp(1000)",      exp(1000),         inf },
+        { "exp(-1000)",     exp(-1000),        0 },
+        { "exp(-0)",        exp(-0.0),         1 },
+        { "log(0)",         log(0.0),          -inf },
+        { "log(-0)",        log(-0.0),         -inf },
+        { "log(-1)",        log(-1),           nan },
+        { "log(inf)",       log(inf),          inf },
+        { "log(1)",         log(1),            0 },
+        { "pow(nan, 0)",    pow(nan, 0),       1 },
+        { "pow(1, nan)",    pow(1, nan),       1 },
+        { "pow(-1, inf)",   pow(-1, inf),      1 },
+        { "pow(0, -1)",     pow(0.0, -1),      inf },
+        { "pow(-0, -1)",    pow(-0.0, -1),     -inf },
+        { "pow(-0, -2)",    pow(-0.0, -2),     inf },
+        { "pow(-0, 3)",     pow(-0.0, 3),      -0.0 },
+        { "pow(-2, 0.5)",   pow(-2, 0.5),      nan },
+        { "pow(-inf, 3)",   pow(-inf, 3),      -inf },
+        { "pow(-inf, -3)",  pow(-inf, -3),     -0.0 },
+        { "pow(-inf, 2)",   pow(-inf, 2),      inf },
+        { "pow(0.5, inf)",  pow(0.5, inf),     0 },
+        { "pow(0.5, -inf)", pow(0.5, -inf),    inf },
+        { "pow(2, -inf)",   pow(2, -inf),      0 },
+        { "pow(2, inf)",    pow(2, inf),       inf },
+        { "pow(2, 2000)",   pow(2, 2000),      inf },
+        { "pow(2, -2000)",  pow(2, -2000),     0 },
+        { "pow(-2, 1025)",  pow(-2, 1025),     -inf },
+        { "pow(-3, 3)",     pow(-3, 3),        -27 },
+        { "pow(2, 10)",     pow(2, 10),        1024 },
+        { "sin(-0)",        sin(-0.0),         -0.0 },
+        { "sin(inf)",       sin(inf),          nan },
+        { "sin(nan)",       sin(nan),          nan },
+        { "cos(0)",         cos(0.0),          1 },
+        { "cos(-inf)",      cos(-inf),         nan },
+        { "tanh(inf)",      tanh(inf),         1 },
+        { "tanh(-inf)",     tanh(-inf),        -1 },
+        { "tanh(-0)",       tanh(-0.0),        -0.0 },
+        { "tanh(nan)",      tanh(nan),         nan },
+        { "sqrt(-1)",       sqrt(-1),          nan },
+        { "sqrt(-0)",       sqrt(-0.0),        -0.0 },
+        { "sqrt(inf)",      sqrt(inf),         inf },
+        { "powf(-0, -1)",   powf(-0.0f, -1),   -inf },
+        { "expf(89)",       expf(89),          inf },
+        { "logf(0)",        logf(0),           -inf },
+        { "sinf(-0)",       sinf(-0.0f),       -0.0 },
+        { "tanhf(-inf)",    tanhf(-inf),       -1 },
+    };
+    int count = sizeof(specials)/sizeof(*specials), failed = 0;
+    for (int i = 0; i < count; i++) {
+        Special* s = &specials[i];
+        bool both_nan = s->got != s->got && s->expected != s->expected;
+        if (!both_nan && bits(s->got) != bits(s->expected)) {
+            log__printf("FAIL %s = %a, expected %a\n", s->name, s->got, s->expected);
+            failed++;
+        }
+    }
+    log__printf("specials: %d values, %d failures\n", count, failed);
+    failures += failed;
+}
+
+#define ARRAY_SIZE 64
+
+static double inputs[ARRAY_SIZE], inputs_y[ARRAY_SIZE], outputs[ARRAY_SIZE];
+static float inputs_f[ARRAY_SIZE], inputs_fy[ARRAY_SIZE], outputs_f[ARRAY_SIZE];
+
+// Lengths that leave every tail size
+static const int lengths[] = { 1, 2, 3, 4, 5, 7, 8, 13, 63 };
+
+static void check_array(const char* name, MathFN scalar, ArrayFN array, ArrayFloatFN array_f, const MathCase* cases, int count) {
+    for (int i = 0; i < ARRAY_SIZE; i++) {
+        inputs[i] = cases[i % count].x;
+        inputs_f[i] = (float)inputs[i];
+    }
+    int mismatches = 0;
+    for (int l = 0; l < sizeof(lengths)/sizeof(*lengths); l++) {
+        int n = lengths[l];
+        array(outputs, inputs, n);
+        array_f(outputs_f, inputs_f, n);
+        for (int i = 0; i < n; i++) {
+            mismatches += bits(outputs[i]) != bits(scalar(inputs[i], 0));
+            mismatches += outputs_f[i] != (float)scalar(inputs_f[i], 0) && outputs_f[i] == outputs_f[i];
+        }
+    }
+    if (mismatches) {
+        log__printf("FAIL %s_array: %d results differ from %s\n", name, mismatches, name);
+        failures++;
+    }
+}
+
+static void check_arrays(void) {
+    check_array("exp",  run_exp,  exp_array,  expf_array,  exp_cases,  sizeof(exp_cases)/sizeof(*exp_cases));
+    check_array("log",  run_log,  log_array,  logf_array,  log_cases,  sizeof(log_cases)/sizeof(*log_cases));
+    check_array("sin",  run_sin,  sin_array,  sinf_array,  sin_cases,  sizeof(sin_cases)/sizeof(*sin_cases));
+    check_array("cos",  run_cos,  cos_array,  cosf_array,  cos_cases,  sizeof(cos_cases)/sizeof(*cos_cases));
+    check_array("tanh", run_tanh, tanh_array, tanhf_array, tanh_cases, sizeof(tanh_cases)/sizeof(*tanh_cases));
+    check_array("sqrt", run_sqrt, sqrt_array, sqrtf_array, sqrt_cases, sizeof(sqrt_cases)/sizeof(*sqrt_cases));
+
+    int count = sizeof(pow_cases)/sizeof(*pow_cases), mismatches = 0;
+    for (int i = 0; i < ARRAY_SIZE; i++) {
+        inputs[i] = pow_cases[i % count].x;
+        inputs_y[i] = pow_cases[i % count].y;
+        inputs_f[i] = (float)powf_cases[i % 24].x;
+        inputs_fy[i] = (float)powf_cases[i % 24].y;
+    }
+    for (int l = 0; l < sizeof(lengths)/sizeof(*lengths); l++) {
+        int n = lengths[l];
+        pow_array(outputs, inputs, inputs_y, n);
+        powf_array(outputs_f, inputs_f, inputs_fy, n);
+        for (int i = 0; i < n; i++) {
+            mismatches += bits(outputs[i]) != bits(pow(inputs[i], inputs_y[i]));
+            mismatches += outputs_f[i] != powf(inputs_f[i], inputs_fy[i]);
+        }
+    }
+    if (mismatches) {
+        log__printf("FAIL pow_array: %d results differ from pow\n", mismatches);
+        failures++;
+    }
+    log__printf("arrays: checked\n");
+}
+
+int ba_entry(const char* path, const char* data, int size) {
+    for (int t = 0; t < sizeof(tests)/sizeof(*tests); t++) {
+        const MathTest* test = &tests[t];
+        double worst = 0, worst_x = 0, worst_y = 0;
+        for (int i = 0; i < test->count; i++) {
+            const MathCase* c = &test->cases[i];
+            double error = ulp_error(test->fn(c->x, c->y), c, test->single);
+            if (error > worst) {
+                worst = error;
+                worst_x = c->x;
+                worst_y = c->y;
+            }
+        }
+        bool ok = worst <= test->bound;
+        log__printf("%-5s %3d cases, max error %.3f ulp at (%a, %a)%s\n", test->name, test->count, worst, worst_x, worst_y, ok ? "" : " FAIL");
+        failures += !ok;
+    }
+    check_specials();
+    check_arrays();
+    log__printf("math: %d failures\n", failures);
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], NULL, 0);
+}
+
+#endif
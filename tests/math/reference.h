@@ -0,0 +1,678 @@
+/* Generated by reference.py, do not edit */
+
+static const MathCase exp_cases[] = {
+    { -0x1.1eacdd80b7430p+9, 0x0.0p+0, 0x1.c71b7821085e2p-828, -0x1.c36119576a3a9p-883 },
+    { -0x1.0b5c232f37b98p+7, 0x0.0p+0, 0x1.1a340480c6d56p-193, 0x1.ed25ae97123d4p-247 },
+    { 0x1.8ce76f83c0a10p+8, 0x0.0p+0, 0x1.8720d484a9cd0p+572, 0x1.5194a5090d9adp+518 },
+    { 0x1.a2d3d404cb3a0p+6, 0x0.0p+0, 0x1.0ae27a6214fa6p+151, 0x1.05a1d568a0467p+96 },
+    { 0x1.efebaf41cb610p+8, 0x0.0p+0, 0x1.60b05a54e5b86p+715, -0x1.bd8bd3644bcfdp+659 },
+    { -0x1.00866da757e40p+7, 0x0.0p+0, 0x1.f0b4a86ad18bcp-186, -0x1.354218fb293a4p-240 },
+    { -0x1.c2f93279549eep+8, 0x0.0p+0, 0x1.4dced0200d480p-651, -0x1.b00e339537ee7p-705 },
+    { -0x1.c38a87c27c2f0p+6, 0x0.0p+0, 0x1.1a46966a272a5p-163, 0x1.09e32d10347aap-217 },
+    { -0x1.86456fc761f40p+7, 0x0.0p+0, 0x1.64c29e7520326p-282, -0x1.749fdafe9745cp-336 },
+    { -0x1.3cad6e0d6b502p+9, 0x0.0p+0, 0x1.32faa1c9f5e3bp-914, 0x1.6a41a68846096p-968 },
+    { 0x1.50c65f4c4cf5ap+9, 0x0.0p+0, 0x1.a7b5aa54e498fp+971, -0x1.ff01da768b3bep+916 },
+    { 0x1.14e24cdef726ap+9, 0x0.0p+0, 0x1.e3d01a936c8d0p+798, -0x1.24edc5a3e3552p+744 },
+    { 0x1.c8b92add4c6dcp+8, 0x0.0p+0, 0x1.e1dad8046f3b5p+658, 0x1.c14f97381ceb0p+603 },
+    { 0x1.4c5bdf1e1e730p+6, 0x0.0p+0, 0x1.d4e568be3e2cep+119, 0x1.cd9f636095b26p+64 },
+    { -0x1.fef51b79697dep+7, 0x0.0p+0, 0x1.5702c18d882f6p-369, -0x1.d7e3e97574dc1p-424 },
+    { -0x1.1743d89d60015p+9, 0x0.0p+0, 0x1.2869f7dfee594p-806, -0x1.d2ff938d42888p-860 },
+    { 0x1.0cac494174188p+9, 0x0.0p+0, 0x1.2b7ebfa6775bap+775, -0x1.d0308564d5379p+721 },
+    { 0x1.b4614058e0ed0p+6, 0x0.0p+0, 0x1.4fa4184e3c77ap+157, 0x1.eaa7a9af1d2ddp+103 },
+    { -0x1.1881a5e391ec4p+9, 0x0.0p+0, 0x1.8c0a970f80877p-810, -0x1.32831d4245cf4p-864 },
+    { 0x1.3d007e8a39caep+9, 0x0.0p+0, 0x1.988287a3085b9p+914, -0x1.21fbdbc20c44fp+857 },
+    { 0x1.1b46a904a2dc0p+9, 0x0.0p+0, 0x1.48f819a1ec71fp+817, -0x1.38ff34c8905d2p+757 },
+    { 0x1.b3b9e9d04bca8p+6, 0x0.0p+0, 0x1.1d09fd4b15955p+157, 0x1.f750fa599b1a4p+103 },
+    { 0x1.ea5e81d2add30p+5, 0x0.0p+0, 0x1.59491683331a5p+88, -0x1.41f4b89c7507cp+27 },
+    { 0x1.0a499db8e87acp+9, 0x0.0p+0, 0x1.44d1b40cc7de9p+768, 0x1.af17be9ac1c6ep+713 },
+    { 0x1.9bb465e36e1c4p+7, 0x0.0p+0, 0x1.f9b44433eadbcp+296, -0x1.2f86b70762693p+241 },
+    { -0x1.9ea7b6aa21484p+7, 0x0.0p+0, 0x1.da43d350e6e8dp-300, -0x1.6eb12ceaf6532p-354 },
+    { -0x1.531094b941441p+9, 0x0.0p+0, 0x1.9627058193b88p-979, 0x0.0037223e287b5p-1022 },
+    { 0x1.60f15e737504ap+9, 0x0.0p+0, 0x1.4ca248ad827a9p+1018, 0x1.b15f192512924p+964 },
+    { 0x1.2a6c3504bef50p+6, 0x0.0p+0, 0x1.8d10a7325c888p+107, -0x1.f27026200937dp+53 },
+    { -0x1.b84f9754e060cp+8, 0x0.0p+0, 0x1.b33ba24f4d2e9p-636, 0x1.e925d2cce07bep-691 },
+    { -0x1.4fd99581cf6f2p+9, 0x0.0p+0, 0x1.ebcc376202b2dp-970, 0x0.5071a9002c68ap-1022 },
+    { 0x1.cc5cf62486a68p+8, 0x0.0p+0, 0x1.1ebdc5648ce25p+664, -0x1.b8033704b65acp+610 },
+    { -0x1.6a7916be4e993p+8, 0x0.0p+0, 0x1.0b3d9bb82ab6dp-523, -0x1.94af1632bccd5p-578 },
+    { -0x1.becd515359662p+8, 0x0.0p+0, 0x1.52038874c4730p-645, 0x1.dd560f783b1b6p-701 },
+    { -0x1.665c2835a220fp+8, 0x0.0p+0, 0x1.fe84f0487937cp-518, -0x1.e13494dad09e5p-575 },
+    { -0x1.a1ff4c16961f1p+8, 0x0.0p+0, 0x1.f11d3ae93400dp-604, 0x1.dc636fb98a278p-658 },
+    { 0x1.e990e47ed5098p+8, 0x0.0p+0, 0x1.39f4df1170e90p+706, -0x1.f8414672a4a8cp+652 },
+    { -0x1.ef878fb3a3e5cp+7, 0x0.0p+0, 0x1.7710b057120c9p-358, 0x1.aea825a612477p-416 },
+    { 0x1.384dcaa57f61ap+9, 0x0.0p+0, 0x1.15ea2f6159967p+901, -0x1.4a18cb9e19606p+846 },
+    { -0x1.1a43f74fe2dccp+7, 0x0.0p+0, 0x1.4f1bec0b9d31dp-204, -0x1.2832ce737e3cbp-259 },
+    { 0x1.4ddb98781f8bep+9, 0x0.0p+0, 0x1.3d5bdb9ad4477p+963, -0x1.9b16dccd359e1p+907 },
+    { -0x1.0a4efde83b0bcp+9, 0x0.0p+0, 0x1.82ed46360c9d7p-769, 0x1.ad85b187b687fp-823 },
+    { -0x1.4e6be3d0e68fcp+8, 0x0.0p+0, 0x1.721e18fb39048p-483, 0x1.81acc908972aap-542 },
+    { -0x1.7b28fb8ec045fp+8, 0x0.0p+0, 0x1.fba01f4b0307cp-548, 0x1.cf15abe5caf65p-603 },
+    { -0x1.d39e1971fb6b8p+6, 0x0.0p+0, 0x1.449edd90d245ap-169, 0x1.191ce361bb36ap-223 },
+    { -0x1.677d7aab4e383p+9, 0x0.0p+0, 0x0.0001a8cfa9d46p-1022, 0x0.0p+0 },
+    { -0x1.bacde1cd11f08p+8, 0x0.0p+0, 0x1.1fb927af46a77p-639, 0x1.a83a2658f6201p-693 },
+    { -0x1.86032cadb6848p+7, 0x0.0p+0, 0x1.960d677832bbbp-282, -0x1.b784d2678fd2ap-337 },
+    { -0x1.5d5e7f0fe8f38p-3, 0x0.0p+0, 0x1.afb391609a057p-1, 0x1.e1465fd70d177p-56 },
+    { 0x1.7daa2a8935b28p-2, 0x0.0p+0, 0x1.73a11ab68f22bp+0, -0x1.68427c42f2961p-56 },
+    { -0x1.36e2c7083938cp-1, 0x0.0p+0, 0x1.16f9da1b06c64p-1, -0x1.81a26f5b28a7ep-56 },
+    { -0x1.73a13ae8321b0p-2, 0x0.0p+0, 0x1.642b39397d738p-1, 0x1.8da47f3c34690p-56 },
+    { 0x1.73f92f3699e72p-1, 0x0.0p+0, 0x1.08af61ce7fa7ep+1, -0x1.e634b31d9b81ep-54 },
+    { 0x1.b48987e7e17fep-1, 0x0.0p+0, 0x1.2c420b08634fbp+1, 0x1.6077f4022547ep-53 },
+    { -0x1.169d863b0fa36p-1, 0x0.0p+0, 0x1.29201615117f1p-1, -0x1.38faf8fb0a6b5p-56 },
+    { 0x1.5f38103f02798p-2, 0x0.0p+0, 0x1.68be1c82cdfb0p+0, 0x1.07974530c3574p-54 },
+    { 0x1.2475b6a37b696p-1, 0x0.0p+0, 0x1.c53985def559bp+0, 0x1.60e56581ba7acp-54 },
+    { 0x1.470fccc10c278p-2, 0x0.0p+0, 0x1.6054f7f66f033p+0, 0x1.cd226e5444559p-54 },
+    { 0x1.23b27fcf2ea68p-1, 0x0.0p+0, 0x1.c48cd8dac309ap+0, 0x1.885b840f9fa56p-55 },
+    { -0x1.d3b5dc51f8550p-3, 0x0.0p+0, 0x1.97768e9bf6261p-1, 0x1.5c1e57506468ep-55 },
+    { -0x1.42cc27059ded0p-3, 0x0.0p+0, 0x1.b556c9b2315dbp-1, -0x1.ddc75e4fdf90ap-55 },
+    { 0x1.48eb4b645ec3ap-1, 0x0.0p+0, 0x1.e6acee491c899p+0, -0x1.adf10ba109f34p-55 },
+    { 0x1.548dab317ab3ap-1, 0x0.0p+0, 0x1.f1dc663cac084p+0, 0x1.2b5bfe6c70b38p-54 },
+    { -0x1.4bbd586ca38d4p-1, 0x0.0p+0, 0x1.0bd7714fa28a1p-1, 0x1.f84e066a10650p-57 },
+    { -0x1.bcff8ad5e3046p-1, 0x0.0p+0, 0x1.ad6070d29efb5p-2, 0x1.60856d9720771p-57 },
+    { 0x1.9974f5fd39264p-2, 0x0.0p+0, 0x1.7dda8f3f4467cp+0, 0x1.3ce672b1bf34fp-54 },
+    { 0x1.bd816ac652630p-1, 0x0.0p+0, 0x1.31904e8d3f9b0p+1, -0x1.158ced0fe4753p-53 },
+    { 0x1.5a867930b139ep-1, 0x0.0p+0, 0x1.f7b3b0632a897p+0, -0x1.0d5329c1944cdp-54 },
+    { -0x1.64addf7e07b18p-3, 0x0.0p+0, 0x1.ae29cce364c35p-1, 0x1.1655c46012f4bp-55 },
+    { 0x1.d1d824ddce974p-1, 0x0.0p+0, 0x1.3df23f636e405p+1, 0x1.62a5d9745e791p-53 },
+    { -0x1.40f7f03d2eb20p-2, 0x0.0p+0, 0x1.763bab35150eap-1, 0x1.1fa984deff879p-55 },
+    { -0x1.277681684ee70p-1, 0x0.0p+0, 0x1.1f81e573df99fp-1, 0x1.0cb20e0c8f3e4p-57 },
+    { 0x1.0000000000000p-1000, 0x0.0p+0, 0x1.0000000000000p+0, 0x0.0p+0 },
+    { -0x1.0000000000000p-60, 0x0.0p+0, 0x1.0000000000000p+0, -0x1.0000000000000p-60 },
+    { 0x1.0000000000000p+0, 0x0.0p+0, 0x1.5bf0a8b145769p+1, 0x1.4d57ee2b1013ap-53 },
+    { 0x1.62e3d70a3d70ap+9, 0x0.0p+0, 0x1.fe9ce5c4c52b4p+1023, 0x1.a8a120488d827p+969 },
+    { -0x1.6240000000000p+9, 0x0.0p+0, 0x0.e6cf6d08897acp-1022, -0x0.0p+0 },
+    { -0x1.7200000000000p+9, 0x0.0p+0, 0x0.0000000000055p-1022, -0x0.0p+0 },
+    { -0x1.748cccccccccdp+9, 0x0.0p+0, 0x0.0000000000001p-1022, -0x0.0p+0 },
+    { 0x1.b7cdfd9d7bdbbp-34, 0x0.0p+0, 0x1.000000006df38p+0, -0x1.3112d8e5e6d4cp-57 },
+};
+
+static const MathCase log_cases[] = {
+    { 0x1.67e1dfaee3fe1p-262, 0x0.0p+0, -0x1.6a8725fbb29eep+7, -0x1.dd06d95ef4039p-49 },
+    { 0x1.1135e30b72963p-542, 0x0.0p+0, -0x1.779ee6a3716dap+8, 0x1.8e9f5fddede9ep-46 },
+    { 0x1.a97b71ba3812ap+348, 0x0.0p+0, 0x1.e3724fb9f3fc4p+7, 0x1.566223e65018bp-48 },
+    { 0x1.910cdf57bec51p-265, 0x0.0p+0, -0x1.6e785e2c2c60bp+7, 0x1.d0511efdc3885p-49 },
+    { 0x1.821d7c9887dbap+79, 0x0.0p+0, 0x1.b95b4faa85f8ep+5, 0x1.269afd0ffc744p-50 },
+    { 0x1.ce06440e17971p+673, 0x0.0p+0, 0x1.d314181d03647p+8, -0x1.7f5bfd2251f7cp-46 },
+    { 0x1.24ed808cbcdb8p+597, 0x0.0p+0, 0x1.9df190c5fd287p+8, -0x1.869829f1d78c5p-46 },
+    { 0x1.c46689ab3388fp+236, 0x0.0p+0, 0x1.484de3575f72ap+7, -0x1.c4ed13fa8fa30p-48 },
+    { 0x1.a3e8683021909p-47, 0x0.0p+0, -0x1.00aa1b308e6c3p+5, 0x1.8522e7b56b0f7p-49 },
+    { 0x1.faa7dc62aa5ecp-316, 0x0.0p+0, -0x1.b4b426503cdfap+7, -0x1.0a90b8bd64f83p-47 },
+    { 0x1.2629817e4922bp+97, 0x0.0p+0, 0x1.0d7f3630956bdp+6, -0x1.d2b8f29351e79p-49 },
+    { 0x1.b54cd03a9a8bbp+790, 0x0.0p+0, 0x1.120f94598b0e4p+9, -0x1.d4605955cb2e1p-45 },
+    { 0x1.47238f996efb1p-659, 0x0.0p+0, -0x1.c889edc8cdd92p+8, 0x1.4b025fa2c0babp-48 },
+    { 0x1.b88623505f84dp+718, 0x0.0p+0, 0x1.f238f356ffd22p+8, 0x1.bc198cfed89d2p-47 },
+    { 0x1.33120c6a5fc98p-505, 0x0.0p+0, -0x1.5ddb804988d4fp+8, 0x1.6a68028ae758cp-47 },
+    { 0x1.76d018ff863e2p-148, 0x0.0p+0, -0x1.98d17129f9165p+6, -0x1.1dc972682e65bp-49 },
+    { 0x1.a0877d30c7da9p-99, 0x0.0p+0, -0x1.108a06d0b3561p+6, -0x1.e04ac7db808fap-48 },
+    { 0x1.f2ce59cab09c4p-843, 0x0.0p+0, -0x1.23d3f8e62cdfdp+9, -0x1.a5a12bcfe542bp-45 },
+    { 0x1.60cfca9a4819ep+634, 0x0.0p+0, 0x1.b7c6ac7d38a24p+8, 0x1.4ee255d34b4dbp-46 },
+    { 0x1.2cf813877d8b4p+476, 0x0.0p+0, 0x1.4a19924164991p+8, 0x1.4d030b2a51665p-48 },
+    { 0x1.8f69f1f40f8bcp-491, 0x0.0p+0, -0x1.53e3f4343646fp+8, 0x1.d6cdb6acf6d62p-48 },
+    { 0x1.c678a3b6314d6p-796, 0x0.0p+0, -0x1.1395e9d544925p+9, 0x1.944bf0c7db6f6p-46 },
+    { 0x1.43614802cba2dp-882, 0x0.0p+0, -0x1.318fa305ffdc4p+9, -0x1.5f0dcb9908172p-46 },
+    { 0x1.4cddf3ea16e0fp-14, 0x0.0p+0, -0x1.2e20ba05a7136p+3, -0x1.5036e09a3f98fp-51 },
+    { 0x1.d3789363bd2f0p-121, 0x0.0p+0, -0x1.4d1318b7d755dp+6, 0x1.2d710794f7dfdp-48 },
+    { 0x1.e469a236fa30cp+93, 0x0.0p+0, 0x1.0466dbb1486bep+6, 0x1.1bec7a2c630c3p-48 },
+    { 0x1.828f6dbaddaa7p+973, 0x0.0p+0, 0x1.516c129495ed8p+9, -0x1.0cc029a150eecp-47 },
+    { 0x1.13d19c8639008p-637, 0x0.0p+0, -0x1.b975ced69c208p+8, -0x1.60c5654bb492cp-48 },
+    { 0x1.220460b67397bp+336, 0x0.0p+0, 0x1.d20b5fc77ec2ep+7, 0x1.a3c82f96c1423p-47 },
+    { 0x1.3efa4bc98578dp-312, 0x0.0p+0, -0x1.b0157df278469p+7, 0x1.dfe2fabf6bc87p-47 },
+    { 0x1.f18eb591d1b1cp+39, 0x0.0p+0, 0x1.bb280867bafb8p+4, -0x1.5a36839b257cep-50 },
+    { 0x1.9888e7f7c6942p-347, 0x0.0p+0, -0x1.e01bfdf8b5efap+7, 0x1.89614cd6abde2p-52 },
+    { 0x1.2cf1abd9e3269p+41, 0x0.0p+0, 0x1.c94ae148c6257p+4, -0x1.79c345935c0a8p-50 },
+    { 0x1.ec82bbb10f67cp+810, 0x0.0p+0, 0x1.190d4149dc774p+9, -0x1.4ecd73478953cp-45 },
+    { 0x1.1ffd771eb5b2dp+262, 0x0.0p+0, 0x1.6b71d29c8832fp+7, -0x1.0014a68a69fdcp-48 },
+    { 0x1.a511d311ee02ap+933, 0x0.0p+0, 0x1.439a1ab695251p+9, 0x1.0f08b567fa64fp-46 },
+    { 0x1.1c8e8909518d6p+133, 0x0.0p+0, 0x1.712d64f13723ep+6, 0x1.9dddff0f68aebp-52 },
+    { 0x1.c1eb263c8574fp-836, 0x0.0p+0, -0x1.21741d9dcd8d3p+9, 0x1.1972f6b1ae5e7p-45 },
+    { 0x1.e828f397d9d86p-87, 0x0.0p+0, -0x1.dd44473cd3f72p+5, -0x1.f878928a7042ep-49 },
+    { 0x1.c5f6da84eff38p-336, 0x0.0p+0, -0x1.d0a6337e549f0p+7, 0x1.a05ffdef1cec3p-47 },
+    { 0x1.282d692dc6479p+490, 0x0.0p+0, 0x1.53c9b3c97a575p+8, 0x1.efbd5b596ba48p-47 },
+    { 0x0.000000ef0da6ep-1022, 0x0.0p+0, -0x1.6a8cdb45ac468p+9, 0x1.eab2e7e9569f6p-45 },
+    { 0x1.d2892a8c22e68p-403, 0x0.0p+0, -0x1.16bcf7d2066fap+8, 0x1.2cbd8130e317fp-46 },
+    { 0x1.095d1e89d08f3p+45, 0x0.0p+0, 0x1.f3a40887781e9p+4, 0x1.935cbe22041c2p-52 },
+    { 0x1.6b878e3a2e64bp+478, 0x0.0p+0, 0x1.4baccf1de2ecep+8, -0x1.55236e5c68fcep-50 },
+    { 0x1.9b8bf27fb8f7bp-665, 0x0.0p+0, -0x1.cc77d75fa84b6p+8, -0x1.f75cb2bc2a00ap-46 },
+    { 0x1.2586a1b8c60cbp+788, 0x0.0p+0, 0x1.112b1b2c20cb7p+9, 0x1.c2a73551d5f91p-47 },
+    { 0x1.854dbc94cbc15p-902, 0x0.0p+0, -0x1.386658765c7fcp+9, -0x1.858dc00bac0e7p-50 },
+    { 0x1.aceb819aca910p-1, 0x0.0p+0, -0x1.6a9b75bc9fc18p-3, 0x1.97a3a83e4d839p-58 },
+    { 0x1.94a537dc121c2p-1, 0x0.0p+0, -0x1.e1ec10604914ep-3, -0x1.136d1dabb688dp-58 },
+    { 0x1.1980707fced14p+0, 0x0.0p+0, 0x1.84f5ee7c5739dp-4, 0x1.b0207ccfe1c70p-58 },
+    { 0x1.33d3b0ba29341p+0, 0x0.0p+0, 0x1.7991d9879499cp-3, 0x1.22e700c39219cp-59 },
+    { 0x1.c157e6c7f6fa2p-1, 0x0.0p+0, -0x1.0b57235757c89p-3, 0x1.69dc88b45f5eep-58 },
+    { 0x1.cb40f1d6fc287p-1, 0x0.0p+0, -0x1.bd53239b6eafbp-4, -0x1.f84ed4592c0dcp-58 },
+    { 0x1.854d46161d202p-1, 0x0.0p+0, -0x1.188b7dbce40a2p-2, 0x1.03dba20ffbc43p-57 },
+    { 0x1.063a85cd96fdfp+0, 0x0.0p+0, 0x1.89dbc555428ecp-6, -0x1.6a876b942b011p-61 },
+    { 0x1.22f6ae6c1048ap+0, 0x0.0p+0, 0x1.062fbae711f6cp-3, 0x1.be1896693167bp-58 },
+    { 0x1.281370f7ab8eap+0, 0x0.0p+0, 0x1.29dbae5353625p-3, -0x1.7c9f705e88646p-58 },
+    { 0x1.0f30e315fd2dap+0, 0x0.0p+0, 0x1.d83bff411c569p-5, -0x1.2483edc142bc0p-60 },
+    { 0x1.c742f04eed9f8p-1, 0x0.0p+0, -0x1.e11612c254bcep-4, 0x1.2f01cf41bf2dcp-59 },
+    { 0x1.4801cc093b15bp+0, 0x0.0p+0, 0x1.fb9cbf399bf11p-3, 0x1.45b08f90b3cb4p-57 },
+    { 0x1.9399b49dd300cp-1, 0x0.0p+0, -0x1.e737c192ab5b5p-3, 0x1.29939c6cc9676p-58 },
+    { 0x1.9b350a67424cfp-1, 0x0.0p+0, -0x1.c0fa4efccbf3ep-3, -0x1.e205e29448be8p-57 },
+    { 0x1.2de7454c1aabbp+0, 0x0.0p+0, 0x1.51c6a3f8b0ca6p-3, 0x1.f46df082735e3p-59 },
+    { 0x1.84bf989af8a97p-1, 0x0.0p+0, -0x1.1a006b07f59f4p-2, -0x1.10d60a77a3db2p-56 },
+    { 0x1.1eac6257904ecp+0, 0x0.0p+0, 0x1.cf8736a7b670cp-4, 0x1.ebb342f08a996p-58 },
+    { 0x1.aa2b216a0b087p-1, 0x0.0p+0, -0x1.77c9891833977p-3, -0x1.69d3679a3758ep-58 },
+    { 0x1.9888abae1a8dep-1, 0x0.0p+0, -0x1.ce55e984d2e34p-3, -0x1.44fd32bd80b06p-58 },
+    { 0x1.1b3a71aefbd1ap+0, 0x0.0p+0, 0x1.9e01b0fc24ebdp-4, -0x1.00c87b098edcbp-58 },
+    { 0x1.9f5032a89132ep-1, 0x0.0p+0, -0x1.aca1079f2aa16p-3, 0x1.dc4f2d34a220ap-57 },
+    { 0x1.094d20e57d986p+0, 0x0.0p+0, 0x1.245c87f0e9094p-5, 0x1.8fa8973926169p-61 },
+    { 0x1.0d00d21f43af4p+0, 0x0.0p+0, 0x1.95e12fd8c35fcp-5, 0x1.3bd93ffc0e432p-61 },
+    { 0x1.0000000400000p+0, 0x0.0p+0, 0x1.fffffffc00000p-31, 0x1.5555555155555p-92 },
+    { 0x1.fffffffffe000p-1, 0x0.0p+0, -0x1.0000000000800p-40, -0x1.5555555556555p-122 },
+    { 0x0.0000000000001p-1022, 0x0.0p+0, -0x1.74385446d71c3p+9, -0x1.8e569fa8ee781p-45 },
+    { 0x1.fffffffffffffp+1023, 0x0.0p+0, 0x1.62e42fefa39efp+9, 0x1.a9c9e3b39803fp-46 },
+    { 0x1.0000000000000p+1, 0x0.0p+0, 0x1.62e42fefa39efp-1, 0x1.abc9e3b39803fp-56 },
+    { 0x1.0000000000000p-1, 0x0.0p+0, -0x1.62e42fefa39efp-1, -0x1.abc9e3b39803fp-56 },
+    { 0x1.56e1fc2f8f359p-997, 0x0.0p+0, -0x1.5963447f87fb5p+9, -0x1.aa670d35324e6p-46 },
+    { 0x1.4000000000000p+3, 0x0.0p+0, 0x1.26bb1bbb55516p+1, -0x1.f48ad494ea3e9p-53 },
+};
+
+static const MathCase pow_cases[] = {
+    { 0x1.f1ecc826f62fep+27, -0x1.032d210520135p+5, 0x1.23333bd3ac0f9p-906, -0x1.c7065c4289a96p-960 },
+    { 0x1.c179180937c48p-7, -0x1.0bbbf6851d64dp+7, 0x1.4800b923ed004p+828, -0x1.a63ab1c2d583ep+774 },
+    { 0x1.34f1c91e839cfp+20, 0x1.1e987528536e7p+5, 0x1.26ffd2973dce1p+726, 0x1.cdf7f52e1a394p+672 },
+    { 0x1.8b4bee3408f5ap-11, -0x1.7cc7e14e07453p+5, 0x1.ab80f540b6c5bp+493, -0x1.fe7c3097f42dbp+437 },
+    { 0x1.08da0241bd5b6p+5, 0x1.496ad7bab2ccep+7, 0x1.89a60c36c6db8p+831, 0x1.35019ee8f8f7ap+775 },
+    { 0x1.ca4b403926258p+20, 0x1.2845f862bba14p+5, 0x1.bcbb9d435bf95p+771, -0x1.e33942534e298p+715 },
+    { 0x1.6a87189dccb26p-9, 0x1.f9d751e8c78a6p+3, 0x1.96658a8764a16p-135, 0x1.c87e18f74c9d7p-190 },
+    { 0x1.5eece8fc3ddaep+11, -0x1.261e9b95ca32ep+5, 0x1.cf9e2a5a23c5ap-422, -0x1.d27330dad909dp-476 },
+    { 0x1.64091470bf5cfp-20, 0x1.ff1d6939ef8eep+4, 0x1.3cf488a2cf4f2p-624, -0x1.eef4658e72430p-681 },
+    { 0x1.a8d78c1ff0f6cp+17, -0x1.f6c718dd2cdf6p+2, 0x1.a26459a912613p-140, 0x1.b4894855e8b30p-195 },
+    { 0x1.adf96713c9ab2p-8, 0x1.695922e9edd7dp+6, 0x1.d8e2669a7a448p-656, 0x1.12619ec35c741p-710 },
+    { 0x1.ae3fcf2f4b447p-18, -0x1.8cbae152fb80ep+4, 0x1.ae1ff0b7a5c00p+427, -0x1.017e2e2a428d3p+373 },
+    { 0x1.eaee183d6fc50p-16, -0x1.5ce619ef701c7p+0, 0x1.7099f5c46052ep+20, 0x1.8ba4acbdc5211p-35 },
+    { 0x1.0d2e23619da39p+6, 0x1.ebb858f20f1b5p+5, 0x1.2ebbeac223942p+373, 0x1.129fde801ee66p+318 },
+    { 0x1.fdf627e59d640p+1, -0x1.7284e3d558a26p+8, 0x1.1148f72c020ccp-739, 0x1.a7be608aeb196p-796 },
+    { 0x1.2dcdfe71aa02fp-26, -0x1.d56e5aa34684bp+4, 0x1.d01339fefe86cp+755, -0x1.f98b3cceac10ep+701 },
+    { 0x1.a5da6b8503e1ap+3, 0x1.bbd263cd528f1p+7, 0x1.8f4008fe6775fp+825, 0x1.62e8ab45995dep+771 },
+    { 0x1.1260dcc1234a1p-24, 0x1.f1c95b8c7ee8bp+4, 0x1.5961d5841a48dp-744, -0x1.9e92c3918f7b8p-799 },
+    { 0x1.fd17439ffd45fp+20, -0x1.00bf5cd8b1f73p+1, 0x1.dbae59f6c2133p-43, -0x1.d6bfe73f8c597p-99 },
+    { 0x1.6757a1a7bacc8p-14, 0x1.056a62cb0b65dp+5, 0x1.6c41475e0b0b8p-442, 0x1.9dbe7346c5643p-496 },
+    { 0x1.123dd0f0517ebp-5, 0x1.56f94b7b365aap+5, 0x1.dd44cf8b24cc4p-211, 0x1.0aa1f9805738ep-265 },
+    { 0x1.239854caf46d9p-27, 0x1.0bc3996b9258dp+5, 0x1.7f6d5ed4e5b28p-898, 0x1.da4d091bc0522p-952 },
+    { 0x1.1188b05705593p-16, -0x1.3ad55159c4526p+5, 0x1.df72a815dabb2p+625, -0x1.5e5b196cf5775p+571 },
+    { 0x1.3d3017a951184p+25, -0x1.294d35f37a307p+4, 0x1.a5f8fedbee224p-471, 0x1.5e7bb9a1e7636p-525 },
+    { 0x1.3aa84cea0760cp+0, 0x1.bf6bffd2e931dp+10, 0x1.99f395cffef80p+532, -0x1.45a945db7b176p+477 },
+    { 0x1.de711c9eb1d20p-17, 0x1.50b66a00c89ccp+5, 0x1.5fca20f9c0790p-678, -0x1.abd159c57564dp-733 },
+    { 0x1.09330f8492dc6p-17, -0x1.32680c353adbep+5, 0x1.1e9805d70fa84p+649, -0x1.f93bbc1ed4c19p+594 },
+    { 0x1.635ca7a5d7004p+23, -0x1.36d790bf04c99p+3, 0x1.fb22d34dd5bc0p-229, 0x1.f899fe71e3e86p-284 },
+    { 0x1.b28cfb8f40b08p+7, 0x1.c1e2e8dc1ff0bp+4, 0x1.38fbff031a18ap+218, -0x1.667eb69fdb88ep+164 },
+    { 0x1.100a393b4b84bp-7, -0x1.e11b3a8473062p+6, 0x1.4fad0b714da90p+831, 0x1.913e4d767fcb7p+777 },
+    { 0x1.3b91fca95b10cp+24, -0x1.61e6848b5aa06p+3, 0x1.2da6c0cce2587p-269, 0x1.13e9177907e5bp-324 },
+    { 0x1.d634d4ecd6351p+7, -0x1.b505b979f5cb8p+4, 0x1.cba0d841335bcp-216, 0x1.6adb6be911240p-271 },
+    { 0x1.50ad7ff060353p+23, 0x1.8fd9b8d6fed4ap+4, 0x1.950e755e7d7c2p+584, 0x1.3fa833944b2cfp+527 },
+    { 0x1.1c9aaae4ea588p+28, -0x1.74ef0ebf6c9e3p+4, 0x1.bef551eafef8ap-657, 0x1.e45e0125a1d5cp-711 },
+    { 0x1.20f1823f33fbfp-11, -0x1.e684b9ac94ff9p+2, 0x1.3997cc815a0e6p+82, 0x1.82b32ab428b6cp+28 },
+    { 0x1.758c781540d7ep+26, 0x1.103cc54ac3907p+4, 0x1.94e734b03da26p+451, -0x1.716f075ad41d7p+397 },
+    { 0x1.188b96d075a69p-27, 0x1.4a79832ddadaap+4, 0x1.0972abc5dd010p-555, 0x1.f376788363879p-609 },
+    { 0x1.8d98e49b490bfp-25, -0x1.9955b2e2807d7p+4, 0x1.431d06593e450p+623, 0x1.927a80dc984c4p+569 },
+    { 0x1.9c0491f63a0dbp+21, 0x1.8f3c192024504p+3, 0x1.7a4fad9ee3740p+270, 0x1.6533f3bb3a62ep+216 },
+    { 0x1.46fac4cf9f075p-23, -0x1.825d6cfb2904ap+4, 0x1.d533744aeddd1p+546, 0x1.533799288f124p+492 },
+    { 0x1.1faf5f050a363p-11, -0x1.2fd4049db96fcp+6, 0x1.abb21c314d8b4p+822, -0x1.e7c914d6085cbp+768 },
+    { 0x1.2aec7b8607715p-11, -0x1.31ee0f62c0a94p+6, 0x1.26b95f5769721p+824, 0x1.a48820340be0cp+768 },
+    { 0x1.6e6baf25fb4d7p-12, 0x1.8752f21ca2be0p+3, 0x1.7ebb6cf0279fcp-141, 0x1.a8857bb1e0af9p-197 },
+    { 0x1.997556939a888p+21, -0x1.0a7fc90ed02e3p+4, 0x1.e9203c5b93b42p-362, -0x1.cf2b01a913318p-416 },
+    { 0x1.95843bd0c3b57p-17, -0x1.d84b4131a19fep+3, 0x1.149cc636b4e8fp+241, -0x1.59af1be3b4745p+187 },
+    { 0x1.8680c04bb9a63p+0, 0x1.28ac80e4968bcp+8, 0x1.a8cabccb8cfc2p+180, 0x1.6e6f10cbe5175p+125 },
+    { 0x1.fceafbb3d0a6fp+26, -0x1.d36fda408e484p+4, 0x1.5ed782b3e6a73p-789, 0x1.c1ef6f1f3418bp-843 },
+    { 0x1.722f4859d501cp-12, -0x1.3ef16dac4c5dbp+3, 0x1.3b384edfa31b7p+114, -0x1.5accac600f202p+58 },
+    { 0x1.fffffffc04ce7p-1, -0x1.f8187b57d72dap+35, 0x1.2e5ea10fc7a95p+45, 0x1.0f1b1833c8755p-10 },
+    { 0x1.000000037eda9p+0, 0x1.082464634151ap+35, 0x1.8b559f8f54ea7p+41, -0x1.5475b58a536eap-14 },
+    { 0x1.00000003fc6c2p+0, -0x1.eeba50e97868cp+34, 0x1.760855302b6a9p-45, 0x1.c48eec86ce99cp-99 },
+    { 0x1.ffffffff9fc15p-1, 0x1.b90a1c293c520p+35, 0x1.3308b7f164b45p-4, -0x1.ae6d0fb3f03bcp-58 },
+    { 0x1.fffffff9c1d3ap-1, 0x1.1a0d922b58e82p+36, 0x1.880a6704bb612p-80, 0x1.6e434a7dfec17p-134 },
+    { 0x1.00000003bc983p+0, -0x1.d9f95d4c50db1p+35, 0x1.1c55a2f15527ep-80, 0x1.0286164366c50p-136 },
+    { 0x1.fffffff97d336p-1, -0x1.069e0d6f46419p+36, 0x1.1041805458e6dp+77, -0x1.5979aa64e79c3p+23 },
+    { 0x1.00000000357b1p+0, 0x1.67bc922da69d6p+36, 0x1.b67a3ee114971p+6, -0x1.71028a2fada0ap-48 },
+    { 0x1.000000025b84cp+0, 0x1.741f95597295cp+34, 0x1.b64812be69919p+19, -0x1.725e8e3443b37p-36 },
+    { 0x1.fffffffa7ac6fp-1, -0x1.f09530629a200p+33, 0x1.5d6f2ad32ab1bp+15, -0x1.c56df499e387ep-39 },
+    { 0x1.ffffffff7790cp-1, -0x1.3d79383347db0p+36, 0x1.8ba7ea3ded8c7p+7, 0x1.07e99d98efeeap-48 },
+    { 0x1.fffffffdd9365p-1, -0x1.aadafcfb823b7p+35, 0x1.a08d762b58f46p+20, -0x1.e0fec87bb0284p-34 },
+    { -0x1.35bea77d20c80p+4, -0x1.d000000000000p+4, -0x1.04cf67c728a99p-124, 0x1.9b800cc8ebc60p-179 },
+    { -0x1.dade59bafa214p+2, 0x1.a800000000000p+5, -0x1.2f0ac5d36c711p+153, -0x1.1266c617351d1p+96 },
+    { -0x1.1dd545f25b05ap+0, 0x1.b000000000000p+4, -0x1.39d19978d903ap+4, -0x1.92486991e42b2p-51 },
+    { -0x1.904c194afeb1fp+2, -0x1.5800000000000p+5, -0x1.3447c1230264dp-114, -0x1.caf6205cb2904p-169 },
+    { -0x1.3e4ce56cc44fap+3, -0x1.2000000000000p+3, -0x1.205f9aa5b1518p-30, 0x1.fa4eb96f47de0p-84 },
+    { -0x1.173177830c165p+4, 0x1.2000000000000p+4, 0x1.30e4cb5a901f8p+74, -0x1.d879ee5fe8321p+20 },
+    { -0x1.b2254e97c951ep+0, 0x1.5000000000000p+5, 0x1.00fa1303eb0eep+32, -0x1.396fd2d2487abp-22 },
+    { -0x1.e29704d1d42fap+3, -0x1.4000000000000p+4, 0x1.a1df7cd27422fp-79, 0x1.46384c95e2fa2p-133 },
+    { -0x1.56472d26bcd8ap+3, -0x1.d000000000000p+5, 0x1.9ee1b68c1c28cp-199, -0x1.2e36bcd1064f9p-254 },
+    { -0x1.182b1ea270358p+2, 0x1.a000000000000p+4, 0x1.4e0c8e5be336fp+55, 0x1.75c9233f9ccedp-2 },
+    { -0x1.34def2f8c4fe3p+4, -0x1.0000000000000p+3, 0x1.c8128843ddb21p-35, 0x1.77f785207ecadp-90 },
+    { -0x1.1e251fe2ba741p+3, 0x1.a000000000000p+3, -0x1.1011f48d91c31p+41, 0x1.f9d4d6bd9fda9p-13 },
+    { 0x1.0000000000000p+1, 0x1.0000000000000p-1, 0x1.6a09e667f3bcdp+0, -0x1.bdd3413b26456p-54 },
+    { 0x1.4000000000000p+3, -0x1.4000000000000p+2, 0x1.4f8b588e368f1p-17, -0x1.ee78183f91e64p-71 },
+    { 0x1.0000000000000p-1, 0x1.0c80000000000p+10, 0x0.0000000000001p-1022, 0x0.0p+0 },
+    { 0x1.0000000000000p+1, 0x1.fffeb851eb852p+9, 0x1.fc769e9b9c396p+1023, 0x1.49ca8e06ea00bp+968 },
+    { 0x1.000001ad7f29bp+0, 0x1.a13b860000000p+32, 0x1.d941ae6e762d4p+1009, 0x1.e2a72d00bc0efp+954 },
+    { 0x1.8000000000000p+1, 0x1.0000000000000p-60, 0x1.0000000000000p+0, 0x1.193ea7aad030bp-60 },
+    { 0x0.0000000000001p-1022, 0x1.eb851eb851eb8p-6, 0x1.b795e38df3c65p-33, -0x1.50de689129f8fp-87 },
+    { 0x1.0000000000000p+0, 0x1.2aa4f4a405be2p+1003, 0x1.0000000000000p+0, 0x0.0p+0 },
+    { 0x1.0000000000000p+0, -0x1.1ccf385ebc8a0p+1023, 0x1.0000000000000p+0, 0x0.0p+0 },
+    { 0x1.0000000000000p+1, 0x1.1ccf385ebc8a0p+1023, __builtin_inf(), 0x0.0p+0 },
+    { 0x1.0000000000000p-1, -0x1.23a516e82d9bap+1013, __builtin_inf(), 0x0.0p+0 },
+    { 0x1.0000000000000p-1, 0x1.23a516e82d9bap+1013, 0x0.0p+0, 0x0.0p+0 },
+    { 0x1.0000000000001p+0, 0x1.7e43c8800759cp+996, __builtin_inf(), 0x0.0p+0 },
+    { -0x1.0000000000000p+0, 0x1.1ccf385ebc8a0p+1023, 0x1.0000000000000p+0, 0x0.0p+0 },
+    { -0x1.0000000000000p+1, 0x1.1ccf385ebc8a0p+1023, __builtin_inf(), 0x0.0p+0 },
+};
+
+static const MathCase sin_cases[] = {
+    { 0x1.51f36ea9659fcp+1, 0x0.0p+0, 0x1.ec25424986e5fp-2, 0x1.82102f33d906bp-57 },
+    { 0x1.ff1d700ff4238p+2, 0x0.0p+0, 0x1.fb8879d6c684dp-1, -0x1.9149ae2368480p-55 },
+    { 0x1.eefca9c372260p+2, 0x0.0p+0, 0x1.fc54634362eb6p-1, -0x1.0c3e6ebe4ecf6p-56 },
+    { -0x1.4d9c471285cbcp+1, 0x0.0p+0, -0x1.05274e1f7d374p-1, -0x1.6729b8342b3f1p-56 },
+    { -0x1.b3191d31d9120p-1, 0x0.0p+0, -0x1.80969b65a5be8p-1, 0x1.172e25a744644p-55 },
+    { -0x1.c299701feb4ccp+1, 0x0.0p+0, 0x1.7a99a56a13f6fp-2, 0x1.06a28c002f6d6p-58 },
+    { -0x1.2dcab331aa9eep+3, 0x0.0p+0, 0x1.975947ddb02aap-8, -0x1.80d18f91979a1p-63 },
+    { 0x1.3510f17d5268cp+3, 0x0.0p+0, -0x1.d9f46496f598bp-3, -0x1.c14dd33b1f8fap-57 },
+    { -0x1.aa36007890cacp+2, 0x0.0p+0, -0x1.785bf81d1f3f6p-2, -0x1.cec3f5d7f2c7fp-58 },
+    { 0x1.4d0cdd8d1d630p+0, 0x0.0p+0, 0x1.ed79b68634acep-1, 0x1.ad390015555f6p-55 },
+    { 0x1.755ad459f0460p+2, 0x0.0p+0, -0x1.bcf5776aab527p-2, -0x1.3a1833aea494ap-56 },
+    { -0x1.7e831a8f74868p+0, 0x0.0p+0, -0x1.fe7f91618f5afp-1, 0x1.b62847675a4e6p-55 },
+    { 0x1.09c58b3747108p+3, 0x0.0p+0, 0x1.ccb8771a8654bp-1, 0x1.f06b7c7407508p-56 },
+    { -0x1.11eeca7bf6620p+1, 0x0.0p+0, -0x1.af3ee1d227a01p-1, -0x1.effb05bf8c595p-56 },
+    { -0x1.2e05e9de58d34p+2, 0x0.0p+0, 0x1.fffd09ee11d5bp-1, 0x1.87d47130a4dd2p-58 },
+    { 0x1.a9d01d68ba6acp+1, 0x0.0p+0, -0x1.78dd8db67a23dp-3, 0x1.c32b8c76bbe8ep-57 },
+    { -0x1.e83ce142c9cacp+1, 0x0.0p+0, 0x1.3f0da86a1f69bp-1, -0x1.64b72210210adp-55 },
+    { 0x1.2d2d80999af64p+1, 0x0.0p+0, 0x1.6b36037b968c8p-1, 0x1.9c2ed06786a82p-55 },
+    { -0x1.0f744c43119acp+3, 0x0.0p+0, -0x1.9e05a81a42d8ep-1, -0x1.e1dad4b937602p-56 },
+    { -0x1.140675835c17fp+2, 0x0.0p+0, 0x1.d7af14795df3bp-1, 0x1.50ad0ac06f943p-55 },
+    { -0x1.67affdc67952cp+1, 0x0.0p+0, -0x1.4d4e58d9c2a2dp-2, 0x1.51de3af58e801p-56 },
+    { -0x1.19aec99a9d878p+0, 0x0.0p+0, -0x1.c85f8bd00249ap-1, -0x1.726fee89ee655p-55 },
+    { 0x1.33adb6f880360p+3, 0x0.0p+0, -0x1.8323cfcc53333p-3, -0x1.a5b5af2feb281p-58 },
+    { -0x1.b67002bc9a9a0p+0, 0x0.0p+0, -0x1.fadb86b3000f9p-1, -0x1.4d63eb10f3231p-56 },
+    { -0x1.79d731a53ae3ap+18, 0x0.0p+0, -0x1.5fd3ed8070de1p-2, -0x1.26743481b359ap-56 },
+    { 0x1.51805cac68338p+18, 0x0.0p+0, 0x1.cd9ab16eb39f3p-1, -0x1.eaa25769d218dp-57 },
+    { -0x1.133f06e16ba4ap+19, 0x0.0p+0, -0x1.d951b31f90ef6p-1, -0x1.bcf63613da201p-55 },
+    { -0x1.9dc204d23bb68p+16, 0x0.0p+0, -0x1.4b1adf532d600p-4, -0x1.aa27edda172abp-58 },
+    { -0x1.b1cd193c3c786p+18, 0x0.0p+0, 0x1.28992e250c42dp-1, -0x1.d27d506021f81p-59 },
+    { -0x1.33a221e14f558p+16, 0x0.0p+0, -0x1.44ffe240eab2ep-1, -0x1.4f0db44214ab6p-57 },
+    { 0x1.0ac3373fc3214p+19, 0x0.0p+0, 0x1.d9ab47c422fa1p-2, 0x1.7696e963a8b01p-60 },
+    { 0x1.5ef9fb273a770p+17, 0x0.0p+0, 0x1.84cc92350ab19p-1, 0x1.2512aed14c956p-55 },
+    { 0x1.9dd7db39e4acep+19, 0x0.0p+0, -0x1.194a31a03d8bdp-1, -0x1.a2ae8b8961161p-55 },
+    { 0x1.bc76c57e56200p+17, 0x0.0p+0, 0x1.d0ad23a4bff39p-1, -0x1.7d8369eacc1d1p-55 },
+    { -0x1.5208396f70e8ep+19, 0x0.0p+0, -0x1.ab385c942849ap-1, -0x1.47239c0787d1dp-55 },
+    { 0x1.09c899515a0e8p+18, 0x0.0p+0, -0x1.e47b8b7becb30p-5, -0x1.e8e107369b094p-59 },
+    { 0x1.3a103958cdf67p+736, 0x0.0p+0, -0x1.df3556e7d7a2fp-2, -0x1.a5d2c5c2e7e86p-57 },
+    { 0x1.902b95e845823p+562, 0x0.0p+0, 0x1.4fe9cb7da9533p-1, 0x1.376661173dab4p-58 },
+    { 0x1.3db64018a0e29p+356, 0x0.0p+0, -0x1.b88ed5e3d191bp-5, 0x1.c2f787d024da6p-61 },
+    { 0x1.a1381181af08ep+714, 0x0.0p+0, 0x1.ae1db7934a762p-2, 0x1.48f914ea26d34p-58 },
+    { -0x1.a9e47d9267583p+254, 0x0.0p+0, -0x1.b4564da38da83p-1, 0x1.afdaa62a7f9d0p-55 },
+    { 0x1.0be878e1e5c45p+872, 0x0.0p+0, 0x1.8e9f3d8e007a7p-1, -0x1.fe995d18dd4c0p-56 },
+    { -0x1.816e7d5d0d424p+931, 0x0.0p+0, -0x1.34286a328dca2p-4, 0x1.928ae60329813p-58 },
+    { -0x1.9e0b4c8502e6ep+544, 0x0.0p+0, 0x1.ed15051c84e58p-2, 0x1.4a487a99b36b1p-56 },
+    { 0x1.4a3343119e338p+407, 0x0.0p+0, -0x1.b5cae146606c4p-1, 0x1.98615491c9ee0p-61 },
+    { 0x1.69a97daf7171fp+766, 0x0.0p+0, -0x1.af29e7e572aafp-1, 0x1.87eb4cb165786p-56 },
+    { -0x1.4a8afb62bdc72p+966, 0x0.0p+0, -0x1.f77204683bdbfp-1, -0x1.74d82e6e02f03p-55 },
+    { -0x1.8399eb4ba1204p+211, 0x0.0p+0, -0x1.ff8a5d563594ep-2, -0x1.ecc5e786a0c19p-57 },
+    { 0x1.921fb54442d18p+0, 0x0.0p+0, 0x1.0000000000000p+0, -0x1.377ce858a5d48p-109 },
+    { 0x1.921fb54442d18p+1, 0x0.0p+0, 0x1.1a62633145c07p-53, -0x1.f1976b7ed8fbdp-109 },
+    { 0x1.0f0cf064dd592p+73, 0x0.0p+0, -0x1.b453ab76bf397p-1, -0x1.f453790772648p-58 },
+    { 0x1.6ac5b262ca1ffp+849, 0x0.0p+0, 0x1.0000000000000p+0, -0x1.2b089ea1e692bp-123 },
+    { 0x1.921fb54442d18p+1, 0x0.0p+0, 0x1.1a62633145c07p-53, -0x1.f1976b7ed8fbdp-109 },
+    { 0x1.0000000000000p-30, 0x0.0p+0, 0x1.0000000000000p-30, -0x1.5555555555555p-93 },
+    { 0x1.6300000000000p+8, 0x0.0p+0, -0x1.f9bd0307d1de3p-16, 0x1.894874d2528d2p-70 },
+    { 0x1.921fb00000000p+20, 0x0.0p+0, -0x1.4b02e5be91e9ep-2, -0x1.94c88681ed4b6p-57 },
+};
+
+static const MathCase cos_cases[] = {
+    { 0x1.51f36ea9659fcp+1, 0x0.0p+0, -0x1.c0fd7d207e651p-1, 0x1.35d1e2ccf34a5p-58 },
+    { 0x1.ff1d700ff4238p+2, 0x0.0p+0, -0x1.0df0046f0ffa8p-3, 0x1.c7ef06d0c47b8p-57 },
+    { 0x1.eefca9c372260p+2, 0x0.0p+0, 0x1.e991dc5333100p-4, 0x1.525664501b8acp-58 },
+    { -0x1.4d9c471285cbcp+1, 0x0.0p+0, -0x1.b863b03f2873bp-1, -0x1.d29c1fe42d81fp-55 },
+    { -0x1.b3191d31d9120p-1, 0x0.0p+0, 0x1.51fce834a53e0p-1, 0x1.5d37f3dac08b1p-55 },
+    { -0x1.c299701feb4ccp+1, 0x0.0p+0, -0x1.dbb84efda4be8p-1, 0x1.e932957ee3a81p-56 },
+    { -0x1.2dcab331aa9eep+3, 0x0.0p+0, -0x1.fffd77d1640f1p-1, 0x1.f4c122257025fp-57 },
+    { 0x1.3510f17d5268cp+3, 0x0.0p+0, -0x1.f219cff50a9c5p-1, -0x1.06c6ab525021ep-56 },
+    { -0x1.aa36007890cacp+2, 0x0.0p+0, 0x1.dc2a0eb030b34p-1, -0x1.5568e8d01f49fp-57 },
+    { 0x1.4d0cdd8d1d630p+0, 0x0.0p+0, 0x1.10f441a16b424p-2, 0x1.ae5da82746e21p-56 },
+    { 0x1.755ad459f0460p+2, 0x0.0p+0, 0x1.cd22f4036c235p-1, 0x1.8782e588ac030p-64 },
+    { -0x1.7e831a8f74868p+0, 0x0.0p+0, 0x1.397b1e59d6eb0p-4, -0x1.f0aeb25dccb33p-59 },
+    { 0x1.09c58b3747108p+3, 0x0.0p+0, -0x1.beaddabb045adp-2, 0x1.8e239e0ba888cp-57 },
+    { -0x1.11eeca7bf6620p+1, 0x0.0p+0, -0x1.13fdc6905a696p-1, 0x1.8c18197aafdc4p-60 },
+    { -0x1.2e05e9de58d34p+2, 0x0.0p+0, 0x1.b886d32fffaadp-8, 0x1.c5da57e4217f4p-62 },
+    { 0x1.a9d01d68ba6acp+1, 0x0.0p+0, -0x1.f741b5380252fp-1, 0x1.1804201fd9733p-59 },
+    { -0x1.e83ce142c9cacp+1, 0x0.0p+0, -0x1.906f9b2a9436bp-1, 0x1.b76a422e55c29p-60 },
+    { 0x1.2d2d80999af64p+1, 0x0.0p+0, -0x1.68dccfbd46093p-1, 0x1.52f21f2157ca9p-57 },
+    { -0x1.0f744c43119acp+3, 0x0.0p+0, -0x1.2d36b63572e0fp-1, 0x1.6b1fc2c5eb439p-55 },
+    { -0x1.140675835c17fp+2, 0x0.0p+0, -0x1.8e49ad2ec3df5p-2, -0x1.35320ce6fdad1p-56 },
+    { -0x1.67affdc67952cp+1, 0x0.0p+0, -0x1.e41e5949b87dbp-1, -0x1.9e89c24938455p-57 },
+    { -0x1.19aec99a9d878p+0, 0x0.0p+0, 0x1.d02ff72f26321p-2, 0x1.1e4f839ded9e1p-57 },
+    { 0x1.33adb6f880360p+3, 0x0.0p+0, -0x1.f6c4dd4c7e63fp-1, 0x1.dd06a73068b8fp-55 },
+    { -0x1.b67002bc9a9a0p+0, 0x0.0p+0, -0x1.218943a0c209cp-3, -0x1.6d7bc112837bdp-57 },
+    { -0x1.79d731a53ae3ap+18, 0x0.0p+0, -0x1.e0d4b1a0e9f56p-1, 0x1.77fd1dd15835fp-55 },
+    { 0x1.51805cac68338p+18, 0x0.0p+0, 0x1.bb03c0fbc083dp-2, 0x1.13e3c9edd0b1ap-58 },
+    { -0x1.133f06e16ba4ap+19, 0x0.0p+0, -0x1.86737384f130bp-2, -0x1.d23a1448d2c41p-56 },
+    { -0x1.9dc204d23bb68p+16, 0x0.0p+0, 0x1.fe530dd10037fp-1, -0x1.f7a3d65a0c3f9p-55 },
+    { -0x1.b1cd193c3c786p+18, 0x0.0p+0, -0x1.a157441bdd00cp-1, -0x1.87a0e8652facap-56 },
+    { -0x1.33a221e14f558p+16, 0x0.0p+0, 0x1.8ba00cc9f04e2p-1, -0x1.46407e2912bffp-55 },
+    { 0x1.0ac3373fc3214p+19, 0x0.0p+0, 0x1.c5ee59c028a86p-1, 0x1.a3375e2c148f8p-56 },
+    { 0x1.5ef9fb273a770p+17, 0x0.0p+0, 0x1.4d22af8610c16p-1, 0x1.612908306bfb2p-56 },
+    { 0x1.9dd7db39e4acep+19, 0x0.0p+0, 0x1.abcef41583153p-1, 0x1.8e4eba929dcc8p-56 },
+    { 0x1.bc76c57e56200p+17, 0x0.0p+0, 0x1.adf9f14de3b75p-2, -0x1.044e1a7173d5fp-58 },
+    { -0x1.5208396f70e8ep+19, 0x0.0p+0, -0x1.1a2eb4c21deafp-1, 0x1.662107d25ee8dp-56 },
+    { 0x1.09c899515a0e8p+18, 0x0.0p+0, 0x1.ff1a93c087301p-1, -0x1.bf3fbc09f4f6cp-55 },
+    { 0x1.3a103958cdf67p+736, 0x0.0p+0, 0x1.c479a8f2e2105p-1, 0x1.b6d8ff54991fep-55 },
+    { 0x1.902b95e845823p+562, 0x0.0p+0, -0x1.8266d66a9d1ddp-1, 0x1.445ac79bf3f42p-59 },
+    { 0x1.3db64018a0e29p+356, 0x0.0p+0, 0x1.ff425209aebe5p-1, 0x1.80df49180d89cp-55 },
+    { 0x1.a1381181af08ep+714, 0x0.0p+0, 0x1.d0a4dca1f4faep-1, 0x1.f4be129c5a507p-57 },
+    { -0x1.a9e47d9267583p+254, 0x0.0p+0, -0x1.0bde84cf1db0ap-1, -0x1.f969ae91a5d76p-55 },
+    { 0x1.0be878e1e5c45p+872, 0x0.0p+0, -0x1.415118aacbb53p-1, -0x1.855eceea6b526p-58 },
+    { -0x1.816e7d5d0d424p+931, 0x0.0p+0, -0x1.fe8c87f8cdb65p-1, -0x1.d16692b9aef92p-55 },
+    { -0x1.9e0b4c8502e6ep+544, 0x0.0p+0, 0x1.c0bbb4b8048cep-1, 0x1.e09e52b0c0b89p-58 },
+    { 0x1.4a3343119e338p+407, 0x0.0p+0, -0x1.097be40fb25aep-1, 0x1.b7e2fd1f724cap-57 },
+    { 0x1.69a97daf7171fp+766, 0x0.0p+0, 0x1.141e8a821c3e7p-1, 0x1.deacd8189cc6bp-55 },
+    { -0x1.4a8afb62bdc72p+966, 0x0.0p+0, -0x1.74cf997b2820ap-3, -0x1.d4ad4a01508d4p-57 },
+    { -0x1.8399eb4ba1204p+211, 0x0.0p+0, -0x1.bb899ead16dfep-1, -0x1.f8fc8cfe2706fp-55 },
+    { 0x1.921fb54442d18p+0, 0x0.0p+0, 0x1.1a62633145c07p-54, -0x1.f1976b7ed8fbcp-110 },
+    { 0x1.921fb54442d18p+1, 0x0.0p+0, -0x1.0000000000000p+0, 0x1.377ce858a5d48p-107 },
+    { 0x1.0f0cf064dd592p+73, 0x0.0p+0, 0x1.0be2cef01c8f4p-1, -0x1.b2d1bc8018c4fp-55 },
+    { 0x1.6ac5b262ca1ffp+849, 0x0.0p+0, -0x1.14ae72e6ba22fp-61, 0x1.73eef1477d90ep-118 },
+    { 0x1.921fb54442d18p+1, 0x0.0p+0, -0x1.0000000000000p+0, 0x1.377ce858a5d48p-107 },
+    { 0x1.0000000000000p-30, 0x0.0p+0, 0x1.0000000000000p+0, -0x1.0000000000000p-61 },
+    { 0x1.6300000000000p+8, 0x0.0p+0, -0x1.fffffffc18e4cp-1, 0x1.862265016699cp-57 },
+    { 0x1.921fb00000000p+20, 0x0.0p+0, 0x1.e4831257a62dap-1, 0x1.1e3bd71a839c9p-55 },
+};
+
+static const MathCase tanh_cases[] = {
+    { 0x1.e8320fd37bec8p-4, 0x0.0p+0, 0x1.e5e599242a94dp-4, -0x1.f7db00e6e5975p-59 },
+    { 0x1.da8e6397463d8p-3, 0x0.0p+0, 0x1.d23dc834d227bp-3, 0x1.62860f03d9485p-57 },
+    { -0x1.b3d908ce1b3d2p-3, 0x0.0p+0, -0x1.ad6287fa36e41p-3, 0x1.9e3c49e99074cp-57 },
+    { 0x1.556b3b018b61cp-2, 0x0.0p+0, 0x1.494e44a774faap-2, -0x1.832c16ee6fcfdp-58 },
+    { -0x1.8468085e38600p-7, 0x0.0p+0, -0x1.84636052222dfp-7, -0x1.cd93612e5ad15p-65 },
+    { -0x1.833b2f8a1d48cp-3, 0x0.0p+0, -0x1.7eae8302429e6p-3, -0x1.98c38b471feaap-57 },
+    { 0x1.e897b3b30297cp-2, 0x0.0p+0, 0x1.c69b22d3ac63bp-2, 0x1.47819d36f796dp-56 },
+    { 0x1.1f01ab8a19b9cp-3, 0x0.0p+0, 0x1.1d246e4fe3de2p-3, 0x1.c8c3c4feab4eap-57 },
+    { 0x1.9a05111106c30p-4, 0x0.0p+0, 0x1.98a7dd7ba814dp-4, -0x1.64a74d023382ep-59 },
+    { -0x1.67b6092baeae7p-2, 0x0.0p+0, -0x1.599c5c8cbd44fp-2, 0x1.b91b7ceadab6bp-56 },
+    { 0x1.a298876949026p-2, 0x0.0p+0, 0x1.8cbd35e2414bap-2, -0x1.fd07dd5887b46p-56 },
+    { 0x1.0f92c6512cf76p-1, 0x0.0p+0, 0x1.f15b381e480c2p-2, 0x1.7bfd5a5c83f63p-58 },
+    { 0x1.480c171f634b4p-2, 0x0.0p+0, 0x1.3d4460a80cb68p-2, -0x1.a27c1f823f6c1p-59 },
+    { -0x1.d1913c2ec8178p-5, 0x0.0p+0, -0x1.d11115418430ep-5, 0x1.52344527ab93dp-59 },
+    { 0x1.fe2007ca0ffa0p-5, 0x0.0p+0, 0x1.fd777e41f2129p-5, -0x1.68337aad04350p-59 },
+    { 0x1.fac3a88e145fcp-2, 0x0.0p+0, 0x1.d514a4e73187fp-2, -0x1.1a8cba8af10f7p-58 },
+    { -0x1.82e23a3d01c4ap-2, 0x0.0p+0, -0x1.7178040906603p-2, 0x1.c2c356acf9e1fp-56 },
+    { -0x1.a1c18291e09dap-2, 0x0.0p+0, -0x1.8c0668f8b0921p-2, -0x1.c49d02820f01ep-56 },
+    { 0x1.d68a028802a38p-4, 0x0.0p+0, 0x1.d47ae6e208034p-4, 0x1.d141c25ab2874p-59 },
+    { -0x1.6c82bf2b0f5b0p-3, 0x0.0p+0, -0x1.68b5b9debacbep-3, 0x1.e127efbba1548p-58 },
+    { 0x1.12cb09ffbece8p-4, 0x0.0p+0, 0x1.1261b05b206c2p-4, 0x1.64f84f321c14dp-59 },
+    { 0x1.fad01c51ac6f8p-3, 0x0.0p+0, 0x1.f0b6e86791438p-3, -0x1.9770f344084e6p-57 },
+    { -0x1.b2c9b9ec4d068p-2, 0x0.0p+0, -0x1.9a6a6dfb6902ap-2, 0x1.d98c12a8915a9p-57 },
+    { 0x1.6ee9243527e10p-4, 0x0.0p+0, 0x1.6deeb5d66a9d6p-4, -0x1.130601f658d07p-59 },
+    { 0x1.193c595397310p+1, 0x0.0p+0, 0x1.f382ad6d91b90p-1, -0x1.9f2073704b00cp-56 },
+    { 0x1.7801610d05aeep+3, 0x0.0p+0, 0x1.fffffffeee59fp-1, 0x1.e69d5aec38adep-56 },
+    { 0x1.a5c89e33e94c8p+3, 0x0.0p+0, 0x1.fffffffff058bp-1, -0x1.0238bc9b5a40fp-55 },
+    { 0x1.8d2bf30733900p+0, 0x0.0p+0, 0x1.d3fb0c75a07c1p-1, -0x1.7b23f935aa940p-55 },
+    { 0x1.89c46721099d4p+3, 0x0.0p+0, 0x1.ffffffffa5d3bp-1, -0x1.a81f9faab95f6p-56 },
+    { -0x1.e4b31b6fd8580p-3, 0x0.0p+0, -0x1.dbd9200eac8f8p-3, -0x1.e0ae1f4245d8dp-57 },
+    { -0x1.de97608ea9c10p+2, 0x0.0p+0, -0x1.ffffea8c1fc8ap-1, -0x1.0618cd678ee13p-56 },
+    { 0x1.0376570c83264p+4, 0x0.0p+0, 0x1.fffffffffff6cp-1, 0x1.cf11d1d10a587p-61 },
+    { -0x1.26f6f8e127185p+4, 0x0.0p+0, -0x1.ffffffffffffep-1, -0x1.007739c772e1cp-55 },
+    { -0x1.286ade38c9aacp+4, 0x0.0p+0, -0x1.fffffffffffffp-1, 0x1.d609c305e8202p-55 },
+    { 0x1.5dcf204df52a4p+2, 0x0.0p+0, 0x1.fffb4fc329ecbp-1, -0x1.20aa07a3d9648p-57 },
+    { 0x1.e387914eaacacp+2, 0x0.0p+0, 0x1.ffffed9d79a54p-1, 0x1.1d7a82ce765a8p-56 },
+    { 0x1.0b8c2bfd9084ap+4, 0x0.0p+0, 0x1.fffffffffffcap-1, 0x1.11e1b2934b6c1p-56 },
+    { 0x1.56ec9cebb0a04p+2, 0x0.0p+0, 0x1.fffa2fa747521p-1, -0x1.f14afb2ab8c8fp-55 },
+    { 0x1.2e310dfc0ae48p+1, 0x0.0p+0, 0x1.f6f79769f3502p-1, 0x1.c9f1a075e8f77p-56 },
+    { 0x1.3adb27e6f5eb4p+4, 0x0.0p+0, 0x1.0000000000000p+0, -0x1.2a235f1463b8cp-56 },
+    { -0x1.33b6a76ea1e27p+4, 0x0.0p+0, -0x1.0000000000000p+0, 0x1.6c07602feb742p-55 },
+    { 0x1.2a0f6303cf76cp+3, 0x0.0p+0, 0x1.ffffff747976ep-1, 0x1.9bcca9a07a844p-57 },
+    { -0x1.91bd4fd98bba4p+3, 0x0.0p+0, -0x1.ffffffffc9366p-1, -0x1.c89bddd19320fp-56 },
+    { -0x1.484e963f270b8p+1, 0x0.0p+0, -0x1.f9f9d1e2fd069p-1, -0x1.6adbb74983954p-55 },
+    { -0x1.30013e172d5bep+2, 0x0.0p+0, -0x1.ffec61ea9b70fp-1, -0x1.8c7e067337ce0p-55 },
+    { 0x1.0116a5dc7bda0p-1, 0x0.0p+0, 0x1.daeb17e06cb7fp-2, 0x1.e015959ef6486p-56 },
+    { -0x1.49116d182d60cp+3, 0x0.0p+0, -0x1.ffffffebe8d18p-1, -0x1.03681ffc5d97cp-55 },
+    { 0x1.8438da9753480p+0, 0x0.0p+0, 0x1.d0f0725f5bd3cp-1, 0x1.b6b89a975ac46p-55 },
+    { 0x1.19984a0e410b6p-1, 0x0.0p+0, 0x1.004333e7f9bbbp-1, 0x1.3ccc9ff992c21p-55 },
+    { 0x1.199999999999ap-1, 0x0.0p+0, 0x1.00442f6419203p-1, -0x1.a6f0615dc969bp-56 },
+    { 0x1.199ae924f227dp-1, 0x0.0p+0, 0x1.00452adf9388cp-1, 0x1.107735e6a9209p-58 },
+    { 0x1.56e1fc2f8f359p-997, 0x0.0p+0, 0x1.56e1fc2f8f359p-997, -0x0.0p+0 },
+    { 0x1.0000000000000p-28, 0x0.0p+0, 0x1.0000000000000p-28, -0x1.5555555555555p-86 },
+    { 0x1.3000000000000p+4, 0x0.0p+0, 0x1.fffffffffffffp-1, 0x1.bceea52a399fap-55 },
+    { -0x1.3333333333333p-2, 0x0.0p+0, -0x1.2a4dda7d914fap-2, 0x1.dcaef7d34268ap-58 },
+    { 0x1.0000000000000p+0, 0x0.0p+0, 0x1.85efab514f394p-1, 0x1.5618caf8a4f11p-55 },
+};
+
+static const MathCase sqrt_cases[] = {
+    { 0x1.05a891f39f5c1p+627, 0x0.0p+0, 0x1.6e04986b0f9b6p+313, 0x1.2a840c3970754p+259 },
+    { 0x1.ae1ad6c1e02d9p+357, 0x0.0p+0, 0x1.d544f0f9ae5d3p+178, -0x1.e2e9df2b4428dp+123 },
+    { 0x1.3deac7a0e13ccp-139, 0x0.0p+0, 0x1.9373b9c9c97b0p-70, -0x1.b526f2e0858d5p-125 },
+    { 0x1.ce4597e7f7246p-442, 0x0.0p+0, 0x1.580214cbc54f3p-221, 0x1.1858db0b80b39p-279 },
+    { 0x1.b2be4e1d62aa3p-61, 0x0.0p+0, 0x1.d7cb00574c552p-31, -0x1.27f4d7440d204p-86 },
+    { 0x1.7df1d154bd0dfp-100, 0x0.0p+0, 0x1.38b1c755200e0p-50, 0x1.bd5a951b40564p-105 },
+    { 0x1.344a6cad53f2fp+779, 0x0.0p+0, 0x1.8d4c037a10907p+389, -0x1.3e94cafb76a54p+334 },
+    { 0x1.04f20259e557cp+198, 0x0.0p+0, 0x1.0275fa099eed0p+99, -0x1.ae960e737a129p+43 },
+    { 0x1.012524f697ecdp+454, 0x0.0p+0, 0x1.0092689d8cbbfp+227, 0x1.94013995e822ep+172 },
+    { 0x1.198a03b6a3951p-684, 0x0.0p+0, 0x1.0c774e61c14a5p-342, 0x1.b44a8cefa9bcdp-396 },
+    { 0x1.e3bc74264c7e4p-187, 0x0.0p+0, 0x1.f1aadf191eb30p-94, -0x1.2313b9d6c9ccfp-148 },
+    { 0x1.49263bdd7d5f3p+118, 0x0.0p+0, 0x1.224792795781cp+59, 0x1.82ae13bca12f0p+5 },
+    { 0x1.45080aaf601e0p+599, 0x0.0p+0, 0x1.97f0f75e59696p+299, 0x1.df324b997539ep+245 },
+    { 0x1.36dd56edd32afp-390, 0x0.0p+0, 0x1.1a1a059360bb2p-195, -0x1.b772fd761fb95p-249 },
+    { 0x1.44bc87d5fafa0p-278, 0x0.0p+0, 0x1.2053be6b1710ep-139, -0x1.c5fe82672f2dap-193 },
+    { 0x1.c3ac3d4dfb080p-24, 0x0.0p+0, 0x1.540aa174515cbp-12, -0x1.aff69012f092fp-66 },
+    { 0x1.6d97fe6986cebp-447, 0x0.0p+0, 0x1.b0a5cc47bab57p-224, -0x1.008d30c729268p-278 },
+    { 0x1.4e063afce2da2p+587, 0x0.0p+0, 0x1.9d8bd3dde97e3p+293, -0x1.9986b12f7669dp+237 },
+    { 0x1.0af2ce2b6152fp+140, 0x0.0p+0, 0x1.056abb2e0513ep+70, -0x1.d2ea51c53a796p+16 },
+    { 0x1.3380095ae3783p-85, 0x0.0p+0, 0x1.8cc98532368ebp-43, 0x1.0a4caa6762022p-97 },
+    { 0x1.c9002e8ad3b2ap+556, 0x0.0p+0, 0x1.560a8c04565f8p+278, -0x1.7f7134590b173p+223 },
+    { 0x1.df253834aaa9dp-507, 0x0.0p+0, 0x1.ef4ce3e56caa4p-254, 0x1.6f081fa6df73cp-309 },
+    { 0x1.0356c341bea0cp-680, 0x0.0p+0, 0x1.01a9ff3039111p-340, 0x1.503e597cb5c9cp-394 },
+    { 0x1.b2c0fdf9fe41ap+306, 0x0.0p+0, 0x1.4d9cae8ab022ap+153, 0x1.6fe808a5c34c0p+99 },
+    { 0x1.a86be2336bf5ep+925, 0x0.0p+0, 0x1.d22894ddef84dp+462, 0x1.120a3881200f0p+406 },
+    { 0x1.769819860d767p+40, 0x0.0p+0, 0x1.35abc3a2d7931p+20, -0x1.8f2e54908c018p-34 },
+    { 0x1.c217106501019p+21, 0x0.0p+0, 0x1.e00c4cda52cafp+10, -0x1.444a4e28b697fp-47 },
+    { 0x1.796b13c8466dap-919, 0x0.0p+0, 0x1.b796afc775eaap-460, 0x1.49699ec970d32p-514 },
+    { 0x1.2b61a6488a22bp+357, 0x0.0p+0, 0x1.87839cc6cb3b1p+178, 0x1.af71b4282d477p+124 },
+    { 0x1.21be363ef2adbp+71, 0x0.0p+0, 0x1.8129069f2d482p+35, 0x1.ca5f5ad44a04ep-19 },
+    { 0x1.3a88bacf39099p-449, 0x0.0p+0, 0x1.914cb9f974769p-225, 0x1.0aec3ab981b1dp-279 },
+    { 0x1.2ebd6f7c53b3cp+920, 0x0.0p+0, 0x1.16640b3abaa03p+460, -0x1.b6ad4577bd69dp+406 },
+    { 0x1.06f5ce8b40d10p+603, 0x0.0p+0, 0x1.6eed60ddbae7dp+301, 0x1.079e67b22f6dbp+247 },
+    { 0x1.99b40c12efd9dp+822, 0x0.0p+0, 0x1.43dbaa3d1e25ap+411, 0x1.81a3f0e0652b5p+357 },
+    { 0x1.41eb97f204dfap+368, 0x0.0p+0, 0x1.1f12fe7483d26p+184, -0x1.a9135f8d44b11p+129 },
+    { 0x1.9b72943202ec1p-299, 0x0.0p+0, 0x1.cafa776e43d8ep-150, -0x1.a630a2a8fb7c2p-204 },
+    { 0x1.87a5cc5ba39b9p-587, 0x0.0p+0, 0x1.bfcc71cf3ba8dp-294, -0x1.8f9ce1cedfc1cp-348 },
+    { 0x1.624f89ec77bdfp-295, 0x0.0p+0, 0x1.a9eb49f79540bp-148, -0x1.2dfb51581a2b5p-202 },
+    { 0x1.105dc1421b46ap+39, 0x0.0p+0, 0x1.756e9c0b9411dp+19, -0x1.8380f7809f257p-37 },
+    { 0x1.35c47410f6619p+949, 0x0.0p+0, 0x1.8e3f4ea034064p+474, 0x1.7196ca026fac5p+420 },
+    { 0x0.000001779de5fp-1022, 0x0.0p+0, 0x1.3617e71ab29c6p-523, -0x1.6b6e6851dabc6p-580 },
+    { 0x0.00000003f69cep-1022, 0x0.0p+0, 0x1.fda5d5e57d18fp-527, -0x1.c8b7d7a31265dp-581 },
+    { 0x1.d3361f9eab0fcp+490, 0x0.0p+0, 0x1.59d757bc8adeep+245, 0x1.e8eb1f534cb02p+191 },
+    { 0x1.6ead44a63bb1fp+104, 0x0.0p+0, 0x1.326183f9b4e27p+52, 0x1.3ec4786df9363p-3 },
+    { 0x1.ad3392f02af3bp-225, 0x0.0p+0, 0x1.d4c6b69989579p-113, 0x1.d252cffa6fcb1p-167 },
+    { 0x1.0be5384c720cap-836, 0x0.0p+0, 0x1.05e152615d5f2p-418, 0x1.50b9adcd644c2p-474 },
+    { 0x1.c1b2402359c67p-35, 0x0.0p+0, 0x1.dfd686d0b59c1p-18, 0x1.43314ff00cac0p-72 },
+    { 0x1.099bbcc624d77p+218, 0x0.0p+0, 0x1.04c28a4ee1c11p+109, -0x1.2e11ab67d0323p+54 },
+    { 0x1.0000000000000p+1, 0x0.0p+0, 0x1.6a09e667f3bcdp+0, -0x1.bdd3413b26456p-54 },
+    { 0x0.0000000000001p-1022, 0x0.0p+0, 0x1.0000000000000p-537, -0x1.af921b4105164p-739 },
+    { 0x1.fffffffffffffp+1023, 0x0.0p+0, 0x1.fffffffffffffp+511, 0x1.0000000000000p+458 },
+};
+
+static const MathCase expf_cases[] = {
+    { 0x1.3ffc6a0000000p+4, 0x0.0p+0, 0x1.ce48e183e625ep+28, -0x1.7306e3a7187d9p-27 },
+    { 0x1.ae791a0000000p+5, 0x0.0p+0, 0x1.8c38fc081b51dp+77, -0x1.999cab617e583p+23 },
+    { 0x1.1bec160000000p+6, 0x0.0p+0, 0x1.5290c7693e280p+102, 0x1.ebbc85387d59dp+47 },
+    { -0x1.179e940000000p+5, 0x0.0p+0, 0x1.7d2c3f6d3ecdfp-51, 0x1.e80a522da907ep-106 },
+    { 0x1.6451940000000p+3, 0x0.0p+0, 0x1.0bad4c3d7abc3p+16, -0x1.d9157f33efecap-39 },
+    { 0x1.5fb7780000000p+6, 0x0.0p+0, 0x1.cf08cfd35f015p+126, 0x1.b3644f42ad281p+70 },
+    { -0x1.a678940000000p+3, 0x0.0p+0, 0x1.efaa76517c595p-20, 0x1.8a343d6f5781cp-74 },
+    { -0x1.45a0de0000000p+6, 0x0.0p+0, 0x1.77f2677d79de1p-118, 0x1.3347f87644df1p-172 },
+    { 0x1.491c600000000p+6, 0x0.0p+0, 0x1.a058f1b3789acp+118, -0x1.45aa05f29fd25p+64 },
+    { -0x1.328f780000000p+6, 0x0.0p+0, 0x1.594c546f607afp-111, -0x1.6a6bec297ba7fp-165 },
+    { 0x1.4f6e420000000p+5, 0x0.0p+0, 0x1.67ab325c7ee22p+60, -0x1.7f5935a09add2p+6 },
+    { -0x1.668d660000000p+3, 0x0.0p+0, 0x1.c8a69a27f4573p-17, 0x1.9fb5ae1353760p-71 },
+    { 0x1.9871ee0000000p+4, 0x0.0p+0, 0x1.c6b9b678a881bp+36, 0x1.3be213563fcbcp-21 },
+    { -0x1.6806c80000000p+5, 0x0.0p+0, 0x1.0d76a952586f7p-65, 0x1.e422fb1699444p-122 },
+    { 0x1.3f447e0000000p+2, 0x0.0p+0, 0x1.2572d9ad06cd5p+7, -0x1.f707b21f52e29p-47 },
+    { -0x1.75686a0000000p+5, 0x0.0p+0, 0x1.94b906e88c849p-68, -0x1.d451500fc2dc0p-122 },
+    { -0x1.d7920a0000000p+5, 0x0.0p+0, 0x1.f1773f854ee1fp-86, 0x1.176f949c202c6p-141 },
+    { 0x1.fa33220000000p+4, 0x0.0p+0, 0x1.8fd452825011dp+45, 0x1.ad53f368a0a18p-10 },
+    { -0x1.293f1c0000000p+6, 0x0.0p+0, 0x1.baf196f6360adp-108, -0x1.7ef4fb678690bp-162 },
+    { -0x1.84544a0000000p+6, 0x0.0p+0, 0x1.eb15a6c885080p-141, -0x1.8669f255d363ep-195 },
+    { -0x1.7b76f20000000p-1, 0x0.0p+0, 0x1.e801d124edd7cp-2, 0x1.d921638a92fd0p-58 },
+    { -0x1.3933e60000000p+6, 0x0.0p+0, 0x1.0677a5bcf8295p-113, 0x1.5aec2a30bfba5p-168 },
+    { -0x1.51f9ac0000000p+5, 0x0.0p+0, 0x1.0922fbaae4973p-61, -0x1.3c0e4b7b2c146p-118 },
+    { -0x1.8cf3fc0000000p+6, 0x0.0p+0, 0x1.c6e9a45dd8db8p-144, -0x1.ea17818db44d1p-198 },
+};
+
+static const MathCase logf_cases[] = {
+    { 0x1.811db80000000p-39, 0x0.0p+0, -0x1.a9fd6e31d6275p+4, -0x1.2f017dd6ba206p-53 },
+    { 0x1.38054c0000000p-67, 0x0.0p+0, -0x1.71f199c06f43cp+5, 0x1.8a7fac804303cp-53 },
+    { 0x1.26e1ac0000000p-2, 0x0.0p+0, -0x1.3eb1a4aaa4e65p+0, -0x1.0e879e7b83a85p-54 },
+    { 0x1.cb75bc0000000p+108, 0x0.0p+0, 0x1.2dc771b6fc7d6p+6, -0x1.ead5b048b1c15p-48 },
+    { 0x1.bc00000000000p-138, 0x0.0p+0, -0x1.7c6a26d7cf6e3p+6, -0x1.01bf7680a1899p-51 },
+    { 0x1.03e16a0000000p+51, 0x0.0p+0, 0x1.1aeca5e12bbe5p+5, -0x1.af9bf094dae8fp-49 },
+    { 0x1.ef8b0a0000000p+31, 0x0.0p+0, 0x1.625e5eb26966dp+4, 0x1.83aaf64f7086ap-50 },
+    { 0x1.29b7700000000p+17, 0x0.0p+0, 0x1.7de72646a42e2p+3, -0x1.0c547968ecc4bp-51 },
+    { 0x1.c672fa0000000p+45, 0x0.0p+0, 0x1.fc3f9e1f5a101p+4, -0x1.1cd0fb3871fa5p-51 },
+    { 0x1.b0338c0000000p-52, 0x0.0p+0, -0x1.1c28d5e96e341p+5, -0x1.fea30b28ccca5p-51 },
+    { 0x1.41f1c00000000p-131, 0x0.0p+0, -0x1.6a4ad555ff8bcp+6, 0x1.b84e52a512e05p-49 },
+    { 0x1.68f0580000000p+48, 0x0.0p+0, 0x1.0ceab12dfaa81p+5, 0x1.05b221fc1a2c7p-49 },
+    { 0x1.f561d80000000p-50, 0x0.0p+0, -0x1.0fe19fa5a0615p+5, 0x1.ba1e0162413c2p-52 },
+    { 0x1.3000000000000p-144, 0x0.0p+0, -0x1.8e90bc6a12d63p+6, -0x1.922150a1e2e7fp-49 },
+    { 0x1.fb0ca80000000p-24, 0x0.0p+0, -0x1.fe779d13b01b5p+3, 0x1.51768c4eecc2dp-53 },
+    { 0x1.b741260000000p+60, 0x0.0p+0, 0x1.5107a4d0be57bp+5, 0x1.ba21be1efce89p-50 },
+    { 0x1.6f7ee00000000p-130, 0x0.0p+0, -0x1.66fd8abcf8642p+6, 0x1.87cbfa5d78cb7p-48 },
+    { 0x1.906b200000000p+51, 0x0.0p+0, 0x1.1e61f95d6632fp+5, -0x1.f67c8f11396d6p-52 },
+    { 0x1.ebd99a0000000p+115, 0x0.0p+0, 0x1.4175ae2535841p+6, 0x1.8e0748bd9b02cp-50 },
+    { 0x1.ef3d840000000p+97, 0x0.0p+0, 0x1.0f94a02577eeap+6, -0x1.4f85fca8a3009p-48 },
+    { 0x1.d54d960000000p+54, 0x0.0p+0, 0x1.3049c45dc9235p+5, -0x1.16692bafdc4d7p-49 },
+    { 0x1.3f703e0000000p+95, 0x0.0p+0, 0x1.08480ee43e017p+6, -0x1.bc620d373092dp-48 },
+    { 0x1.4000000000000p-147, 0x0.0p+0, -0x1.96ad8f4ef913cp+6, 0x1.65b35df01d9bcp-48 },
+    { 0x1.e5180e0000000p+30, 0x0.0p+0, 0x1.56eff231c1e26p+4, 0x1.5f170920ca667p-51 },
+};
+
+static const MathCase powf_cases[] = {
+    { 0x1.d5a71a0000000p-3, 0x1.b609580000000p+2, 0x1.5fdf0588e26c8p-15, -0x1.f11e8d5d852e4p-69 },
+    { 0x1.23ee800000000p+2, -0x1.035dd00000000p+2, 0x1.1788e7bcb9f73p-9, 0x1.ca23b95b81a7bp-64 },
+    { 0x1.20a0360000000p-5, 0x1.5ba8040000000p+2, 0x1.b76862222a4bap-27, 0x1.d0437f719e4e4p-81 },
+    { 0x1.7d54f20000000p+2, 0x1.2736e40000000p+0, 0x1.f53afc4f47e76p+2, 0x1.4ee5e369fbf9bp-52 },
+    { 0x1.b577820000000p-3, 0x1.9256660000000p+2, 0x1.00048a36fbdb2p-14, 0x1.f292689d093ffp-71 },
+    { 0x1.d50e360000000p+0, 0x1.f482ca0000000p+2, 0x1.c7bf479d194dbp+6, 0x1.53ed380c2aaf9p-49 },
+    { 0x1.aaba260000000p-4, -0x1.02f6320000000p-2, 0x1.c58ef36c7ae0bp+0, 0x1.fcbcc99dbde30p-54 },
+    { 0x1.4433420000000p-1, -0x1.bb233c0000000p+2, 0x1.7aa69af17c0a9p+4, -0x1.26a15dda9b7cap-50 },
+    { 0x1.69f3f20000000p-4, 0x1.dc85900000000p-2, 0x1.4b188164bf3cbp-2, -0x1.fea0ebb984aa1p-58 },
+    { 0x1.0c46320000000p-4, 0x1.1a99f20000000p+2, 0x1.8dc2b840b307cp-18, -0x1.7a99a34171be8p-78 },
+    { 0x1.5fbcb80000000p+2, 0x1.3c48080000000p+2, 0x1.1bd6e34f7d30cp+12, -0x1.a1691132e0dc4p-44 },
+    { 0x1.1f2bec0000000p+3, -0x1.6244180000000p+2, 0x1.641c5ba3ee6c9p-18, 0x1.2cecf8354b7fdp-73 },
+    { 0x1.4127620000000p-5, 0x1.777c440000000p+2, 0x1.7fda1ae6f33bcp-28, -0x1.52e37074d9fccp-82 },
+    { 0x1.7d00e80000000p+2, 0x1.2f77bc0000000p+1, 0x1.12b493ae54881p+6, 0x1.612de62b32e3ep-49 },
+    { 0x1.c145500000000p-5, 0x1.8ddb220000000p+1, 0x1.f94551a766a19p-14, 0x1.847082b4a3d6dp-69 },
+    { 0x1.216bae0000000p+1, 0x1.9bfd260000000p+2, 0x1.7ddb41209fbbfp+7, 0x1.090c099677da8p-47 },
+    { 0x1.ca98460000000p+0, -0x1.90cc800000000p+0, 0x1.9b0e88b74d599p-2, 0x1.22a9a530da2d8p-61 },
+    { 0x1.ffa65a0000000p-1, -0x1.66f4a80000000p+2, 0x1.00fbf9577e5d5p+0, 0x1.6033fb4c1fb4ap-57 },
+    { 0x1.dc18400000000p-5, 0x1.fe49ba0000000p+0, 0x1.c3363dff5ba35p-9, 0x1.dc9ba97b30e5bp-64 },
+    { 0x1.0ee7520000000p+4, -0x1.79f1440000000p+2, 0x1.dc8efcec75c8ep-25, -0x1.8db2fe92bd07dp-79 },
+    { 0x1.c21a300000000p+0, 0x1.4748a20000000p-4, 0x1.0bce98d553ac8p+0, -0x1.3da8c13215f9ep-54 },
+    { 0x1.b714f20000000p-2, 0x1.4a22940000000p+2, 0x1.9f5fd3202668cp-7, -0x1.b6aec500996c7p-61 },
+    { 0x1.b9d84a0000000p-2, -0x1.90365c0000000p+1, 0x1.bb12885c8aae9p+3, -0x1.cc9a53f36dee0p-53 },
+    { 0x1.62ce780000000p-2, 0x1.eb1b660000000p+2, 0x1.33e4fcc05bab1p-12, 0x1.d7de5390fd8d6p-66 },
+};
+
+static const MathCase sinf_cases[] = {
+    { 0x1.39f8540000000p+12, 0x0.0p+0, -0x1.d157910ac0426p-4, -0x1.4b1af68f2f54bp-60 },
+    { 0x1.2bacb80000000p+12, 0x0.0p+0, 0x1.53589d207cb7ap-1, -0x1.ebcc7a2d7b2ffp-56 },
+    { 0x1.7c38400000000p+11, 0x0.0p+0, 0x1.4851aee2cdc83p-1, 0x1.aedc91719616ap-55 },
+    { 0x1.7c8f3e0000000p+12, 0x0.0p+0, 0x1.09e670e9a08f4p-1, 0x1.1a5d37c33d7cbp-56 },
+    { -0x1.5cd7240000000p+12, 0x0.0p+0, -0x1.d6302c826e65fp-1, -0x1.e6bb04ae4e3c7p-56 },
+    { 0x1.2b55ae0000000p+13, 0x0.0p+0, 0x1.8bd361ea55eabp-8, 0x1.ce9544af3fea6p-62 },
+    { 0x1.1c78ae0000000p+13, 0x0.0p+0, -0x1.e5f7fd8139803p-1, -0x1.8413ce59e9d1dp-55 },
+    { 0x1.08a2380000000p+13, 0x0.0p+0, -0x1.fca80caf8a0ebp-1, -0x1.2952ce9dd3200p-55 },
+    { 0x1.23461a0000000p+12, 0x0.0p+0, -0x1.f8806ca32fef4p-1, -0x1.7f85da119fe5dp-55 },
+    { -0x1.23f8300000000p+13, 0x0.0p+0, 0x1.2b35968393e7ap-4, 0x1.eaa330b4f4563p-60 },
+    { -0x1.0d10ca0000000p+11, 0x0.0p+0, 0x1.04762bdcfb6e4p-1, 0x1.e5da0959bc852p-55 },
+    { 0x1.887e900000000p+11, 0x0.0p+0, -0x1.fedbda96b79a5p-1, 0x1.325c8d8df6cdbp-55 },
+    { -0x1.654ea20000000p+8, 0x0.0p+0, 0x1.7b56afdbe3114p-1, 0x1.59e31192939f2p-57 },
+    { -0x1.d016800000000p+12, 0x0.0p+0, 0x1.efd3bf2da5aa1p-1, -0x1.53ed841d2da50p-58 },
+    { -0x1.bced960000000p+11, 0x0.0p+0, 0x1.607223558709fp-14, -0x1.be1fff0015381p-69 },
+    { 0x1.8c810c0000000p+10, 0x0.0p+0, 0x1.e00d501ec0d5ap-2, 0x1.e73ce7f03c0eep-56 },
+    { 0x1.02b3580000000p+13, 0x0.0p+0, -0x1.4367c1643249dp-2, -0x1.f7ce4088d71adp-56 },
+    { -0x1.8e3d9e0000000p+11, 0x0.0p+0, -0x1.5fb0fb3a8bb3ep-2, 0x1.d695568bf1fdcp-57 },
+    { -0x1.5ceade0000000p+9, 0x0.0p+0, -0x1.9004ea4b9ccabp-2, -0x1.d6fd745d50696p-57 },
+    { 0x1.8911a60000000p+12, 0x0.0p+0, -0x1.6df601f195293p-2, -0x1.9879473cb7368p-59 },
+    { -0x1.679a8a0000000p+11, 0x0.0p+0, 0x1.872df6a7533ccp-1, -0x1.3758b0ef2d4f6p-55 },
+    { -0x1.c543b60000000p+12, 0x0.0p+0, -0x1.fb5c9424b7c63p-1, 0x1.a9d77b5cb5beap-58 },
+    { -0x1.6d5a280000000p+11, 0x0.0p+0, -0x1.d068623ff8d42p-1, 0x1.50e7962600bfap-55 },
+    { -0x1.25e2c40000000p+11, 0x0.0p+0, -0x1.d870e93762048p-1, 0x1.201e943a58096p-56 },
+};
+
+static const MathCase cosf_cases[] = {
+    { 0x1.b9ff420000000p+9, 0x0.0p+0, -0x1.6caf1e74d5db2p-2, -0x1.828a14e444103p-57 },
+    { 0x1.4aa1420000000p+11, 0x0.0p+0, 0x1.f79219b5d7cd5p-1, -0x1.0ab256d05f070p-56 },
+    { 0x1.d74c3c0000000p+12, 0x0.0p+0, 0x1.2d072e1e104adp-1, 0x1.c28d3899a5af6p-56 },
+    { -0x1.370d360000000p+13, 0x0.0p+0, 0x1.dd5b73fcb80acp-2, 0x1.e869e287aefb0p-59 },
+    { 0x1.5317e40000000p+12, 0x0.0p+0, -0x1.ffa497c59c7bdp-1, -0x1.25fd9c601b9c6p-55 },
+    { -0x1.1550460000000p+13, 0x0.0p+0, -0x1.23836be688243p-1, -0x1.84efa25880160p-56 },
+    { 0x1.1368040000000p+13, 0x0.0p+0, -0x1.57cf5d07a2c69p-1, 0x1.fd6262cacb448p-55 },
+    { 0x1.f380300000000p+7, 0x0.0p+0, -0x1.9994b6c25ad5cp-8, -0x1.9156b20dc48fbp-63 },
+    { 0x1.e447800000000p+7, 0x0.0p+0, -0x1.f1afac14985c2p-1, 0x1.79435a5c192d1p-56 },
+    { -0x1.58d0280000000p+12, 0x0.0p+0, 0x1.dcc81e44f423fp-1, -0x1.a501e36eb50d8p-55 },
+    { 0x1.3727640000000p+12, 0x0.0p+0, -0x1.249dfef1ac03cp-1, -0x1.17b9b920ea99cp-55 },
+    { -0x1.ceb2480000000p+11, 0x0.0p+0, 0x1.6dbb772f64013p-1, 0x1.5959a34f61f1ep-55 },
+    { -0x1.1b49180000000p+13, 0x0.0p+0, 0x1.230c8b577348cp-4, 0x1.7de9210c8ad67p-60 },
+    { 0x1.42a3a00000000p+9, 0x0.0p+0, -0x1.411d6430236f2p-2, -0x1.9d1b2a3280c5ep-56 },
+    { 0x1.c3a7f40000000p+12, 0x0.0p+0, 0x1.5808eb1e935f5p-1, 0x1.8d615b3fb30bdp-55 },
+    { -0x1.01f41a0000000p+6, 0x0.0p+0, -0x1.5eb96ceff26ebp-4, 0x1.77e417a663eb5p-59 },
+    { 0x1.9b19f40000000p+11, 0x0.0p+0, -0x1.cfffc5820d03fp-1, 0x1.34b3bdacc4464p-60 },
+    { -0x1.b6e6620000000p+12, 0x0.0p+0, -0x1.2e3e0259d7b2dp-1, 0x1.5a65d2febcba8p-55 },
+    { 0x1.74d5b80000000p+12, 0x0.0p+0, -0x1.ba8652e2387acp-1, 0x1.6763abb4c5fe2p-55 },
+    { -0x1.a761e60000000p+12, 0x0.0p+0, 0x1.53df409546d49p-1, -0x1.b3d8e43b89fddp-55 },
+    { 0x1.26eebe0000000p+13, 0x0.0p+0, 0x1.c1b44319c36c7p-1, -0x1.ca5927dafa197p-55 },
+    { -0x1.d33cae0000000p+10, 0x0.0p+0, -0x1.e934e072f406fp-1, 0x1.417a107f87f82p-57 },
+    { -0x1.5eafc40000000p+10, 0x0.0p+0, -0x1.9d2102cef4749p-6, 0x1.123448adb18d2p-60 },
+    { 0x1.25fee60000000p+11, 0x0.0p+0, -0x1.dc03e820cd672p-2, -0x1.825c08d8440e7p-58 },
+};
+
+static const MathCase tanhf_cases[] = {
+    { 0x1.6f35380000000p+1, 0x0.0p+0, 0x1.fcb5f9cba6352p-1, -0x1.0b2407bf5321fp-55 },
+    { 0x1.d6d01a0000000p+2, 0x0.0p+0, 0x1.ffffe4a4f3cebp-1, -0x1.d717cfcf4069ep-60 },
+    { 0x1.832dac0000000p+2, 0x0.0p+0, 0x1.fffe8aa858b69p-1, -0x1.7cb1dc3ef4ac1p-55 },
+    { -0x1.79b3680000000p+2, 0x0.0p+0, -0x1.fffe09f7249e6p-1, 0x1.ac22e5e380942p-55 },
+    { 0x1.fb18fe0000000p+2, 0x0.0p+0, 0x1.fffff7329522ep-1, -0x1.325d90fee37bcp-55 },
+    { 0x1.0bb3b00000000p+1, 0x0.0p+0, 0x1.f09d0f3122a29p-1, -0x1.03f1c073970d3p-56 },
+    { -0x1.f6a4300000000p+0, 0x0.0p+0, -0x1.ec36494684619p-1, 0x1.a7fcfafdb6e46p-57 },
+    { 0x1.62787a0000000p+2, 0x0.0p+0, 0x1.fffbf2769b02ap-1, 0x1.d7074a11c6ef6p-57 },
+    { 0x1.d1f21c0000000p+2, 0x0.0p+0, 0x1.ffffe02686d06p-1, 0x1.a81f58ea6e46dp-56 },
+    { -0x1.86d4d00000000p+1, 0x0.0p+0, -0x1.fdb94af30b442p-1, 0x1.a11536e930d76p-55 },
+    { -0x1.e8e7b40000000p+2, 0x0.0p+0, -0x1.fffff0754333dp-1, 0x1.223e7f1dd41f9p-57 },
+    { 0x1.3d7f0a0000000p+2, 0x0.0p+0, 0x1.fff321776302dp-1, -0x1.0579fadc9832dp-56 },
+    { -0x1.06b4a00000000p+1, 0x0.0p+0, -0x1.ef626c4272e93p-1, -0x1.8406deebbc078p-57 },
+    { -0x1.02f5ca0000000p+2, 0x0.0p+0, -0x1.ffafdad481ad1p-1, 0x1.63bf43ee64d64p-56 },
+    { -0x1.0baa400000000p+0, 0x0.0p+0, -0x1.8f66382040490p-1, 0x1.a1cd9764fce82p-55 },
+    { -0x1.2770100000000p+0, 0x0.0p+0, -0x1.a36018af2fb78p-1, -0x1.4e388a51b8cfep-56 },
+    { 0x1.b284440000000p+1, 0x0.0p+0, 0x1.fed93a6f25759p-1, -0x1.5226edf2018d6p-55 },
+    { -0x1.caadbc0000000p-1, 0x0.0p+0, -0x1.6db5617a8248ap-1, -0x1.cbe64f978f0e7p-57 },
+    { 0x1.ec809e0000000p+1, 0x0.0p+0, 0x1.ff88cb88ab534p-1, 0x1.397cd6d9df94ap-55 },
+    { 0x1.0fa3700000000p+1, 0x0.0p+0, 0x1.f184b677bfc19p-1, -0x1.340662f0935b2p-59 },
+    { 0x1.9ae5b40000000p+2, 0x0.0p+0, 0x1.ffff4e16c0b4bp-1, 0x1.b2752210f60ffp-56 },
+    { 0x1.10d5e00000000p+1, 0x0.0p+0, 0x1.f1c874263684dp-1, -0x1.fb3e448281dcdp-55 },
+    { -0x1.eab3380000000p+0, 0x0.0p+0, -0x1.ea5171000f43ep-1, 0x1.acd85759363a9p-55 },
+    { 0x1.1d2e900000000p-1, 0x0.0p+0, 0x1.02f10543661b5p-1, -0x1.01fd662aeccf8p-55 },
+};
+
+static const MathCase sqrtf_cases[] = {
+    { 0x1.57a44a0000000p-100, 0x0.0p+0, 0x1.2899ea25501adp-50, 0x1.533f9188b44d4p-106 },
+    { 0x1.28d8420000000p+66, 0x0.0p+0, 0x1.13aabc1ad3639p+33, -0x1.f6112a5c8bd30p-21 },
+    { 0x1.31382a0000000p+39, 0x0.0p+0, 0x1.8b501d771c91dp+19, -0x1.1e023e65f3f72p-36 },
+    { 0x1.71661c0000000p+17, 0x0.0p+0, 0x1.b2e4b20c7ecb2p+8, 0x1.e0659b6cb7b8dp-47 },
+    { 0x1.4e21aa0000000p-14, 0x0.0p+0, 0x1.2477ddc0ea53fp-7, 0x1.f8e34115e0b4bp-63 },
+    { 0x1.8448000000000p-135, 0x0.0p+0, 0x1.bddeb42366ee1p-68, 0x1.69be73f3e7dbdp-123 },
+    { 0x1.9738560000000p+37, 0x0.0p+0, 0x1.c89d468fd3209p+18, 0x1.2d59851a9c307p-36 },
+    { 0x1.d09e7e0000000p+21, 0x0.0p+0, 0x1.e7bc0b01887bap+10, 0x1.d4314453d4d96p-45 },
+    { 0x1.f976d80000000p-53, 0x0.0p+0, 0x1.fcb8bc24895ffp-27, 0x1.6c076324ca838p-81 },
+    { 0x1.498e4e0000000p-117, 0x0.0p+0, 0x1.9ac54fe5c1642p-59, 0x1.88888fa5924dap-114 },
+    { 0x1.47d7660000000p+90, 0x0.0p+0, 0x1.21b3c7326a84bp+45, 0x1.0db7b02000c3fp-9 },
+    { 0x1.02d33a0000000p+17, 0x0.0p+0, 0x1.6c07e53068d99p+8, -0x1.981b079e5dc35p-46 },
+    { 0x1.5dedf60000000p-126, 0x0.0p+0, 0x1.2b4d6dd73840cp-63, -0x1.f4988bb8b2030p-117 },
+    { 0x1.8a31760000000p-10, 0x0.0p+0, 0x1.3dab35e758aa6p-5, -0x1.d683c987692b2p-63 },
+    { 0x1.ead7e40000000p+49, 0x0.0p+0, 0x1.f54f606b23a80p+24, -0x1.9cec45be00fe8p-30 },
+    { 0x1.c90c800000000p-131, 0x0.0p+0, 0x1.e3bea913c45ebp-66, 0x1.e318f30531119p-120 },
+    { 0x1.0dd46c0000000p+97, 0x0.0p+0, 0x1.73b06ddb0098dp+48, 0x1.933c589c601c0p-7 },
+    { 0x1.6f99100000000p-129, 0x0.0p+0, 0x1.b1d4f7f7d4a57p-65, -0x1.dae395a219f50p-122 },
+    { 0x1.ff40660000000p-104, 0x0.0p+0, 0x1.69c62245217f9p-52, -0x1.c6310d9290dd1p-108 },
+    { 0x1.7bb9a20000000p+75, 0x0.0p+0, 0x1.b8ee1488ac48cp+37, -0x1.1993cdcee8365p-17 },
+    { 0x1.5598400000000p+46, 0x0.0p+0, 0x1.27b76cb970407p+23, 0x1.0505de795e474p-32 },
+    { 0x1.fbcba20000000p-42, 0x0.0p+0, 0x1.688c8fefbc0a3p-21, -0x1.3167d2f42b9adp-76 },
+    { 0x1.495fc80000000p-50, 0x0.0p+0, 0x1.2260f18fdcc33p-25, 0x1.66d75018864dap-80 },
+    { 0x1.af80ea0000000p-107, 0x0.0p+0, 0x1.d6081f8573697p-54, 0x1.72f2f4a6b2e54p-109 },
+};
+
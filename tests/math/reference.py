@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+
+'''
+
+Generates reference.h for tests/math: inputs and the exact results of each libm
+function, computed with decimal arithmetic to 60 digits and stored as the
+nearest double plus the remainder, so the test can measure errors below an ULP.
+
+tests/math/reference.py > tests/math/reference.h
+
+'''
+
+import random, struct
+from decimal import Decimal as D, getcontext, localcontext
+
+getcontext().prec = 60
+
+def machin_pi(digits):
+    # pi = 16 atan(1/5) - 4 atan(1/239) in fixed point
+    one = 10 ** (digits + 10)
+    def atan_inv(n):
+        total, term, k, sign = 0, one // n, 1, 1
+        while term:
+            total += sign * (term // k)
+            term //= n * n
+            k += 2
+            sign = -sign
+        return total
+    return D(16 * atan_inv(5) - 4 * atan_inv(239)) / D(one)
+
+with localcontext() as c:
+    c.prec = 420
+    PI = machin_pi(410)
+
+def reduce(x):
+    # x mod 2pi with enough digits for x up to 1e308
+    with localcontext() as c:
+        c.prec = 420
+        x = D(x)
+        n = (x / (2 * PI)).to_integral_value()
+        return +(x - n * 2 * PI)
+
+def series_sin(r):
+    term, total, k = r, r, 1
+    while abs(term) > D(10) ** -70:
+        term = -term * r * r / ((2 * k) * (2 * k + 1))
+        total += term
+        k += 1
+    return total
+
+def series_cos(r):
+    term, total, k = D(1), D(1), 1
+    while abs(term) > D(10) ** -70:
+        term = -term * r * r / ((2 * k - 1) * (2 * k))
+        total += term
+        k += 1
+    return total
+
+def ref_exp(x, y): return D(x).exp()
+def ref_log(x, y): return D(x).ln()
+def ref_sqrt(x, y): return D(x).sqrt()
+def ref_sin(x, y): return series_sin(reduce(x))
+def ref_cos(x, y): return series_cos(reduce(x))
+
+def ref_tanh(x, y):
+    if abs(x) < 1:
+        # sinh / cosh, (e - 1) / (e + 1) cancels for small x
+        r, s, c, k = D(x), D(x), D(1), 1
+        term_s, term_c = D(x), D(1)
+        while abs(term_s) > abs(s) * D(10) ** -70:
+            term_s = term_s * r * r / ((2 * k) * (2 * k + 1))
+            term_c = term_c * r * r / ((2 * k - 1) * (2 * k))
+            s += term_s
+            c += term_c
+            k += 1
+        return s / c
+    e = (2 * D(x)).exp()
+    return (e - 1) / (e + 1)
+
+def ref_pow(x, y):
+    t = D(y) * D(abs(x)).ln()
+    # Past the range of doubles, exp would overflow the decimal context
+    v = D('Infinity') if t > 1000 else D(0) if t < -1000 else t.exp()
+    return -v if x < 0 and int(y) % 2 else v
+
+def f64(bits): return struct.unpack('<d', struct.pack('<Q', bits))[0]
+def f32(x): return struct.unpack('<f', struct.pack('<f', x))[0]
+
+def uniform(lo, hi): return random.uniform(lo, hi)
+def log_uniform(lo, hi, sign=1): return sign * 2 ** random.uniform(lo, hi)
+
+def c_double(v):
+    return v.hex() if abs(v) != float('inf') else f"{'-' if v < 0 else ''}__builtin_inf()"
+
+def cases(name, fn, inputs):
+    print(f"static const MathCase {name}_cases[] = {{")
+    for x, y in inputs:
+        v = fn(x, y)
+        hi = float(v)
+        lo = float(v - D(hi)) if abs(hi) != float('inf') else 0.0
+        print(f"    {{ {x.hex()}, {y.hex()}, {c_double(hi)}, {lo.hex()} }},")
+    print("};\n")
+
+def main():
+    random.seed(20240601)
+    N = 48
+    print("/* Generated by reference.py, do not edit */\n")
+
+    exp_in = [uniform(-745, 709.7) for _ in range(N)] + [uniform(-1, 1) for _ in range(N // 2)]
+    exp_in += [float.fromhex("0x1p-1000"), -float.fromhex("0x1p-60"), 1.0, 709.78, -708.5, -740.0, -745.1, 1e-10]
+    log_in = [log_uniform(-1074, 1024) for _ in range(N)] + [1 + uniform(-0.3, 0.3) for _ in range(N // 2)]
+    log_in += [1 + 2 ** -30, 1 - 2 ** -40, float.fromhex("0x1p-1074"), float.fromhex("0x1.fffffffffffffp1023"), 2.0, 0.5, 1e-300, 10.0]
+    sin_in = [uniform(-10, 10) for _ in range(N // 2)] + [uniform(-1e6, 1e6) for _ in range(N // 4)]
+    sin_in += [log_uniform(20, 1023, random.choice((1, -1))) for _ in range(N // 4)]
+    sin_in += [f64(0x3FF921FB54442D18), 3.141592653589793, 1e22, float.fromhex("0x1.6ac5b262ca1ffp+849"), float.fromhex("0x1.921fb54442d18p+1"), float.fromhex("0x1p-30"), 355.0, 1647099.0]
+    tanh_in = [uniform(-0.55, 0.55) for _ in range(N // 2)] + [uniform(-20, 20) for _ in range(N // 2)]
+    tanh_in += [0.54999, 0.55, 0.55001, 1e-300, float.fromhex("0x1p-28"), 19.0, -0.3, 1.0]
+    sqrt_in = [log_uniform(-1074, 1024) for _ in range(N)] + [2.0, float.fromhex("0x1p-1074"), float.fromhex("0x1.fffffffffffffp1023")]
+    pow_in = []
+    for _ in range(N):
+        x = log_uniform(-30, 30)
+        y = uniform(-700, 700) / abs(D(x).ln().__float__() or 1.0)
+        pow_in.append((x, max(-1e4, min(1e4, y))))
+    pow_in += [(1 + uniform(-1e-9, 1e-9), uniform(-1e11, 1e11)) for _ in range(N // 4)]
+    pow_in += [(-uniform(0.5, 20), float(random.randint(-60, 60))) for _ in range(N // 4)]
+    pow_in += [(2.0, 0.5), (10.0, -5.0), (0.5, 1074.0), (2.0, 1023.99), (1.0000001, 7e9), (3.0, float.fromhex("0x1p-60")), (float.fromhex("0x1p-1074"), 0.03)]
+    # Huge finite y, the result is 0, 1 or inf
+    pow_in += [(1.0, 1e302), (1.0, -1e308), (2.0, 1e308), (0.5, -1e305), (0.5, 1e305), (1.0000000000000002, 1e300), (-1.0, 1e308), (-2.0, 1e308)]
+
+    cases("exp", ref_exp, [(x, 0.0) for x in exp_in])
+    cases("log", ref_log, [(x, 0.0) for x in log_in])
+    cases("pow", ref_pow, pow_in)
+    cases("sin", ref_sin, [(x, 0.0) for x in sin_in])
+    cases("cos", ref_cos, [(x, 0.0) for x in sin_in])
+    cases("tanh", ref_tanh, [(x, 0.0) for x in tanh_in])
+    cases("sqrt", ref_sqrt, [(x, 0.0) for x in sqrt_in])
+
+    # Float versions, results measured in float ULPs
+    M = 24
+    cases("expf", ref_exp, [(f32(uniform(-103, 88)), 0.0) for _ in range(M)])
+    cases("logf", ref_log, [(f32(log_uniform(-149, 128)), 0.0) for _ in range(M)])
+    cases("powf", ref_pow, [(f32(log_uniform(-5, 5)), f32(uniform(-8, 8))) for _ in range(M)])
+    cases("sinf", ref_sin, [(f32(uniform(-1e4, 1e4)), 0.0) for _ in range(M)])
+    cases("cosf", ref_cos, [(f32(uniform(-1e4, 1e4)), 0.0) for _ in range(M)])
+    cases("tanhf", ref_tanh, [(f32(uniform(-9, 9)), 0.0) for _ in range(M)])
+    cases("sqrtf", ref_sqrt, [(f32(log_uniform(-149, 128)), 0.0) for _ in range(M)])
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,34 @@
+#include "platform/platform.h"
+#include "merge.h"
+
+/*
+    Code reaches the strings through their symbols, the pointers in 'names'
+    through the section and an addend.
+*/
+
+static const char delta[] MERGE_STRINGS = "delta";
+
+const char* names[] = { alpha, beta, gamma_, delta };
+
+const char* other_name(int i);
+double      other_scale(double x);
+
+double scale(double x) {
+    return x * factor + 0.5;
+}
+
+int ba_entry(const char* path, const char* data, int size) {
+    for (int i = 0; i < 4; i++)
+        log__printf("%s %s\n", names[i], other_name(i));
+    log__printf("%s %s\n", alpha, gamma_);
+    log__printf("scale %d %d\n", (int)(scale(4.0) * 100), (int)(other_scale(4.0) * 100));
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], 0, 0);
+}
+
+#endif
@@ -0,0 +1,17 @@
+/*
+    Strings and constants in mergeable sections, what -fmerge-constants (on
+    from -O1) does with literals. Both objects of the test have copies.
+*/
+
+#ifdef __ELF__
+    #define MERGE_STRINGS __attribute__((section(".rodata.str1.1,\"aMS\",@progbits,1#")))
+    #define MERGE_CONST8  __attribute__((section(".rodata.cst8,\"aM\",@progbits,8#")))
+#else
+    #define MERGE_STRINGS
+    #define MERGE_CONST8
+#endif
+
+static const char alpha[] MERGE_STRINGS = "alpha";
+static const char beta[]  MERGE_STRINGS = "beta";
+static const char gamma_[] MERGE_STRINGS = "gamma";
+static const double factor MERGE_CONST8 = 2.75;
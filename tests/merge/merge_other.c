@@ -0,0 +1,14 @@
+#include "merge.h"
+
+static const char other[] MERGE_STRINGS = "other";
+
+// Through the section and an addend as well, whichever object comes first
+static const char* other_names[] = { gamma_, alpha, other, beta };
+
+const char* other_name(int i) {
+    return i == 2 ? other : other_names[i];
+}
+
+double other_scale(double x) {
+    return x * factor + 1.5;
+}
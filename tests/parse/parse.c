@@ -0,0 +1,60 @@
+#include "platform/platform.h"
+
+/*
+    strtol, strtoull, strtod and strtof from src/libc in the artifact against the
+    C runtime in the native program. Floats are printed with %a so any difference
+    in the last bit shows, the offset of endptr is printed after each value.
+*/
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+    #include <stdio.h>
+    #include <stdlib.h>
+#else
+    #include "libc/libc.c"
+#endif
+
+static const char* integers[] = {
+    "0", "-0", "42", "  -17xyz", "+8", "0x1F", "0X", "0777", "08", "z", "",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+    "18446744073709551615", "18446744073709551616", "123456789012345678901234567890", "\t\n 1234567890123456",
+};
+
+static const int bases[] = { 0, 10, 16, 8, 2, 36 };
+
+static const char* floats[] = {
+    "0", "-0.0", "1", "0.1", "3.14159", "  -2.5e-3x", "1e23", "8.98846567431158e307", "1.7976931348623157e308",
+    "1.7976931348623159e308", "1e400", "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4703282292062328e-324",
+    "1e-400", "9007199254740993", "0.30000000000000004", "123456789012345678901234567890e-10",
+    "0.000000000000000000000000000000000000000000000001e48", "1.00000005960464477539062500000000000000000001",
+    "3.4028235e38", "3.5e38", "1e-45", "7e-46", "0x1p-2", "0x1.8p+1", "0X.8", "0x1.fffffffffffff8p0", "0x",
+    "inf", "-INFINITY", "infinit", "nan", "1e", "1e+", ".5", ".", "-.e1", "12.", "1.5E+10", "0.12345678901234567890123",
+};
+
+int ba_entry(const char* path, const char* data, int size) {
+    char* end;
+    for (int i = 0; i < sizeof(integers)/sizeof(*integers); i++) {
+        for (int b = 0; b < sizeof(bases)/sizeof(*bases); b++) {
+            long long l = strtoll(integers[i], &end, bases[b]);
+            log__printf("strtoll '%s' %d: %lld %d\n", integers[i], bases[b], l, (int)(end - integers[i]));
+            unsigned long long u = strtoull(integers[i], &end, bases[b]);
+            log__printf("strtoull '%s' %d: %llu %d\n", integers[i], bases[b], u, (int)(end - integers[i]));
+        }
+        long l = strtol(integers[i], &end, 0);
+        log__printf("strtol '%s': %ld %d\n", integers[i], l, (int)(end - integers[i]));
+    }
+    for (int i = 0; i < sizeof(floats)/sizeof(*floats); i++) {
+        double d = strtod(floats[i], &end);
+        log__printf("strtod '%s': %a %d\n", floats[i], d, (int)(end - floats[i]));
+        float f = strtof(floats[i], &end);
+        log__printf("strtof '%s': %a %d\n", floats[i], (double)f, (int)(end - floats[i]));
+    }
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], NULL, 0);
+}
+
+#endif
@@ -0,0 +1,63 @@
+#include "platform/platform.h"
+
+/*
+    snprintf from src/libc in the artifact against the C runtime's snprintf in the
+    native program, both print the same list of conversions.
+*/
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+    #include <stdio.h>
+#else
+    #include "libc/libc.c"
+#endif
+
+static const char* float_formats[] = {
+    "%f", "%e", "%g", "%a", "%.0f", "%.3f", "%.20f", "%.0e", "%.16e", "%.1g", "%.17g",
+    "%12.4f|", "%-12.4e|", "%+015.3g", "% f", "%#.0f", "%G", "%E", "%.3A", "%.60f",
+};
+
+static const double float_values[] = {
+    0.0, -0.0, 1.0, 0.5, 1.5, 2.5, 0.1, 0.15, 1e23, 99.5, 1e-300, 5e-324,
+    1.7976931348623157e308, 1.0 / 0.0, -1.0 / 0.0, 3.14159, -2.71828, 1e-5, 123456789012345678.0,
+};
+
+static const char* integer_formats[] = {
+    "%d", "%5d|", "%-5d|", "%05d", "%+d", "% d", "%.3d", "%.0d", "%x", "%#x", "%#o", "%X", "%#08x", "%u", "%hhd", "%hu",
+};
+
+static const int integer_values[] = { 0, 1, -1, 42, -123456, 2147483647, -2147483647 - 1, 65535 };
+
+static int truncate_at = 8;
+
+int ba_entry(const char* path, const char* data, int size) {
+    char buffer[512];
+    for (int f = 0; f < sizeof(float_formats)/sizeof(*float_formats); f++) {
+        for (int v = 0; v < sizeof(float_values)/sizeof(*float_values); v++) {
+            snprintf(buffer, sizeof(buffer), float_formats[f], float_values[v]);
+            log__printf("%s\n", buffer);
+        }
+    }
+    for (int f = 0; f < sizeof(integer_formats)/sizeof(*integer_formats); f++) {
+        for (int v = 0; v < sizeof(integer_values)/sizeof(*integer_values); v++) {
+            snprintf(buffer, sizeof(buffer), integer_formats[f], integer_values[v]);
+            log__printf("%s\n", buffer);
+        }
+    }
+    snprintf(buffer, sizeof(buffer), "%lld %llx %20lld| %zu %lo", -9223372036854775807LL - 1, 0x123456789abcdefLL, 1234567890123LL, (size_t)77, 511L);
+    log__printf("%s\n", buffer);
+    snprintf(buffer, sizeof(buffer), "%s|%10s|%-10s|%.2s|%*s|%-*.*s|%*.s|", "hello", "hi", "left", "abc", 6, "w", 8, 2, "xyz", 5, "abc");
+    log__printf("%s\n", buffer);
+    snprintf(buffer, sizeof(buffer), "%c%5c%-5c|%%|%p|%p", 'a', 'b', 'c', (void*)0x1234, (void*)0);
+    log__printf("%s\n", buffer);
+    int length = snprintf(buffer, truncate_at, "%s %d", "truncated", 12345);
+    log__printf("%s %d\n", buffer, length);
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], NULL, 0);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "platform/platform.h"
+
+/*
+    Batched reads through an FSQueue (io_uring or the thread pool). Reads match
+    fs__read, an unknown op completes with an error, a queue takes no more than
+    its depth, everything submitted completes before destroy returns and sizes
+    over 32 bits aren't cut.
+*/
+
+#define BLOCK 16
+
+int ba_entry(const char* path, const char* data, int size) {
+    FSHandle file = fs__open(path, FS_READ);
+    if (file == FS_INVALID_HANDLE) {
+        log__printf("could not open self\n");
+        return 1;
+    }
+    char direct[4 * BLOCK], queued[4 * BLOCK], unused[BLOCK];
+    fs__read(file, 0, direct, sizeof(direct));
+
+    FSQueue* queue = fs__queue_create(8);
+    FSRequest requests[5] = {
+        { FS_OP_READ, file, 0 * BLOCK, queued + 0 * BLOCK, BLOCK, 0 },
+        { FS_OP_READ, file, 1 * BLOCK, queued + 1 * BLOCK, BLOCK, 1 },
+        { 99,         file, 0,         unused,             BLOCK, 2 },
+        { FS_OP_READ, file, 2 * BLOCK, queued + 2 * BLOCK, BLOCK, 3 },
+        { FS_OP_READ, file, 3 * BLOCK, queued + 3 * BLOCK, BLOCK, 4 },
+    };
+    uint32_t submitted = fs__submit(queue, requests, 5);
+    FSCompletion completions[8];
+    int64_t results[5] = { 0 };
+    for (uint32_t done = 0; done < submitted;) {
+        uint32_t n = fs__complete(queue, completions, 8, 1);
+        for (uint32_t i = 0; i < n; i++)
+            results[completions[i].user_data] = completions[i].result;
+        done += n;
+    }
+    log__printf("submitted %u\n", submitted);
+    for (int i = 0; i < 5; i++)
+        log__printf("request %d: %s\n", i, results[i] == BLOCK ? "read" : results[i] < 0 ? "error" : "wrong size");
+    int differs = 0;
+    for (int i = 0; i < (int)sizeof(direct); i++)
+        differs |= direct[i] != queued[i];
+    log__printf("data %s\n", differs ? "differs" : "matches");
+    fs__queue_destroy(queue);
+
+    // Depth 2 takes two, destroy waits for them
+    queue = fs__queue_create(2);
+    log__printf("depth 2 took %u\n", fs__submit(queue, requests, 5));
+    fs__queue_destroy(queue);
+
+    // 4 GiB doesn't fit the 32-bit length of the kernel, the last block must still be read
+    FSInfo info;
+    fs__info(file, &info);
+    // Not on the stack, the kernel checks that the whole range is below the top of the address space
+    static char last[BLOCK];
+    FSRequest huge = { FS_OP_READ, file, info.file_size - BLOCK, last, 1ull << 32, 0 };
+    queue = fs__queue_create(1);
+    fs__submit(queue, &huge, 1);
+    fs__complete(queue, completions, 1, 1);
+    log__printf("4 GiB read at the end: %lld bytes\n", (long long)completions[0].result);
+    fs__queue_destroy(queue);
+
+    fs__close(file);
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], 0, 0);
+}
+
+#endif
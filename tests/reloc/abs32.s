@@ -0,0 +1,11 @@
+# Absolute 32-bit relocations. The image is reserved above 4 GB so an artifact
+# with these doesn't load, tools/test.py only converts this file and checks the
+# relocations in the dump against abs32.expect.
+
+    .text
+    movl    $counter, %eax          # R_X86_64_32
+    movq    $counter+8, %rax        # R_X86_64_32S
+    movl    numbers+12(,%rdi,4), %eax  # R_X86_64_32S
+
+    .data
+    .long   numbers                 # R_X86_64_32
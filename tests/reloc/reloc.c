@@ -0,0 +1,80 @@
+#include "platform/platform.h"
+
+#include <stddef.h>
+
+/*
+    Relocations of each type the converter handles. References go to another
+    object (reloc_target.c) so the compiler can't resolve them itself.
+
+    GOT loads are forced with noplt and inline assembly since the test flags
+    (-fpie) otherwise give plain PC32. Relaxable loads become direct references
+    in the loader, 'add' through the GOT can't be relaxed and gets a slot.
+
+    ABS32 and ABS32S can't be loaded, the image is reserved above 4 GB so every
+    symbol address fails the fits-in-32-bits check (and the PIE native program
+    can't link them). abs32.s only checks that the converter produces them.
+    @TODO Run them once the loader can place images in the low 4 GB.
+*/
+
+extern int counter;
+extern int numbers[8];
+extern int add_counter(int x) __attribute__((noplt)); // call *add_counter@GOTPCREL(%rip)
+
+static int local_value = 7;
+static int zeroed[4];
+
+// R_X86_64_64
+static int* pointers[] = { &counter, &numbers[3], &local_value, &zeroed[2] };
+static int (*functions[])(int) = { add_counter };
+
+#ifdef __ELF__
+// jmp *add_counter@GOTPCREL(%rip)
+__asm__(
+    ".text\n"
+    ".globl tail_add_counter\n"
+    "tail_add_counter:\n"
+    "    jmp *add_counter@GOTPCREL(%rip)\n"
+);
+int tail_add_counter(int x);
+#endif
+
+int ba_entry(const char* path, const char* data, int size) {
+    int failures = 0;
+    #define CHECK(E) ((E) ? 0 : (log__printf("FAIL %s\n", #E), failures++))
+
+    CHECK(add_counter(1) == 6);
+    CHECK(numbers[5] == 6);                     // PC32 with addend
+    CHECK(*pointers[0] == 5 && *pointers[1] == 4 && *pointers[2] == 7 && *pointers[3] == 0);
+    CHECK(pointers[3] == &zeroed[2]);
+    CHECK(functions[0](2) == 7);
+
+    counter = 10;
+    CHECK(add_counter(1) == 11);
+
+#ifdef __ELF__
+    CHECK(tail_add_counter(3) == 13);
+
+    int* p;
+    __asm__("movq counter@GOTPCREL(%%rip), %0" : "=r"(p)); // relaxed to lea
+    CHECK(p == &counter);
+
+    uint64_t sum = 16;
+    __asm__("addq counter@GOTPCREL(%%rip), %0" : "+r"(sum)); // loads from a GOT slot
+    CHECK(sum == (uint64_t)&counter + 16);
+
+    void (*printer)(const char*, ...);
+    __asm__("movq log__printf@GOTPCREL(%%rip), %0" : "=r"(printer)); // external
+    printer("printed through the GOT\n");
+#endif
+
+    log__printf("reloc: %d failures\n", failures);
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], NULL, 0);
+}
+
+#endif
@@ -0,0 +1,10 @@
+/*
+    Definitions that reloc.c reaches from another object, through the GOT or directly.
+*/
+
+int counter = 5;
+int numbers[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+int add_counter(int x) {
+    return x + counter;
+}
@@ -0,0 +1,150 @@
+#include "platform/platform.h"
+
+/*
+    Fuzzes the string and memory routines in src/libc against byte-at-a-time
+    reference versions. Strings are placed so they end right before an
+    inaccessible page, a routine that reads past the terminator crashes.
+
+    The artifact is built with AVX2 and the native program without, so both
+    the vector and the portable versions are checked.
+*/
+
+#include "libc/libc_rename.h"
+#include "libc/libc.c"
+
+#define ITERATIONS 20000
+#define MAX_LENGTH 300
+
+static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (uint32_t)(state >> 16);
+}
+
+static size_t ref_strlen(const char* s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+static int ref_strncmp(const char* a, const char* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        unsigned char x = a[i], y = b[i];
+        if (x != y || x == 0)
+            return (int)x - (int)y;
+    }
+    return 0;
+}
+
+static char* ref_strchr(const char* s, int c) {
+    for (;; s++) {
+        if (*s == (char)c)
+            return (char*)s;
+        if (!*s)
+            return NULL;
+    }
+}
+
+static char* ref_strrchr(const char* s, int c) {
+    const char* last = NULL;
+    do {
+        if (*s == (char)c)
+            last = s;
+    } while (*s++);
+    return (char*)last;
+}
+
+static void* ref_memchr(const void* s, int c, size_t n) {
+    const unsigned char* p = s;
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] == (unsigned char)c)
+            return (void*)(p + i);
+    }
+    return NULL;
+}
+
+static char* ref_strstr(const char* h, const char* n) {
+    size_t m = ref_strlen(n);
+    for (;; h++) {
+        if (ref_strncmp(h, n, m) == 0)
+            return (char*)h;
+        if (!*h)
+            return NULL;
+    }
+}
+
+static int sign(int x) {
+    return (x > 0) - (x < 0);
+}
+
+static int failures;
+
+static void check(bool ok, const char* what, int iteration) {
+    if (!ok && failures++ < 10)
+        log__printf("FAIL %s at iteration %d\n", what, iteration);
+}
+
+// Random string of a small alphabet so characters repeat and substrings match
+static void fill(char* s, size_t length) {
+    for (size_t i = 0; i < length; i++)
+        s[i] = 'a' + next() % 4;
+    s[length] = 0;
+}
+
+int ba_entry(const char* path, const char* data, int size) {
+    uint64_t page = mem__page_size();
+    char* base = mem__reserve(NULL, 4 * page);
+    mem__commit(base, page, MEM_READ|MEM_WRITE);
+    mem__commit(base + 2 * page, page, MEM_READ|MEM_WRITE);
+    char* guard_a = base + page;     // strings in the first page end at the guard
+    char* guard_b = base + 3 * page;
+
+    for (int it = 0; it < ITERATIONS; it++) {
+        size_t la = next() % MAX_LENGTH;
+        size_t lb = next() % 4 ? la : next() % MAX_LENGTH;
+        char* a = guard_a - la - 1;
+        char* b = next() % 2 ? guard_b - lb - 1 : guard_b - lb - 1 - next() % 64;
+        fill(a, la);
+        if (lb == la && next() % 2) {
+            for (size_t i = 0; i <= la; i++) b[i] = a[i];
+            if (la && next() % 2)
+                b[next() % la] = 'a' + next() % 5;
+        } else {
+            fill(b, lb);
+        }
+        int c = 'a' + next() % 5;
+
+        check(libc_strlen(a) == la && libc_strlen(b) == lb, "strlen", it);
+        check(sign(libc_strcmp(a, b)) == sign(ref_strncmp(a, b, (size_t)-1)), "strcmp", it);
+        size_t n = next() % (MAX_LENGTH + 40);
+        check(sign(libc_strncmp(a, b, n)) == sign(ref_strncmp(a, b, n)), "strncmp", it);
+        check(libc_strchr(a, c) == ref_strchr(a, c) && libc_strchr(a, 0) == a + la, "strchr", it);
+        check(libc_strrchr(a, c) == ref_strrchr(a, c) && libc_strrchr(b, 0) == b + lb, "strrchr", it);
+        size_t mn = la ? next() % (la + 1) : 0;
+        check(libc_memchr(a + la - mn, c, mn + 1) == ref_memchr(a + la - mn, c, mn + 1), "memchr", it);
+
+        size_t nl = next() % 6;
+        char* needle = b + lb - (nl < lb ? nl : lb);
+        check(libc_strstr(a, needle) == ref_strstr(a, needle), "strstr", it);
+
+        check(sign(libc_memcmp(a, b, la < lb ? la : lb)) == sign(ref_strncmp(a, b, la < lb ? la : lb)), "memcmp", it);
+        char* copy = base + 2 * page + next() % 64;
+        libc_strcpy(copy, a);
+        check(ref_strncmp(copy, a, la + 1) == 0 && copy[la] == 0, "strcpy", it);
+    }
+
+    mem__unmap(base, 4 * page);
+    log__printf("string: %d iterations, %d failures\n", ITERATIONS, failures);
+    return 0;
+}
+
+#if defined(OS_WINDOWS) || defined(OS_LINUX)
+
+int main(int argc, const char** argv) {
+    return ba_entry(argv[0], NULL, 0);
+}
+
+#endif
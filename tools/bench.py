@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+
+'''
+
+Script to run benchmarks.
+
+tools/bench.py [BENCHMARKS...]
+
+All benchmarks run if none are specified.
+
+A benchmark is a directory in bench/ with C files. They are compiled as a native
+program with optimizations and linked with the platform layer, then executed.
+The benchmark prints its own measurements.
+
+'''
+
+import os, sys, subprocess, glob, shlex, platform
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__))).replace('\\','/')
+
+def collect_benchmarks():
+    benchmarks = []
+    for bench_dir in sorted(glob.glob(f"{ROOT}/bench/*")):
+        if os.path.isdir(bench_dir):
+            benchmarks.append(bench_dir.replace('\\','/'))
+    return benchmarks
+
+class FailException(Exception):
+    pass
+
+def cmd(c: str):
+    c = c.replace("\\", "/")
+    proc = subprocess.run(shlex.split(c), text=True, stdout=subprocess.PIPE,stderr=subprocess.STDOUT)
+    if proc.returncode != 0:
+        print(c)
+        print(proc.stdout, end="")
+        raise FailException()
+
+def compile_native_program(output_file, files, flags):
+    INT = os.path.dirname(output_file)
+    os.makedirs(INT, exist_ok=True)
+
+    OBJECTS = [ INT + "/" + os.path.basename(f).replace('.c', '.o') for f in files ]
+
+    LIBS = ""
+    if platform.system() == "Windows":
+        flags += " -DOS_WINDOWS"
+        LIBS += " -lsynchronization"
+    if platform.system() == "Linux":
+        flags += " -DOS_LINUX"
+        LIBS += " -lpthread -lm"
+
+    for obj, src in zip(OBJECTS, files):
+        cmd(f"gcc -c {flags} {src} -o {obj}")
+
+    cmd(f"gcc {flags} -o {output_file} {ROOT}/src/platform/platform.c {' '.join(OBJECTS)} {LIBS}")
+
+def run_benchmark(bench_dir, args):
+    name = os.path.basename(bench_dir)
+    print(f"Benchmark {name}")
+
+    c_files = glob.glob(f"{bench_dir}/*.c")
+
+    WARN_FLAGS = "-Wall -Wno-unused-variable -Wno-unused-value"
+    FLAGS = f"-O2 -mavx2 {WARN_FLAGS} -I{ROOT}/include -I{ROOT}/src"
+
+    exe_file = f"{bench_dir}/int/{name}.exe"
+    compile_native_program(exe_file, c_files, FLAGS)
+
+    proc = subprocess.run([exe_file] + args, text=True, cwd=bench_dir)
+    return proc.returncode == 0
+
+def main(args):
+    benchmarks_to_run = []
+    bench_args = []
+    argi = 1
+    while argi < len(args):
+        arg = args[argi]
+        argi+=1
+        if arg == '-h':
+            print(f"Usage:")
+            print(f"  {__file__}                                Run all benchmarks")
+            print(f"  {__file__} [BENCHMARKS...] -- [args...]   Run specific benchmarks with arguments")
+            exit(0)
+        elif arg == '--':
+            bench_args = args[argi:]
+            break
+        elif arg[0] == '-':
+            print(f"ERROR: Unknown flag '{arg}'")
+            exit(1)
+        else:
+            benchmarks_to_run.append(arg)
+
+    benchmarks = collect_benchmarks()
+    if len(benchmarks_to_run) != 0:
+        benchmarks = [ b for b in benchmarks if os.path.basename(b) in benchmarks_to_run or b in benchmarks_to_run ]
+        if len(benchmarks) == 0:
+            print("ERROR: Arguments matched no benchmarks.")
+            print(f"  Arguments: {benchmarks_to_run}")
+            exit(1)
+
+    failed = 0
+    for bench_dir in benchmarks:
+        try:
+            if not run_benchmark(bench_dir, bench_args):
+                failed += 1
+        except FailException:
+            failed += 1
+
+    if failed != 0:
+        print(f"FAILURE {failed} benchmarks failed")
+        exit(1)
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -25,7 +25,7 @@ All tests run if none are specified.
 
 '''
 
-import os, sys, subprocess, glob, shlex, shutil, platform
+import os, sys, subprocess, glob, shlex, shutil, platform, filecmp
 
 ROOT = os.path.dirname(os.path.dirname(__file__)).replace('\\','/')
 
@@ -35,9 +35,8 @@ def collect_tests():
         tests.append(test_dir)
     return tests
 
-class FailException:
-    def __init__(self):
-        pass
+class FailException(Exception):
+    pass
 
 def cmd(c: str, silent: bool = False):
     c = c.replace("\\", "/")
@@ -46,7 +45,10 @@ def cmd(c: str, silent: bool = False):
     proc = subprocess.run(shlex.split(c), text=True, stdout=subprocess.PIPE,stderr=subprocess.STDOUT)
     # res = os.system(c)
     if proc.returncode != 0:
+        print(c)
+        print(proc.stdout, end="")
         raise FailException()
+    return proc.stdout
         # print(c)
         # exit(1)
     # proc = subprocess.run(shlex.split(c), shell=True, text=True, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
@@ -66,18 +68,20 @@ def compile_native_program(output_file, files, flags):
 
     OBJECTS = [ INT + "/" + os.path.basename(f).replace('.c', '.o') for f in files ]
 
+    LIBS = ""
     if platform.system() == "Windows":
         flags += " -DOS_WINDOWS"
+        LIBS += " -lsynchronization"
     if platform.system() == "Linux":
         flags += " -DOS_LINUX"
 
     for obj, src in zip(OBJECTS, files):
         cmd(f"gcc -c {flags} {src} -o {obj}")
 
-    cmd(f"gcc {flags} -o {output_file} {ROOT}/src/platform/platform.c {' '.join(OBJECTS)}")
+    cmd(f"gcc {flags} -o {output_file} {ROOT}/src/platform/platform.c {' '.join(OBJECTS)}{LIBS}")
     
     
-def compile_artifact(output_file, files, flags):
+def compile_artifact(output_file, files, flags, combine_flags = ""):
     INT = f"{ROOT}/int"
     os.makedirs(INT, exist_ok=True)
     os.makedirs(os.path.dirname(os.path.abspath(output_file)), exist_ok=True)
@@ -86,7 +90,32 @@ def compile_artifact(output_file, files, flags):
     for obj, src in zip(OBJECTS, files):
         cmd(f"gcc -c {flags} {src} -o {obj}")
     
-    cmd(f"barf -c -o {output_file} {' '.join(OBJECTS)}")
+    return cmd(f"barf -c {combine_flags}-o {output_file} {' '.join(OBJECTS)}")
+
+# Assembly files of a test are only converted, not run. The lines in '<name>.expect'
+# must show up in the dump of the converted file (relocations that can't be loaded).
+def check_conversions(test_dir):
+    if platform.system() != "Linux":
+        return True
+    INT = f"{test_dir}/int"
+    for src in glob.glob(f"{test_dir}/*.s"):
+        base = os.path.splitext(os.path.basename(src))[0]
+        obj = f"{INT}/{base}.o"
+        ba = f"{INT}/{base}-converted.ba"
+        cmd(f"gcc -c {src} -o {obj}")
+        cmd(f"barf -c -o {ba} {obj}")
+        dump = cmd(f"barf -d {ba}")
+        with open(os.path.splitext(src)[0] + ".expect") as f:
+            expected = [ line.strip() for line in f if line.strip() ]
+        missing = [ line for line in expected if line not in dump ]
+        if missing:
+            print("FAILED conversion of", os.path.basename(src))
+            print("Dump:")
+            print(dump)
+            print("Missing:")
+            print("\n".join(missing))
+            return False
+    return True
 
 def run_test(test_dir):
     print(f"Running {test_dir}")
@@ -102,23 +131,50 @@ def run_test(test_dir):
 
     WARN_FLAGS = "-Wall -Wno-unused-variable -Wno-unused-value"
     NOLIB_FLAGS = "-fno-builtin -static -fPIC -fpie -nostdlib -ffreestanding -nostartfiles -mavx2"
-    FLAGS = f"{WARN_FLAGS} -I{ROOT}/include"
+    FLAGS = f"{WARN_FLAGS} -I{ROOT}/include -I{ROOT}/src"
     
     ba_file = f"{INT}/{name}.ba"
     exe_file = f"{INT}/{name}.exe"
 
-    compile_artifact(ba_file, c_files, f"{FLAGS} {NOLIB_FLAGS}")
     compile_native_program(exe_file, c_files, FLAGS)
-    
-    proc_ba = subprocess.run(shlex.split(f"barf {ba_file}"), text=True, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
     proc_exe = subprocess.run(shlex.split(f"{exe_file}"), text=True, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
 
-    if proc_exe.stdout != proc_ba.stdout:
-        print("FAILED")
-        print("STDOUT ba:")
-        print(proc_ba.stdout)
-        print("STDOUT exe:")
-        print(proc_exe.stdout)
+    # The artifact must behave the same with and without merged, collected and folded sections
+    for combine_flags in ["", "--merge-sections ", "--gc-sections --merge-sections --icf "]:
+        combine_output = compile_artifact(ba_file, c_files, f"{FLAGS} {NOLIB_FLAGS}", combine_flags)
+
+        # Lines in 'combine.expect' must be printed by the combiner when all flags are on,
+        # equal output alone doesn't show that sections were folded
+        if "--icf" in combine_flags and os.path.exists(f"{test_dir}/combine.expect"):
+            with open(f"{test_dir}/combine.expect") as f:
+                expected = [ line.strip() for line in f if line.strip() ]
+            missing = [ line for line in expected if line not in combine_output ]
+            if missing:
+                print("FAILED", combine_flags)
+                print("Combiner output:")
+                print(combine_output)
+                print("Missing:")
+                print("\n".join(missing))
+                return False
+
+        proc_ba = subprocess.run(shlex.split(f"barf {ba_file}"), text=True, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+        if proc_exe.stdout != proc_ba.stdout:
+            print("FAILED", combine_flags)
+            print("STDOUT ba:")
+            print(proc_ba.stdout)
+            print("STDOUT exe:")
+            print(proc_exe.stdout)
+            return False
+
+    # Inputs are converted on a thread pool, the result must not depend on the thread count
+    compile_artifact(f"{INT}/{name}-j1.ba", c_files, f"{FLAGS} {NOLIB_FLAGS}", "-j 1 --gc-sections --merge-sections --icf ")
+    compile_artifact(f"{INT}/{name}-j4.ba", c_files, f"{FLAGS} {NOLIB_FLAGS}", "-j 4 --gc-sections --merge-sections --icf ")
+    if not filecmp.cmp(f"{INT}/{name}-j1.ba", f"{INT}/{name}-j4.ba", shallow=False):
+        print("FAILED -j 4 output differs from -j 1")
+        return False
+
+    if not check_conversions(test_dir):
         return False
 
     print("PASSED", name)
@@ -176,7 +232,7 @@ def main(args):
                 passed_tests += 1
             
         except FailException as ex:
-            pass
+            print("FAILED", os.path.basename(test_dir))
     
     if passed_tests == total_tests:
         print(f"SUCCESS {passed_tests}/{total_tests}")